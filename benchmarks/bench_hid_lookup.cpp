@@ -0,0 +1,115 @@
+/**
+ * @file bench_hid_lookup.cpp
+ * @brief Microbenchmark: flat constexpr KEY_* tables vs. std::unordered_map lookup
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * Replays a pseudo-random stream of Linux key codes (mostly mapped keys with
+ * some unmapped ones mixed in) through hid::get_keyboard_usage() /
+ * hid::get_consumer_usage() and through an std::unordered_map built from the
+ * same source tables, which is how lookups were implemented previously.
+ *
+ * Usage: bench_hid_lookup [iterations]
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "hid_keycodes.hpp"
+
+namespace {
+
+constexpr std::size_t STREAM_LENGTH = 4096;
+constexpr std::size_t DEFAULT_ITERATIONS = 2000;
+
+// Keeps lookup results observable so the timed loops cannot be optimized away
+volatile std::uint64_t g_sink = 0;
+
+std::vector<int> make_key_stream() {
+    std::vector<int> codes;
+    codes.reserve(STREAM_LENGTH);
+
+    std::uint32_t seed = 0x12345678U;
+    for (std::size_t i = 0; i < STREAM_LENGTH; ++i) {
+        seed = seed * 1664525U + 1013904223U;  // LCG, deterministic across runs
+        if (seed % 8 == 0) {
+            codes.push_back(static_cast<int>((seed >> 8) % hid::KEYCODE_TABLE_SIZE));
+        } else {
+            const auto& entry = hid::kKeyboardUsage[(seed >> 8) % std::size(hid::kKeyboardUsage)];
+            codes.push_back(entry.linux_code);
+        }
+    }
+    return codes;
+}
+
+template <typename Fn>
+double measure_ns_per_lookup(const std::vector<int>& codes, std::size_t iterations, Fn&& lookup) {
+    std::uint64_t checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t it = 0; it < iterations; ++it) {
+        for (const int code : codes) {
+            checksum += lookup(code);
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    g_sink = checksum;
+
+    const auto ns = std::chrono::duration<double, std::nano>(end - start).count();
+    return ns / static_cast<double>(iterations * codes.size());
+}
+
+void report(const std::string& name, double map_ns, double table_ns) {
+    std::cout << name << ": unordered_map " << map_ns << " ns/lookup, flat table " << table_ns
+              << " ns/lookup (" << (table_ns > 0.0 ? map_ns / table_ns : 0.0) << "x)\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t iterations =
+        argc > 1 ? static_cast<std::size_t>(std::strtoul(argv[1], nullptr, 10)) : DEFAULT_ITERATIONS;
+    if (iterations == 0) {
+        std::cerr << "Usage: " << argv[0] << " [iterations > 0]\n";
+        return 1;
+    }
+
+    // Previous representation, built from the same source tables
+    std::unordered_map<int, std::uint8_t> keyboard_map;
+    for (const auto& entry : hid::kKeyboardUsage) {
+        keyboard_map.emplace(entry.linux_code, entry.usage);
+    }
+    std::unordered_map<int, std::uint16_t> consumer_map;
+    for (const auto& entry : hid::kConsumerUsage) {
+        consumer_map.emplace(entry.linux_code, entry.usage);
+    }
+
+    const std::vector<int> codes = make_key_stream();
+
+    const double keyboard_map_ns = measure_ns_per_lookup(codes, iterations, [&](int code) {
+        const auto it = keyboard_map.find(code);
+        return it != keyboard_map.end() ? it->second : 0;
+    });
+    const double keyboard_table_ns = measure_ns_per_lookup(
+        codes, iterations, [](int code) { return hid::get_keyboard_usage(code).value_or(0); });
+
+    const double consumer_map_ns = measure_ns_per_lookup(codes, iterations, [&](int code) {
+        const auto it = consumer_map.find(code);
+        return it != consumer_map.end() ? it->second : 0;
+    });
+    const double consumer_table_ns = measure_ns_per_lookup(
+        codes, iterations, [](int code) { return hid::get_consumer_usage(code).value_or(0); });
+
+    std::cout << "=== HID usage lookup (" << iterations << " x " << codes.size()
+              << " key codes) ===\n";
+    report("keyboard", keyboard_map_ns, keyboard_table_ns);
+    report("consumer", consumer_map_ns, consumer_table_ns);
+    return 0;
+}
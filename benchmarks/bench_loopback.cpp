@@ -0,0 +1,424 @@
+/**
+ * @file bench_loopback.cpp
+ * @brief End-to-end input benchmark: uinput keyboard → input thread → mock BLE sink
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * Creates a virtual keyboard through /dev/uinput, waits until the real
+ * KeyboardManager hot-plug path has picked it up, and runs the real
+ * InputThread on it. A scripted key stream is written to the virtual
+ * keyboard at a fixed rate while the main thread drains the report ring
+ * the way main.cpp does, except that the "BLE write" is a sink that only
+ * stamps and stores the report. No Bluetooth hardware is involved.
+ *
+ * The same script is run through an offline KeyEventProcessor to get the
+ * reports the pipeline should produce; received reports are matched
+ * against them in order to count drops (e.g. after an evdev buffer
+ * overrun) and unexpected reports. Latency histograms come from the
+ * LatencyTracker, so the stages are those of `--latency-stats`, with the
+ * sink standing in for writeCharacteristic():
+ *
+ * - kernel→read: uinput write → event read on the input thread
+ * - read→report: event read → report queued
+ * - report→write: report queued → drained by the sink
+ * - end-to-end: uinput write → drained by the sink
+ *
+ * Only the virtual keyboard stays grabbed; the other keyboards are handed
+ * back to the desktop. Their events are still read, so do not type while
+ * the benchmark runs (reports from them are counted separately).
+ *
+ * Usage: bench_loopback [--rate <events/s>] [--count <events>] [--rollover <keys>]
+ *                       [--coalesce-frames] [--json]
+ *
+ * Needs write access to /dev/uinput (root, or `modprobe uinput` plus a udev
+ * rule for the uinput group).
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <poll.h>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <linux/input.h>
+
+#include "device_manager.hpp"
+#include "input_thread.hpp"
+#include "key_event_processor.hpp"
+#include "latency_tracker.hpp"
+#include "logger.hpp"
+#include "virtual_keyboard.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr const char* KEYBOARD_NAME = "ninjaUSB loopback keyboard";
+constexpr auto DETECT_TIMEOUT = std::chrono::seconds(5);  //!< Hot-plug pick-up limit
+constexpr auto SETTLE_TIMEOUT = std::chrono::milliseconds(500);  //!< Wait for stragglers
+
+//! @brief Keys of the script: no modifiers, so no hotkey chord can fire
+constexpr std::array<unsigned int, 36> SCRIPT_KEYS = {
+    KEY_A, KEY_B, KEY_C, KEY_D, KEY_E, KEY_F, KEY_G, KEY_H, KEY_I, KEY_J, KEY_K, KEY_L,
+    KEY_M, KEY_N, KEY_O, KEY_P, KEY_Q, KEY_R, KEY_S, KEY_T, KEY_U, KEY_V, KEY_W, KEY_X,
+    KEY_Y, KEY_Z, KEY_1, KEY_2, KEY_3, KEY_4, KEY_5, KEY_6, KEY_7, KEY_8, KEY_9, KEY_0};
+
+struct LoopbackOptions {
+    long rate = 1000;              //!< Key events per second (0: as fast as possible)
+    long count = 10000;            //!< Key events to inject
+    int rollover = 1;              //!< Keys held at once
+    bool coalesce_frames = false;  //!< Same as ninja_util --coalesce-frames
+    bool json = false;             //!< Print the results as one JSON object
+    bool verbose = false;          //!< Debug logging from the pipeline
+};
+
+struct KeyEvent {
+    unsigned int code;
+    int value;
+};
+
+void show_usage(const char* program) {
+    std::cout
+        << "Usage: " << program << " [OPTIONS]\n\n"
+        << "OPTIONS:\n"
+        << "    --rate <events/s>    Key events per second (default 1000, 0: as fast as\n"
+        << "                         possible)\n"
+        << "    --count <events>     Key events to inject (default 10000)\n"
+        << "    --rollover <keys>    Keys held at once, 1-6 (default 1)\n"
+        << "    --coalesce-frames    Run the input thread with frame coalescing\n"
+        << "    --json               Print the results as JSON\n"
+        << "    -V, --verbose        Per-event debug logging\n"
+        << "    -h, --help           Show this help message and exit\n\n"
+        << "Exit status: 0 every report arrived, 1 error, 2 reports dropped or unexpected\n";
+}
+
+std::optional<long> parse_number(const std::string& text, long min, long max) {
+    char* end = nullptr;
+    const long n = std::strtol(text.c_str(), &end, 10);
+    if (end == text.c_str() || *end != '\0' || n < min || n > max) {
+        return std::nullopt;
+    }
+    return n;
+}
+
+std::optional<LoopbackOptions> parse_options(int argc, char* argv[]) {
+    LoopbackOptions opts;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto number = [&](long min, long max) -> std::optional<long> {
+            const auto n = i + 1 < argc ? parse_number(argv[++i], min, max) : std::nullopt;
+            if (!n) {
+                std::cerr << "Error: " << arg << " must be a number from " << min << " to "
+                          << max << "\n";
+            }
+            return n;
+        };
+
+        if (arg == "-h" || arg == "--help") {
+            show_usage(argv[0]);
+            std::exit(0);
+        } else if (arg == "--rate") {
+            const auto n = number(0, 1000000);
+            if (!n) {
+                return std::nullopt;
+            }
+            opts.rate = *n;
+        } else if (arg == "--count") {
+            const auto n = number(1, 100000000);
+            if (!n) {
+                return std::nullopt;
+            }
+            opts.count = *n;
+        } else if (arg == "--rollover") {
+            const auto n = number(1, 6);
+            if (!n) {
+                return std::nullopt;
+            }
+            opts.rollover = static_cast<int>(*n);
+        } else if (arg == "--coalesce-frames") {
+            opts.coalesce_frames = true;
+        } else if (arg == "--json") {
+            opts.json = true;
+        } else if (arg == "-V" || arg == "--verbose") {
+            opts.verbose = true;
+        } else {
+            std::cerr << "Error: unknown argument '" << arg << "'\n";
+            return std::nullopt;
+        }
+    }
+    return opts;
+}
+
+/**
+ * @brief Build the key stream: a window of `rollover` held keys sliding over SCRIPT_KEYS
+ * @return At least `count` events; the last ones release every key still held
+ */
+std::vector<KeyEvent> make_script(long count, int rollover) {
+    std::vector<KeyEvent> script;
+    script.reserve(static_cast<std::size_t>(count) + static_cast<std::size_t>(rollover));
+    std::size_t pressed = 0;  // Keys pressed so far; the window is the last `rollover` of them
+    std::size_t released = 0;
+    while (static_cast<long>(script.size()) < count) {
+        if (pressed - released == static_cast<std::size_t>(rollover)) {
+            script.push_back({SCRIPT_KEYS[released++ % SCRIPT_KEYS.size()], 0});
+        } else {
+            script.push_back({SCRIPT_KEYS[pressed++ % SCRIPT_KEYS.size()], 1});
+        }
+    }
+    while (released < pressed) {
+        script.push_back({SCRIPT_KEYS[released++ % SCRIPT_KEYS.size()], 0});
+    }
+    return script;
+}
+
+/**
+ * @brief Reports the pipeline should produce for the script
+ */
+std::vector<pipeline::Report> expected_reports(const std::vector<KeyEvent>& script,
+                                               bool coalesce) {
+    std::vector<pipeline::Report> reports;
+    pipeline::KeyEventProcessor reference(
+        [&](const pipeline::Report& report) { reports.push_back(report); }, false, coalesce);
+    for (const auto& key : script) {
+        input_event ev{};
+        ev.type = EV_KEY;
+        ev.code = static_cast<std::uint16_t>(key.code);
+        ev.value = key.value;
+        [[maybe_unused]] const auto action = reference.process(ev, KEYBOARD_NAME);
+        ev.type = EV_SYN;
+        ev.code = SYN_REPORT;
+        ev.value = 0;
+        [[maybe_unused]] const auto sync = reference.process(ev, KEYBOARD_NAME);
+    }
+    return reports;
+}
+
+/**
+ * @brief Let the hot-plug path pick up the virtual keyboard
+ * @return Index of the keyboard in manager.keyboards(), or nullopt after DETECT_TIMEOUT
+ */
+std::optional<std::size_t> wait_for_keyboard(device::KeyboardManager& manager,
+                                             const std::string& devnode) {
+    const auto deadline = Clock::now() + DETECT_TIMEOUT;
+    for (;;) {
+        const auto& keyboards = manager.keyboards();
+        for (std::size_t i = 0; i < keyboards.size(); ++i) {
+            if (keyboards[i].path() == devnode) {
+                return i;
+            }
+        }
+        const auto left =
+            std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now());
+        if (left.count() <= 0) {
+            return std::nullopt;
+        }
+        pollfd fds[2] = {{manager.monitor_fd(), POLLIN, 0}, {manager.retry_fd(), POLLIN, 0}};
+        if (poll(fds, 2, static_cast<int>(left.count())) > 0) {
+            manager.update_devices();
+        }
+    }
+}
+
+/**
+ * @brief Result of matching the received reports against the expected ones
+ */
+struct Match {
+    std::size_t dropped = 0;     //!< Expected reports that never arrived
+    std::size_t unexpected = 0;  //!< Received reports that fit nowhere in the sequence
+};
+
+Match match_reports(const std::vector<pipeline::Report>& expected,
+                    const std::vector<pipeline::Report>& received) {
+    Match match;
+    auto next = expected.begin();
+    for (const auto& report : received) {
+        const auto it = std::find(next, expected.end(), report);
+        if (it == expected.end()) {
+            ++match.unexpected;
+            continue;
+        }
+        match.dropped += static_cast<std::size_t>(it - next);
+        next = it + 1;
+    }
+    match.dropped += static_cast<std::size_t>(expected.end() - next);
+    return match;
+}
+
+double to_us(std::uint64_t ns) {
+    return static_cast<double>(ns) / 1e3;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const auto opts = parse_options(argc, argv);
+    if (!opts) {
+        return 1;
+    }
+    logging::Logger::set_level(opts->verbose ? "debug" : "warn");
+
+    device::KeyboardManager manager;
+    if (!manager.is_valid()) {
+        std::cerr << "Error: cannot initialize device monitoring (udev)\n";
+        return 1;
+    }
+    // The keyboards found at start-up go back to the desktop; the virtual one is
+    // hot-plugged after this and stays grabbed, so its keys never reach the console
+    for (std::size_t i = 0; i < manager.device_count(); ++i) {
+        [[maybe_unused]] const bool released = manager.keyboard(i).set_grabbed(false);
+    }
+
+    device::VirtualKeyboard virtual_keyboard(KEYBOARD_NAME);
+    if (!virtual_keyboard.is_valid()) {
+        std::cerr << "Error: cannot create a uinput keyboard: "
+                  << std::strerror(virtual_keyboard.error())
+                  << " (needs write access to /dev/uinput and the uinput module)\n";
+        return 1;
+    }
+    if (!wait_for_keyboard(manager, virtual_keyboard.devnode())) {
+        std::cerr << "Error: " << virtual_keyboard.devnode() << " was not picked up within "
+                  << DETECT_TIMEOUT.count() << " s\n";
+        return 1;
+    }
+
+    const auto script = make_script(opts->count, opts->rollover);
+    const auto expected = expected_reports(script, opts->coalesce_frames);
+
+    pipeline::LatencyTracker latency;
+    const std::uint8_t slot = latency.keyboard_slot(virtual_keyboard.devnode());
+    pipeline::InputThread::Config config;
+    config.coalesce_frames = opts->coalesce_frames;
+    config.latency = &latency;
+    pipeline::InputThread input(manager, config, opts->verbose);
+    if (!input.is_valid() || !input.start()) {
+        std::cerr << "Error: cannot start the input thread\n";
+        return 1;
+    }
+
+    // Injector: one key event plus SYN_REPORT per tick, on an absolute schedule
+    std::atomic<bool> injected{false};
+    std::atomic<std::size_t> write_errors{0};
+    Clock::duration inject_time{};
+    std::thread injector([&] {
+        const auto period = opts->rate > 0 ? std::chrono::nanoseconds(1000000000 / opts->rate)
+                                           : std::chrono::nanoseconds(0);
+        const auto start = Clock::now();
+        auto tick = start;
+        for (const auto& key : script) {
+            if (period.count() > 0) {
+                std::this_thread::sleep_until(tick);
+                tick += period;
+            }
+            if (!virtual_keyboard.key(key.code, key.value)) {
+                write_errors.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        inject_time = Clock::now() - start;
+        injected.store(true, std::memory_order_release);
+    });
+
+    // Mock BLE sink: drained on notify_fd() like the Qt thread does
+    std::vector<pipeline::Report> received;
+    received.reserve(expected.size());
+    std::size_t foreign = 0;
+    auto last_report = Clock::now();
+    for (;;) {
+        pollfd pfd{input.notify_fd(), POLLIN, 0};
+        if (poll(&pfd, 1, 20) > 0) {
+            const std::size_t drained = input.drain(
+                [&](const pipeline::Report& report, const pipeline::ReportTiming& timing) {
+                    latency.on_report_written(timing, pipeline::monotonic_now_ns());
+                    if (timing.keyboard != slot) {
+                        ++foreign;
+                    } else {
+                        received.push_back(report);
+                    }
+                });
+            if (drained > 0) {
+                last_report = Clock::now();
+            }
+        }
+        if (injected.load(std::memory_order_acquire) &&
+            (received.size() >= expected.size() || Clock::now() - last_report > SETTLE_TIMEOUT)) {
+            break;
+        }
+    }
+    injector.join();
+    input.stop();
+
+    const Match match = match_reports(expected, received);
+    const double seconds = std::chrono::duration<double>(inject_time).count();
+    const double events_per_second =
+        seconds > 0.0 ? static_cast<double>(script.size()) / seconds : 0.0;
+
+    const pipeline::LatencyStage stages[] = {
+        pipeline::LatencyStage::KernelToRead, pipeline::LatencyStage::ReadToReport,
+        pipeline::LatencyStage::ReportToWrite, pipeline::LatencyStage::EndToEnd};
+    auto summary = [&](pipeline::LatencyStage stage) {
+        const auto* histogram = latency.keyboard(virtual_keyboard.devnode(), stage);
+        return histogram ? histogram->summarize() : pipeline::LatencyHistogram::Summary{};
+    };
+
+    if (opts->json) {
+        std::cout << "{\"events\": " << script.size() << ", \"rate\": " << opts->rate
+                  << ", \"rollover\": " << opts->rollover
+                  << ", \"coalesce_frames\": " << (opts->coalesce_frames ? "true" : "false")
+                  << ", \"events_per_second\": " << events_per_second
+                  << ", \"write_errors\": " << write_errors.load()
+                  << ", \"reports_expected\": " << expected.size()
+                  << ", \"reports_received\": " << received.size()
+                  << ", \"reports_dropped\": " << match.dropped
+                  << ", \"reports_unexpected\": " << match.unexpected
+                  << ", \"reports_foreign\": " << foreign
+                  << ", \"queue_high_water\": " << input.queue_high_water_mark()
+                  << ", \"queue_full_waits\": " << input.queue_full_waits()
+                  << ", \"latency_us\": {";
+        const char* separator = "";
+        for (const auto stage : stages) {
+            const auto s = summary(stage);
+            std::cout << separator << "\"" << pipeline::to_string(stage) << "\": {\"count\": "
+                      << s.count << ", \"mean\": " << to_us(s.mean)
+                      << ", \"p50\": " << to_us(s.p50) << ", \"p99\": " << to_us(s.p99)
+                      << ", \"p999\": " << to_us(s.p999) << ", \"max\": " << to_us(s.max) << "}";
+            separator = ", ";
+        }
+        std::cout << "}}\n";
+    } else {
+        std::cout << "Loopback: " << script.size() << " key events on "
+                  << virtual_keyboard.devnode() << " at "
+                  << (opts->rate > 0 ? std::to_string(opts->rate) + "/s" : "full speed")
+                  << " (achieved " << events_per_second << "/s), rollover " << opts->rollover
+                  << (opts->coalesce_frames ? ", frame coalescing" : "") << "\n";
+        if (write_errors.load() > 0) {
+            std::cout << "Injection: " << write_errors.load() << " uinput writes failed\n";
+        }
+        std::cout << "Reports: " << expected.size() << " expected, " << received.size()
+                  << " received, " << match.dropped << " dropped, " << match.unexpected
+                  << " unexpected";
+        if (foreign > 0) {
+            std::cout << ", " << foreign << " from other keyboards";
+        }
+        std::cout << "\nInput thread: queue high-water mark " << input.queue_high_water_mark()
+                  << ", " << input.queue_full_waits() << " full-queue waits\n";
+        std::cout << "Latency in us (report->write and end-to-end end at the mock sink):\n";
+        for (const auto stage : stages) {
+            const auto s = summary(stage);
+            std::cout << "  " << pipeline::to_string(stage) << ": n=" << s.count
+                      << " mean=" << to_us(s.mean) << " p50=" << to_us(s.p50)
+                      << " p99=" << to_us(s.p99) << " p99.9=" << to_us(s.p999)
+                      << " max=" << to_us(s.max) << "\n";
+        }
+    }
+    return match.dropped == 0 && match.unexpected == 0 && write_errors.load() == 0 ? 0 : 2;
+}
@@ -0,0 +1,340 @@
+/**
+ * @file ninja_bench.cpp
+ * @brief Google Benchmark suite for the input → report hot path
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * Covers every stage a key event passes through before it is handed to the
+ * BLE link:
+ * - KEY_* → HID usage lookup (hid::get_keyboard_usage())
+ * - KeyboardState updates and report encoding under a typing stream and
+ *   under rollover with 2-10 keys held (beyond six exercises the overflow bitmap)
+ * - Report de-duplication and the whole KeyEventProcessor
+ * - Logging calls below the level (the common case) and enabled, synchronous
+ *   and with the async sink
+ * - KeyboardManager poll set: get_poll_fds() against the cached poll_fds()
+ *
+ * Results are printed as JSON unless `--benchmark_format` is given, so runs
+ * can be archived and compared across releases (e.g. with Google Benchmark's
+ * tools/compare.py). `make bench_json` writes them to ninja_bench.json.
+ *
+ * Usage: ninja_bench [--benchmark_filter=<regex>] [--benchmark_format=console|json|csv]
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <linux/input.h>
+
+#include "device_manager.hpp"
+#include "hid_keycodes.hpp"
+#include "key_event_processor.hpp"
+#include "logger.hpp"
+#include "report_deduplicator.hpp"
+
+namespace {
+
+constexpr std::size_t STREAM_LENGTH = 4096;
+
+/**
+ * @brief One EV_KEY event of a synthetic stream
+ */
+struct KeyEvent {
+    int code;   //!< Linux key code
+    int value;  //!< 0 release, 1 press, 2 repeat
+};
+
+//! @brief Deterministic LCG so every run replays the same streams
+std::uint32_t next_random(std::uint32_t& seed) {
+    seed = seed * 1664525U + 1013904223U;
+    return seed >> 8;
+}
+
+/**
+ * @brief Key codes drawn from the keyboard table, one in eight unmapped
+ */
+std::vector<int> make_code_stream() {
+    std::vector<int> codes;
+    codes.reserve(STREAM_LENGTH);
+    std::uint32_t seed = 0x12345678U;
+    for (std::size_t i = 0; i < STREAM_LENGTH; ++i) {
+        const std::uint32_t r = next_random(seed);
+        if (r % 8 == 0) {
+            codes.push_back(static_cast<int>(r % hid::KEYCODE_TABLE_SIZE));
+        } else {
+            codes.push_back(hid::kKeyboardUsage[r % std::size(hid::kKeyboardUsage)].linux_code);
+        }
+    }
+    return codes;
+}
+
+/**
+ * @brief Press/release pairs of letters and spaces, every tenth letter shifted
+ *
+ * Each key is released before the next one is pressed, with an occasional
+ * auto-repeat, which is what most typing looks like to the processor.
+ */
+std::vector<KeyEvent> make_typing_stream() {
+    static constexpr int letters[] = {KEY_A, KEY_B, KEY_C, KEY_D, KEY_E, KEY_F, KEY_G,
+                                      KEY_H, KEY_I, KEY_J, KEY_K, KEY_L, KEY_M, KEY_N,
+                                      KEY_O, KEY_P, KEY_Q, KEY_R, KEY_S, KEY_T, KEY_U,
+                                      KEY_V, KEY_W, KEY_X, KEY_Y, KEY_Z, KEY_SPACE};
+    std::vector<KeyEvent> events;
+    events.reserve(STREAM_LENGTH);
+    std::uint32_t seed = 0x9E3779B9U;
+    while (events.size() + 5 <= STREAM_LENGTH) {
+        const std::uint32_t r = next_random(seed);
+        const int code = letters[r % std::size(letters)];
+        const bool shifted = r % 10 == 0;
+        if (shifted) {
+            events.push_back({KEY_LEFTSHIFT, 1});
+        }
+        events.push_back({code, 1});
+        if (r % 50 == 1) {
+            events.push_back({code, 2});
+        }
+        events.push_back({code, 0});
+        if (shifted) {
+            events.push_back({KEY_LEFTSHIFT, 0});
+        }
+    }
+    return events;
+}
+
+/**
+ * @brief Rolling window of held keys: each press releases the key pressed `held` presses ago
+ * @param held Keys held at once (2-10)
+ */
+std::vector<KeyEvent> make_rollover_stream(std::size_t held) {
+    std::vector<int> window;
+    std::vector<KeyEvent> events;
+    events.reserve(STREAM_LENGTH);
+    std::uint32_t seed = 0xC0FFEE11U;
+    while (events.size() + 2 <= STREAM_LENGTH) {
+        int code = 0;
+        std::optional<std::uint8_t> usage;
+        do {
+            code = KEY_Q + static_cast<int>(next_random(seed) % 35);  // Q ... M rows
+            usage = hid::get_keyboard_usage(code);
+        } while (!usage || hid::is_modifier(*usage) ||
+                 std::find(window.begin(), window.end(), code) != window.end());
+        events.push_back({code, 1});
+        window.push_back(code);
+        if (window.size() > held) {
+            events.push_back({window.front(), 0});
+            window.erase(window.begin());
+        }
+    }
+    return events;
+}
+
+input_event to_input_event(const KeyEvent& key) {
+    input_event ev{};
+    ev.type = EV_KEY;
+    ev.code = static_cast<decltype(ev.code)>(key.code);
+    ev.value = key.value;
+    return ev;
+}
+
+/**
+ * @brief Stream buffer that discards everything (keeps enabled log calls off the terminal)
+ */
+class NullBuffer : public std::streambuf {
+  protected:
+    int overflow(int c) override { return traits_type::not_eof(c); }
+    std::streamsize xsputn(const char* /*s*/, std::streamsize n) override { return n; }
+};
+
+/**
+ * @brief Redirects std::cout and std::cerr into a NullBuffer for its lifetime
+ */
+class SilencedOutput {
+  private:
+    NullBuffer null_;
+    std::streambuf* cout_;
+    std::streambuf* cerr_;
+
+  public:
+    SilencedOutput() : cout_(std::cout.rdbuf(&null_)), cerr_(std::cerr.rdbuf(&null_)) {}
+    ~SilencedOutput() {
+        std::cout.rdbuf(cout_);
+        std::cerr.rdbuf(cerr_);
+    }
+    SilencedOutput(const SilencedOutput&) = delete;
+    SilencedOutput& operator=(const SilencedOutput&) = delete;
+};
+
+// ------------------ HID usage lookup ------------------
+
+void BM_GetKeyboardUsage(benchmark::State& state) {
+    const std::vector<int> codes = make_code_stream();
+    for (auto _ : state) {
+        std::uint32_t checksum = 0;
+        for (const int code : codes) {
+            checksum += hid::get_keyboard_usage(code).value_or(0);
+        }
+        benchmark::DoNotOptimize(checksum);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * codes.size()));
+}
+BENCHMARK(BM_GetKeyboardUsage);
+
+// ------------------ Keyboard state and report encoding ------------------
+
+void run_key_stream(benchmark::State& state, const std::vector<KeyEvent>& events) {
+    hid::KeyboardState keys;
+    for (auto _ : state) {
+        for (const KeyEvent& event : events) {
+            if (hid::apply_key_event(keys, event.code, event.value)) {
+                benchmark::DoNotOptimize(keys.get_report());
+                benchmark::DoNotOptimize(keys.get_overflow_bitmap());
+            }
+        }
+        keys.clear();
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * events.size()));
+}
+
+void BM_ApplyKeyEventTyping(benchmark::State& state) {
+    run_key_stream(state, make_typing_stream());
+}
+BENCHMARK(BM_ApplyKeyEventTyping);
+
+void BM_ApplyKeyEventRollover(benchmark::State& state) {
+    run_key_stream(state, make_rollover_stream(static_cast<std::size_t>(state.range(0))));
+}
+BENCHMARK(BM_ApplyKeyEventRollover)->Arg(2)->Arg(6)->Arg(10);
+
+// ------------------ De-duplication and the whole processor ------------------
+
+void BM_ReportDeduplicator(benchmark::State& state) {
+    // Reports of a typing stream, with every auto-repeat producing an unchanged report
+    std::vector<pipeline::Report> reports;
+    hid::KeyboardState keys;
+    for (const KeyEvent& event : make_typing_stream()) {
+        if (hid::apply_key_event(keys, event.code, event.value)) {
+            reports.push_back(pipeline::Report::keyboard(keys.get_report()));
+        }
+    }
+    std::uint64_t sent = 0;
+    pipeline::ReportDeduplicator dedup([&sent](const pipeline::Report&) { ++sent; });
+    for (auto _ : state) {
+        for (const pipeline::Report& report : reports) {
+            benchmark::DoNotOptimize(dedup.submit(report));
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * reports.size()));
+    state.counters["sent_ratio"] =
+        static_cast<double>(sent) / static_cast<double>(state.iterations() * reports.size());
+}
+BENCHMARK(BM_ReportDeduplicator);
+
+void BM_KeyEventProcessor(benchmark::State& state) {
+    const bool coalesce = state.range(0) != 0;
+    std::vector<input_event> events;
+    for (const KeyEvent& key : make_typing_stream()) {
+        events.push_back(to_input_event(key));
+        input_event syn{};
+        syn.type = EV_SYN;
+        syn.code = SYN_REPORT;
+        events.push_back(syn);
+    }
+    std::uint64_t sent = 0;
+    pipeline::KeyEventProcessor processor([&sent](const pipeline::Report&) { ++sent; }, false,
+                                          coalesce);
+    const std::string source = "bench";
+    for (auto _ : state) {
+        for (const input_event& ev : events) {
+            benchmark::DoNotOptimize(processor.process(ev, source));
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * events.size()));
+    benchmark::DoNotOptimize(sent);
+}
+BENCHMARK(BM_KeyEventProcessor)->ArgName("coalesce")->Arg(0)->Arg(1);
+
+// ------------------ Logging ------------------
+
+void BM_LogSuppressed(benchmark::State& state) {
+    int code = 0;
+    for (auto _ : state) {
+        LOG_DEBUG("Key event: code=" + std::to_string(code));  // Never built
+        LOG_DEBUGF("Key event: code=%d value=%d", code, 1);
+        ++code;
+    }
+    benchmark::DoNotOptimize(code);
+}
+BENCHMARK(BM_LogSuppressed);
+
+void BM_LogEnabled(benchmark::State& state) {
+    const bool async = state.range(0) != 0;
+    logging::Logger::set_level(logging::Level::DEBUG);
+    {
+        SilencedOutput silenced;
+        logging::Logger::enable_async(async);
+        int code = 0;
+        for (auto _ : state) {
+            LOG_DEBUGF("Key event: code=%d value=%d from %s", code++, 1, "bench");
+        }
+        logging::Logger::flush();
+        logging::Logger::enable_async(false);
+    }
+    logging::Logger::set_level(logging::Level::WARN);
+    state.counters["dropped"] = static_cast<double>(logging::Logger::dropped_count());
+}
+BENCHMARK(BM_LogEnabled)->ArgName("async")->Arg(0)->Arg(1);
+
+// ------------------ Poll set ------------------
+
+void BM_PollFds(benchmark::State& state) {
+    const bool cached = state.range(0) != 0;
+    device::KeyboardManager manager;
+    if (!manager.is_valid()) {
+        state.SkipWithError("udev monitor unavailable");
+        return;
+    }
+    for (auto _ : state) {
+        if (cached) {
+            benchmark::DoNotOptimize(manager.poll_fds());
+        } else {
+            benchmark::DoNotOptimize(manager.get_poll_fds());
+        }
+    }
+    state.counters["keyboards"] = static_cast<double>(manager.poll_fds().keyboard_count);
+}
+BENCHMARK(BM_PollFds)->ArgName("cached")->Arg(0)->Arg(1);
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    // JSON unless the caller picked a format
+    std::vector<char*> args(argv, argv + argc);
+    bool format_given = false;
+    for (int i = 1; i < argc; ++i) {
+        format_given = format_given || std::strncmp(argv[i], "--benchmark_format", 18) == 0;
+    }
+    static char json_format[] = "--benchmark_format=json";
+    if (!format_given) {
+        args.push_back(json_format);
+    }
+    int count = static_cast<int>(args.size());
+    args.push_back(nullptr);
+
+    // Device and udev messages would end up in the JSON on stdout
+    logging::Logger::set_level(logging::Level::WARN);
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data())) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -11,6 +11,9 @@
 #include <algorithm>
 #include <iostream>
 
+#include "connection_tuner.hpp"
+#include "link_router.hpp"
+#include "metrics_server.hpp"
 #include "version.hpp"
 
 namespace args {
@@ -62,9 +65,49 @@ void ArgumentParser::setup_descriptions() {
         {"--list-devices", "List available BLE devices and exit"},
         {"--disable-auto-connect", "Disable automatic connection to single NinjaUSB device"},
         {"--scan-timeout <ms>", "BLE scan timeout in milliseconds (default: 10000)"},
-        {"--poll-interval <ms>", "Input polling interval in milliseconds (default: 1)"},
-        {"--target <address>", "Target BLE device address to connect to"},
-        {"--log-level <level>", "Set log level (debug, info, warn, error) (default: info)"}};
+        {"--scan-grace <ms>",
+         "Wait for a second NinjaUSB device before auto-connecting (default: 500, 0: none)"},
+        {"--poll-interval <ms>",
+         "Use legacy timer polling at this interval in milliseconds (default: event-driven)"},
+        {"--target <address>[,...]",
+         "Target BLE device address to connect to; several mirror input to each device"},
+        {"--log-level <level>", "Set log level (debug, info, warn, error) (default: info)"},
+        {"--log-async",
+         "Write log output from a background thread so slow terminals never block input"},
+        {"--input-thread", "Read keyboards on a dedicated input thread"},
+        {"--input-rt-priority <prio>",
+         "Run the input thread with SCHED_FIFO priority 1-99 (implies --input-thread)"},
+        {"--input-cpu <n>", "Pin the input thread to CPU core n (implies --input-thread)"},
+        {"--conn-profile <profile>",
+         "BLE connection profile: low-latency, balanced, power-save (default: low-latency)"},
+        {"--idle-timeout <s>",
+         "Request power-save connection parameters after s seconds without key input (0: never)"},
+        {"--coalesce-frames",
+         "Send one HID report per input frame (SYN_REPORT) instead of per key event"},
+        {"--batch-reads",
+         "Read input events in batches with read(2) instead of one at a time via libevdev"},
+        {"--gatt-cache <path>",
+         "File remembering the last BLE device (default: ~/.cache/ninja_util/gatt_cache)"},
+        {"--no-gatt-cache",
+         "Always scan and discover instead of reconnecting to the cached device"},
+        {"--no-reconnect", "Exit when an established BLE link is lost instead of reconnecting"},
+        {"--trace <path>",
+         "Record input events, HID reports and BLE writes to a binary trace file"},
+        {"--trace-size <MiB>", "Preallocated trace file size in MiB (default: 16)"},
+        {"--latency-stats",
+         "Collect report latency histograms; printed on SIGUSR1 and at exit"},
+        {"--metrics <port|path>",
+         "Serve counters on http://127.0.0.1:<port>/metrics or an absolute Unix socket path"},
+        {"--keymap <path>", "Remap keys per keyboard from a keymap file; reloaded on SIGHUP"},
+        {"--hotkeys <action=chord>[,...]",
+         "Bind hotkeys: exit, next-target, grab, local, metrics, link-1..link-9, all-links "
+         "(e.g. grab=ctrl+alt+g)"},
+        {"--share-input",
+         "Keep typing on the local machine too, through a uinput passthrough keyboard"},
+        {"--type <text>", "Type the text on the host once connected (US layout)"},
+        {"--type-file <path>", "Type the contents of a file once connected ('-': standard input)"},
+        {"--daemon <path>",
+         "Run without prompting; select targets and inject reports via the Unix socket at path"}};
 }
 
 /**
@@ -102,6 +145,14 @@ std::optional<Options> ArgumentParser::parse() {
     opts.verbose = has_flag("-V") || has_flag("--verbose");
     opts.list_devices = has_flag("--list-devices");
     opts.disable_auto_connect = has_flag("--disable-auto-connect");
+    opts.input_thread = has_flag("--input-thread");
+    opts.coalesce_frames = has_flag("--coalesce-frames");
+    opts.batch_reads = has_flag("--batch-reads");
+    opts.no_gatt_cache = has_flag("--no-gatt-cache");
+    opts.no_reconnect = has_flag("--no-reconnect");
+    opts.log_async = has_flag("--log-async");
+    opts.latency_stats = has_flag("--latency-stats");
+    opts.share_input = has_flag("--share-input");
 
     // Parse values with validation
     if (auto timeout = get_int_value("--scan-timeout")) {
@@ -112,16 +163,63 @@ std::optional<Options> ArgumentParser::parse() {
         opts.scan_timeout = *timeout;
     }
 
+    if (auto grace = get_int_value("--scan-grace")) {
+        if (*grace < 0 || *grace > 10000) {
+            std::cerr << "Error: scan-grace must be between 0 and 10000 ms\n";
+            return std::nullopt;
+        }
+        opts.scan_grace = *grace;
+    }
+
     if (auto interval = get_int_value("--poll-interval")) {
         if (*interval < 1 || *interval > 1000) {
             std::cerr << "Error: poll-interval must be between 1 and 1000 ms\n";
             return std::nullopt;
         }
         opts.poll_interval = *interval;
+        opts.legacy_polling = true;
+    }
+
+    if (auto priority = get_int_value("--input-rt-priority")) {
+        if (*priority < 1 || *priority > 99) {
+            std::cerr << "Error: input-rt-priority must be between 1 and 99\n";
+            return std::nullopt;
+        }
+        opts.input_rt_priority = *priority;
+        opts.input_thread = true;
+    }
+
+    if (auto cpu = get_int_value("--input-cpu")) {
+        if (*cpu < 0 || *cpu > 1023) {
+            std::cerr << "Error: input-cpu must be between 0 and 1023\n";
+            return std::nullopt;
+        }
+        opts.input_cpu = *cpu;
+        opts.input_thread = true;
+    }
+
+    if (opts.input_thread && opts.legacy_polling) {
+        std::cerr << "Error: --poll-interval cannot be combined with the input thread\n";
+        return std::nullopt;
     }
 
     if (auto target = get_value("--target")) {
-        opts.target_device = *target;
+        // A comma-separated list mirrors input to several devices
+        std::size_t begin = 0;
+        while (begin <= target->size()) {
+            const std::size_t end = std::min(target->find(',', begin), target->size());
+            if (end == begin) {
+                std::cerr << "Error: empty device in --target list\n";
+                return std::nullopt;
+            }
+            opts.targets.push_back(target->substr(begin, end - begin));
+            begin = end + 1;
+        }
+        if (opts.targets.size() > ble::MAX_LINKS) {
+            std::cerr << "Error: at most " << ble::MAX_LINKS << " --target devices are supported\n";
+            return std::nullopt;
+        }
+        opts.target_device = opts.targets.front();
     }
 
     if (auto log_level = get_value("--log-level")) {
@@ -134,6 +232,105 @@ std::optional<Options> ArgumentParser::parse() {
         opts.log_level = *log_level;
     }
 
+    if (auto profile = get_value("--conn-profile")) {
+        if (!ble::parse_connection_profile(*profile)) {
+            std::cerr << "Error: invalid connection profile '" << *profile << "'\n";
+            std::cerr << "Valid profiles: low-latency, balanced, power-save\n";
+            return std::nullopt;
+        }
+        opts.conn_profile = *profile;
+    }
+
+    if (auto idle = get_int_value("--idle-timeout")) {
+        if (*idle < 0 || *idle > 86400) {
+            std::cerr << "Error: idle-timeout must be between 0 and 86400 seconds\n";
+            return std::nullopt;
+        }
+        opts.idle_timeout = *idle;
+    }
+
+    if (auto cache = get_value("--gatt-cache")) {
+        if (cache->empty()) {
+            std::cerr << "Error: gatt-cache path must not be empty\n";
+            return std::nullopt;
+        }
+        opts.gatt_cache = *cache;
+    }
+
+    if (auto trace = get_value("--trace")) {
+        if (trace->empty()) {
+            std::cerr << "Error: trace path must not be empty\n";
+            return std::nullopt;
+        }
+        opts.trace = *trace;
+    }
+
+    if (auto size = get_int_value("--trace-size")) {
+        if (*size < 1 || *size > 4096) {
+            std::cerr << "Error: trace-size must be between 1 and 4096 MiB\n";
+            return std::nullopt;
+        }
+        opts.trace_size = *size;
+    }
+
+    if (auto endpoint = get_value("--metrics")) {
+        if (!metrics::parse_endpoint(*endpoint)) {
+            std::cerr << "Error: metrics must be a port (1-65535, bound to 127.0.0.1) or an "
+                         "absolute Unix socket path\n";
+            return std::nullopt;
+        }
+        opts.metrics = *endpoint;
+    }
+
+    if (auto keymap = get_value("--keymap")) {
+        if (keymap->empty()) {
+            std::cerr << "Error: keymap path must not be empty\n";
+            return std::nullopt;
+        }
+        opts.keymap = *keymap;
+    }
+
+    if (auto hotkeys = get_value("--hotkeys")) {
+        if (hotkeys->empty()) {
+            std::cerr << "Error: hotkeys must be a list of ACTION=CHORD entries\n";
+            return std::nullopt;
+        }
+        opts.hotkeys = *hotkeys;
+    }
+
+    if (auto text = get_value("--type")) {
+        if (text->empty()) {
+            std::cerr << "Error: text to type must not be empty\n";
+            return std::nullopt;
+        }
+        opts.type_text = *text;
+    }
+
+    if (auto file = get_value("--type-file")) {
+        if (file->empty()) {
+            std::cerr << "Error: file to type must not be empty\n";
+            return std::nullopt;
+        }
+        opts.type_file = *file;
+    }
+
+    if (!opts.type_text.empty() && !opts.type_file.empty()) {
+        std::cerr << "Error: --type and --type-file cannot be combined\n";
+        return std::nullopt;
+    }
+
+    if (auto socket = get_value("--daemon")) {
+        if (socket->empty() || socket->front() != '/') {
+            std::cerr << "Error: daemon control socket must be an absolute path\n";
+            return std::nullopt;
+        }
+        if (opts.list_devices) {
+            std::cerr << "Error: --daemon and --list-devices cannot be combined\n";
+            return std::nullopt;
+        }
+        opts.daemon = *socket;
+    }
+
     // Check for unknown arguments
     for (size_t i = 0; i < args_.size(); ++i) {
         const auto& arg = args_[i];
@@ -144,13 +341,20 @@ std::optional<Options> ArgumentParser::parse() {
 
         // Skip known flags and their values
         if (arg == "-h" || arg == "--help" || arg == "-v" || arg == "--version" || arg == "-V" ||
-            arg == "--verbose" || arg == "--list-devices" || arg == "--disable-auto-connect") {
+            arg == "--verbose" || arg == "--list-devices" || arg == "--disable-auto-connect" ||
+            arg == "--input-thread" || arg == "--coalesce-frames" || arg == "--no-gatt-cache" ||
+            arg == "--log-async" || arg == "--latency-stats" || arg == "--batch-reads" ||
+            arg == "--no-reconnect" || arg == "--share-input") {
             continue;
         }
 
         // Skip known options with values
-        if (arg == "--scan-timeout" || arg == "--poll-interval" || arg == "--target" ||
-            arg == "--log-level") {
+        if (arg == "--scan-timeout" || arg == "--scan-grace" || arg == "--poll-interval" ||
+            arg == "--target" || arg == "--log-level" || arg == "--input-rt-priority" ||
+            arg == "--input-cpu" || arg == "--conn-profile" || arg == "--gatt-cache" ||
+            arg == "--idle-timeout" || arg == "--trace" || arg == "--trace-size" ||
+            arg == "--metrics" || arg == "--keymap" || arg == "--hotkeys" || arg == "--type" ||
+            arg == "--type-file" || arg == "--daemon") {
             i++;  // Skip the value too
             continue;
         }
@@ -159,8 +363,15 @@ std::optional<Options> ArgumentParser::parse() {
         bool is_known_option = false;
         if (arg.find('=') != std::string::npos) {
             std::string option_part = arg.substr(0, arg.find('='));
-            if (option_part == "--scan-timeout" || option_part == "--poll-interval" ||
-                option_part == "--target" || option_part == "--log-level") {
+            if (option_part == "--scan-timeout" || option_part == "--scan-grace" ||
+                option_part == "--poll-interval" || option_part == "--target" ||
+                option_part == "--log-level" || option_part == "--input-rt-priority" ||
+                option_part == "--input-cpu" || option_part == "--conn-profile" ||
+                option_part == "--idle-timeout" || option_part == "--gatt-cache" ||
+                option_part == "--trace" || option_part == "--trace-size" ||
+                option_part == "--metrics" || option_part == "--keymap" ||
+                option_part == "--hotkeys" || option_part == "--type" ||
+                option_part == "--type-file" || option_part == "--daemon") {
                 is_known_option = true;
             }
         }
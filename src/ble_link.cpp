@@ -0,0 +1,505 @@
+/**
+ * @file ble_link.cpp
+ * @brief Implementation of one BLE connection and its report path
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include "ble_link.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <QBluetoothUuid>
+#include <QByteArray>
+#include <QLowEnergyConnectionParameters>
+#include <QLowEnergyController>
+#include <QLowEnergyDescriptor>
+#include <QLowEnergyService>
+#include <QString>
+
+#include "logger.hpp"
+#include "metrics.hpp"
+#include "report_map.hpp"
+#include "trace_recorder.hpp"
+
+namespace ble {
+
+namespace {
+
+using TransmitClock = pipeline::TransmitScheduler::Clock;
+
+/**
+ * @brief Factory function to create HID report writer for BLE characteristics
+ * @param service Pointer to the BLE GATT service
+ * @param keyboard The writable characteristic for boot keyboard reports
+ * @param nkro NKRO report characteristic (invalid if the peer has none)
+ * @param consumer Consumer-control characteristic (invalid if the peer has none)
+ * @return Lambda function that writes HID reports to the BLE characteristics
+ *
+ * The characteristic and wire form come from encode_report_write(); consumer
+ * reports without a consumer characteristic are dropped. The lambda
+ * validates the service and characteristic before each write and uses
+ * WriteWithoutResponse for minimal latency.
+ */
+auto make_report_writer(QLowEnergyService* service, QLowEnergyCharacteristic keyboard,
+                        QLowEnergyCharacteristic nkro, QLowEnergyCharacteristic consumer) {
+    return [service, keyboard, nkro, consumer](const pipeline::Report& report) {
+        const auto write = encode_report_write(report, nkro.isValid(), consumer.isValid());
+        if (!write) {
+            return;
+        }
+        const QLowEnergyCharacteristic& ch =
+            write->characteristic == hid::ReportId::Consumer ? consumer
+            : write->characteristic == hid::ReportId::Nkro   ? nkro
+                                                             : keyboard;
+
+        // Validate service and characteristic before writing
+        if (!service || !ch.isValid()) {
+            LOG_INFO("Invalid service or characteristic, skipping HID report");
+            return;
+        }
+
+        const QByteArray data(reinterpret_cast<const char*>(write->data()),
+                              static_cast<int>(write->size));
+        service->writeCharacteristic(ch, data, QLowEnergyService::WriteWithoutResponse);
+    };
+}
+
+/**
+ * @brief Get the report ID from a characteristic's Report Reference descriptor
+ * @param ch Discovered characteristic
+ * @return Report ID, or nullopt without a (readable) descriptor
+ */
+std::optional<std::uint8_t> report_reference_id(const QLowEnergyCharacteristic& ch) {
+    const QLowEnergyDescriptor descriptor =
+        ch.descriptor(QBluetoothUuid(QBluetoothUuid::DescriptorType::ReportReference));
+    if (!descriptor.isValid() || descriptor.value().isEmpty()) {
+        return std::nullopt;
+    }
+    return static_cast<std::uint8_t>(descriptor.value().at(0));
+}
+
+/**
+ * @brief Describe a controller error
+ * @param error Error reported by QLowEnergyController
+ * @return Human-readable description
+ */
+std::string describe_error(QLowEnergyController::Error error) {
+    switch (error) {
+        case QLowEnergyController::UnknownError:
+            return "Unknown error";
+        case QLowEnergyController::UnknownRemoteDeviceError:
+            return "Unknown remote device error";
+        case QLowEnergyController::NetworkError:
+            return "Network error";
+        case QLowEnergyController::InvalidBluetoothAdapterError:
+            return "Invalid Bluetooth adapter";
+        case QLowEnergyController::ConnectionError:
+            return "Connection error";
+        case QLowEnergyController::AdvertisingError:
+            return "Advertising error";
+        case QLowEnergyController::RemoteHostClosedError:
+            return "Remote host closed connection";
+        case QLowEnergyController::AuthorizationError:
+            return "Authorization error";
+        default:
+            return "Error code: " + std::to_string(static_cast<int>(error));
+    }
+}
+
+/**
+ * @brief Describe a controller state
+ * @param state State reported by QLowEnergyController
+ * @return Human-readable name
+ */
+std::string describe_state(QLowEnergyController::ControllerState state) {
+    switch (state) {
+        case QLowEnergyController::UnconnectedState:
+            return "Unconnected";
+        case QLowEnergyController::ConnectingState:
+            return "Connecting";
+        case QLowEnergyController::ConnectedState:
+            return "Connected";
+        case QLowEnergyController::DiscoveringState:
+            return "Discovering";
+        case QLowEnergyController::DiscoveredState:
+            return "Discovered";
+        case QLowEnergyController::ClosingState:
+            return "Closing";
+        case QLowEnergyController::AdvertisingState:
+            return "Advertising";
+        default:
+            return "Unknown state: " + std::to_string(static_cast<int>(state));
+    }
+}
+
+}  // namespace
+
+BleLink::BleLink(const QBluetoothDeviceInfo& device, Config config, Callbacks callbacks)
+    : device_(device), config_(std::move(config)), callbacks_(std::move(callbacks)),
+      tuner_(config_.profile) {
+    connect_timer_.setSingleShot(true);
+    QObject::connect(&connect_timer_, &QTimer::timeout,
+                     [this]() { fail(LinkFailure::Kind::Timeout, "timeout"); });
+
+    tune_timer_.setSingleShot(true);
+    tune_timer_.setInterval(ConnectionTuner::UPDATE_TIMEOUT_MS);
+    QObject::connect(&tune_timer_, &QTimer::timeout, [this]() {
+        const std::string requested = to_string(tuner_.active_profile());
+        if (auto fallback = tuner_.on_timeout()) {
+            LOG_WARN(config_.label + requested + " connection parameters not accepted, falling " +
+                     "back to " + to_string(tuner_.active_profile()) + " profile");
+            request_connection_parameters(*fallback);
+        } else {
+            LOG_WARN(config_.label + requested +
+                     " connection parameters not accepted, keeping the peer's parameters");
+        }
+    });
+
+    // Reports are paced to the connection interval; the timer fires when the next
+    // waiting report may be written.
+    transmit_timer_.setSingleShot(true);
+    transmit_timer_.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&transmit_timer_, &QTimer::timeout, [this]() {
+        if (scheduler_) {
+            arm_transmit_timer(scheduler_->service(TransmitClock::now()));
+        }
+    });
+}
+
+BleLink::~BleLink() {
+    detach();
+}
+
+/**
+ * @brief Connect to the peripheral and find its report characteristic
+ *
+ * On the cached path only the cached service is inspected and the setup is
+ * timed until the link is ready; otherwise only the connect itself is timed.
+ */
+void BleLink::connect() {
+    controller_ = QLowEnergyController::createCentral(device_);
+    LOG_INFO(config_.label + "Connecting to device: " + device_.name().toStdString());
+
+    QObject::connect(controller_, &QLowEnergyController::connected, [this]() {
+        LOG_INFO(config_.label + "Connected. Discovering services...");
+        if (!config_.cached) {
+            connect_timer_.stop();  // The cached path stays timed until it is ready
+        }
+        request_connection_parameters(tuner_.start());
+        controller_->discoverServices();
+    });
+
+    QObject::connect(controller_, &QLowEnergyController::disconnected, [this]() {
+        if (config_.metrics) {
+            config_.metrics->ble_disconnects.add();
+        }
+        fail(LinkFailure::Kind::Disconnected, "disconnected");
+    });
+
+    QObject::connect(
+        controller_,
+        QOverload<QLowEnergyController::Error>::of(&QLowEnergyController::errorOccurred),
+        [this](QLowEnergyController::Error error) {
+            if (error != QLowEnergyController::NoError) {
+                fail(LinkFailure::Kind::Error, describe_error(error));
+            }
+        });
+
+    QObject::connect(controller_, &QLowEnergyController::stateChanged,
+                     [this](QLowEnergyController::ControllerState state) {
+                         if (config_.trace) {
+                             config_.trace->record_connection_state(static_cast<int>(state));
+                         }
+                         if (config_.verbose) {
+                             LOG_DEBUG(config_.label +
+                                       "BLE Controller state: " + describe_state(state));
+                         }
+                     });
+
+    // Pace report writes to the interval the peripheral actually accepted
+    QObject::connect(controller_, &QLowEnergyController::connectionUpdated,
+                     [this](const QLowEnergyConnectionParameters& params) {
+                         on_connection_updated(params.maximumInterval(), params.latency(),
+                                               params.supervisionTimeout());
+                     });
+
+    QObject::connect(controller_, &QLowEnergyController::serviceDiscovered,
+                     [this](const QBluetoothUuid& uuid) {
+                         if (config_.verbose) {
+                             LOG_DEBUG(config_.label +
+                                       "Service discovered: " + uuid.toString().toStdString());
+                         }
+                     });
+
+    QObject::connect(controller_, &QLowEnergyController::discoveryFinished, [this]() {
+        if (config_.verbose) {
+            LOG_DEBUG(config_.label + "Service discovery finished");
+        }
+        if (config_.cached) {
+            QLowEnergyService* cached = controller_->createServiceObject(
+                QBluetoothUuid(QString::fromStdString(config_.cached->service_uuid)));
+            if (!cached) {
+                fail(LinkFailure::Kind::NoCharacteristic, "cached service not found");
+                return;
+            }
+            watch_service(cached);
+            return;
+        }
+        // Inspect every service; the first writable characteristic wins
+        for (const QBluetoothUuid& uuid : controller_->services()) {
+            if (QLowEnergyService* candidate = controller_->createServiceObject(uuid)) {
+                watch_service(candidate);
+            }
+        }
+        if (pending_service_details_ == 0) {
+            fail(LinkFailure::Kind::NoCharacteristic, "no writable characteristic");
+        }
+    });
+
+    connect_timer_.start(config_.cached ? FAST_RECONNECT_TIMEOUT_MS : CONNECT_TIMEOUT_MS);
+    controller_->connectToDevice();
+}
+
+void BleLink::watch_service(QLowEnergyService* service) {
+    services_.push_back(service);
+    ++pending_service_details_;
+    QObject::connect(
+        service, &QLowEnergyService::stateChanged,
+        [this, service](QLowEnergyService::ServiceState state) {
+            if (state != QLowEnergyService::RemoteServiceDiscovered ||
+                characteristic_.isValid()) {
+                return;  // Still discovering, or already chosen
+            }
+            --pending_service_details_;
+            const auto characteristics = service->characteristics();
+            std::vector<CharacteristicInfo> infos;
+            for (const auto& ch : characteristics) {
+                const auto write_flags =
+                    QLowEnergyCharacteristic::Write | QLowEnergyCharacteristic::WriteNoResponse;
+                const bool writable = (ch.properties() & write_flags) != 0;
+                infos.push_back({ch.uuid().toString().toStdString(), writable,
+                                 report_reference_id(ch)});
+            }
+            std::optional<std::string> cached_uuid;
+            if (config_.cached) {
+                // Same spelling as the discovered UUIDs
+                cached_uuid = QBluetoothUuid(QString::fromStdString(
+                                                 config_.cached->characteristic_uuid))
+                                  .toString()
+                                  .toStdString();
+            }
+            const ReportMap map = map_report_characteristics(infos, cached_uuid);
+            if (map.keyboard) {
+                const auto at = [&](std::optional<std::size_t> index) {
+                    return index ? characteristics.at(static_cast<qsizetype>(*index))
+                                 : QLowEnergyCharacteristic();
+                };
+                use_characteristic(service, at(map.keyboard), at(map.nkro), at(map.consumer));
+                return;
+            }
+            if (pending_service_details_ > 0) {
+                return;
+            }
+            fail(LinkFailure::Kind::NoCharacteristic, config_.cached
+                                                          ? "cached characteristic not found"
+                                                          : "no writable characteristic");
+        });
+    service->discoverDetails();
+}
+
+void BleLink::use_characteristic(QLowEnergyService* service, const QLowEnergyCharacteristic& ch,
+                                 const QLowEnergyCharacteristic& nkro,
+                                 const QLowEnergyCharacteristic& consumer) {
+    connect_timer_.stop();
+    service_ = service;
+    characteristic_ = ch;
+    nkro_ = nkro.isValid();
+    consumer_ = consumer.isValid();
+    last_boot_.reset();
+    writer_ = make_report_writer(service_, characteristic_, nkro, consumer);
+    LOG_INFO(config_.label + "Report characteristics: " +
+             (nkro_ ? "NKRO keyboard" : "boot keyboard") +
+             (consumer_ ? ", consumer control" : ""));
+    handles_ = GattCacheEntry{device_.address().toString().toStdString(),
+                              device_.name().toStdString(),
+                              service_->serviceUuid().toString().toStdString(),
+                              characteristic_.uuid().toString().toStdString()};
+    if (!scheduler_) {
+        // Created once; a reconnect only points the writer at the new characteristic
+        scheduler_ = std::make_unique<pipeline::TransmitScheduler>(
+            [this](const pipeline::Report& report) {
+                if (config_.trace) {
+                    config_.trace->record_report(trace::RecordType::BleWrite, report);
+                }
+                writer_(report);
+            });
+        scheduler_->set_latency_tracker(config_.latency);
+        scheduler_->set_metrics(config_.metrics);
+    }
+    scheduler_->set_connection_interval(interval_);
+    ready_ = true;
+    if (callbacks_.ready) {
+        callbacks_.ready(*this);
+    }
+}
+
+/**
+ * @brief Start over on the same device after the link was lost
+ * @param use_handles Restrict the lookup to the last ready connection's handles
+ *
+ * The controller of the lost connection is released first; the scheduler and
+ * its statistics are kept, but reports queued for the old connection are
+ * dropped because they describe a state the host no longer needs.
+ */
+void BleLink::reconnect(bool use_handles) {
+    detach();
+    failed_ = false;
+    ready_ = false;
+    service_ = nullptr;
+    characteristic_ = QLowEnergyCharacteristic();
+    nkro_ = false;
+    consumer_ = false;
+    writer_ = nullptr;
+    pending_service_details_ = 0;
+    config_.cached = use_handles ? handles_ : std::nullopt;
+    if (scheduler_) {
+        scheduler_->clear();
+    }
+    connect();
+}
+
+void BleLink::submit(const pipeline::Report& report, const pipeline::ReportTiming& timing) {
+    if (!ready()) {
+        return;
+    }
+    if (report.is_consumer()) {
+        if (!consumer_) {
+            return;  // The peer cannot take media keys
+        }
+    } else if (!nkro_) {
+        // A boot-only peer does not see keys beyond the six slots
+        if (last_boot_ == report.bytes) {
+            return;
+        }
+        last_boot_ = report.bytes;
+    }
+    arm_transmit_timer(scheduler_->submit(report, TransmitClock::now(), timing));
+}
+
+void BleLink::flush() {
+    if (ready()) {
+        scheduler_->flush(TransmitClock::now());
+    }
+}
+
+void BleLink::set_power_save(bool power_save) {
+    if (power_save == power_save_ || config_.profile == ConnectionProfile::PowerSave) {
+        return;
+    }
+    power_save_ = power_save;
+    const ConnectionParameters requested =
+        tuner_.retarget(power_save ? ConnectionProfile::PowerSave : config_.profile);
+    if (ready()) {
+        request_connection_parameters(requested);
+    }
+}
+
+void BleLink::arm_transmit_timer(std::optional<TransmitClock::duration> wait) {
+    if (wait) {
+        const auto ms = std::chrono::ceil<std::chrono::milliseconds>(*wait).count();
+        transmit_timer_.start(static_cast<int>(ms));
+    }
+}
+
+/**
+ * @brief After connecting, ask the peer for the selected profile's interval range
+ * @param requested Parameters to request
+ *
+ * Falls back to the balanced profile once if the request is not accepted
+ * within ConnectionTuner::UPDATE_TIMEOUT_MS.
+ */
+void BleLink::request_connection_parameters(const ConnectionParameters& requested) {
+    if (!controller_) {
+        return;
+    }
+    QLowEnergyConnectionParameters params;
+    params.setIntervalRange(requested.min_interval_ms, requested.max_interval_ms);
+    params.setLatency(requested.latency);
+    params.setSupervisionTimeout(requested.supervision_timeout_ms);
+
+    LOG_INFO(config_.label + "Requesting " + to_string(tuner_.active_profile()) +
+             " connection parameters: interval " + std::to_string(requested.min_interval_ms) +
+             "-" + std::to_string(requested.max_interval_ms) + " ms, latency " +
+             std::to_string(requested.latency) + ", timeout " +
+             std::to_string(requested.supervision_timeout_ms) + " ms");
+    controller_->requestConnectionUpdate(params);
+    tune_timer_.start();
+}
+
+void BleLink::on_connection_updated(double interval_ms, int latency,
+                                    int supervision_timeout_ms) {
+    interval_ = std::chrono::microseconds(static_cast<long long>(interval_ms * 1000.0));
+    if (config_.trace) {
+        config_.trace->record_connection_interval(interval_);
+    }
+    if (scheduler_) {
+        scheduler_->set_connection_interval(interval_);
+    }
+    LOG_INFO(config_.label + "Connection parameters updated: interval " +
+             std::to_string(interval_ms) + " ms, latency " + std::to_string(latency) +
+             ", timeout " + std::to_string(supervision_timeout_ms) + " ms");
+
+    if (!tuner_.pending()) {
+        return;  // Peer-initiated change
+    }
+    tune_timer_.stop();
+    const std::string requested = to_string(tuner_.active_profile());
+    if (auto fallback = tuner_.on_updated(interval_ms)) {
+        LOG_WARN(config_.label + "Peer chose an interval outside the requested " + requested +
+                 " range, falling back to " + to_string(tuner_.active_profile()) + " profile");
+        request_connection_parameters(*fallback);
+    } else if (tuner_.state() == ConnectionTuner::State::Accepted) {
+        LOG_INFO(config_.label + "Peer accepted " + requested + " connection profile");
+    } else {
+        LOG_WARN(config_.label + "Peer refused the " + requested +
+                 " profile, keeping its parameters");
+    }
+}
+
+void BleLink::fail(LinkFailure::Kind kind, const std::string& reason) {
+    if (failed_) {
+        return;  // e.g. disconnected after errorOccurred
+    }
+    failed_ = true;
+    connect_timer_.stop();
+    tune_timer_.stop();
+    transmit_timer_.stop();
+    if (callbacks_.failed) {
+        callbacks_.failed(*this, LinkFailure{kind, reason});
+    }
+}
+
+void BleLink::detach() noexcept {
+    connect_timer_.stop();
+    tune_timer_.stop();
+    transmit_timer_.stop();
+    for (QLowEnergyService* service : services_) {
+        QObject::disconnect(service, nullptr, nullptr, nullptr);
+    }
+    services_.clear();
+    if (controller_) {
+        QObject::disconnect(controller_, nullptr, nullptr, nullptr);
+        controller_->disconnectFromDevice();
+        controller_->deleteLater();
+        controller_ = nullptr;
+    }
+}
+
+}  // namespace ble
@@ -0,0 +1,163 @@
+/**
+ * @file chord_matcher.cpp
+ * @brief `--hotkeys` parsing and chord descriptions
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include "chord_matcher.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <optional>
+#include <utility>
+
+#include <libevdev/libevdev.h>
+
+#include "keymap.hpp"
+
+namespace hotkey {
+
+namespace {
+
+std::string lower(std::string_view text) {
+    std::string result(text);
+    std::transform(result.begin(), result.end(), result.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return result;
+}
+
+std::optional<Action> parse_action(std::string_view name) {
+    for (std::size_t i = 1; i <= ACTION_COUNT; ++i) {
+        const auto action = static_cast<Action>(i);
+        if (name == action_name(action)) {
+            return action;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<std::uint8_t> parse_modifier(std::string_view name) {
+    if (name == "ctrl" || name == "control") {
+        return MOD_CTRL;
+    }
+    if (name == "shift") {
+        return MOD_SHIFT;
+    }
+    if (name == "alt") {
+        return MOD_ALT;
+    }
+    if (name == "meta" || name == "super" || name == "gui") {
+        return MOD_GUI;
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Parse `ctrl+alt+h`
+ * @return false (with error set) on an unknown or unmappable key
+ */
+bool parse_chord(std::string_view text, Chord& chord, std::string& error) {
+    std::size_t begin = 0;
+    while (begin <= text.size()) {
+        const std::size_t end = std::min(text.find('+', begin), text.size());
+        const std::string token = lower(text.substr(begin, end - begin));
+        begin = end + 1;
+        if (token.empty()) {
+            error = "empty key in '" + std::string(text) + "'";
+            return false;
+        }
+        if (const auto modifier = parse_modifier(token)) {
+            chord.modifiers |= *modifier;
+            continue;
+        }
+        const auto code = keymap::parse_key(token);
+        const auto usage = code ? hid::get_keyboard_usage(*code) : std::nullopt;
+        if (!usage) {
+            error = "unknown key '" + token + "' in '" + std::string(text) + "'";
+            return false;
+        }
+        chord.add_key(*usage);
+    }
+    if (!chord.has_keys()) {
+        error = "'" + std::string(text) + "' has no key besides modifiers";
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+bool parse_hotkeys(std::string_view spec, ChordMatcher& matcher, std::string& error) {
+    std::size_t begin = 0;
+    while (begin <= spec.size()) {
+        const std::size_t end = std::min(spec.find(',', begin), spec.size());
+        const std::string_view entry = spec.substr(begin, end - begin);
+        begin = end + 1;
+
+        const std::size_t equals = entry.find('=');
+        if (equals == std::string_view::npos) {
+            error = "expected ACTION=CHORD, got '" + std::string(entry) + "'";
+            return false;
+        }
+        const std::string name = lower(entry.substr(0, equals));
+        const auto action = parse_action(name);
+        if (!action) {
+            error = "unknown action '" + name +
+                    "' (exit, next-target, grab, metrics, local, link-1 ... link-9, all-links)";
+            return false;
+        }
+        const std::string_view value = entry.substr(equals + 1);
+        if (lower(value) == "none") {
+            if (*action == Action::Exit) {
+                error = "the exit hotkey cannot be removed";
+                return false;
+            }
+            matcher.unbind(*action);
+            continue;
+        }
+        Chord chord;
+        chord.action = *action;
+        if (!parse_chord(value, chord, error)) {
+            return false;
+        }
+        matcher.bind(chord);
+    }
+    return true;
+}
+
+std::string describe(const Chord& chord) {
+    std::string text;
+    for (const auto& [bit, name] : {std::pair<std::uint8_t, const char*>{MOD_CTRL, "Ctrl"},
+                                    {MOD_ALT, "Alt"},
+                                    {MOD_SHIFT, "Shift"},
+                                    {MOD_GUI, "Meta"}}) {
+        if (chord.modifiers & bit) {
+            text += std::string(name) + "+";
+        }
+    }
+    for (unsigned usage = 0; usage < 256; ++usage) {
+        if (!(chord.keys[usage >> 6] & (std::uint64_t{1} << (usage & 63U)))) {
+            continue;
+        }
+        // Name the first Linux key that maps to the usage (reverse of get_keyboard_usage)
+        std::string key = std::to_string(usage);
+        for (int code = 1; code <= KEY_MAX; ++code) {
+            if (hid::get_keyboard_usage(code) == usage) {
+                if (const char* name = libevdev_event_code_get_name(EV_KEY, code)) {
+                    key = name;
+                    if (key.rfind("KEY_", 0) == 0) {
+                        key.erase(0, 4);
+                    }
+                }
+                break;
+            }
+        }
+        text += key + "+";
+    }
+    text.pop_back();
+    return text;
+}
+
+}  // namespace hotkey
@@ -0,0 +1,73 @@
+/**
+ * @file connection_tuner.cpp
+ * @brief Implementation of the BLE connection-parameter tuning stage
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include "connection_tuner.hpp"
+
+namespace ble {
+
+namespace {
+
+//! @brief Tolerance for comparing intervals (controllers round to 1.25 ms steps)
+constexpr double INTERVAL_EPSILON_MS = 0.01;
+
+}  // namespace
+
+ConnectionParameters ConnectionTuner::start() noexcept { return retarget(profile_); }
+
+ConnectionParameters ConnectionTuner::retarget(ConnectionProfile profile) noexcept {
+    profile_ = profile;
+    active_ = profile;
+    state_ = State::Requested;
+    return parameters_for(profile);
+}
+
+/**
+ * @brief Handle a refused request
+ * @return Balanced parameters for a single fallback attempt, or nullopt when done
+ */
+std::optional<ConnectionParameters> ConnectionTuner::refused() noexcept {
+    if (state_ == State::Requested && active_ != ConnectionProfile::Balanced) {
+        active_ = ConnectionProfile::Balanced;
+        state_ = State::FallingBack;
+        return parameters_for(active_);
+    }
+    state_ = State::Refused;
+    return std::nullopt;
+}
+
+/**
+ * @brief Feed back a connection-parameter update reported by the controller
+ * @param interval_ms Interval now in use
+ * @return Fallback parameters to request, or nullopt if nothing else is needed
+ *
+ * An interval inside the requested range counts as accepted. Updates that
+ * arrive while no request is outstanding (peer-initiated changes) are
+ * only observed.
+ */
+std::optional<ConnectionParameters> ConnectionTuner::on_updated(double interval_ms) noexcept {
+    if (!pending()) {
+        return std::nullopt;
+    }
+
+    const ConnectionParameters requested = parameters_for(active_);
+    if (interval_ms >= requested.min_interval_ms - INTERVAL_EPSILON_MS &&
+        interval_ms <= requested.max_interval_ms + INTERVAL_EPSILON_MS) {
+        state_ = State::Accepted;
+        return std::nullopt;
+    }
+    return refused();
+}
+
+std::optional<ConnectionParameters> ConnectionTuner::on_timeout() noexcept {
+    if (!pending()) {
+        return std::nullopt;
+    }
+    return refused();
+}
+
+}  // namespace ble
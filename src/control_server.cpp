@@ -0,0 +1,189 @@
+/**
+ * @file control_server.cpp
+ * @brief Implementation of the daemon control socket
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include "control_server.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <utility>
+
+namespace control {
+
+namespace {
+
+constexpr int LISTEN_BACKLOG = 8;             //!< Pending connects before they are refused
+constexpr std::size_t MAX_CLIENTS = 16;       //!< Connected clients before new ones are refused
+constexpr std::size_t READ_CHUNK = 1024;      //!< Bytes read per recv()
+constexpr std::size_t MAX_INPUT = 64 * 1024;  //!< Bytes taken per service() call
+
+int open_unix_socket(const std::string& path) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    // Replace a socket left behind by a previous run, but never any other file
+    struct stat st{};
+    if (lstat(path.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            errno = EEXIST;
+            return -1;
+        }
+        unlink(path.c_str());
+    }
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    // Owner only from the start: on Linux bind() creates the file with the socket inode's
+    // mode (less the umask). chmod() afterwards would race, and changing the umask would
+    // affect files the other threads create meanwhile.
+    if (fchmod(fd, S_IRUSR | S_IWUSR) < 0 ||
+        bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(fd, LISTEN_BACKLOG) < 0) {
+        const int err = errno;
+        close(fd);
+        errno = err;
+        return -1;
+    }
+    return fd;
+}
+
+//! @brief Write a response in one go; the client is dropped if it does not fit
+bool send_all(int fd, const std::vector<std::uint8_t>& data) {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        const ssize_t n =
+            send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;  // Gone, or not reading its responses
+        }
+        sent += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+}  // namespace
+
+ControlServer::ControlServer(std::string path, Handler handle)
+    : path_(std::move(path)), handle_(std::move(handle)) {
+    listen_fd_ = open_unix_socket(path_);
+}
+
+ControlServer::~ControlServer() {
+    for (const Client& client : clients_) {
+        close(client.fd);
+    }
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+        unlink(path_.c_str());
+    }
+}
+
+ControlServer::Client* ControlServer::find(int fd) noexcept {
+    const auto it = std::find_if(clients_.begin(), clients_.end(),
+                                 [fd](const Client& client) { return client.fd == fd; });
+    return it == clients_.end() ? nullptr : &*it;
+}
+
+int ControlServer::accept_client() {
+    const int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+        return -1;  // Nothing pending (or the client gave up already)
+    }
+    if (clients_.size() >= MAX_CLIENTS) {
+        close(fd);
+        return -1;
+    }
+    clients_.push_back(Client{fd, {}});
+    return fd;
+}
+
+/**
+ * @brief Drain a readable client and answer its complete requests in order
+ *
+ * Partial requests stay buffered until the rest arrives. A length above
+ * MAX_PAYLOAD means the client does not speak the protocol; the stream
+ * cannot be resynchronized, so the client is dropped. At most MAX_INPUT
+ * bytes are taken per call, so a flooding client cannot stall the event
+ * loop; the notifier fires again for the rest.
+ */
+bool ControlServer::service(int fd) {
+    Client* client = find(fd);
+    if (client == nullptr) {
+        return false;
+    }
+
+    bool open = true;
+    std::uint8_t buffer[READ_CHUNK];
+    while (client->input.size() < MAX_INPUT) {
+        const ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (n <= 0) {
+            open = false;  // Closed or failed; still answer what arrived before
+            break;
+        }
+        client->input.insert(client->input.end(), buffer, buffer + n);
+    }
+
+    std::vector<std::uint8_t> output;
+    std::size_t used = 0;
+    Frame request;
+    for (;;) {
+        const auto size =
+            decode_frame(client->input.data() + used, client->input.size() - used, request);
+        if (!size) {
+            return false;
+        }
+        if (*size == 0) {
+            break;
+        }
+        used += *size;
+        const Frame response = handle_(request);
+        // Unknown commands are echoed as received (the enum is fixed to std::uint8_t)
+        append_frame(output, static_cast<Command>(request.command), response.status,
+                     response.payload);
+        ++requests_;
+    }
+    client->input.erase(client->input.begin(),
+                        client->input.begin() + static_cast<std::ptrdiff_t>(used));
+
+    if (!output.empty() && !send_all(fd, output)) {
+        return false;
+    }
+    return open;
+}
+
+void ControlServer::close_client(int fd) {
+    const auto it = std::find_if(clients_.begin(), clients_.end(),
+                                 [fd](const Client& client) { return client.fd == fd; });
+    if (it == clients_.end()) {
+        return;
+    }
+    close(it->fd);
+    clients_.erase(it);
+}
+
+}  // namespace control
@@ -8,19 +8,27 @@
 
 #include "device_manager.hpp"
 
-#include <algorithm>
 #include <cerrno>
+#include <chrono>
+#include <cstdint>
 #include <cstring>
+#include <ctime>
 #include <fcntl.h>
 #include <functional>
 #include <libudev.h>
+#include <optional>
 #include <string>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/timerfd.h>
+#include <thread>
 #include <unistd.h>
 #include <vector>
 
 #include <libevdev/libevdev.h>
 
 #include "logger.hpp"
+#include "metrics.hpp"
 
 namespace device {
 
@@ -42,6 +50,19 @@ constexpr const char* INPUT_SUBSYSTEM = "input";      //!< udev subsystem name f
 constexpr const char* UDEV_SOURCE = "udev";           //!< udev event source identifier
 constexpr const char* ACTION_ADD = "add";             //!< udev action for device addition
 constexpr const char* ACTION_REMOVE = "remove";       //!< udev action for device removal
+
+constexpr const char* PROP_INPUT = "ID_INPUT";              //!< Set once udev classified a node
+constexpr const char* PROP_KEYBOARD = "ID_INPUT_KEYBOARD";  //!< udev keyboard classification
+
+/**
+ * @brief Classify a udev input device without opening its node
+ * @param dev udev device
+ * @return udev's verdict on whether the node is a keyboard
+ */
+UdevKeyboardClass classify(udev_device* dev) {
+    return classify_udev_properties(udev_device_get_property_value(dev, PROP_INPUT),
+                                    udev_device_get_property_value(dev, PROP_KEYBOARD));
+}
 }  // namespace
 
 /**
@@ -85,6 +106,7 @@ void log_debug(const std::string& message) {
 /**
  * @brief Construct KeyboardDevice from device path with validation and initialization
  * @param device_path Path to the input device (e.g., "/dev/input/event0")
+ * @param quiet_open_errors Log a failed open() at debug level only
  *
  * The constructor performs several initialization steps:
  * 1. Input validation of the device path
@@ -100,7 +122,7 @@ void log_debug(const std::string& message) {
  * @note Device validation ensures only actual keyboards are accepted
  * @note Failed initialization leaves the object in a safe, invalid state
  */
-KeyboardDevice::KeyboardDevice(const std::string& device_path)
+KeyboardDevice::KeyboardDevice(const std::string& device_path, bool quiet_open_errors)
     : path_(device_path), fd_(INVALID_FD) {
     // Input validation
     if (device_path.empty()) {
@@ -110,10 +132,22 @@ KeyboardDevice::KeyboardDevice(const std::string& device_path)
 
     fd_ = open(device_path.c_str(), O_RDONLY | O_NONBLOCK);
     if (fd_ < 0) {
-        log_error("Failed to open device: " + device_path + " (" + std::strerror(errno) + ")");
+        open_error_ = errno;
+        const std::string message = "Failed to open device: " + device_path + " (" +
+                                    std::strerror(open_error_) + ")";
+        if (quiet_open_errors) {
+            log_debug(message);
+        } else {
+            log_error(message);
+        }
         return;
     }
 
+    struct stat st{};
+    if (fstat(fd_, &st) == 0) {
+        devnum_ = st.st_rdev;
+    }
+
     if (libevdev_new_from_fd(fd_, &evdev_) < 0) {
         close(fd_);
         fd_ = INVALID_FD;
@@ -125,6 +159,12 @@ KeyboardDevice::KeyboardDevice(const std::string& device_path)
         return;
     }
 
+    // Stamp events with CLOCK_MONOTONIC (the steady_clock time base) instead of wall-clock
+    // time, so event ages can be measured (--latency-stats) and survive clock adjustments
+    if (libevdev_set_clock_id(evdev_, CLOCK_MONOTONIC) < 0) {
+        log_debug("Failed to select monotonic event timestamps for: " + device_path);
+    }
+
     // Grab exclusive access to prevent keystrokes from reaching the host system
     if (libevdev_grab(evdev_, LIBEVDEV_GRAB) < 0) {
         log_error("Failed to grab exclusive access to device: " + device_path + " (" +
@@ -138,6 +178,9 @@ KeyboardDevice::KeyboardDevice(const std::string& device_path)
     const char* dev_name = libevdev_get_name(evdev_);
     name_ = dev_name ? dev_name : "Unknown Device";
 
+    // Allocated once so reading events never allocates
+    batch_.resize(READ_BATCH);
+
     log_debug("Added keyboard: " + path_ + " (" + name_ + ")");
 }
 
@@ -164,7 +207,12 @@ KeyboardDevice::~KeyboardDevice() {
  */
 KeyboardDevice::KeyboardDevice(KeyboardDevice&& other) noexcept
     : fd_(other.fd_), evdev_(other.evdev_), path_(std::move(other.path_)),
-      name_(std::move(other.name_)) {
+      name_(std::move(other.name_)), devnum_(other.devnum_), open_error_(other.open_error_),
+      batch_(std::move(other.batch_)), sync_(std::move(other.sync_)),
+      delivered_(other.delivered_), resync_stamp_(other.resync_stamp_),
+      pending_begin_(other.pending_begin_), pending_end_(other.pending_end_),
+      batch_reads_(other.batch_reads_), dropping_(other.dropping_),
+      resync_due_(other.resync_due_), keymaps_(other.keymaps_), remap_(other.remap_) {
     other.fd_ = INVALID_FD;
     other.evdev_ = nullptr;
 }
@@ -189,6 +237,19 @@ KeyboardDevice& KeyboardDevice::operator=(KeyboardDevice&& other) noexcept {
         evdev_ = other.evdev_;
         path_ = std::move(other.path_);
         name_ = std::move(other.name_);
+        devnum_ = other.devnum_;
+        open_error_ = other.open_error_;
+        batch_ = std::move(other.batch_);
+        sync_ = std::move(other.sync_);
+        delivered_ = other.delivered_;
+        resync_stamp_ = other.resync_stamp_;
+        pending_begin_ = other.pending_begin_;
+        pending_end_ = other.pending_end_;
+        batch_reads_ = other.batch_reads_;
+        dropping_ = other.dropping_;
+        resync_due_ = other.resync_due_;
+        keymaps_ = other.keymaps_;
+        remap_ = other.remap_;
 
         other.fd_ = INVALID_FD;
         other.evdev_ = nullptr;
@@ -242,6 +303,143 @@ bool KeyboardDevice::is_keyboard_device(libevdev* dev) noexcept {
            libevdev_has_event_code(dev, EV_KEY, KEY_A);
 }
 
+/**
+ * @brief Select batched read(2) or libevdev event reads
+ * @param enabled true for batched reads
+ *
+ * The resync buffer is sized for the worst case here, so a SYN_DROPPED
+ * recovery does not allocate either. Key state starts empty, like the
+ * consumer's: keys already held are reported by the first resync.
+ */
+void KeyboardDevice::set_batch_reads(bool enabled) {
+    batch_reads_ = enabled;
+    if (enabled && sync_.size() < MAX_RESYNC_EVENTS) {
+        sync_.resize(MAX_RESYNC_EVENTS);
+    }
+}
+
+bool KeyboardDevice::set_grabbed(bool grabbed) noexcept {
+    if (!is_valid()) {
+        return false;
+    }
+    if (libevdev_grab(evdev_, grabbed ? LIBEVDEV_GRAB : LIBEVDEV_UNGRAB) < 0) {
+        log_error(std::string(grabbed ? "Failed to grab " : "Failed to release ") + path_ + " (" +
+                  std::strerror(errno) + ")");
+        return false;
+    }
+    return true;
+}
+
+EventBatch KeyboardDevice::read_batch() {
+    if (!is_valid() || batch_.empty()) {
+        return {nullptr, 0, -ENODEV};
+    }
+    EventBatch batch = batch_reads_ ? read_batch_direct() : read_batch_libevdev();
+    if (keymaps_ && batch.count > 0) {
+        // Both paths hand out events from batch_ or sync_, which this device owns
+        batch.count = remap_events(const_cast<input_event*>(batch.events), batch.count);
+    }
+    return batch;
+}
+
+/**
+ * @brief Apply the keymap to a batch
+ * @param events Events to remap in place
+ * @param count Number of events
+ * @return Events kept, compacted to the front
+ *
+ * Picks up a newly published keymap first; keys held across the switch are
+ * still released as they were pressed.
+ */
+std::size_t KeyboardDevice::remap_events(input_event* events, std::size_t count) noexcept {
+    if (remap_.update(keymaps_->current(), name_, path_)) {
+        const keymap::DeviceKeymap* tables = remap_.keymap();
+        log_debug(tables ? "Keymap for " + path_ + ": " + std::to_string(tables->layers.size()) +
+                               " layer(s)"
+                         : "No keymap for " + path_);
+    }
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (remap_.remap(events[i])) {
+            events[kept++] = events[i];
+        }
+    }
+    return kept;
+}
+
+/**
+ * @brief Fill the batch buffer from libevdev
+ * @return Events read and libevdev's last status
+ *
+ * Unfiltered, so the default path behaves exactly like calling
+ * libevdev_next_event() in a loop.
+ */
+EventBatch KeyboardDevice::read_batch_libevdev() {
+    std::size_t count = 0;
+    int rc = 0;
+    while (count < batch_.size() &&
+           (rc = libevdev_next_event(evdev_, LIBEVDEV_READ_FLAG_NORMAL, &batch_[count])) == 0) {
+        ++count;
+    }
+    return {batch_.data(), count, rc};
+}
+
+/**
+ * @brief Read and filter a batch with one read(2)
+ * @return Key events and frame boundaries, or a synthetic resync frame
+ *
+ * libevdev cannot resync for this path: it never saw the events and its
+ * key state is as old as the open. After a SYN_DROPPED gap the key state
+ * is read back with EVIOCGKEY and diffed against the state delivered so
+ * far. Events queued behind the gap stay in the buffer and are filtered on
+ * the call after the resync frame.
+ */
+EventBatch KeyboardDevice::read_batch_direct() {
+    if (resync_due_) {
+        resync_due_ = false;
+        KeyBitmap actual;
+        if (ioctl(fd_, EVIOCGKEY(KeyBitmap::byte_size()), actual.data()) < 0) {
+            log_debug("Failed to read key state after dropped events: " + path_ + " (" +
+                      std::strerror(errno) + ")");
+        } else {
+            const std::size_t count =
+                build_resync(delivered_, actual, resync_stamp_, sync_.data(), sync_.size());
+            if (count > 0) {
+                return {sync_.data(), count, 0};
+            }
+        }
+    }
+
+    std::size_t begin = pending_begin_;
+    std::size_t end = pending_end_;
+    bool drained = false;
+    if (begin == end) {
+        const ssize_t bytes = read(fd_, batch_.data(), batch_.size() * sizeof(input_event));
+        if (bytes < 0) {
+            return {nullptr, 0, -errno};
+        }
+        if (bytes == 0) {
+            return {nullptr, 0, -ENODEV};
+        }
+        begin = 0;
+        end = static_cast<std::size_t>(bytes) / sizeof(input_event);
+        drained = end < batch_.size();  // A short read emptied the kernel queue
+    }
+
+    input_event* events = batch_.data() + begin;
+    const FilterResult result = filter_key_frames(events, end - begin, delivered_, dropping_);
+    if (result.resync) {
+        resync_stamp_ = events[result.scanned - 1];
+        resync_due_ = true;
+        pending_begin_ = begin + result.scanned;
+        pending_end_ = end;
+        return {events, result.kept, 0};
+    }
+    pending_begin_ = 0;
+    pending_end_ = 0;
+    return {events, result.kept, drained ? -EAGAIN : 0};
+}
+
 //-----------------------------------------------------------------------------
 // DeviceMonitor implementation
 //-----------------------------------------------------------------------------
@@ -330,15 +528,17 @@ void DeviceMonitor::cleanup() noexcept {
 
 /**
  * @brief Enumerate all existing keyboard devices in the system
- * @return Vector of valid KeyboardDevice objects
+ * @return Vector of valid KeyboardDevice objects, in udev enumeration order
  *
  * Scans the system for input devices using udev enumeration and creates
  * KeyboardDevice objects for all detected keyboards. The function:
  * 1. Creates udev enumerate context
  * 2. Filters for input subsystem devices
- * 3. Iterates through all matching devices
- * 4. Validates device nodes for keyboard characteristics
- * 5. Creates KeyboardDevice objects for valid keyboards
+ * 3. Collects event nodes that are neither cached as non-keyboards nor
+ *    classified by udev as something else (touchpads, power buttons, ...)
+ * 4. Opens and validates the candidates in parallel, since a single open
+ *    can block for a long time in the driver
+ * 5. Keeps the keyboards and caches the candidates that are not keyboards
  *
  * Invalid devices are automatically filtered out during the process.
  * This is typically called during initialization to discover existing devices.
@@ -347,7 +547,7 @@ void DeviceMonitor::cleanup() noexcept {
  * @note Each returned device is guaranteed to be valid (is_valid() == true)
  * @note Returns empty vector if udev context is invalid
  */
-std::vector<KeyboardDevice> DeviceMonitor::enumerate_keyboards() const {
+std::vector<KeyboardDevice> DeviceMonitor::enumerate_keyboards() {
     std::vector<KeyboardDevice> keyboards;
 
     if (!udev_) {
@@ -362,19 +562,35 @@ std::vector<KeyboardDevice> DeviceMonitor::enumerate_keyboards() const {
     udev_enumerate_add_match_subsystem(enumerate, INPUT_SUBSYSTEM);
     udev_enumerate_scan_devices(enumerate);
 
+    struct Candidate {
+        std::string devnode;  //!< Node to open
+        std::string syspath;  //!< Negative cache key
+    };
+    std::vector<Candidate> candidates;
+    std::size_t skipped = 0;
+
     udev_list_entry* devices = udev_enumerate_get_list_entry(enumerate);
     udev_list_entry* entry = nullptr;
 
     udev_list_entry_foreach(entry, devices) {
         const char* syspath = udev_list_entry_get_name(entry);
+        if (!syspath) {
+            continue;
+        }
+        if (not_keyboards_.contains(syspath)) {
+            ++skipped;
+            continue;
+        }
         udev_device* dev = udev_device_new_from_syspath(udev_, syspath);
 
         if (dev) {
             const char* devnode = udev_device_get_devnode(dev);
             if (devnode && std::strstr(devnode, EVENT_DEVICE_PREFIX)) {
-                KeyboardDevice kbd(devnode);
-                if (kbd.is_valid()) {
-                    keyboards.emplace_back(std::move(kbd));
+                if (classify(dev) == UdevKeyboardClass::NotKeyboard) {
+                    not_keyboards_.insert(syspath);
+                    ++skipped;
+                } else {
+                    candidates.push_back({devnode, syspath});
                 }
             }
             udev_device_unref(dev);
@@ -382,6 +598,25 @@ std::vector<KeyboardDevice> DeviceMonitor::enumerate_keyboards() const {
     }
 
     udev_enumerate_unref(enumerate);
+
+    std::vector<std::optional<KeyboardDevice>> probed(candidates.size());
+    const std::size_t workers =
+        probe_worker_count(candidates.size(), std::thread::hardware_concurrency());
+    parallel_for(candidates.size(), workers,
+                 [&](std::size_t i) { probed[i].emplace(candidates[i].devnode); });
+
+    for (std::size_t i = 0; i < candidates.size(); ++i) {
+        KeyboardDevice& kbd = *probed[i];
+        if (kbd.is_valid()) {
+            keyboards.emplace_back(std::move(kbd));
+        } else if (kbd.open_error() == 0) {
+            not_keyboards_.insert(candidates[i].syspath);  // Opened fine, not a keyboard
+        }
+    }
+
+    log_debug("Probed " + std::to_string(candidates.size()) + " input node(s) on " +
+              std::to_string(workers) + " thread(s), skipped " + std::to_string(skipped) +
+              " non-keyboard node(s)");
     return keyboards;
 }
 
@@ -395,22 +630,25 @@ std::vector<KeyboardDevice> DeviceMonitor::enumerate_keyboards() const {
  * for device addition and removal. The function:
  * 1. Checks for pending udev events on the monitor
  * 2. Processes each event to determine action type
- * 3. Filters events for keyboard-relevant devices
- * 4. Calls appropriate callback for add/remove actions
+ * 3. Filters events for keyboard-relevant devices: added nodes that udev
+ *    classifies as something else, or that are in the negative cache, are
+ *    skipped without being opened
+ * 4. Calls appropriate callback for add/remove actions, caching nodes that
+ *    on_add reports as not being keyboards
  * 5. Continues until no more events are pending
  *
  * This should be called when the monitor file descriptor becomes readable.
  *
  * @section CallbackParameters Callback Parameters
  * - on_add: Called with device path string (e.g., "/dev/input/event0")
- * - on_remove: Called with device path string of removed device
+ *   and the node's device number
+ * - on_remove: Called with device path string and device number of removed device
  *
  * @note Callbacks may be called multiple times per call to process_events()
  * @note Callbacks should be lightweight to avoid blocking event processing
  * @note Returns false if monitor is invalid
  */
-bool DeviceMonitor::process_events(const std::function<void(const std::string&)>& on_add,
-                                   const std::function<void(const std::string&)>& on_remove) const {
+bool DeviceMonitor::process_events(const AddCallback& on_add, const HotplugCallback& on_remove) {
     if (!monitor_) {
         return false;
     }
@@ -423,12 +661,22 @@ bool DeviceMonitor::process_events(const std::function<void(const std::string&)>
 
         const char* action = udev_device_get_action(dev);
         const char* devnode = udev_device_get_devnode(dev);
+        const char* syspath = udev_device_get_syspath(dev);
 
-        if (devnode && std::strstr(devnode, EVENT_DEVICE_PREFIX) && action) {
+        if (devnode && std::strstr(devnode, EVENT_DEVICE_PREFIX) && action && syspath) {
+            const dev_t devnum = udev_device_get_devnum(dev);
             if (std::strcmp(action, ACTION_ADD) == 0 && on_add) {
-                on_add(devnode);
-            } else if (std::strcmp(action, ACTION_REMOVE) == 0 && on_remove) {
-                on_remove(devnode);
+                if (not_keyboards_.contains(syspath)) {
+                    // Announced again (e.g. udevadm trigger) and known not to be a keyboard
+                } else if (classify(dev) == UdevKeyboardClass::NotKeyboard ||
+                           on_add(devnode, devnum) == ProbeOutcome::NotKeyboard) {
+                    not_keyboards_.insert(syspath);
+                }
+            } else if (std::strcmp(action, ACTION_REMOVE) == 0) {
+                not_keyboards_.erase(syspath);
+                if (on_remove) {
+                    on_remove(devnode, devnum);
+                }
             }
         }
 
@@ -453,6 +701,7 @@ bool DeviceMonitor::process_events(const std::function<void(const std::string&)>
  * 2. Enumerates all existing keyboard devices in the system
  * 3. Validates and stores successfully initialized devices
  * 4. Logs the number of discovered keyboards for debugging
+ * 5. Creates the timer that drives probe retries of hot-plugged nodes
  *
  * @note The manager will be invalid if monitor initialization fails
  * @note Only valid keyboard devices are stored in the collection
@@ -461,6 +710,24 @@ KeyboardManager::KeyboardManager() {
     if (monitor_.is_valid()) {
         keyboards_ = monitor_.enumerate_keyboards();
         log_info("Found " + std::to_string(keyboards_.size()) + " keyboard(s) at startup");
+
+        retry_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (retry_fd_ < 0) {
+            log_error("Failed to create hot-plug retry timer (" +
+                      std::string(std::strerror(errno)) + "); busy nodes will not be retried");
+        }
+    }
+    devnums_.reserve(keyboards_.size());
+    for (std::size_t i = 0; i < keyboards_.size(); ++i) {
+        devnums_.push_back(keyboards_[i].devnum());
+        index_device(i);
+    }
+    rebuild_poll_fds();
+}
+
+KeyboardManager::~KeyboardManager() {
+    if (retry_fd_ >= 0) {
+        close(retry_fd_);
     }
 }
 
@@ -468,23 +735,24 @@ KeyboardManager::KeyboardManager() {
  * @brief Process hot-plug events and update device collection
  * @return true if the device list was modified (devices added or removed)
  *
- * Checks for pending hot-plug events and updates the internal device
+ * Handles pending hot-plug work and updates the internal device
  * collection accordingly. The function:
  * 1. Validates the monitor is ready for event processing
- * 2. Sets up callbacks for device addition and removal
- * 3. Processes all pending events from the udev monitor
- * 4. Updates the devices_changed flag for each modification
- * 5. Returns whether the device collection was modified
+ * 2. Processes all pending events from the udev monitor, probing only
+ *    the added nodes
+ * 3. Probes the nodes whose retry is due
+ * 4. Returns whether the device collection was modified
  *
- * Should be called regularly to maintain an accurate device list.
+ * Each add or remove patches the pollfd array in place, so the cost per
+ * event does not grow with the number of managed keyboards.
  *
  * @section EventHandling Event Handling
  * - Device addition: Creates new KeyboardDevice and adds to collection
  * - Device removal: Removes corresponding device from collection
  * - Invalid devices: Automatically filtered out during processing
  *
- * @note This function is typically called in the main event loop
- * @note Returns true if polling file descriptor list should be rebuilt
+ * @note Call when the monitor or retry timer fd is readable
+ * @note Returns true if polling file descriptor list should be refreshed
  * @note Returns false if monitor is invalid
  */
 bool KeyboardManager::update_devices() {
@@ -494,17 +762,20 @@ bool KeyboardManager::update_devices() {
 
     bool devices_changed = false;
 
-    auto on_add = [this, &devices_changed](const std::string& path) {
-        add_device(path);
-        devices_changed = true;
+    auto on_add = [this, &devices_changed](const std::string& path, dev_t devnum) {
+        retries_.cancel(path);  // A fresh add event restarts the backoff
+        const ProbeOutcome outcome = add_device(path, devnum);
+        devices_changed |= outcome == ProbeOutcome::Added;
+        return outcome;
     };
 
-    auto on_remove = [this, &devices_changed](const std::string& path) {
-        remove_device(path);
-        devices_changed = true;
+    auto on_remove = [this, &devices_changed](const std::string& path, dev_t devnum) {
+        ignored_.erase(path);  // The node is gone; a later device may reuse its path
+        devices_changed |= remove_device(path, devnum);
     };
 
     monitor_.process_events(on_add, on_remove);
+    devices_changed |= process_retries();
     return devices_changed;
 }
 
@@ -555,64 +826,247 @@ std::vector<int> KeyboardManager::get_poll_fds() const {
 }
 
 /**
- * @brief Add new keyboard device to managed collection
+ * @brief Rebuild the cached pollfd array and fd → index map
+ *
+ * Produces exactly one entry per stored keyboard, in keyboards_ order, so
+ * index `i` of the array always refers to keyboards_[i]. The monitor entry
+ * is appended last when the monitor is valid. Capacity is retained across
+ * rebuilds, so steady-state hot-plug churn does not reallocate.
+ */
+void KeyboardManager::rebuild_poll_fds() {
+    poll_fds_.clear();
+    fd_index_.clear();
+    poll_fds_.reserve(keyboards_.size() + 1);
+
+    for (std::size_t i = 0; i < keyboards_.size(); ++i) {
+        const int fd = keyboards_[i].fd();
+        poll_fds_.push_back({fd, POLLIN, 0});
+        if (fd >= 0) {
+            fd_index_.emplace(fd, i);
+        }
+    }
+
+    if (monitor_.is_valid()) {
+        poll_fds_.push_back({monitor_.monitor_fd(), POLLIN, 0});
+        if (retry_fd_ >= 0) {
+            poll_fds_.push_back({retry_fd_, POLLIN, 0});
+        }
+    }
+}
+
+/**
+ * @brief Find a managed keyboard by device number, or by path if it is unknown
+ * @param devnum Device number (0: unknown)
+ * @param device_path Device path
+ * @return Index into keyboards_, or nullopt
+ *
+ * Both are hash lookups, so the cost does not grow with the number of managed
+ * keyboards. The path index is only consulted when udev did not report a
+ * device number.
+ */
+std::optional<std::size_t> KeyboardManager::find_device(dev_t devnum,
+                                                        const std::string& device_path) const {
+    if (devnum != 0) {
+        const auto it = devnum_index_.find(devnum);
+        return it != devnum_index_.end() ? std::optional<std::size_t>(it->second) : std::nullopt;
+    }
+    const auto it = path_index_.find(device_path);
+    return it != path_index_.end() ? std::optional<std::size_t>(it->second) : std::nullopt;
+}
+
+void KeyboardManager::index_device(std::size_t index) {
+    if (devnums_[index] != 0) {
+        devnum_index_[devnums_[index]] = index;
+    }
+    path_index_[keyboards_[index].path()] = index;
+}
+
+/**
+ * @brief Probe a hot-plugged node and add it if it is a keyboard
  * @param device_path Path to the new input device
+ * @param devnum Device number from udev (0 if unknown)
+ * @param failures Failed probes of this node so far
+ * @return Added, NotKeyboard if the node opened but is not a keyboard, or Skipped
  *
- * Creates a KeyboardDevice for the specified path and adds it to
- * the collection if it's valid. The function:
- * 1. Checks if device already exists in the collection
- * 2. Returns early if device is already managed
- * 3. Creates new KeyboardDevice from the path
- * 4. Validates the device initialization succeeded
- * 5. Adds the device to the collection if valid
+ * Only the added node is opened. The function:
+ * 1. Returns early if the device is already managed
+ * 2. Creates a new KeyboardDevice from the path
+ * 3. Schedules a retry if the node cannot be opened yet (udev rules
+ *    may still be setting its permissions)
+ * 4. Appends a valid keyboard to the collection and inserts its pollfd
+ *    entry in front of the hot-plug entries
  *
- * Invalid devices are ignored and not added to the collection.
- * Duplicate devices are detected and not added again.
+ * Nodes that are not keyboards (mice, power buttons, ...) are ignored.
  *
- * @note Only valid devices are added to the collection
  * @note Duplicate devices are safely ignored
  */
-void KeyboardManager::add_device(const std::string& device_path) {
-    // Check if device already exists
-    auto it = std::find_if(
-        keyboards_.begin(), keyboards_.end(),
-        [&device_path](const KeyboardDevice& kbd) { return kbd.path() == device_path; });
+ProbeOutcome KeyboardManager::add_device(const std::string& device_path, dev_t devnum,
+                                         int failures) {
+    if (find_device(devnum, device_path)) {
+        return ProbeOutcome::Skipped;  // Already exists
+    }
+    if (ignored_.count(device_path) != 0) {
+        return ProbeOutcome::Skipped;
+    }
+
+    KeyboardDevice kbd(device_path, /*quiet_open_errors=*/true);
+    if (!kbd.is_valid()) {
+        const int error = kbd.open_error();
+        if (error != 0 && ProbeRetryQueue::is_retryable(error) && retry_fd_ >= 0) {
+            if (retries_.schedule(device_path, devnum, failures + 1,
+                                  ProbeRetryQueue::Clock::now())) {
+                arm_retry_timer();
+            } else {
+                log_error("Giving up on " + device_path + " after " +
+                          std::to_string(failures + 1) + " attempts (" + std::strerror(error) +
+                          ")");
+            }
+        } else if (error != 0) {
+            log_error("Failed to open device: " + device_path + " (" + std::strerror(error) +
+                      ")");
+        }
+        return error == 0 ? ProbeOutcome::NotKeyboard : ProbeOutcome::Skipped;
+    }
+
+    kbd.set_batch_reads(batch_reads_);
+    kbd.set_keymaps(keymaps_);
+    if (!grabbed_) {
+        kbd.set_grabbed(false);
+    }
+    const std::size_t index = keyboards_.size();
+    const int fd = kbd.fd();
+    devnums_.push_back(kbd.devnum() != 0 ? kbd.devnum() : devnum);
+    keyboards_.emplace_back(std::move(kbd));
+    index_device(index);
+    poll_fds_.insert(poll_fds_.begin() + static_cast<std::ptrdiff_t>(index), {fd, POLLIN, 0});
+    fd_index_[fd] = index;
+    if (metrics_) {
+        metrics_->keyboards_added.add();
+    }
+    return ProbeOutcome::Added;
+}
 
-    if (it != keyboards_.end()) {
-        return;  // Already exists
+void KeyboardManager::set_batch_reads(bool enabled) {
+    batch_reads_ = enabled;
+    for (auto& kbd : keyboards_) {
+        kbd.set_batch_reads(enabled);
     }
+}
 
-    KeyboardDevice kbd(device_path);
-    if (kbd.is_valid()) {
-        keyboards_.emplace_back(std::move(kbd));
+void KeyboardManager::set_grabbed(bool grabbed) noexcept {
+    grabbed_ = grabbed;
+    for (auto& kbd : keyboards_) {
+        kbd.set_grabbed(grabbed);
+    }
+}
+
+bool KeyboardManager::ignore_device(const std::string& device_path) {
+    if (device_path.empty()) {
+        return false;
+    }
+    ignored_.insert(device_path);
+    retries_.cancel(device_path);
+    const auto found = find_device(0, device_path);
+    return found && remove_device(device_path, devnums_[*found]);
+}
+
+void KeyboardManager::set_keymaps(const keymap::KeymapStore* keymaps) noexcept {
+    keymaps_ = keymaps;
+    for (auto& kbd : keyboards_) {
+        kbd.set_keymaps(keymaps);
     }
 }
 
 /**
  * @brief Remove keyboard device from managed collection
  * @param device_path Path of the device to remove
+ * @param devnum Device number from udev (0 if unknown)
+ * @return true if a keyboard was removed
  *
- * Finds and removes the device with the specified path from the
- * collection. The function:
- * 1. Searches for device with matching path
- * 2. Uses lambda predicate for path comparison
- * 3. Removes device from collection if found
- * 4. Device destructor handles resource cleanup automatically
- *
- * If the device is not found, no action is taken.
- * The device's destructor will handle cleanup of resources.
+ * The removed keyboard's slot is filled with the last keyboard, so the
+ * keyboards_, devnums_ and pollfd arrays stay index-aligned without
+ * shifting; only the moved keyboard's index entries change. If the device
+ * is not found, only a pending retry of the node is cancelled. The
+ * device's destructor will handle cleanup of resources.
  *
  * @note Device cleanup is handled automatically by RAII
  * @note Safe to call with non-existent device paths
  */
-void KeyboardManager::remove_device(const std::string& device_path) {
-    auto it = std::find_if(
-        keyboards_.begin(), keyboards_.end(),
-        [&device_path](const KeyboardDevice& kbd) { return kbd.path() == device_path; });
+bool KeyboardManager::remove_device(const std::string& device_path, dev_t devnum) {
+    retries_.cancel(device_path);
+    const auto found = find_device(devnum, device_path);
+    if (!found) {
+        return false;
+    }
+
+    const std::size_t index = *found;
+    const std::size_t last = keyboards_.size() - 1;
+    fd_index_.erase(keyboards_[index].fd());
+    devnum_index_.erase(devnums_[index]);
+    path_index_.erase(keyboards_[index].path());
+    if (index != last) {
+        keyboards_[index] = std::move(keyboards_[last]);
+        devnums_[index] = devnums_[last];
+        poll_fds_[index] = poll_fds_[last];
+        fd_index_[keyboards_[index].fd()] = index;
+        index_device(index);
+    }
+    keyboards_.pop_back();
+    devnums_.pop_back();
+    poll_fds_.erase(poll_fds_.begin() + static_cast<std::ptrdiff_t>(last));
+    if (metrics_) {
+        metrics_->keyboards_removed.add();
+    }
+    return true;
+}
+
+/**
+ * @brief Probe every node whose retry is due and re-arm the timer
+ * @return true if a keyboard was added
+ */
+bool KeyboardManager::process_retries() {
+    if (retry_fd_ < 0) {
+        return false;
+    }
 
-    if (it != keyboards_.end()) {
-        keyboards_.erase(it);
+    // Clear the timer's readiness; the due times below decide what to probe
+    std::uint64_t expirations = 0;
+    [[maybe_unused]] const ssize_t n = read(retry_fd_, &expirations, sizeof(expirations));
+    if (retries_.empty()) {
+        return false;
+    }
+
+    bool added = false;
+    for (const auto& probe : retries_.take_due(ProbeRetryQueue::Clock::now())) {
+        if (add_device(probe.path, probe.devnum, probe.failures) == ProbeOutcome::Added) {
+            log_info("Keyboard became accessible on retry " + std::to_string(probe.failures) +
+                     ": " + probe.path);
+            added = true;
+        }
+    }
+    arm_retry_timer();
+    return added;
+}
+
+/**
+ * @brief Arm retry_fd_ for the earliest pending retry, or disarm it
+ */
+void KeyboardManager::arm_retry_timer() const {
+    if (retry_fd_ < 0) {
+        return;
+    }
+    itimerspec spec{};  // All zero disarms the timer
+    if (const auto due = retries_.next_due()) {
+        const auto ns =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(due->time_since_epoch()).count();
+        spec.it_value.tv_sec = static_cast<time_t>(ns / 1000000000);
+        spec.it_value.tv_nsec = static_cast<long>(ns % 1000000000);
+        if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) {
+            spec.it_value.tv_nsec = 1;  // Zero would disarm
+        }
     }
+    // steady_clock is CLOCK_MONOTONIC, so the due time is an absolute timer value
+    timerfd_settime(retry_fd_, TFD_TIMER_ABSTIME, &spec, nullptr);
 }
 
 }  // namespace device
@@ -0,0 +1,135 @@
+/**
+ * @file gatt_cache.cpp
+ * @brief Implementation of the persistent GATT cache
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include "gatt_cache.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace ble {
+
+namespace {
+
+//! @brief First line of every cache file; bump the version when the format changes
+constexpr const char* CACHE_HEADER = "ninja_util-gatt-cache 1";
+
+//! @brief Case-insensitive comparison (addresses may be written in either case)
+bool iequals(const std::string& a, const std::string& b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::tolower(static_cast<unsigned char>(x)) ==
+                      std::tolower(static_cast<unsigned char>(y));
+           });
+}
+
+//! @brief Keep values on a single line
+std::string single_line(std::string value) {
+    std::replace(value.begin(), value.end(), '\n', ' ');
+    std::replace(value.begin(), value.end(), '\r', ' ');
+    return value;
+}
+
+}  // namespace
+
+bool GattCacheEntry::matches_target(const std::string& target) const {
+    return target.empty() || iequals(target, address) || target == name;
+}
+
+std::string default_gatt_cache_path() {
+    const char* xdg = std::getenv("XDG_CACHE_HOME");
+    if (xdg && *xdg) {
+        return std::string(xdg) + "/ninja_util/gatt_cache";
+    }
+    const char* home = std::getenv("HOME");
+    if (home && *home) {
+        return std::string(home) + "/.cache/ninja_util/gatt_cache";
+    }
+    return {};
+}
+
+std::optional<GattCacheEntry> load_gatt_cache(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        return std::nullopt;
+    }
+
+    std::string line;
+    if (!std::getline(in, line) || line != CACHE_HEADER) {
+        return std::nullopt;
+    }
+
+    GattCacheEntry entry;
+    while (std::getline(in, line)) {
+        const auto eq = line.find('=');
+        if (eq == std::string::npos) {
+            continue;
+        }
+        const std::string key = line.substr(0, eq);
+        std::string value = line.substr(eq + 1);
+        if (key == "address") {
+            entry.address = std::move(value);
+        } else if (key == "name") {
+            entry.name = std::move(value);
+        } else if (key == "service") {
+            entry.service_uuid = std::move(value);
+        } else if (key == "characteristic") {
+            entry.characteristic_uuid = std::move(value);
+        }
+        // Unknown keys are ignored so newer versions may add fields
+    }
+
+    if (!entry.is_valid()) {
+        return std::nullopt;
+    }
+    return entry;
+}
+
+bool save_gatt_cache(const std::string& path, const GattCacheEntry& entry) {
+    if (path.empty() || !entry.is_valid()) {
+        return false;
+    }
+
+    std::error_code ec;
+    const std::filesystem::path file(path);
+    if (file.has_parent_path()) {
+        std::filesystem::create_directories(file.parent_path(), ec);
+        if (ec) {
+            return false;
+        }
+    }
+
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+        out << CACHE_HEADER << '\n'
+            << "address=" << single_line(entry.address) << '\n'
+            << "name=" << single_line(entry.name) << '\n'
+            << "service=" << single_line(entry.service_uuid) << '\n'
+            << "characteristic=" << single_line(entry.characteristic_uuid) << '\n';
+        out.flush();
+        if (!out) {
+            std::filesystem::remove(tmp, ec);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tmp, file, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace ble
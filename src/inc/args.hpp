@@ -17,8 +17,24 @@
  * - `--list-devices, -l`: List available BLE devices and exit
  * - `--target <address>`: Connect to specific BLE device by MAC address
  * - `--scan-timeout <ms>`: Set BLE device scanning timeout in milliseconds
- * - `--poll-interval <ms>`: Set input polling interval in milliseconds
+ * - `--scan-grace <ms>`: Wait this long for a second NinjaUSB device before auto-connecting
+ * - `--poll-interval <ms>`: Use legacy timer polling at the given interval in milliseconds
  * - `--log-level <level>`: Set logging verbosity (debug, info, error)
+ * - `--input-thread`: Read keyboards on a dedicated input thread
+ * - `--input-rt-priority <prio>`: SCHED_FIFO priority for the input thread
+ * - `--input-cpu <n>`: Pin the input thread to a CPU core
+ * - `--conn-profile <profile>`: BLE connection parameters to request after connecting
+ * - `--idle-timeout <s>`: Switch the links to power-save after this long without key input
+ * - `--gatt-cache <path>`, `--no-gatt-cache`: Fast reconnect to the last device
+ * - `--no-reconnect`: Exit when an established BLE link is lost
+ * - `--log-async`: Write log output from a background thread
+ * - `--trace <path>`, `--trace-size <MiB>`: Record a binary event trace for ninja_util-replay
+ * - `--latency-stats`: Collect per-stage report latency histograms (dumped on SIGUSR1 and exit)
+ * - `--metrics <port|path>`: Serve operational counters on localhost HTTP or a Unix socket
+ * - `--keymap <path>`: Remap keys per keyboard, with layers; reloaded on SIGHUP
+ * - `--hotkeys <action=chord>[,...]`: Bind the exit, next-target, grab and metrics hotkeys
+ * - `--type <text>`, `--type-file <path>`: Type text on the host once the link is ready
+ * - `--daemon <path>`: Keep running without a terminal, controlled through a Unix socket
  *
  * @section ArgumentErrorHandling Error Handling
  * - Invalid options: Show error message and usage information
@@ -70,8 +86,13 @@ namespace args {
  *
  * @section DefaultValues Default Values
  * - scan_timeout: 10000ms (10 seconds) - reasonable time for device discovery
- * - poll_interval: 1ms - responsive input processing without excessive CPU usage
+ * - scan_grace: 500ms - scanning stops early once the device is identified
+ * - poll_interval: 1ms - only used by the legacy timer-driven polling fallback
+ * - legacy_polling: false - input is event-driven (fd notifications) by default
  * - log_level: "info" - balanced verbosity for normal operation
+ * - conn_profile: "low-latency" - shortest BLE connection interval the peer accepts
+ * - idle_timeout: 0 - the links keep conn_profile while input is idle
+ * - trace_size: 16 MiB - about 500000 trace records
  * - All boolean flags: false - opt-in behavior
  *
  * @section Validation Value Validation
@@ -86,10 +107,34 @@ struct Options {
     bool verbose = false;               //!< Enable verbose logging with timestamps
     bool list_devices = false;          //!< List available BLE devices and exit
     bool disable_auto_connect = false;  //!< Disable automatic connection to single NinjaUSB device
+    bool legacy_polling = false;   //!< Poll input on a timer instead of fd notifications
+    bool input_thread = false;     //!< Read keyboards on a dedicated input thread
+    int input_rt_priority = 0;     //!< SCHED_FIFO priority for the input thread (0: default)
+    int input_cpu = -1;            //!< CPU core to pin the input thread to (-1: no pinning)
+    bool coalesce_frames = false;  //!< Send one report per SYN_REPORT frame instead of per key
+    bool batch_reads = false;      //!< read(2) input events in batches, bypassing libevdev
+    bool no_gatt_cache = false;    //!< Ignore the GATT cache and always scan/discover
+    bool no_reconnect = false;     //!< Exit on a lost BLE link instead of reconnecting
+    bool log_async = false;        //!< Write log output from a background thread
+    bool latency_stats = false;    //!< Collect report latency histograms
+    bool share_input = false;      //!< Also deliver input to the local host via uinput
     int scan_timeout = 10000;   //!< BLE device scanning timeout in milliseconds (default: 10s)
+    int scan_grace = 500;       //!< Grace window for a second NinjaUSB device before auto-connect
     int poll_interval = 1;      //!< Input device polling interval in milliseconds (default: 1ms)
+    int trace_size = 16;        //!< Preallocated trace file size in MiB
+    int idle_timeout = 0;       //!< Seconds without key input before going power-save (0: never)
     std::string target_device;  //!< Specific BLE device MAC address to connect to (optional)
+    std::vector<std::string> targets;  //!< Every --target device; more than one fans out input
     std::string log_level = "info";  //!< Logging verbosity level (debug, info, error)
+    std::string conn_profile = "low-latency";  //!< BLE connection profile requested after connect
+    std::string gatt_cache;  //!< GATT cache file (empty: ble::default_gatt_cache_path())
+    std::string trace;       //!< Binary event trace file (empty: no tracing)
+    std::string metrics;     //!< Metrics endpoint: port or Unix socket path (empty: off)
+    std::string keymap;      //!< Key remapping file, reloaded on SIGHUP (empty: no remapping)
+    std::string hotkeys;     //!< Hotkey bindings, ACTION=CHORD list (empty: defaults only)
+    std::string type_text;   //!< Text to type once connected (empty: none)
+    std::string type_file;   //!< File to type once connected, "-" for stdin (empty: none)
+    std::string daemon;      //!< Control socket path of the daemon mode (empty: interactive)
 };
 
 /**
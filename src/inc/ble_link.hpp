@@ -0,0 +1,263 @@
+/**
+ * @file ble_link.hpp
+ * @brief One BLE connection to a NinjaUSB peripheral and its report path
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * A BleLink owns everything that belongs to a single peripheral: the
+ * QLowEnergyController, the service and characteristics reports are written
+ * to, the connection-parameter tuning stage and a TransmitScheduler with its
+ * own pacing timer. Keyboard reports are written in NKRO form when the
+ * service has an NKRO characteristic and in boot form otherwise; consumer
+ * reports only reach peers with a consumer characteristic (see
+ * report_map.hpp). Reports handed to submit() are queued per link, so a
+ * slow or stalled peer never delays the other links (see LinkRouter for
+ * the fan-out in main.cpp).
+ *
+ * What happens after a failure (fall back to a scan, reconnect, drop the
+ * link or exit) is left to the owner, which is told through the Callbacks.
+ * reconnect() reuses the service and characteristic of the last ready
+ * connection and keeps the transmit scheduler, so statistics and pacing
+ * survive a dropped link.
+ *
+ * @section LinkUsage Usage Example
+ * @code
+ * ble::BleLink link(device, config,
+ *                   {[&](ble::BleLink& l) { start_input(); },
+ *                    [&](ble::BleLink& l, const ble::LinkFailure& f) { give_up(f.reason); }});
+ * link.connect();
+ * // once ready:
+ * link.submit(report, timing);
+ * @endcode
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <QBluetoothDeviceInfo>
+#include <QLowEnergyCharacteristic>
+#include <QTimer>
+
+#include "connection_tuner.hpp"
+#include "gatt_cache.hpp"
+#include "report_types.hpp"
+#include "transmit_scheduler.hpp"
+
+class QLowEnergyController;
+class QLowEnergyService;
+
+namespace metrics {
+class Metrics;
+}
+
+namespace trace {
+class TraceRecorder;
+}
+
+namespace ble {
+
+//! @brief Why a link gave up
+struct LinkFailure {
+    //! @brief Failure category
+    enum class Kind {
+        Timeout,          //!< Not connected (or, cached, not ready) in time
+        Disconnected,     //!< The peer went away
+        Error,            //!< QLowEnergyController::errorOccurred
+        NoCharacteristic  //!< No usable report characteristic
+    };
+
+    Kind kind;           //!< Category
+    std::string reason;  //!< Short description, e.g. "timeout" or "Connection error"
+};
+
+/**
+ * @class BleLink
+ * @brief Connection, GATT lookup and paced report writes for one peripheral
+ *
+ * @note Lives on the Qt thread; neither copyable nor movable (Qt signal
+ *       handlers refer to the object)
+ */
+class BleLink {
+  public:
+    //! @brief Time allowed to connect when not using the GATT cache
+    static constexpr int CONNECT_TIMEOUT_MS = 30000;
+
+    /**
+     * @struct Config
+     * @brief How to connect and what to attach to the transmit path
+     */
+    struct Config {
+        ConnectionProfile profile = ConnectionProfile::LowLatency;  //!< --conn-profile
+
+        //! Inspect only this service and characteristic, time the whole setup with
+        //! FAST_RECONNECT_TIMEOUT_MS (GATT cache reconnect)
+        std::optional<GattCacheEntry> cached;
+
+        std::string label;                            //!< Log prefix (empty with a single link)
+        bool verbose = false;                         //!< Log controller states and services
+        trace::TraceRecorder* trace = nullptr;        //!< --trace; must outlive the link
+        pipeline::LatencyTracker* latency = nullptr;  //!< --latency-stats; must outlive the link
+        metrics::Metrics* metrics = nullptr;          //!< --metrics; must outlive the link
+    };
+
+    /**
+     * @struct Callbacks
+     * @brief Notifications to the owner; called at most once each per connection attempt
+     *
+     * The owner must not destroy the link from inside a callback (defer it,
+     * e.g. with a zero-timeout QTimer).
+     */
+    struct Callbacks {
+        std::function<void(BleLink&)> ready;                       //!< Reports can be sent
+        std::function<void(BleLink&, const LinkFailure&)> failed;  //!< The link is unusable
+    };
+
+  private:
+    QBluetoothDeviceInfo device_;                  //!< Peripheral to connect to
+    Config config_;                                //!< Connection options
+    Callbacks callbacks_;                          //!< Owner notifications
+    QLowEnergyController* controller_{nullptr};    //!< Central role controller
+    std::vector<QLowEnergyService*> services_;     //!< Services whose details are being read
+    QLowEnergyService* service_{nullptr};          //!< Service of the report characteristic
+    QLowEnergyCharacteristic characteristic_;      //!< Boot keyboard report characteristic
+    bool nkro_{false};                             //!< Keyboard reports go out in NKRO form
+    bool consumer_{false};                         //!< The peer takes consumer reports
+    //! Boot bytes of the last keyboard report queued (boot-only peers)
+    std::optional<std::array<std::uint8_t, hid::KEYBOARD_REPORT_SIZE>> last_boot_;
+    int pending_service_details_{0};               //!< Services still being read
+    ConnectionTuner tuner_;                        //!< Post-connect parameter negotiation
+    std::chrono::microseconds interval_{0};        //!< Negotiated interval (0: unknown)
+    //! Paced writes (created once the link is ready)
+    std::unique_ptr<pipeline::TransmitScheduler> scheduler_;
+    pipeline::ReportSink writer_;                  //!< Writes to the current characteristic
+    std::optional<GattCacheEntry> handles_;        //!< Handles of the last ready connection
+    QTimer connect_timer_;                         //!< Connect (or cached setup) deadline
+    QTimer tune_timer_;                            //!< Connection-parameter update deadline
+    QTimer transmit_timer_;                        //!< Next paced write
+    bool power_save_{false};                       //!< Idle: power-save parameters requested
+    bool ready_{false};                            //!< ready was reported
+    bool failed_{false};                           //!< failed was reported
+
+  public:
+    /**
+     * @brief Prepare a link (does not connect yet)
+     * @param device Peripheral to connect to
+     * @param config Connection options
+     * @param callbacks Owner notifications
+     */
+    BleLink(const QBluetoothDeviceInfo& device, Config config, Callbacks callbacks);
+
+    /**
+     * @brief Disconnect and release the controller
+     */
+    ~BleLink();
+
+    BleLink(const BleLink&) = delete;
+    BleLink& operator=(const BleLink&) = delete;
+
+    /**
+     * @brief Start connecting and looking up the report characteristic
+     */
+    void connect();
+
+    /**
+     * @brief Connect again after a failure (same device, same scheduler)
+     * @param use_handles Only inspect the service and characteristic of the last
+     *                    ready connection (GATT cache style); false runs a full
+     *                    service discovery
+     *
+     * Waiting reports of the lost connection are dropped; the owner resends
+     * the current state once the link is ready again.
+     */
+    void reconnect(bool use_handles = true);
+
+    /**
+     * @brief Queue a report for this peripheral
+     * @param report Report to send
+     * @param timing Latency stamps of the report
+     *
+     * Ignored until the link is ready or after it failed. Consumer reports
+     * are also ignored without a consumer characteristic, and keyboard
+     * reports whose boot form did not change on a boot-only peer.
+     */
+    void submit(const pipeline::Report& report, const pipeline::ReportTiming& timing = {});
+
+    /**
+     * @brief Write every waiting report immediately (e.g. before exiting)
+     */
+    void flush();
+
+    /**
+     * @brief Switch between power-save and the configured connection profile
+     * @param power_save true while input is idle (see IdleGovernor)
+     *
+     * Only the parameter request changes: reports submitted meanwhile are
+     * written on the current connection, paced to the interval in use
+     * until the peer confirms the update. A reconnect requests the profile
+     * in effect.
+     */
+    void set_power_save(bool power_save);
+
+    [[nodiscard]] bool power_save() const noexcept { return power_save_; }
+
+    [[nodiscard]] bool ready() const noexcept { return ready_ && !failed_; }
+    [[nodiscard]] bool failed() const noexcept { return failed_; }
+
+    [[nodiscard]] const QBluetoothDeviceInfo& device() const noexcept { return device_; }
+    [[nodiscard]] const std::string& label() const noexcept { return config_.label; }
+    [[nodiscard]] QLowEnergyService* service() const noexcept { return service_; }
+    [[nodiscard]] const QLowEnergyCharacteristic& characteristic() const noexcept {
+        return characteristic_;
+    }
+
+    /**
+     * @brief Get the device and handles of the last ready connection
+     * @return Entry for the GATT cache or reconnect(), nullopt if never ready
+     */
+    [[nodiscard]] const std::optional<GattCacheEntry>& gatt_entry() const noexcept {
+        return handles_;
+    }
+
+    /**
+     * @brief Get the transmit scheduler for exit statistics
+     * @return Scheduler (kept across reconnects), or nullptr if the link never became ready
+     */
+    [[nodiscard]] const pipeline::TransmitScheduler* scheduler() const noexcept {
+        return scheduler_.get();
+    }
+
+  private:
+    //! @brief Read a service's characteristics and pick the report characteristics
+    void watch_service(QLowEnergyService* service);
+
+    //! @brief Start the report path on the chosen characteristics (nkro, consumer may be invalid)
+    void use_characteristic(QLowEnergyService* service, const QLowEnergyCharacteristic& ch,
+                            const QLowEnergyCharacteristic& nkro,
+                            const QLowEnergyCharacteristic& consumer);
+
+    //! @brief Ask the peer for the given parameters and start the update deadline
+    void request_connection_parameters(const ConnectionParameters& requested);
+
+    //! @brief Handle QLowEnergyController::connectionUpdated
+    void on_connection_updated(double interval_ms, int latency, int supervision_timeout_ms);
+
+    //! @brief Arm the transmit timer for a scheduler delay
+    void arm_transmit_timer(std::optional<pipeline::TransmitScheduler::Clock::duration> wait);
+
+    //! @brief Report a failure once and stop reacting to the controller
+    void fail(LinkFailure::Kind kind, const std::string& reason);
+
+    //! @brief Disconnect every signal handler that refers to this link
+    void detach() noexcept;
+};
+
+}  // namespace ble
@@ -0,0 +1,307 @@
+/**
+ * @file chord_matcher.hpp
+ * @brief Table-driven hotkey chords matched against the keyboard state
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * A chord is a set of modifiers plus one or more keys, bound to an action.
+ * The matcher keeps no key state of its own: it is asked after each key
+ * press has been applied to the hid::KeyboardState, and compares the
+ * state's modifier byte and pressed-key bitmap against the registered
+ * chords. A press that is not a key of any chord is rejected with a single
+ * bitmap test, so ordinary typing costs a shift and an AND per event.
+ *
+ * Modifiers match on either side (Left or Right Ctrl) and a chord fires
+ * when at least its modifiers are held, so Ctrl+Alt+Shift+H also triggers
+ * Ctrl+Alt+H. A chord fires on the press of its last key only; repeats and
+ * the other keys of a held chord do not fire it again.
+ *
+ * @section ChordSpec Binding Syntax (`--hotkeys`)
+ * @code
+ * exit=ctrl+alt+q,next-target=ctrl+alt+n,grab=ctrl+alt+g,metrics=ctrl+alt+m,local=ctrl+alt+l
+ * link-1=meta+f1,all-links=none
+ * @endcode
+ * Keys are named as in a keymap file (keymap::parse_key()); modifiers are
+ * `ctrl`, `shift`, `alt` and `meta` (or `super`, `gui`). `ACTION=none`
+ * removes a binding, except for `exit`.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "hid_keycodes.hpp"
+
+namespace hotkey {
+
+//! @brief What a chord does
+enum class Action : std::uint8_t {
+    None,         //!< No chord matched
+    Exit,         //!< Release every key and stop (default Ctrl+Alt+H)
+    NextTarget,   //!< Route input to the next BLE link
+    ToggleGrab,   //!< Give the keyboards back to the local host, or take them again
+    DumpMetrics,  //!< Log the latency histograms and counters
+    ToggleLocal,  //!< Start or stop delivering input to the local host (--share-input)
+    ToggleLink1,  //!< Toggle link 1 (in --target order) in or out of the routed set
+    ToggleLink2,  //!< Toggle link 2
+    ToggleLink3,  //!< Toggle link 3
+    ToggleLink4,  //!< Toggle link 4
+    ToggleLink5,  //!< Toggle link 5
+    ToggleLink6,  //!< Toggle link 6
+    ToggleLink7,  //!< Toggle link 7
+    ToggleLink8,  //!< Toggle link 8
+    ToggleLink9,  //!< Toggle link 9
+    AllLinks      //!< Route input to every link again
+};
+
+//! @brief Number of actions a chord can be bound to (None excluded)
+inline constexpr std::size_t ACTION_COUNT = 15;
+
+//! @brief Number of ToggleLink actions, one per routable link
+inline constexpr std::size_t LINK_ACTION_COUNT = 9;
+
+//! @brief `--hotkeys` names of the ToggleLink actions
+inline constexpr std::array<std::string_view, LINK_ACTION_COUNT> LINK_ACTION_NAMES = {
+    "link-1", "link-2", "link-3", "link-4", "link-5", "link-6", "link-7", "link-8", "link-9"};
+
+/**
+ * @brief Action that toggles a link
+ * @param link Link index (0 for link 1), below LINK_ACTION_COUNT
+ * @return ToggleLink1 + link
+ */
+[[nodiscard]] constexpr Action toggle_link_action(std::size_t link) noexcept {
+    return static_cast<Action>(static_cast<std::size_t>(Action::ToggleLink1) + link);
+}
+
+/**
+ * @brief Link toggled by an action
+ * @param action Action
+ * @return Link index (0 for link 1), or nullopt if the action is not a ToggleLink action
+ */
+[[nodiscard]] constexpr std::optional<std::size_t> toggled_link(Action action) noexcept {
+    if (action < Action::ToggleLink1 || action > Action::ToggleLink9) {
+        return std::nullopt;
+    }
+    return static_cast<std::size_t>(action) - static_cast<std::size_t>(Action::ToggleLink1);
+}
+
+/**
+ * @brief Name of an action in `--hotkeys` and log messages
+ * @param action Action
+ * @return "exit", "next-target", "grab", "metrics", "local", "link-1" ... "link-9",
+ *         "all-links" or "none"
+ */
+[[nodiscard]] constexpr std::string_view action_name(Action action) noexcept {
+    if (const auto link = toggled_link(action)) {
+        return LINK_ACTION_NAMES[*link];
+    }
+    switch (action) {
+        case Action::Exit:
+            return "exit";
+        case Action::NextTarget:
+            return "next-target";
+        case Action::ToggleGrab:
+            return "grab";
+        case Action::DumpMetrics:
+            return "metrics";
+        case Action::ToggleLocal:
+            return "local";
+        case Action::AllLinks:
+            return "all-links";
+        default:
+            break;
+    }
+    return "none";
+}
+
+//! @name Side-independent modifier bits of a chord
+//! @{
+inline constexpr std::uint8_t MOD_CTRL = 0x01;   //!< Left or right Ctrl
+inline constexpr std::uint8_t MOD_SHIFT = 0x02;  //!< Left or right Shift
+inline constexpr std::uint8_t MOD_ALT = 0x04;    //!< Left or right Alt
+inline constexpr std::uint8_t MOD_GUI = 0x08;    //!< Left or right GUI (Meta)
+//! @}
+
+/**
+ * @brief Fold a HID modifier byte onto the side-independent bits
+ * @param modifiers Report byte 0 (left modifiers in bits 0-3, right in 4-7)
+ * @return MOD_* bits
+ */
+[[nodiscard]] constexpr std::uint8_t fold_modifiers(std::uint8_t modifiers) noexcept {
+    return static_cast<std::uint8_t>((modifiers | (modifiers >> 4)) & 0x0FU);
+}
+
+/**
+ * @struct Chord
+ * @brief Modifiers and keys that trigger an action
+ */
+struct Chord {
+    std::uint8_t modifiers = 0;                //!< MOD_* bits that must be held
+    hid::KeyboardState::KeyBitmap keys{};      //!< HID usages that must be held (at least one)
+    Action action = Action::None;              //!< Action to report
+
+    /**
+     * @brief Add a key to the chord
+     * @param hid_code HID usage; modifiers are added to the modifier bits instead
+     */
+    void add_key(std::uint8_t hid_code) noexcept {
+        if (hid::is_modifier(hid_code)) {
+            modifiers |= fold_modifiers(hid::modifier_bit(hid_code));
+        } else {
+            keys[hid_code >> 6] |= std::uint64_t{1} << (hid_code & 63U);
+        }
+    }
+
+    [[nodiscard]] bool has_keys() const noexcept {
+        return (keys[0] | keys[1] | keys[2] | keys[3]) != 0;
+    }
+};
+
+/**
+ * @class ChordMatcher
+ * @brief A small table of chords, at most one per action
+ *
+ * @note Trivially copyable; each KeyEventProcessor holds its own copy
+ */
+class ChordMatcher {
+  private:
+    std::array<Chord, ACTION_COUNT> chords_{};  //!< Bound chords, in binding order
+    std::size_t count_{0};                      //!< Used entries of chords_
+    hid::KeyboardState::KeyBitmap triggers_{};  //!< Union of every chord's keys
+
+    void rebuild_triggers() noexcept {
+        triggers_ = {};
+        for (std::size_t i = 0; i < count_; ++i) {
+            for (std::size_t word = 0; word < triggers_.size(); ++word) {
+                triggers_[word] |= chords_[i].keys[word];
+            }
+        }
+    }
+
+  public:
+    /**
+     * @brief Default bindings: Ctrl+Alt+H exits
+     * @param link_count Number of BLE links; with several, Ctrl+Alt+1 ... Ctrl+Alt+9
+     *        toggle links 1-9 and Ctrl+Alt+0 routes to all links
+     */
+    [[nodiscard]] static ChordMatcher defaults(std::size_t link_count = 1) noexcept {
+        ChordMatcher matcher;
+        auto bind_ctrl_alt = [&matcher](Action action, int code) {
+            Chord chord;
+            chord.action = action;
+            chord.modifiers = MOD_CTRL | MOD_ALT;
+            chord.add_key(*hid::get_keyboard_usage(code));
+            matcher.bind(chord);
+        };
+        bind_ctrl_alt(Action::Exit, KEY_H);
+        if (link_count > 1) {
+            for (std::size_t link = 0; link < link_count && link < LINK_ACTION_COUNT; ++link) {
+                bind_ctrl_alt(toggle_link_action(link), KEY_1 + static_cast<int>(link));
+            }
+            bind_ctrl_alt(Action::AllLinks, KEY_0);
+        }
+        return matcher;
+    }
+
+    /**
+     * @brief Bind a chord, replacing the chord of the same action
+     * @param chord Chord with at least one key and an action
+     * @return false if the chord has no key or no action
+     */
+    bool bind(const Chord& chord) noexcept {
+        if (chord.action == Action::None || !chord.has_keys()) {
+            return false;
+        }
+        std::size_t slot = 0;
+        while (slot < count_ && chords_[slot].action != chord.action) {
+            ++slot;
+        }
+        chords_[slot] = chord;
+        count_ = slot == count_ ? count_ + 1 : count_;
+        rebuild_triggers();
+        return true;
+    }
+
+    /**
+     * @brief Remove the chord of an action
+     * @param action Action to unbind
+     */
+    void unbind(Action action) noexcept {
+        for (std::size_t i = 0; i < count_; ++i) {
+            if (chords_[i].action == action) {
+                for (std::size_t j = i + 1; j < count_; ++j) {
+                    chords_[j - 1] = chords_[j];
+                }
+                --count_;
+                break;
+            }
+        }
+        rebuild_triggers();
+    }
+
+    /**
+     * @brief Get the chord bound to an action
+     * @return Chord, or nullptr if the action is not bound
+     */
+    [[nodiscard]] const Chord* chord(Action action) const noexcept {
+        for (std::size_t i = 0; i < count_; ++i) {
+            if (chords_[i].action == action) {
+                return &chords_[i];
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Check a key press against the chords
+     * @param state Keyboard state with the press already applied
+     * @param hid_code Usage of the key just pressed (not a repeat)
+     * @return Action of the first chord it completes, or Action::None
+     */
+    [[nodiscard]] Action match(const hid::KeyboardState& state,
+                               std::uint8_t hid_code) const noexcept {
+        if (!(triggers_[hid_code >> 6] & (std::uint64_t{1} << (hid_code & 63U)))) {
+            return Action::None;
+        }
+        const std::uint8_t held_modifiers = fold_modifiers(state.get_modifiers());
+        const auto& held = state.get_pressed_bitmap();
+        for (std::size_t i = 0; i < count_; ++i) {
+            const Chord& chord = chords_[i];
+            if ((held_modifiers & chord.modifiers) != chord.modifiers ||
+                !(chord.keys[hid_code >> 6] & (std::uint64_t{1} << (hid_code & 63U)))) {
+                continue;
+            }
+            if ((held[0] & chord.keys[0]) == chord.keys[0] &&
+                (held[1] & chord.keys[1]) == chord.keys[1] &&
+                (held[2] & chord.keys[2]) == chord.keys[2] &&
+                (held[3] & chord.keys[3]) == chord.keys[3]) {
+                return chord.action;
+            }
+        }
+        return Action::None;
+    }
+};
+
+/**
+ * @brief Apply a `--hotkeys` list to a matcher
+ * @param spec `ACTION=CHORD[,ACTION=CHORD...]`, e.g. `grab=ctrl+alt+g`
+ * @param matcher Matcher to bind to (usually ChordMatcher::defaults())
+ * @param error Receives the reason on failure
+ * @return false on the first invalid entry; the matcher is then partly updated
+ */
+[[nodiscard]] bool parse_hotkeys(std::string_view spec, ChordMatcher& matcher, std::string& error);
+
+/**
+ * @brief Describe a chord for log messages
+ * @param chord Chord
+ * @return E.g. "Ctrl+Alt+H" (keys as HID usage numbers if they have no name)
+ */
+[[nodiscard]] std::string describe(const Chord& chord);
+
+}  // namespace hotkey
@@ -0,0 +1,191 @@
+/**
+ * @file connection_tuner.hpp
+ * @brief BLE connection-parameter profiles and the post-connect tuning stage
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * The connection interval dominates end-to-end latency of the bridge, so
+ * after connecting we ask the peripheral for the interval range of the
+ * selected profile. If the peer does not accept it (no update within the
+ * timeout, or an interval outside the requested range) the tuner falls
+ * back to the balanced profile once.
+ *
+ * The tuner is independent of Qt; main.cpp translates its requests into
+ * QLowEnergyController::requestConnectionUpdate() calls and feeds back
+ * connectionUpdated() results and timer expiry.
+ *
+ * @section TunerUsage Usage Example
+ * @code
+ * ble::ConnectionTuner tuner(ble::ConnectionProfile::LowLatency);
+ * controller->requestConnectionUpdate(to_qt(tuner.start()));
+ * // connectionUpdated(params):
+ * if (auto retry = tuner.on_updated(params.maximumInterval())) {
+ *     controller->requestConnectionUpdate(to_qt(*retry));
+ * }
+ * @endcode
+ */
+
+#pragma once
+
+#include <optional>
+#include <string_view>
+
+/**
+ * @namespace ble
+ * @brief Bluetooth Low Energy link management helpers
+ */
+namespace ble {
+
+//! @brief Named connection-parameter presets selectable with --conn-profile
+enum class ConnectionProfile {
+    LowLatency,  //!< Shortest intervals, no peripheral latency (default)
+    Balanced,    //!< Moderate intervals; fallback when low latency is refused
+    PowerSave    //!< Long intervals with peripheral latency for idle links
+};
+
+/**
+ * @struct ConnectionParameters
+ * @brief Values passed to QLowEnergyConnectionParameters
+ */
+struct ConnectionParameters {
+    double min_interval_ms;      //!< Minimum connection interval (multiple of 1.25 ms)
+    double max_interval_ms;      //!< Maximum connection interval (multiple of 1.25 ms)
+    int latency;                 //!< Peripheral latency in connection events
+    int supervision_timeout_ms;  //!< Link supervision timeout (multiple of 10 ms)
+};
+
+/**
+ * @brief Get the connection parameters of a profile
+ * @param profile Profile to look up
+ * @return Parameters requested for the profile
+ */
+[[nodiscard]] constexpr ConnectionParameters parameters_for(ConnectionProfile profile) noexcept {
+    switch (profile) {
+        case ConnectionProfile::LowLatency:
+            return {7.5, 15.0, 0, 2000};
+        case ConnectionProfile::PowerSave:
+            return {60.0, 120.0, 4, 6000};
+        case ConnectionProfile::Balanced:
+        default:
+            return {15.0, 30.0, 0, 4000};
+    }
+}
+
+/**
+ * @brief Get the command-line name of a profile
+ * @param profile Profile to name
+ * @return "low-latency", "balanced" or "power-save"
+ */
+[[nodiscard]] constexpr const char* to_string(ConnectionProfile profile) noexcept {
+    switch (profile) {
+        case ConnectionProfile::LowLatency:
+            return "low-latency";
+        case ConnectionProfile::PowerSave:
+            return "power-save";
+        case ConnectionProfile::Balanced:
+        default:
+            return "balanced";
+    }
+}
+
+/**
+ * @brief Parse a command-line profile name
+ * @param name "low-latency", "balanced" or "power-save"
+ * @return Matching profile, or nullopt for an unknown name
+ */
+[[nodiscard]] constexpr std::optional<ConnectionProfile>
+parse_connection_profile(std::string_view name) noexcept {
+    if (name == "low-latency") {
+        return ConnectionProfile::LowLatency;
+    }
+    if (name == "balanced") {
+        return ConnectionProfile::Balanced;
+    }
+    if (name == "power-save") {
+        return ConnectionProfile::PowerSave;
+    }
+    return std::nullopt;
+}
+
+/**
+ * @class ConnectionTuner
+ * @brief Requests a profile after connect and falls back to balanced if refused
+ *
+ * @note Not thread-safe; driven from the Qt thread
+ */
+class ConnectionTuner {
+  public:
+    //! @brief How long to wait for connectionUpdated() before treating a request as refused
+    static constexpr int UPDATE_TIMEOUT_MS = 5000;
+
+    //! @brief Tuning progress
+    enum class State {
+        Idle,         //!< start() not called yet
+        Requested,    //!< Waiting for the peer to accept the selected profile
+        FallingBack,  //!< Waiting for the peer to accept the balanced profile
+        Accepted,     //!< Peer is using parameters within the requested range
+        Refused       //!< Peer refused every request; its own parameters stay in use
+    };
+
+  private:
+    ConnectionProfile profile_;  //!< Profile selected by the user
+    ConnectionProfile active_;   //!< Profile of the outstanding/accepted request
+    State state_{State::Idle};   //!< Current tuning state
+
+    [[nodiscard]] std::optional<ConnectionParameters> refused() noexcept;
+
+  public:
+    /**
+     * @brief Construct tuner for a profile
+     * @param profile Profile to request after connecting
+     */
+    explicit ConnectionTuner(ConnectionProfile profile) noexcept
+        : profile_(profile), active_(profile) {}
+
+    /**
+     * @brief Begin tuning (call once the link is connected)
+     * @return Parameters to request from the peer
+     */
+    [[nodiscard]] ConnectionParameters start() noexcept;
+
+    /**
+     * @brief Switch to another profile on an already tuned link
+     * @param profile New profile (e.g. power-save while idle)
+     * @return Parameters to request from the peer
+     *
+     * The balanced fallback applies to the new request as well.
+     */
+    [[nodiscard]] ConnectionParameters retarget(ConnectionProfile profile) noexcept;
+
+    /**
+     * @brief Feed back a connection-parameter update reported by the controller
+     * @param interval_ms Interval now in use
+     * @return Fallback parameters to request, or nullopt if nothing else is needed
+     */
+    [[nodiscard]] std::optional<ConnectionParameters> on_updated(double interval_ms) noexcept;
+
+    /**
+     * @brief Report that no update arrived within UPDATE_TIMEOUT_MS
+     * @return Fallback parameters to request, or nullopt if tuning is over
+     */
+    [[nodiscard]] std::optional<ConnectionParameters> on_timeout() noexcept;
+
+    /**
+     * @brief Check whether a request is still outstanding
+     * @return true while waiting for the peer
+     */
+    [[nodiscard]] bool pending() const noexcept {
+        return state_ == State::Requested || state_ == State::FallingBack;
+    }
+
+    [[nodiscard]] State state() const noexcept { return state_; }
+
+    /**
+     * @brief Profile of the current request (the fallback once falling back)
+     * @return Active profile
+     */
+    [[nodiscard]] ConnectionProfile active_profile() const noexcept { return active_; }
+};
+
+}  // namespace ble
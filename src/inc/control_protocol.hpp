@@ -0,0 +1,365 @@
+/**
+ * @file control_protocol.hpp
+ * @brief Binary frames of the daemon control socket (--daemon)
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * Requests and responses share one frame layout, all integers little-endian:
+ *
+ * | Offset | Size | Field |
+ * |--------|------|-------|
+ * | 0 | 1 | Command |
+ * | 1 | 1 | Status (0 in requests) |
+ * | 2 | 2 | Payload length (at most MAX_PAYLOAD) |
+ * | 4 | n | Payload |
+ *
+ * Every request is answered with exactly one frame carrying the same
+ * command, in request order. Payloads per command:
+ *
+ * | Command | Request | Response |
+ * |---------|---------|----------|
+ * | ListDevices | - | u8 count, then DeviceEntry records (see encode_devices()) |
+ * | SelectTarget | 6-byte address, or empty for the best NinjaUSB unit seen recently | - |
+ * | InjectReport | u8 hid::ReportId (Keyboard or Consumer), 8 boot bytes or u16 usage | - |
+ * | QueryStats | - | u8 count, then count u64 values in Stat order |
+ *
+ * Clients must ignore Stat values beyond the ones they know, so new
+ * statistics can be appended without breaking them.
+ *
+ * @section ControlProtocolUsage Usage Example
+ * @code
+ * std::vector<std::uint8_t> out;
+ * control::append_frame(out, control::Command::QueryStats);
+ * // ... send out, receive into buffer ...
+ * control::Frame response;
+ * const auto used = control::decode_frame(buffer.data(), buffer.size(), response);
+ * if (used && *used != 0) {
+ *     const auto stats = control::decode_stats(response.payload);
+ * }
+ * @endcode
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "report_types.hpp"
+
+/**
+ * @namespace control
+ * @brief Daemon control socket: protocol and server
+ */
+namespace control {
+
+//! @brief Size of the frame header
+inline constexpr std::size_t HEADER_SIZE = 4;
+
+//! @brief Largest payload accepted in a frame
+inline constexpr std::size_t MAX_PAYLOAD = 4096;
+
+//! @brief Size of a Bluetooth device address
+inline constexpr std::size_t ADDRESS_SIZE = 6;
+
+//! @brief Request type
+enum class Command : std::uint8_t {
+    ListDevices = 1,   //!< Devices of the cached scan results, best candidate first
+    SelectTarget = 2,  //!< Connect to another device (switches the target)
+    InjectReport = 3,  //!< Send a report to the routed links as if it was typed
+    QueryStats = 4     //!< Counters, see Stat
+};
+
+//! @brief Outcome carried in a response
+enum class Status : std::uint8_t {
+    Ok = 0,          //!< Done
+    BadRequest = 1,  //!< Malformed payload
+    NotFound = 2,    //!< No such device in the scan results
+    NotReady = 3,    //!< No BLE link is ready
+    Unsupported = 4  //!< Unknown command, or not possible in this mode
+};
+
+//! @brief Bits of a ListDevices entry
+enum DeviceFlags : std::uint8_t {
+    DEVICE_NINJA = 1U << 0,     //!< Named like a NinjaUSB peripheral
+    DEVICE_SELECTED = 1U << 1,  //!< Target of a link
+    DEVICE_READY = 1U << 2,     //!< That link is ready
+    DEVICE_STALE = 1U << 3      //!< Not seen by the recent scans
+};
+
+//! @brief Position of each value in a QueryStats response
+enum class Stat : std::uint8_t {
+    ReadyLinks,       //!< Links that are ready
+    ReportsRouted,    //!< Keyboard reports handed to the links
+    ReportsInjected,  //!< Reports injected through the socket
+    BleWritten,       //!< Reports written to the peripherals
+    BleCollapsed,     //!< Waiting reports merged into a newer one
+    BleQueueDepth,    //!< Reports waiting for a write slot
+    BleConnects,      //!< Connection attempts, reconnects included
+    Idle,             //!< 1 while the links are in power-save (--idle-timeout)
+    UptimeMs,         //!< Milliseconds since the daemon started
+    KnownDevices,     //!< Peripherals in the device cache
+    Count             //!< Number of values (not a value)
+};
+
+//! @brief Number of values in a QueryStats response
+inline constexpr std::size_t STAT_COUNT = static_cast<std::size_t>(Stat::Count);
+
+//! @brief Values of a QueryStats response, indexed by Stat
+using Stats = std::array<std::uint64_t, STAT_COUNT>;
+
+/**
+ * @struct Frame
+ * @brief One decoded request or response
+ */
+struct Frame {
+    std::uint8_t command = 0;           //!< Command (raw, may be unknown)
+    Status status = Status::Ok;         //!< Outcome (responses)
+    std::vector<std::uint8_t> payload;  //!< Command-specific bytes
+};
+
+/**
+ * @struct DeviceEntry
+ * @brief One device of a ListDevices response
+ */
+struct DeviceEntry {
+    std::array<std::uint8_t, ADDRESS_SIZE> address{};  //!< As written, most significant first
+    std::int16_t rssi = 0;                             //!< Signal strength in dBm (0: unknown)
+    std::uint8_t flags = 0;                            //!< DeviceFlags
+    std::string name;                                  //!< Advertised name (up to 255 bytes)
+};
+
+/**
+ * @brief Append one frame to an output buffer
+ * @param out Buffer to append to
+ * @param command Command (echoed in responses)
+ * @param status Outcome (Status::Ok in requests)
+ * @param payload Payload bytes (truncated to MAX_PAYLOAD)
+ */
+inline void append_frame(std::vector<std::uint8_t>& out, Command command,
+                         Status status = Status::Ok,
+                         const std::vector<std::uint8_t>& payload = {}) {
+    const std::size_t size = std::min(payload.size(), MAX_PAYLOAD);
+    out.push_back(static_cast<std::uint8_t>(command));
+    out.push_back(static_cast<std::uint8_t>(status));
+    out.push_back(static_cast<std::uint8_t>(size & 0xFF));
+    out.push_back(static_cast<std::uint8_t>(size >> 8));
+    out.insert(out.end(), payload.begin(),
+               payload.begin() + static_cast<std::ptrdiff_t>(size));
+}
+
+/**
+ * @brief Decode the frame at the start of a buffer
+ * @param data Received bytes
+ * @param size Number of bytes
+ * @param frame Filled with the frame when one is complete
+ * @return Bytes used by the frame, 0 if it is not complete yet, nullopt if
+ *         the length is above MAX_PAYLOAD (the stream cannot be resynchronized)
+ */
+[[nodiscard]] inline std::optional<std::size_t> decode_frame(const std::uint8_t* data,
+                                                             std::size_t size, Frame& frame) {
+    if (size < HEADER_SIZE) {
+        return 0;
+    }
+    const std::size_t length = static_cast<std::size_t>(data[2] | (data[3] << 8));
+    if (length > MAX_PAYLOAD) {
+        return std::nullopt;
+    }
+    if (size < HEADER_SIZE + length) {
+        return 0;
+    }
+    frame.command = data[0];
+    frame.status = static_cast<Status>(data[1]);
+    frame.payload.assign(data + HEADER_SIZE, data + HEADER_SIZE + length);
+    return HEADER_SIZE + length;
+}
+
+/**
+ * @brief Parse a textual device address
+ * @param text "AA:BB:CC:DD:EE:FF" (either case)
+ * @return Address bytes, nullopt if malformed
+ */
+[[nodiscard]] inline std::optional<std::array<std::uint8_t, ADDRESS_SIZE>>
+parse_address(std::string_view text) noexcept {
+    if (text.size() != ADDRESS_SIZE * 3 - 1) {
+        return std::nullopt;
+    }
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') {
+            return c - '0';
+        }
+        if (c >= 'a' && c <= 'f') {
+            return c - 'a' + 10;
+        }
+        if (c >= 'A' && c <= 'F') {
+            return c - 'A' + 10;
+        }
+        return -1;
+    };
+    std::array<std::uint8_t, ADDRESS_SIZE> address{};
+    for (std::size_t i = 0; i < ADDRESS_SIZE; ++i) {
+        const int high = nibble(text[i * 3]);
+        const int low = nibble(text[i * 3 + 1]);
+        if (high < 0 || low < 0 || (i + 1 < ADDRESS_SIZE && text[i * 3 + 2] != ':')) {
+            return std::nullopt;
+        }
+        address[i] = static_cast<std::uint8_t>(high << 4 | low);
+    }
+    return address;
+}
+
+/**
+ * @brief Format a device address
+ * @param address Address bytes
+ * @return "AA:BB:CC:DD:EE:FF" (upper case, as Qt prints it)
+ */
+[[nodiscard]] inline std::string format_address(
+    const std::array<std::uint8_t, ADDRESS_SIZE>& address) {
+    static constexpr char HEX[] = "0123456789ABCDEF";
+    std::string text;
+    for (std::size_t i = 0; i < ADDRESS_SIZE; ++i) {
+        if (i != 0) {
+            text += ':';
+        }
+        text += HEX[address[i] >> 4];
+        text += HEX[address[i] & 0x0F];
+    }
+    return text;
+}
+
+/**
+ * @brief Encode a ListDevices response payload
+ *
+ * Per device: 6-byte address, i16 RSSI, u8 DeviceFlags, u8 name length, name.
+ *
+ * @param devices Devices; entries that do not fit MAX_PAYLOAD (or past 255) are left out
+ * @return Payload
+ */
+[[nodiscard]] inline std::vector<std::uint8_t> encode_devices(
+    const std::vector<DeviceEntry>& devices) {
+    std::vector<std::uint8_t> out{0};
+    for (const DeviceEntry& device : devices) {
+        const std::size_t name_size = std::min<std::size_t>(device.name.size(), 255);
+        if (out[0] == 255 || out.size() + ADDRESS_SIZE + 4 + name_size > MAX_PAYLOAD) {
+            break;
+        }
+        out.insert(out.end(), device.address.begin(), device.address.end());
+        const auto rssi = static_cast<std::uint16_t>(device.rssi);
+        out.push_back(static_cast<std::uint8_t>(rssi & 0xFF));
+        out.push_back(static_cast<std::uint8_t>(rssi >> 8));
+        out.push_back(device.flags);
+        out.push_back(static_cast<std::uint8_t>(name_size));
+        out.insert(out.end(), device.name.begin(),
+                   device.name.begin() + static_cast<std::ptrdiff_t>(name_size));
+        ++out[0];
+    }
+    return out;
+}
+
+/**
+ * @brief Decode a ListDevices response payload
+ * @param payload Payload
+ * @return Devices, nullopt if truncated
+ */
+[[nodiscard]] inline std::optional<std::vector<DeviceEntry>> decode_devices(
+    const std::vector<std::uint8_t>& payload) {
+    if (payload.empty()) {
+        return std::nullopt;
+    }
+    std::vector<DeviceEntry> devices(payload[0]);
+    std::size_t pos = 1;
+    for (DeviceEntry& device : devices) {
+        if (pos + ADDRESS_SIZE + 4 > payload.size()) {
+            return std::nullopt;
+        }
+        std::copy_n(payload.begin() + static_cast<std::ptrdiff_t>(pos), ADDRESS_SIZE,
+                    device.address.begin());
+        pos += ADDRESS_SIZE;
+        device.rssi = static_cast<std::int16_t>(payload[pos] | (payload[pos + 1] << 8));
+        device.flags = payload[pos + 2];
+        const std::size_t name_size = payload[pos + 3];
+        pos += 4;
+        if (pos + name_size > payload.size()) {
+            return std::nullopt;
+        }
+        device.name.assign(payload.begin() + static_cast<std::ptrdiff_t>(pos),
+                           payload.begin() + static_cast<std::ptrdiff_t>(pos + name_size));
+        pos += name_size;
+    }
+    return devices;
+}
+
+/**
+ * @brief Encode an InjectReport request payload
+ * @param report Keyboard (boot bytes only) or consumer report
+ * @return Payload
+ */
+[[nodiscard]] inline std::vector<std::uint8_t> encode_report(const pipeline::Report& report) {
+    std::vector<std::uint8_t> out{static_cast<std::uint8_t>(report.id)};
+    out.insert(out.end(), report.begin(),
+               report.begin() + static_cast<std::ptrdiff_t>(report.wire_size()));
+    return out;
+}
+
+/**
+ * @brief Decode an InjectReport request payload
+ * @param payload Report ID followed by 8 boot bytes (Keyboard) or a u16 usage (Consumer)
+ * @return Report, nullopt for other IDs or sizes
+ */
+[[nodiscard]] inline std::optional<pipeline::Report> decode_report(
+    const std::vector<std::uint8_t>& payload) {
+    if (payload.empty()) {
+        return std::nullopt;
+    }
+    const auto id = static_cast<hid::ReportId>(payload[0]);
+    if (id == hid::ReportId::Keyboard && payload.size() == 1 + hid::KEYBOARD_REPORT_SIZE) {
+        std::array<std::uint8_t, hid::KEYBOARD_REPORT_SIZE> boot{};
+        std::copy(payload.begin() + 1, payload.end(), boot.begin());
+        return pipeline::Report::keyboard(boot);
+    }
+    if (id == hid::ReportId::Consumer && payload.size() == 1 + hid::CONSUMER_REPORT_SIZE) {
+        return pipeline::Report::consumer(static_cast<std::uint16_t>(payload[1] | payload[2] << 8));
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Encode a QueryStats response payload
+ * @param stats Values indexed by Stat
+ * @return Payload
+ */
+[[nodiscard]] inline std::vector<std::uint8_t> encode_stats(const Stats& stats) {
+    std::vector<std::uint8_t> out{static_cast<std::uint8_t>(STAT_COUNT)};
+    for (const std::uint64_t value : stats) {
+        for (int shift = 0; shift < 64; shift += 8) {
+            out.push_back(static_cast<std::uint8_t>(value >> shift));
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief Decode a QueryStats response payload
+ * @param payload Payload
+ * @return Values indexed by Stat (missing ones 0, unknown ones ignored), nullopt if truncated
+ */
+[[nodiscard]] inline std::optional<Stats> decode_stats(const std::vector<std::uint8_t>& payload) {
+    if (payload.empty() || payload.size() < 1 + std::size_t{payload[0]} * 8) {
+        return std::nullopt;
+    }
+    Stats stats{};
+    for (std::size_t i = 0; i < std::min<std::size_t>(payload[0], STAT_COUNT); ++i) {
+        for (int byte = 7; byte >= 0; --byte) {
+            stats[i] = stats[i] << 8 | payload[1 + i * 8 + static_cast<std::size_t>(byte)];
+        }
+    }
+    return stats;
+}
+
+}  // namespace control
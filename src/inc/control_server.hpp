@@ -0,0 +1,126 @@
+/**
+ * @file control_server.hpp
+ * @brief Unix domain control socket of the daemon mode (--daemon)
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * Unlike the metrics server this one runs on the owner's event loop: every
+ * command touches the BLE links, which live on the Qt thread, so a server
+ * thread would only have to hand each request back. All sockets are
+ * non-blocking; the owner watches listen_fd() and every accepted client
+ * (QSocketNotifier) and calls accept_client() / service() when they are
+ * readable. Responses are small and written at once; a client whose socket
+ * buffer is full is dropped rather than blocking the bridge.
+ *
+ * The socket file is created with mode 0600: a client can type on the
+ * connected host, so only the user running the daemon may connect.
+ *
+ * @section ControlServerUsage Usage Example
+ * @code
+ * control::ControlServer server("/run/ninja_util.ctl", [&](const control::Frame& request) {
+ *     control::Frame response;
+ *     response.status = control::Status::Unsupported;
+ *     return response;
+ * });
+ * // listen_fd() readable:
+ * if (const int client = server.accept_client(); client >= 0) { watch(client); }
+ * // client readable:
+ * if (!server.service(client)) { unwatch(client); server.close_client(client); }
+ * @endcode
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "control_protocol.hpp"
+
+namespace control {
+
+/**
+ * @class ControlServer
+ * @brief Listening socket plus the clients connected to it
+ *
+ * @note Not thread-safe; driven from the owner's event loop
+ */
+class ControlServer {
+  public:
+    /**
+     * @brief Answers one request
+     *
+     * The response command is overwritten with the request command, so the
+     * handler only fills in status and payload.
+     */
+    using Handler = std::function<Frame(const Frame&)>;
+
+  private:
+    struct Client {
+        int fd;                           //!< Connected socket
+        std::vector<std::uint8_t> input;  //!< Bytes of an incomplete request
+    };
+
+    std::string path_;             //!< Socket file
+    Handler handle_;               //!< Request handler
+    int listen_fd_{-1};            //!< Bound, listening, non-blocking socket
+    std::vector<Client> clients_;  //!< Accepted clients
+    std::uint64_t requests_ = 0;   //!< Requests answered
+
+    Client* find(int fd) noexcept;
+
+  public:
+    /**
+     * @brief Create and bind the listening socket
+     * @param path Absolute socket path; a stale socket at the path is replaced
+     * @param handle Request handler
+     */
+    ControlServer(std::string path, Handler handle);
+
+    /**
+     * @brief Close all clients and the socket, and remove the socket file
+     */
+    ~ControlServer();
+
+    ControlServer(const ControlServer&) = delete;
+    ControlServer& operator=(const ControlServer&) = delete;
+    ControlServer(ControlServer&&) = delete;
+    ControlServer& operator=(ControlServer&&) = delete;
+
+    /**
+     * @brief Check if the socket is listening
+     * @return true if clients can connect (errno describes the failure otherwise)
+     */
+    [[nodiscard]] bool is_valid() const noexcept { return listen_fd_ >= 0; }
+
+    //! @brief Socket to watch for incoming connections
+    [[nodiscard]] int listen_fd() const noexcept { return listen_fd_; }
+
+    [[nodiscard]] const std::string& path() const noexcept { return path_; }
+
+    /**
+     * @brief Accept one pending connection
+     * @return Client socket to watch, or -1 if none was pending
+     */
+    int accept_client();
+
+    /**
+     * @brief Read what a client sent and answer every complete request
+     * @param fd Client socket returned by accept_client()
+     * @return false if the client is gone or misbehaved; close it with close_client()
+     */
+    bool service(int fd);
+
+    /**
+     * @brief Close a client socket and forget its buffered input
+     * @param fd Client socket
+     */
+    void close_client(int fd);
+
+    [[nodiscard]] std::size_t client_count() const noexcept { return clients_.size(); }
+    [[nodiscard]] std::uint64_t requests() const noexcept { return requests_; }
+};
+
+}  // namespace control
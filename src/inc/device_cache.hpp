@@ -0,0 +1,276 @@
+/**
+ * @file device_cache.hpp
+ * @brief Index of the BLE peripherals seen by discovery, ranked for selection
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * Every deviceDiscovered()/deviceUpdated() event of any scan, the startup
+ * scan and the background scans of the daemon and fan-out modes alike, is
+ * folded into one entry per address: name, RSSI, first and last sighting,
+ * manufacturer data and whether the device is a NinjaUSB unit. The
+ * classification is computed when the entry is created (or when the device
+ * first advertises a different name), so selection never scans names again.
+ *
+ * Entries keep their discovery order, which numbers the interactive device
+ * prompt. ranked() and best() order them for automatic selection: NinjaUSB
+ * units first, then devices seen within the freshness window, then by
+ * signal strength. A target switch or a missing --target can thus be served
+ * from the cache at once instead of waiting for a fresh --scan-timeout scan.
+ *
+ * The class is independent of Qt: main.cpp feeds it the fields of each
+ * QBluetoothDeviceInfo and builds one back for the device it connects to.
+ *
+ * @section DeviceCacheUsage Usage Example
+ * @code
+ * ble::DeviceCache cache;
+ * // deviceDiscovered(info):
+ * ble::DeviceCache::Sighting sighting;
+ * sighting.address = address;
+ * sighting.name = name;
+ * sighting.rssi = info.rssi();
+ * const auto seen = cache.on_seen(sighting, Clock::now());
+ * if (seen.added) { log(seen.device); }
+ * // select command without an address:
+ * if (const auto* device = cache.best(Clock::now(), std::chrono::minutes(1))) {
+ *     connect(*device);
+ * }
+ * @endcode
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "scan_selector.hpp"
+
+namespace ble {
+
+/**
+ * @class DeviceCache
+ * @brief Known peripherals keyed by address
+ *
+ * @note Not thread-safe; driven from the Qt thread
+ */
+class DeviceCache {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @struct Sighting
+     * @brief Fields of one discovery event
+     */
+    struct Sighting {
+        std::string address;                          //!< "AA:BB:CC:DD:EE:FF"
+        std::string name;                             //!< Advertised name (may be empty)
+        std::int16_t rssi = 0;                        //!< dBm (0: not reported)
+        std::uint16_t manufacturer_id = 0;            //!< Company ID of the data below
+        std::vector<std::uint8_t> manufacturer_data;  //!< Manufacturer data (empty: none)
+    };
+
+    /**
+     * @struct Device
+     * @brief Everything known about one peripheral
+     */
+    struct Device {
+        std::string address;                          //!< Key
+        std::string name;                             //!< Latest non-empty name
+        std::int16_t rssi = 0;                        //!< Latest reported RSSI (0: never)
+        Clock::time_point first_seen;                 //!< First sighting
+        Clock::time_point last_seen;                  //!< Latest sighting
+        std::uint32_t sightings = 0;                  //!< Discovery events
+        std::uint16_t manufacturer_id = 0;            //!< Company ID of the data below
+        std::vector<std::uint8_t> manufacturer_data;  //!< Latest manufacturer data
+        bool ninja = false;                           //!< NinjaUSB unit (from the name)
+    };
+
+    /**
+     * @struct Seen
+     * @brief Result of on_seen()
+     */
+    struct Seen {
+        const Device& device;  //!< Updated entry (valid until the next on_seen/prune/clear)
+        std::size_t position;  //!< Position in discovery order
+        bool added;            //!< First sighting of this address
+    };
+
+  private:
+    std::vector<Device> devices_;                         //!< Discovery order
+    std::unordered_map<std::string, std::size_t> index_;  //!< Address to devices_ position
+
+    void reindex() {
+        index_.clear();
+        for (std::size_t i = 0; i < devices_.size(); ++i) {
+            index_.emplace(devices_[i].address, i);
+        }
+    }
+
+  public:
+    /**
+     * @brief Fold a discovery event into the cache
+     * @param sighting Fields of the event; empty names and data keep the previous ones
+     * @param now Time of the event
+     * @return The entry and whether it is new
+     */
+    Seen on_seen(const Sighting& sighting, Clock::time_point now) {
+        auto [it, added] = index_.try_emplace(sighting.address, devices_.size());
+        if (added) {
+            Device device;
+            device.address = sighting.address;
+            device.first_seen = now;
+            devices_.push_back(std::move(device));
+        }
+        Device& device = devices_[it->second];
+        if (!sighting.name.empty() && sighting.name != device.name) {
+            device.name = sighting.name;
+            device.ninja = ScanSelector::is_ninja_name(device.name);
+        }
+        if (sighting.rssi != 0) {
+            device.rssi = sighting.rssi;
+        }
+        if (!sighting.manufacturer_data.empty()) {
+            device.manufacturer_id = sighting.manufacturer_id;
+            device.manufacturer_data = sighting.manufacturer_data;
+        }
+        device.last_seen = now;
+        ++device.sightings;
+        return {device, it->second, added};
+    }
+
+    /**
+     * @brief Look up a device by address
+     * @param address "AA:BB:CC:DD:EE:FF" as reported by discovery
+     * @return Entry, or nullptr if never seen
+     */
+    [[nodiscard]] const Device* find(const std::string& address) const {
+        const auto it = index_.find(address);
+        return it == index_.end() ? nullptr : &devices_[it->second];
+    }
+
+    /**
+     * @brief Look up a --target value
+     * @param target Address (in either case) or advertised name
+     * @return Entry with that address, else the most recently seen one with that name
+     */
+    [[nodiscard]] const Device* match(const std::string& target) const {
+        if (const Device* device = find(target)) {
+            return device;
+        }
+        // Discovery reports addresses in upper case
+        std::string address = target;
+        std::transform(address.begin(), address.end(), address.begin(), [](unsigned char c) {
+            return static_cast<char>(std::toupper(c));
+        });
+        if (const Device* device = find(address)) {
+            return device;
+        }
+        const Device* latest = nullptr;
+        for (const Device& device : devices_) {
+            if (device.name == target && (!latest || device.last_seen > latest->last_seen)) {
+                latest = &device;
+            }
+        }
+        return latest;
+    }
+
+    /**
+     * @brief Order the devices for automatic selection
+     * @param now Current time
+     * @param fresh_for Sightings older than this rank below fresh ones
+     * @return NinjaUSB units first, then fresh before stale, then strongest signal first
+     */
+    [[nodiscard]] std::vector<const Device*> ranked(Clock::time_point now,
+                                                    Clock::duration fresh_for) const {
+        std::vector<const Device*> order;
+        order.reserve(devices_.size());
+        for (const Device& device : devices_) {
+            order.push_back(&device);
+        }
+        // An unreported RSSI (0) ranks below every real reading
+        auto strength = [](const Device* device) {
+            return device->rssi == 0 ? std::numeric_limits<int>::min()
+                                     : static_cast<int>(device->rssi);
+        };
+        std::stable_sort(order.begin(), order.end(), [&](const Device* a, const Device* b) {
+            const bool fresh_a = now - a->last_seen <= fresh_for;
+            const bool fresh_b = now - b->last_seen <= fresh_for;
+            if (a->ninja != b->ninja) {
+                return a->ninja;
+            }
+            if (fresh_a != fresh_b) {
+                return fresh_a;
+            }
+            return strength(a) > strength(b);
+        });
+        return order;
+    }
+
+    /**
+     * @brief Best NinjaUSB unit to connect to
+     * @param now Current time
+     * @param fresh_for Only devices seen within this window qualify
+     * @return Strongest fresh NinjaUSB unit, or nullptr if none
+     */
+    [[nodiscard]] const Device* best(Clock::time_point now, Clock::duration fresh_for) const {
+        const Device* best = nullptr;
+        for (const Device& device : devices_) {
+            if (!device.ninja || now - device.last_seen > fresh_for) {
+                continue;
+            }
+            if (!best || (device.rssi != 0 && (best->rssi == 0 || device.rssi > best->rssi))) {
+                best = &device;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * @brief Forget devices that have not been seen for a while
+     * @param now Current time
+     * @param max_age Entries whose last sighting is older are removed
+     * @return Number of entries removed
+     *
+     * Renumbers the remaining entries; do not call while a numbered prompt is shown.
+     */
+    std::size_t prune(Clock::time_point now, Clock::duration max_age) {
+        const std::size_t before = devices_.size();
+        devices_.erase(std::remove_if(devices_.begin(), devices_.end(),
+                                      [&](const Device& device) {
+                                          return now - device.last_seen > max_age;
+                                      }),
+                       devices_.end());
+        if (devices_.size() != before) {
+            reindex();
+        }
+        return before - devices_.size();
+    }
+
+    //! @brief Forget every device
+    void clear() noexcept {
+        devices_.clear();
+        index_.clear();
+    }
+
+    //! @brief Devices in discovery order
+    [[nodiscard]] const std::vector<Device>& devices() const noexcept { return devices_; }
+
+    [[nodiscard]] std::size_t size() const noexcept { return devices_.size(); }
+    [[nodiscard]] bool empty() const noexcept { return devices_.empty(); }
+
+    //! @brief Number of NinjaUSB units known
+    [[nodiscard]] std::size_t ninja_count() const noexcept {
+        return static_cast<std::size_t>(std::count_if(
+            devices_.begin(), devices_.end(), [](const Device& device) { return device.ninja; }));
+    }
+};
+
+}  // namespace ble
@@ -36,15 +36,30 @@
 
 #pragma once
 
+#include <cstddef>
 #include <functional>
+#include <optional>
+#include <poll.h>
 #include <string>
+#include <sys/types.h>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include "device_probe.hpp"
+#include "event_batch.hpp"
+#include "keymap.hpp"
+#include "probe_retry.hpp"
+
 // Forward declarations for system headers to minimize compile dependencies
 struct udev;          //!< udev context for device enumeration
 struct udev_monitor;  //!< udev monitor for hot-plug events
 struct libevdev;      //!< libevdev device handle for input processing
 
+namespace metrics {
+class Metrics;
+}
+
 /**
  * @namespace device
  * @brief Device management functionality for keyboard input handling
@@ -55,6 +70,22 @@ struct libevdev;      //!< libevdev device handle for input processing
  */
 namespace device {
 
+/**
+ * @struct EventBatch
+ * @brief Events returned by one KeyboardDevice::read_batch() call
+ *
+ * The events point into the device's own buffer and stay valid until the
+ * next read_batch() on the same device.
+ */
+struct EventBatch {
+    const input_event* events{nullptr};  //!< First event
+    std::size_t count{0};                //!< Number of events
+    int status{0};                       //!< 0: call again; -EAGAIN: drained; other: stop
+
+    [[nodiscard]] const input_event* begin() const noexcept { return events; }
+    [[nodiscard]] const input_event* end() const noexcept { return events + count; }
+};
+
 /**
  * @class KeyboardDevice
  * @brief RAII wrapper for individual USB keyboard input devices
@@ -86,11 +117,28 @@ class KeyboardDevice {
     libevdev* evdev_{nullptr};  //!< libevdev context for event processing
     std::string path_;          //!< Device path (e.g., /dev/input/event0)
     std::string name_;          //!< Human-readable device name
+    dev_t devnum_{0};           //!< Device number of the node (st_rdev), 0 if not opened
+    int open_error_{0};         //!< errno of a failed open(), 0 otherwise
+
+    std::vector<input_event> batch_;  //!< read_batch() buffer, allocated once
+    std::vector<input_event> sync_;   //!< Synthetic resync events (batched reads only)
+    KeyBitmap delivered_;             //!< Key state handed out by batched reads
+    input_event resync_stamp_{};      //!< SYN_REPORT that ended the last dropped gap
+    std::size_t pending_begin_{0};    //!< Unfiltered events left in batch_ by a resync
+    std::size_t pending_end_{0};      //!< End of the unfiltered events
+    bool batch_reads_{false};         //!< read(2) the node directly instead of via libevdev
+    bool dropping_{false};            //!< Discarding events after SYN_DROPPED
+    bool resync_due_{false};          //!< A dropped gap ended; resync before more events
+
+    const keymap::KeymapStore* keymaps_{nullptr};  //!< --keymap (nullptr: no remapping)
+    keymap::Remapper remap_;                       //!< This keyboard's tables and held keys
 
   public:
     /**
      * @brief Construct keyboard device from device path
      * @param device_path Path to input device (e.g., "/dev/input/event0")
+     * @param quiet_open_errors Log a failed open() at debug level only (the
+     *                          caller retries and reports a final failure itself)
      *
      * Opens the device file, initializes libevdev context, and validates
      * that the device is a keyboard. If any step fails, the device will
@@ -98,7 +146,7 @@ class KeyboardDevice {
      *
      * @note Constructor does not throw exceptions - check is_valid() after construction
      */
-    explicit KeyboardDevice(const std::string& device_path);
+    explicit KeyboardDevice(const std::string& device_path, bool quiet_open_errors = false);
 
     /**
      * @brief Destructor - automatically cleans up all resources
@@ -155,6 +203,68 @@ class KeyboardDevice {
      */
     [[nodiscard]] const std::string& name() const noexcept { return name_; }
 
+    /**
+     * @brief Get the device number of the node
+     * @return st_rdev of the opened node, or 0 if it could not be opened
+     */
+    [[nodiscard]] dev_t devnum() const noexcept { return devnum_; }
+
+    /**
+     * @brief Get the reason the device node could not be opened
+     * @return errno of the failed open(), or 0 if open() succeeded
+     */
+    [[nodiscard]] int open_error() const noexcept { return open_error_; }
+
+    /**
+     * @brief Read events with read(2) in batches instead of through libevdev
+     * @param enabled true to take the direct path (`--batch-reads`)
+     *
+     * Must be set before the first read_batch(): libevdev's own queue and
+     * state are bypassed from then on.
+     */
+    void set_batch_reads(bool enabled);
+
+    [[nodiscard]] bool batch_reads() const noexcept { return batch_reads_; }
+
+    /**
+     * @brief Remap keys with the current keymap of a store
+     * @param keymaps Keymap store (`--keymap`), must outlive the device; nullptr disables
+     *
+     * The store is checked once per read_batch(), so a reload applies from
+     * the next batch on.
+     */
+    void set_keymaps(const keymap::KeymapStore* keymaps) noexcept { keymaps_ = keymaps; }
+
+    /**
+     * @brief Take or release exclusive access (EVIOCGRAB)
+     * @param grabbed true to keep keystrokes from the local host (the default
+     *                after construction), false to let the host see them too
+     * @return true on success
+     *
+     * Events are read either way.
+     */
+    bool set_grabbed(bool grabbed) noexcept;
+
+    /**
+     * @brief Read the next batch of pending events
+     * @return Up to READ_BATCH events and a status: 0 if more may be queued,
+     *         -EAGAIN once the queue is drained, LIBEVDEV_READ_STATUS_SYNC
+     *         (libevdev path) or another negative errno to stop reading
+     *
+     * By default events come from libevdev_next_event() unchanged. With batched
+     * reads one read(2) fills the buffer, which is then filtered in place down
+     * to `EV_KEY` events and `SYN_REPORT` boundaries (filter_key_frames()).
+     * After a `SYN_DROPPED` gap the next call returns the key changes missed
+     * during the gap, read back with `EVIOCGKEY`, as one synthetic frame.
+     * With a keymap, key events are remapped last and disabled keys and
+     * layer keys removed (keymap::Remapper).
+     *
+     * Does not allocate; call until status is non-zero.
+     */
+    [[nodiscard]] EventBatch read_batch();
+
+    static constexpr std::size_t READ_BATCH = 64;  //!< Events per read_batch()
+
   private:
     /**
      * @brief Clean up all allocated resources
@@ -174,6 +284,15 @@ class KeyboardDevice {
      * that also generate key events.
      */
     static bool is_keyboard_device(libevdev* dev) noexcept;
+
+    //! @brief read_batch() through libevdev_next_event()
+    EventBatch read_batch_libevdev();
+
+    //! @brief read_batch() through read(2), filter_key_frames() and build_resync()
+    EventBatch read_batch_direct();
+
+    //! @brief Remap events in place and drop the removed ones; returns the new count
+    std::size_t remap_events(input_event* events, std::size_t count) noexcept;
 };
 
 /**
@@ -201,9 +320,10 @@ class KeyboardDevice {
  */
 class DeviceMonitor {
   private:
-    udev* udev_{nullptr};             //!< udev context for device operations
-    udev_monitor* monitor_{nullptr};  //!< udev monitor for hot-plug events
-    int monitor_fd_{-1};              //!< File descriptor for polling monitor
+    udev* udev_{nullptr};               //!< udev context for device operations
+    udev_monitor* monitor_{nullptr};    //!< udev monitor for hot-plug events
+    int monitor_fd_{-1};                //!< File descriptor for polling monitor
+    NegativeProbeCache not_keyboards_;  //!< Nodes known not to be keyboards
 
   public:
     /**
@@ -240,16 +360,31 @@ class DeviceMonitor {
 
     /**
      * @brief Enumerate all existing keyboard devices in the system
-     * @return Vector of valid KeyboardDevice objects
+     * @return Vector of valid KeyboardDevice objects, in udev enumeration order
      *
      * Scans the system for input devices and creates KeyboardDevice objects
-     * for all detected keyboards. Invalid devices are filtered out.
+     * for all detected keyboards. Nodes udev classifies as something else
+     * and nodes in the negative cache are skipped without being opened; the
+     * remaining candidates are probed in parallel (see device_probe.hpp).
      * This is typically called during initialization to discover existing devices.
      *
      * @note Only returns devices that pass keyboard validation checks
      * @note Each returned device is guaranteed to be valid (is_valid() == true)
      */
-    [[nodiscard]] std::vector<KeyboardDevice> enumerate_keyboards() const;
+    [[nodiscard]] std::vector<KeyboardDevice> enumerate_keyboards();
+
+    /**
+     * @brief Number of nodes remembered as not being keyboards
+     * @return Negative cache size
+     */
+    [[nodiscard]] std::size_t cached_non_keyboards() const noexcept {
+        return not_keyboards_.size();
+    }
+
+    //! @brief Hot-plug add callback; returns NotKeyboard to have the node cached
+    using AddCallback = std::function<ProbeOutcome(const std::string&, dev_t)>;
+    //! @brief Hot-plug callback: device node path and device number (0 if udev has none)
+    using HotplugCallback = std::function<void(const std::string&, dev_t)>;
 
     /**
      * @brief Process pending hot-plug events from udev monitor
@@ -259,17 +394,20 @@ class DeviceMonitor {
      *
      * Reads events from the udev monitor and calls appropriate callbacks
      * for device addition and removal. This should be called when the
-     * monitor file descriptor becomes readable.
+     * monitor file descriptor becomes readable. Added nodes that udev does
+     * not classify as keyboards, or that are in the negative cache, never
+     * reach on_add.
      *
      * @section CallbackParameters Callback Parameters
      * - on_add: Called with device path string (e.g., "/dev/input/event0")
-     * - on_remove: Called with device path string of removed device
+     *   and the node's device number
+     * - on_remove: Called with device path string and device number of the
+     *   removed device (the node itself may already be gone)
      *
      * @note Callbacks may be called multiple times per call to process_events()
      * @note Callbacks should be lightweight to avoid blocking event processing
      */
-    bool process_events(const std::function<void(const std::string&)>& on_add,
-                        const std::function<void(const std::string&)>& on_remove) const;
+    bool process_events(const AddCallback& on_add, const HotplugCallback& on_remove);
 
   private:
     /**
@@ -281,6 +419,54 @@ class DeviceMonitor {
     void cleanup() noexcept;
 };
 
+/**
+ * @struct PollFdSet
+ * @brief View of the pollfd array cached by KeyboardManager
+ *
+ * Entry `i` for `i < keyboard_count` belongs to `KeyboardManager::keyboards()[i]`;
+ * the hot-plug entries follow the keyboards: the udev monitor and the probe
+ * retry timer (both present only if the monitor is valid).
+ * The view stays valid until the next update_devices() call that returns true.
+ * poll() may be called on it directly; only revents is written.
+ */
+struct PollFdSet {
+    pollfd* fds = nullptr;           //!< First entry of the cached array
+    std::size_t count = 0;           //!< Total number of entries
+    std::size_t keyboard_count = 0;  //!< Number of leading keyboard entries
+
+    [[nodiscard]] pollfd* begin() const noexcept { return fds; }
+    [[nodiscard]] pollfd* end() const noexcept { return fds + count; }
+
+    /**
+     * @brief Get the udev monitor entry
+     * @return Pointer to the monitor pollfd, or nullptr if there is none
+     */
+    [[nodiscard]] pollfd* monitor() const noexcept {
+        return count > keyboard_count ? fds + keyboard_count : nullptr;
+    }
+
+    /**
+     * @brief Get the probe retry timer entry
+     * @return Pointer to the timer pollfd, or nullptr if there is none
+     */
+    [[nodiscard]] pollfd* retry_timer() const noexcept {
+        return count > keyboard_count + 1 ? fds + keyboard_count + 1 : nullptr;
+    }
+
+    /**
+     * @brief Check whether poll() reported a hot-plug entry readable
+     * @return true if KeyboardManager::update_devices() has work to do
+     */
+    [[nodiscard]] bool hotplug_ready() const noexcept {
+        for (std::size_t i = keyboard_count; i < count; ++i) {
+            if (fds[i].revents & POLLIN) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
 /**
  * @class KeyboardManager
  * @brief High-level manager for multiple keyboard devices with hot-plug support
@@ -318,8 +504,13 @@ class DeviceMonitor {
  *
  * @section DevicePerformance Performance Characteristics
  * - O(1) device lookup and access operations
- * - Minimal overhead for hot-plug event processing
- * - Efficient polling with consolidated file descriptor list
+ * - Incremental hot-plug: only the added node is probed, and an add or remove
+ *   patches the pollfd array, fd map and device index in place (a removed
+ *   keyboard's slot is filled by the last one, so keyboards() order may change)
+ * - Devices are found by device number (or by path when udev reports none) in hash
+ *   indexes, never by scanning the device list
+ * - Nodes that cannot be opened yet are retried with backoff (ProbeRetryQueue)
+ * - O(1) fd → device index lookup for notifier/epoll-style dispatch
  * - Memory-efficient storage with move semantics
  *
  * @note The manager automatically handles device lifecycle management
@@ -327,8 +518,22 @@ class DeviceMonitor {
  */
 class KeyboardManager {
   private:
-    std::vector<KeyboardDevice> keyboards_;  //!< Collection of managed keyboard devices
-    DeviceMonitor monitor_;                  //!< Hot-plug event monitor
+    std::vector<KeyboardDevice> keyboards_;           //!< Collection of managed keyboard devices
+    std::vector<dev_t> devnums_;                      //!< devnums_[i] == keyboards_[i].devnum()
+    DeviceMonitor monitor_;                           //!< Hot-plug event monitor
+    std::vector<pollfd> poll_fds_;                    //!< Keyboard fds + monitor + retry timer
+    std::unordered_map<int, std::size_t> fd_index_;  //!< fd → index into keyboards_
+    ProbeRetryQueue retries_;                         //!< Added nodes waiting for another probe
+    int retry_fd_{-1};                                //!< timerfd armed for the next retry
+    metrics::Metrics* metrics_{nullptr};              //!< Hot-plug counters (--metrics), optional
+    bool batch_reads_{false};                         //!< Applied to every managed keyboard
+    const keymap::KeymapStore* keymaps_{nullptr};     //!< Applied to every managed keyboard
+    bool grabbed_{true};                              //!< Applied to every managed keyboard
+    std::unordered_set<std::string> ignored_;         //!< Nodes skipped until udev removes them
+
+    // Lookups into keyboards_, kept in step with it by index_device()
+    std::unordered_map<dev_t, std::size_t> devnum_index_;      //!< Device number → index
+    std::unordered_map<std::string, std::size_t> path_index_;  //!< Path → index (devnum 0)
 
   public:
     /**
@@ -339,6 +544,14 @@ class KeyboardManager {
      */
     KeyboardManager();
 
+    /**
+     * @brief Close the retry timer; devices are released by their destructors
+     */
+    ~KeyboardManager();
+
+    KeyboardManager(const KeyboardManager&) = delete;
+    KeyboardManager& operator=(const KeyboardManager&) = delete;
+
     /**
      * @brief Check if manager was successfully initialized
      * @return true if manager is ready for device operations
@@ -353,6 +566,15 @@ class KeyboardManager {
         return keyboards_;
     }
 
+    /**
+     * @brief Get one managed keyboard for reading events
+     * @param index Index into keyboards()
+     * @return The keyboard; read_batch() needs a non-const device
+     */
+    [[nodiscard]] KeyboardDevice& keyboard(std::size_t index) noexcept {
+        return keyboards_[index];
+    }
+
     /**
      * @brief Get number of currently managed devices
      * @return Count of valid keyboard devices
@@ -365,21 +587,30 @@ class KeyboardManager {
      */
     [[nodiscard]] int monitor_fd() const noexcept { return monitor_.monitor_fd(); }
 
+    /**
+     * @brief Get the probe retry timer for polling
+     * @return timerfd that becomes readable when a hot-plug retry is due, or -1
+     *
+     * Call update_devices() when either this fd or monitor_fd() is readable.
+     */
+    [[nodiscard]] int retry_fd() const noexcept { return retry_fd_; }
+
     /**
      * @brief Process hot-plug events and update device collection
      * @return true if the device list was modified (devices added or removed)
      *
-     * Checks for pending hot-plug events and updates the internal device
-     * collection accordingly. Should be called regularly to maintain an
-     * accurate device list.
+     * Handles pending udev events and due probe retries and updates the
+     * internal device collection accordingly. Call it when monitor_fd() or
+     * retry_fd() is readable (see PollFdSet::hotplug_ready()).
      *
      * @section EventHandling Event Handling
-     * - Device addition: Creates new KeyboardDevice and adds to collection
+     * - Device addition: Probes only the added node; a node that cannot be
+     *   opened yet (EACCES, ENOENT, ...) is retried with backoff
      * - Device removal: Removes corresponding device from collection
      * - Invalid devices: Automatically filtered out during processing
      *
      * @note This function is typically called in the main event loop
-     * @note Returns true if polling file descriptor list should be rebuilt
+     * @note Returns true if polling file descriptor list should be refreshed
      */
     bool update_devices();
 
@@ -404,27 +635,142 @@ class KeyboardManager {
      * @note The last file descriptor in the vector is always the monitor FD
      * @note Only valid devices are included in the returned vector
      * @note Vector should be rebuilt after calling update_devices() if it returns true
+     * @note Allocates on every call; hot loops should use poll_fds() instead
+     * @note Does not include retry_fd(); use poll_fds() to get hot-plug retries
      */
     [[nodiscard]] std::vector<int> get_poll_fds() const;
 
+    /**
+     * @brief Get the cached pollfd array for all keyboards plus the monitor
+     * @return View whose keyboard entries are index-aligned with keyboards()
+     *
+     * The array is owned by the manager and only rebuilt when update_devices()
+     * adds or removes a device, so polling it costs no allocation.
+     *
+     * @code
+     * auto set = manager.poll_fds();
+     * if (poll(set.fds, set.count, -1) > 0) {
+     *     for (std::size_t i = 0; i < set.keyboard_count; ++i) {
+     *         if (set.fds[i].revents & POLLIN) {
+     *             handle(manager.keyboards()[i]);
+     *         }
+     *     }
+     * }
+     * @endcode
+     */
+    [[nodiscard]] PollFdSet poll_fds() noexcept {
+        return {poll_fds_.data(), poll_fds_.size(), keyboards_.size()};
+    }
+
+    /**
+     * @brief Find the keyboard that owns a file descriptor
+     * @param fd Device file descriptor (e.g. from a readiness notification)
+     * @return Index into keyboards(), or nullopt if no managed keyboard uses fd
+     */
+    [[nodiscard]] std::optional<std::size_t> device_index_for_fd(int fd) const noexcept {
+        if (const auto it = fd_index_.find(fd); it != fd_index_.end()) {
+            return it->second;
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Count hot-plug additions and removals in a metrics registry
+     * @param registry Metrics registry, or nullptr to stop; must outlive the manager
+     *
+     * Keyboards found at start-up are not counted as additions.
+     */
+    void set_metrics(metrics::Metrics* registry) noexcept { metrics_ = registry; }
+
+    /**
+     * @brief Read every keyboard, current and hot-plugged, with batched read(2)
+     * @param enabled true for `--batch-reads`
+     * @see KeyboardDevice::set_batch_reads()
+     */
+    void set_batch_reads(bool enabled);
+
+    /**
+     * @brief Remap every keyboard, current and hot-plugged, with a keymap store
+     * @param keymaps Store (`--keymap`), must outlive the manager; nullptr disables
+     * @see KeyboardDevice::set_keymaps()
+     */
+    void set_keymaps(const keymap::KeymapStore* keymaps) noexcept;
+
+    /**
+     * @brief Grab or release every keyboard, current and hot-plugged
+     * @param grabbed false hands the keyboards back to the local host
+     * @see KeyboardDevice::set_grabbed()
+     */
+    void set_grabbed(bool grabbed) noexcept;
+
+    [[nodiscard]] bool grabbed() const noexcept { return grabbed_; }
+
+    /**
+     * @brief Never manage a node, e.g. a uinput keyboard the bridge writes itself
+     * @param device_path Device node such as /dev/input/event7 (empty: ignored)
+     * @return true if the node was managed and has been dropped
+     *
+     * Call it before the next update_devices() so the node's add event is skipped.
+     */
+    bool ignore_device(const std::string& device_path);
+
   private:
     /**
-     * @brief Add new keyboard device to managed collection
+     * @brief Find a managed keyboard
+     * @param devnum Device number (0: unknown, match by path)
+     * @param device_path Device path
+     * @return Index into keyboards_, or nullopt
+     */
+    [[nodiscard]] std::optional<std::size_t> find_device(dev_t devnum,
+                                                         const std::string& device_path) const;
+
+    /**
+     * @brief Point the device number and path indexes at keyboards_[index]
+     * @param index Index into keyboards_ and devnums_
+     */
+    void index_device(std::size_t index);
+
+    /**
+     * @brief Probe a hot-plugged node and add it if it is a keyboard
      * @param device_path Path to the new input device
+     * @param devnum Device number from udev (0 if unknown)
+     * @param failures Failed probes of this node so far
+     * @return Added, NotKeyboard if the node opened but is not a keyboard, or Skipped
      *
      * Creates a KeyboardDevice for the specified path and adds it to
-     * the collection if it's valid. Invalid devices are ignored.
+     * the collection if it's valid. Invalid devices are ignored; nodes
+     * that cannot be opened yet are scheduled for a retry.
      */
-    void add_device(const std::string& device_path);
+    ProbeOutcome add_device(const std::string& device_path, dev_t devnum, int failures = 0);
 
     /**
      * @brief Remove keyboard device from managed collection
      * @param device_path Path of the device to remove
+     * @param devnum Device number from udev (0 if unknown)
+     * @return true if a keyboard was removed
+     *
+     * Removes the device from the collection and cancels a pending retry of
+     * the node. The device's destructor will handle cleanup.
+     */
+    bool remove_device(const std::string& device_path, dev_t devnum);
+
+    /**
+     * @brief Probe every node whose retry is due and re-arm the timer
+     * @return true if a keyboard was added
+     */
+    bool process_retries();
+
+    /**
+     * @brief Arm retry_fd_ for the earliest pending retry (or disarm it)
+     */
+    void arm_retry_timer() const;
+
+    /**
+     * @brief Rebuild the cached pollfd array and fd → index map
      *
-     * Finds and removes the device with the specified path from the
-     * collection. The device's destructor will handle cleanup.
+     * Called after construction; hot-plug changes patch the array in place.
      */
-    void remove_device(const std::string& device_path);
+    void rebuild_poll_fds();
 };
 
 }  // namespace device
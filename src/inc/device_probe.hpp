@@ -0,0 +1,151 @@
+/**
+ * @file device_probe.hpp
+ * @brief Helpers that keep input node probing off the cold-start critical path
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * Bridge hardware exposes many `/dev/input/event*` nodes (touchpads, power
+ * buttons, HDMI-CEC, consumer-control interfaces), and opening one can take
+ * long (the driver may wake the device). DeviceMonitor therefore:
+ *
+ * 1. skips every node udev has already classified as something other than
+ *    a keyboard (`ID_INPUT_KEYBOARD`), without opening it;
+ * 2. probes the remaining candidates concurrently on a few worker threads;
+ * 3. remembers nodes that turned out not to be keyboards in a
+ *    NegativeProbeCache and skips them on later scans and hot-plug events.
+ *
+ * Nothing here touches udev or evdev, so the pieces are unit-testable.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace device {
+
+//! @brief What udev's input_id builtin says about a node
+enum class UdevKeyboardClass {
+    Keyboard,     //!< ID_INPUT_KEYBOARD=1: probe it
+    NotKeyboard,  //!< Classified by udev, but not as a keyboard: skip without opening
+    Unknown       //!< No udev classification (no rules, container): probe it
+};
+
+/**
+ * @brief Classify a node from its udev properties
+ * @param id_input Value of ID_INPUT (nullptr if unset)
+ * @param id_input_keyboard Value of ID_INPUT_KEYBOARD (nullptr if unset)
+ * @return Classification; Unknown unless udev has classified the node at all
+ */
+[[nodiscard]] inline UdevKeyboardClass classify_udev_properties(
+    const char* id_input, const char* id_input_keyboard) noexcept {
+    if (id_input_keyboard && std::strcmp(id_input_keyboard, "1") == 0) {
+        return UdevKeyboardClass::Keyboard;
+    }
+    if (id_input && std::strcmp(id_input, "1") == 0) {
+        return UdevKeyboardClass::NotKeyboard;
+    }
+    return UdevKeyboardClass::Unknown;
+}
+
+//! @brief Result of probing a hot-plugged node
+enum class ProbeOutcome {
+    Added,        //!< A keyboard was added
+    NotKeyboard,  //!< The node opened but is not a keyboard: cache it
+    Skipped       //!< Already managed, retry scheduled or open failed: do not cache
+};
+
+/**
+ * @class NegativeProbeCache
+ * @brief Nodes known not to be keyboards, keyed by udev syspath
+ *
+ * The syspath (`/sys/devices/.../input/input17/event5`) names one device
+ * instance: it is never reused after unplugging, unlike `/dev/input/eventN`
+ * or the device number. Entries are dropped on the node's remove event.
+ *
+ * @note Not thread-safe; used by DeviceMonitor on the thread that owns it
+ */
+class NegativeProbeCache {
+  private:
+    std::unordered_set<std::string> syspaths_;  //!< Rejected nodes
+
+  public:
+    void insert(const std::string& syspath) { syspaths_.insert(syspath); }
+
+    [[nodiscard]] bool contains(const std::string& syspath) const {
+        return syspaths_.count(syspath) != 0;
+    }
+
+    /**
+     * @brief Forget a node (it was removed)
+     * @param syspath udev syspath
+     * @return true if the node was cached
+     */
+    bool erase(const std::string& syspath) { return syspaths_.erase(syspath) != 0; }
+
+    [[nodiscard]] std::size_t size() const noexcept { return syspaths_.size(); }
+};
+
+//! @brief Upper bound on probe threads; opens are I/O-bound, not CPU-bound
+inline constexpr std::size_t MAX_PROBE_WORKERS = 8;
+
+/**
+ * @brief Number of threads to probe a set of candidates with
+ * @param candidates Nodes to probe
+ * @param hardware_threads std::thread::hardware_concurrency() (0 if unknown)
+ * @return Between 1 and MAX_PROBE_WORKERS, never more than @p candidates
+ *
+ * Slow opens block in the kernel rather than use the CPU, so at least two
+ * workers are used even on a single core.
+ */
+[[nodiscard]] inline std::size_t probe_worker_count(std::size_t candidates,
+                                                    unsigned hardware_threads) noexcept {
+    const std::size_t wanted = std::max<std::size_t>(2, hardware_threads);
+    return std::max<std::size_t>(1, std::min({candidates, wanted, MAX_PROBE_WORKERS}));
+}
+
+/**
+ * @brief Call fn(i) for every i in [0, count) on up to @p workers threads
+ * @param count Number of items
+ * @param workers Thread count (1: run inline on the calling thread)
+ * @param fn Callable taking std::size_t; must be safe to run concurrently
+ *           for different indices
+ *
+ * Workers take the next index from a shared counter, so one slow item does
+ * not hold up the others. Returns once every item is done.
+ */
+template <typename Fn>
+void parallel_for(std::size_t count, std::size_t workers, Fn&& fn) {
+    workers = std::min(workers, count);
+    if (workers <= 1) {
+        for (std::size_t i = 0; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next{0};
+    auto work = [&]() {
+        for (std::size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            fn(i);
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (std::size_t t = 1; t < workers; ++t) {
+        threads.emplace_back(work);
+    }
+    work();  // The calling thread is one of the workers
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+}  // namespace device
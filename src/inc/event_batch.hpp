@@ -0,0 +1,190 @@
+/**
+ * @file event_batch.hpp
+ * @brief Batch filtering and SYN_DROPPED resync for direct evdev reads
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * With `--batch-reads`, KeyboardDevice read()s whole arrays of
+ * `struct input_event` from the node instead of pulling events one at a
+ * time through libevdev. The helpers here do the work libevdev would
+ * otherwise do for that path, on caller-owned buffers:
+ *
+ * - filter_key_frames() compacts a batch in place down to `EV_KEY` events
+ *   and `SYN_REPORT` frame boundaries, and drops everything from a
+ *   `SYN_DROPPED` up to the next `SYN_REPORT` (the kernel queue overflowed);
+ * - build_resync() turns the difference between the key state delivered so
+ *   far and the state read back with `EVIOCGKEY` into synthetic key events
+ *   closed by a `SYN_REPORT`.
+ *
+ * Nothing here allocates or touches a file descriptor, so the pieces are
+ * unit-testable.
+ */
+
+#pragma once
+
+#include <array>
+#include <climits>
+#include <cstddef>
+
+#include <linux/input.h>
+
+namespace device {
+
+/**
+ * @class KeyBitmap
+ * @brief Pressed/released state of every `EV_KEY` code
+ *
+ * Same layout as the buffer filled by the `EVIOCGKEY` ioctl, so data() and
+ * byte_size() can be passed to it directly.
+ */
+class KeyBitmap {
+  public:
+    static constexpr std::size_t WORD_BITS = sizeof(unsigned long) * CHAR_BIT;
+    static constexpr std::size_t WORDS = (KEY_CNT + WORD_BITS - 1) / WORD_BITS;
+
+  private:
+    std::array<unsigned long, WORDS> words_{};  //!< One bit per key code
+
+  public:
+    /**
+     * @brief Record a key event
+     * @param code EV_KEY code; out-of-range codes are ignored
+     * @param pressed true for press or autorepeat, false for release
+     */
+    void set(unsigned code, bool pressed) noexcept {
+        if (code >= KEY_CNT) {
+            return;
+        }
+        const unsigned long bit = 1UL << (code % WORD_BITS);
+        if (pressed) {
+            words_[code / WORD_BITS] |= bit;
+        } else {
+            words_[code / WORD_BITS] &= ~bit;
+        }
+    }
+
+    [[nodiscard]] bool test(unsigned code) const noexcept {
+        return code < KEY_CNT && (words_[code / WORD_BITS] >> (code % WORD_BITS)) & 1UL;
+    }
+
+    void clear() noexcept { words_.fill(0); }
+
+    [[nodiscard]] unsigned long* data() noexcept { return words_.data(); }
+    [[nodiscard]] const unsigned long* data() const noexcept { return words_.data(); }
+    [[nodiscard]] static constexpr std::size_t byte_size() noexcept {
+        return WORDS * sizeof(unsigned long);
+    }
+
+    [[nodiscard]] bool operator==(const KeyBitmap& other) const noexcept {
+        return words_ == other.words_;
+    }
+    [[nodiscard]] bool operator!=(const KeyBitmap& other) const noexcept {
+        return !(*this == other);
+    }
+};
+
+//! @brief Worst-case output of build_resync(): every key changed plus the SYN_REPORT
+inline constexpr std::size_t MAX_RESYNC_EVENTS = KEY_CNT + 1;
+
+//! @brief Result of filter_key_frames()
+struct FilterResult {
+    std::size_t kept = 0;     //!< Events left at the front of the buffer
+    std::size_t scanned = 0;  //!< Input events consumed; less than count after a resync
+    bool resync = false;      //!< A SYN_DROPPED gap ended at events[scanned - 1]
+};
+
+/**
+ * @brief Compact a batch of raw events to key events and frame boundaries
+ * @param events Events as read from the node; overwritten in place
+ * @param count Number of events
+ * @param delivered Key state of every event delivered so far; updated with
+ *                  the kept events
+ * @param dropping Carried across calls: true while discarding after a
+ *                 SYN_DROPPED whose closing SYN_REPORT has not been read yet
+ * @return Kept/scanned counts
+ *
+ * Everything but `EV_KEY` and `SYN_REPORT` is dropped. A `SYN_DROPPED` also
+ * discards the part of the current frame that is still in this batch. Scanning
+ * stops right after the `SYN_REPORT` that ends a dropped gap (`resync` set):
+ * the caller must deliver the kept events, then build_resync(), and only then
+ * filter the rest of the batch (starting at @c scanned).
+ */
+[[nodiscard]] inline FilterResult filter_key_frames(input_event* events, std::size_t count,
+                                                    KeyBitmap& delivered, bool& dropping) noexcept {
+    FilterResult result;
+    std::size_t frame_start = 0;  // First kept event of the frame still open
+    std::size_t i = 0;
+    for (; i < count; ++i) {
+        const input_event& ev = events[i];
+        if (dropping) {
+            if (ev.type == EV_SYN && ev.code == SYN_REPORT) {
+                dropping = false;
+                result.resync = true;
+                ++i;
+                break;
+            }
+            continue;
+        }
+        if (ev.type == EV_KEY) {
+            events[result.kept++] = ev;
+        } else if (ev.type == EV_SYN && ev.code == SYN_REPORT) {
+            events[result.kept++] = ev;
+            frame_start = result.kept;
+        } else if (ev.type == EV_SYN && ev.code == SYN_DROPPED) {
+            result.kept = frame_start;
+            dropping = true;
+        }
+    }
+    result.scanned = i;
+
+    for (std::size_t k = 0; k < result.kept; ++k) {
+        if (events[k].type == EV_KEY) {
+            delivered.set(events[k].code, events[k].value != 0);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Synthesize the key events that bring @p delivered in line with @p actual
+ * @param delivered Key state the consumer has seen; set to @p actual
+ * @param actual Key state read back from the device (EVIOCGKEY)
+ * @param stamp Event whose timestamp the synthetic events carry (the
+ *              SYN_REPORT that ended the gap)
+ * @param out Output buffer
+ * @param capacity Size of @p out; MAX_RESYNC_EVENTS always suffices
+ * @return Number of events written: releases first, then presses, then a
+ *         SYN_REPORT; 0 if nothing changed
+ *
+ * Releases go first so a modifier let go during the gap cannot combine with
+ * a key pressed during it. Changes beyond @p capacity are dropped.
+ */
+inline std::size_t build_resync(KeyBitmap& delivered, const KeyBitmap& actual,
+                                const input_event& stamp, input_event* out,
+                                std::size_t capacity) noexcept {
+    if (delivered == actual || capacity == 0) {
+        return 0;
+    }
+
+    std::size_t n = 0;
+    for (const bool pressed : {false, true}) {
+        for (unsigned code = 0; code < KEY_CNT && n + 1 < capacity; ++code) {
+            if (delivered.test(code) != actual.test(code) && actual.test(code) == pressed) {
+                out[n] = stamp;
+                out[n].type = EV_KEY;
+                out[n].code = static_cast<decltype(out[n].code)>(code);
+                out[n].value = pressed ? 1 : 0;
+                ++n;
+            }
+        }
+    }
+    out[n] = stamp;
+    out[n].type = EV_SYN;
+    out[n].code = SYN_REPORT;
+    out[n].value = 0;
+    delivered = actual;
+    return n + 1;
+}
+
+}  // namespace device
@@ -0,0 +1,87 @@
+/**
+ * @file gatt_cache.hpp
+ * @brief Persistent cache of the last BLE device and report characteristic
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * Scanning (up to --scan-timeout) and full GATT discovery dominate the time
+ * from start-up to the first HID report. After a successful connection the
+ * device address and the service/characteristic UUIDs are written to a small
+ * text file; the next start connects to that address directly and only
+ * discovers the cached service. main.cpp falls back to a normal scan when
+ * the cached device cannot be reached or no longer exposes the
+ * characteristic.
+ *
+ * @section CacheFormat File Format
+ * @code
+ * ninja_util-gatt-cache 1
+ * address=AA:BB:CC:DD:EE:FF
+ * name=NinjaUSB
+ * service={0000ffe0-0000-1000-8000-00805f9b34fb}
+ * characteristic={0000ffe1-0000-1000-8000-00805f9b34fb}
+ * @endcode
+ */
+
+#pragma once
+
+#include <optional>
+#include <string>
+
+namespace ble {
+
+//! @brief Time allowed for a cached reconnect (connect and discovery) before falling back to a scan
+inline constexpr int FAST_RECONNECT_TIMEOUT_MS = 5000;
+
+/**
+ * @struct GattCacheEntry
+ * @brief Everything needed to reconnect without scanning
+ */
+struct GattCacheEntry {
+    std::string address;              //!< Device MAC address (AA:BB:CC:DD:EE:FF)
+    std::string name;                 //!< Device name at the time it was cached (informational)
+    std::string service_uuid;         //!< Service holding the report characteristic
+    std::string characteristic_uuid;  //!< Writable characteristic used for reports
+
+    /**
+     * @brief Check whether the entry can be used for a direct reconnect
+     * @return true if address, service and characteristic are all set
+     */
+    [[nodiscard]] bool is_valid() const noexcept {
+        return !address.empty() && !service_uuid.empty() && !characteristic_uuid.empty();
+    }
+
+    /**
+     * @brief Check whether the entry satisfies a --target selection
+     * @param target Address or name given with --target (empty: any device)
+     * @return true if the cached device may be used for this target
+     */
+    [[nodiscard]] bool matches_target(const std::string& target) const;
+};
+
+/**
+ * @brief Get the default cache file location
+ * @return `$XDG_CACHE_HOME/ninja_util/gatt_cache`, falling back to
+ *         `$HOME/.cache/ninja_util/gatt_cache`, or an empty string if neither is set
+ */
+[[nodiscard]] std::string default_gatt_cache_path();
+
+/**
+ * @brief Read a cache file
+ * @param path Cache file path
+ * @return Cached entry, or nullopt if the file is missing, malformed or incomplete
+ */
+[[nodiscard]] std::optional<GattCacheEntry> load_gatt_cache(const std::string& path);
+
+/**
+ * @brief Write a cache file, creating its directory if needed
+ * @param path Cache file path
+ * @param entry Entry to store
+ * @return true on success
+ *
+ * The file is written to a temporary name and renamed into place, so a
+ * crash never leaves a half-written cache behind.
+ */
+bool save_gatt_cache(const std::string& path, const GattCacheEntry& entry);
+
+}  // namespace ble
@@ -24,6 +24,10 @@
  * - Byte 1: Reserved (always 0)
  * - Bytes 2-7: Up to 6 simultaneous key codes (non-modifier keys)
  *
+ * Peripherals that offer them also take an NKRO report (modifier byte plus
+ * a 16-byte bitmap of usages 0x00-0x7F) and a 2-byte consumer-control
+ * report; see ReportId.
+ *
  * @section KeyMapping Key Mapping
  * The module provides bidirectional mapping:
  * - Linux KEY_* codes → USB HID usage codes
@@ -61,10 +65,10 @@
 // ---------------------------------------------------------------------------
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <optional>
-#include <set>
-#include <unordered_map>
+#include <type_traits>
 
 #include <linux/input-event-codes.h>  // Linux KEY_* codes
 
@@ -97,6 +101,39 @@ constexpr std::size_t KEYBOARD_REPORT_SIZE = 8;
  */
 constexpr std::size_t CONSUMER_REPORT_SIZE = 2;
 
+/**
+ * @brief Number of keyboard usages covered by the NKRO bitmap
+ *
+ * Usages 0x00-0x7F hold every mapped non-modifier key; modifiers keep their
+ * own byte as in the boot report.
+ */
+constexpr std::size_t NKRO_USAGE_COUNT = 128;
+
+/**
+ * @brief Size of the NKRO bitmap in bytes (bit n of byte n / 8 = usage n)
+ */
+constexpr std::size_t NKRO_BITMAP_SIZE = NKRO_USAGE_COUNT / 8;
+
+/**
+ * @brief Size of HID NKRO keyboard report in bytes
+ *
+ * One modifier byte followed by the usage bitmap; 17 bytes fit a single
+ * write at the default ATT MTU.
+ */
+constexpr std::size_t NKRO_REPORT_SIZE = 1 + NKRO_BITMAP_SIZE;
+
+/**
+ * @brief HID report IDs of the reports sent to the peripheral
+ *
+ * Match the Report Reference descriptor (0x2908) of the characteristic each
+ * report is written to.
+ */
+enum class ReportId : std::uint8_t {
+    Keyboard = 1,  //!< 8-byte boot keyboard report
+    Consumer = 2,  //!< 2-byte consumer-control report (one usage, little-endian)
+    Nkro = 3       //!< NKRO_REPORT_SIZE-byte bitmap keyboard report
+};
+
 /**
  * @brief Maximum number of simultaneous non-modifier keys
  *
@@ -120,10 +157,35 @@ constexpr std::uint8_t MODIFIER_BASE = 0xE0;
  */
 constexpr std::uint8_t MODIFIER_MAX = 0xE7;
 
+/**
+ * @brief Number of slots in the flat KEY_* lookup tables
+ *
+ * Linux key codes are dense and bounded by KEY_MAX, so a table indexed by
+ * the code itself covers every possible EV_KEY event.
+ */
+constexpr std::size_t KEYCODE_TABLE_SIZE = KEY_MAX + 1;
+
+/**
+ * @brief Sentinel stored in the flat tables for unmapped key codes
+ *
+ * Usage 0x00 is "Reserved (no event indicated)" on both the Keyboard and
+ * Consumer pages, so it never appears as a real mapping.
+ */
+constexpr std::uint8_t NO_USAGE = 0x00;
+
 // ---------------------------------------------------------------------------
 //  Key Mapping Tables
 // ---------------------------------------------------------------------------
 
+/**
+ * @brief One row of a Linux KEY_* → HID usage mapping table
+ * @tparam Usage Usage code type (8-bit keyboard page, 16-bit consumer page)
+ */
+template <typename Usage> struct UsageEntry {
+    int linux_code;  //!< Linux KEY_* code
+    Usage usage;     //!< HID usage ID on the table's usage page
+};
+
 /**
  * @brief Mapping from Linux KEY_* codes to USB HID keyboard usage codes
  *
@@ -147,8 +209,9 @@ constexpr std::uint8_t MODIFIER_MAX = 0xE7;
  *
  * @note Only includes keys that have direct HID equivalents
  * @note Modifier keys are handled separately in the modifier bitmap
+ * @note Source table only; lookups go through the flat kKeyboardUsageTable
  */
-inline const std::unordered_map<int, std::uint8_t> kKeyboardUsage = {
+inline constexpr UsageEntry<std::uint8_t> kKeyboardUsage[] = {
     /* Alphabet */
     {KEY_A, 0x04},
     {KEY_B, 0x05},
@@ -281,7 +344,12 @@ inline const std::unordered_map<int, std::uint8_t> kKeyboardUsage = {
     {KEY_WAKEUP, 0x69},
 };
 
-inline const std::unordered_map<int, std::uint16_t> kConsumerUsage = {
+/**
+ * @brief Mapping from Linux KEY_* codes to Consumer Control usage codes (page 0x0C)
+ *
+ * @note Source table only; lookups go through the flat kConsumerUsageTable
+ */
+inline constexpr UsageEntry<std::uint16_t> kConsumerUsage[] = {
     {KEY_VOLUMEUP, 0x00E9},       {KEY_VOLUMEDOWN, 0x00EA}, {KEY_MUTE, 0x00E2},
     {KEY_PLAYPAUSE, 0x00CD},      {KEY_NEXTSONG, 0x00B5},   {KEY_PREVIOUSSONG, 0x00B6},
     {KEY_STOPCD, 0x00B7},         {KEY_EJECTCD, 0x00B8},    {KEY_BRIGHTNESSUP, 0x006F},
@@ -290,6 +358,52 @@ inline const std::unordered_map<int, std::uint16_t> kConsumerUsage = {
     {KEY_BOOKMARKS, 0x022A},
 };
 
+/**
+ * @brief Expand a mapping table into a flat array indexed by Linux key code
+ * @tparam Usage Usage code type
+ * @tparam N Number of table rows
+ * @param entries Source mapping table
+ * @return Array of KEYCODE_TABLE_SIZE usages, NO_USAGE for unmapped codes
+ *
+ * Evaluated at compile time, so the resulting tables need no static
+ * initialization. For duplicated codes the first row wins, matching the
+ * previous std::unordered_map initializer-list semantics.
+ */
+template <typename Usage, std::size_t N>
+[[nodiscard]] constexpr std::array<Usage, KEYCODE_TABLE_SIZE>
+make_usage_table(const UsageEntry<Usage> (&entries)[N]) noexcept {
+    std::array<Usage, KEYCODE_TABLE_SIZE> table{};
+    for (std::size_t i = N; i-- > 0;) {
+        table[static_cast<std::size_t>(entries[i].linux_code)] = entries[i].usage;
+    }
+    return table;
+}
+
+/**
+ * @brief Check that every row of a mapping table fits the flat table
+ * @return true if all codes are in [0, KEY_MAX] and no usage equals NO_USAGE
+ */
+template <typename Usage, std::size_t N>
+[[nodiscard]] constexpr bool usage_table_is_valid(const UsageEntry<Usage> (&entries)[N]) noexcept {
+    for (const auto& entry : entries) {
+        if (entry.linux_code < 0 || entry.linux_code > KEY_MAX || entry.usage == NO_USAGE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(usage_table_is_valid(kKeyboardUsage), "kKeyboardUsage row out of range");
+static_assert(usage_table_is_valid(kConsumerUsage), "kConsumerUsage row out of range");
+
+//! @brief Flat KEY_* → keyboard usage table (NO_USAGE for unmapped codes)
+inline constexpr std::array<std::uint8_t, KEYCODE_TABLE_SIZE> kKeyboardUsageTable =
+    make_usage_table(kKeyboardUsage);
+
+//! @brief Flat KEY_* → consumer usage table (NO_USAGE for unmapped codes)
+inline constexpr std::array<std::uint16_t, KEYCODE_TABLE_SIZE> kConsumerUsageTable =
+    make_usage_table(kConsumerUsage);
+
 // ---------------------------------------------------------------------------
 //  Helper utilities
 // ---------------------------------------------------------------------------
@@ -305,12 +419,16 @@ inline const std::unordered_map<int, std::uint16_t> kConsumerUsage = {
  * @brief Look up HID usage code for a Linux key code
  * @param linux_code Linux input event code
  * @return HID usage code if found, nullopt otherwise
+ *
+ * Single bounds check plus one array load; negative codes wrap to large
+ * unsigned values and fail the same comparison.
  */
-[[nodiscard]] inline std::optional<std::uint8_t> get_keyboard_usage(int linux_code) noexcept {
-    if (const auto it = kKeyboardUsage.find(linux_code); it != kKeyboardUsage.end()) {
-        return it->second;
+[[nodiscard]] constexpr std::optional<std::uint8_t> get_keyboard_usage(int linux_code) noexcept {
+    const auto index = static_cast<std::size_t>(static_cast<unsigned int>(linux_code));
+    if (index >= KEYCODE_TABLE_SIZE || kKeyboardUsageTable[index] == NO_USAGE) {
+        return std::nullopt;
     }
-    return std::nullopt;
+    return kKeyboardUsageTable[index];
 }
 
 /**
@@ -318,38 +436,77 @@ inline const std::unordered_map<int, std::uint16_t> kConsumerUsage = {
  * @param linux_code Linux input event code
  * @return Consumer usage code if found, nullopt otherwise
  */
-[[nodiscard]] inline std::optional<std::uint16_t> get_consumer_usage(int linux_code) noexcept {
-    if (const auto it = kConsumerUsage.find(linux_code); it != kConsumerUsage.end()) {
-        return it->second;
+[[nodiscard]] constexpr std::optional<std::uint16_t> get_consumer_usage(int linux_code) noexcept {
+    const auto index = static_cast<std::size_t>(static_cast<unsigned int>(linux_code));
+    if (index >= KEYCODE_TABLE_SIZE || kConsumerUsageTable[index] == NO_USAGE) {
+        return std::nullopt;
     }
-    return std::nullopt;
+    return kConsumerUsageTable[index];
 }
 
 /**
  * @brief Represents the state of a HID keyboard
+ *
+ * Non-modifier keys are tracked in a 256-bit bitmap indexed by HID usage,
+ * plus a fixed array holding the (up to six) keys currently in the report
+ * in press order. Keys pressed beyond the 6KRO limit stay in the bitmap and
+ * take over a report slot as soon as one is released (lowest usage first).
+ * No member allocates, and the whole state is trivially copyable so it can
+ * be snapshotted by value.
  */
 class KeyboardState {
+  public:
+    static constexpr std::size_t BITMAP_WORDS = 4;  //!< 256 usage codes, 64 per word
+
+    //! @brief Non-modifier usages as a bitmap: bit n % 64 of word n / 64 for usage n
+    using KeyBitmap = std::array<std::uint64_t, BITMAP_WORDS>;
+
   private:
-    std::uint8_t modifiers_{0};
-    std::set<std::uint8_t> pressed_keys_;  // Non‑modifier HID codes
+    std::uint8_t modifiers_{0};                                //!< Modifier bitmap (report byte 0)
+    KeyBitmap pressed_{};                                      //!< Non-modifier HID codes held down
+    std::array<std::uint8_t, MAX_SIMULTANEOUS_KEYS> slots_{};  //!< Reported keys, in press order
+    std::uint8_t slot_count_{0};                               //!< Used entries in slots_
+    std::uint16_t pressed_count_{0};                           //!< Number of bits set in pressed_
     mutable std::array<std::uint8_t, KEYBOARD_REPORT_SIZE> report_{};
     mutable bool report_dirty_{true};
 
+    [[nodiscard]] static constexpr std::uint64_t bit_of(std::uint8_t hid_code) noexcept {
+        return std::uint64_t{1} << (hid_code & 63U);
+    }
+
+    /**
+     * @brief Move held-but-unreported keys into free report slots
+     *
+     * Only does work while more than six keys are held; each promoted key
+     * costs one bit-scan over the bitmap minus the already reported keys.
+     */
+    void fill_free_slots() noexcept {
+        if (pressed_count_ <= slot_count_) {
+            return;
+        }
+
+        auto candidates = pressed_;
+        for (std::size_t i = 0; i < slot_count_; ++i) {
+            candidates[slots_[i] >> 6] &= ~bit_of(slots_[i]);
+        }
+
+        for (std::size_t word = 0; word < BITMAP_WORDS; ++word) {
+            while (candidates[word] != 0 && slot_count_ < MAX_SIMULTANEOUS_KEYS) {
+                const auto bit = static_cast<unsigned int>(__builtin_ctzll(candidates[word]));
+                candidates[word] &= candidates[word] - 1;  // Clear lowest set bit
+                slots_[slot_count_++] = static_cast<std::uint8_t>(word * 64 + bit);
+            }
+        }
+    }
+
     void update_report() const noexcept {
         if (!report_dirty_)
             return;
 
         report_.fill(0);
         report_[0] = modifiers_;
-
-        std::size_t idx = 2;
-        for (const auto key : pressed_keys_) {
-            if (idx < report_.size()) {
-                report_[idx++] = key;
-            } else {
-                // Handle key rollover - could implement NKRO or 6KRO behavior
-                break;
-            }
+        for (std::size_t i = 0; i < slot_count_; ++i) {
+            report_[2 + i] = slots_[i];
         }
         report_dirty_ = false;
     }
@@ -373,10 +530,47 @@ class KeyboardState {
 
     /**
      * @brief Get number of currently pressed non-modifier keys
-     * @return Number of pressed keys
+     * @return Number of pressed keys (may exceed the six reported ones)
      */
-    [[nodiscard]] std::size_t get_pressed_key_count() const noexcept {
-        return pressed_keys_.size();
+    [[nodiscard]] std::size_t get_pressed_key_count() const noexcept { return pressed_count_; }
+
+    /**
+     * @brief Get the keys held beyond the six in the report, as an NKRO bitmap
+     * @return Bit n of byte n / 8 set for held usage n missing from get_report()
+     *
+     * All zeros (without scanning) while at most six keys are held.
+     */
+    [[nodiscard]] std::array<std::uint8_t, NKRO_BITMAP_SIZE> get_overflow_bitmap() const noexcept {
+        std::array<std::uint8_t, NKRO_BITMAP_SIZE> bitmap{};
+        if (pressed_count_ <= slot_count_) {
+            return bitmap;
+        }
+        auto hidden = pressed_;
+        for (std::size_t i = 0; i < slot_count_; ++i) {
+            hidden[slots_[i] >> 6] &= ~bit_of(slots_[i]);
+        }
+        for (std::size_t byte = 0; byte < NKRO_BITMAP_SIZE; ++byte) {
+            bitmap[byte] = static_cast<std::uint8_t>(hidden[byte / 8] >> ((byte % 8) * 8));
+        }
+        return bitmap;
+    }
+
+    /**
+     * @brief Get every non-modifier key held down
+     * @return Bitmap of held usages, including those beyond the six report slots
+     */
+    [[nodiscard]] const KeyBitmap& get_pressed_bitmap() const noexcept { return pressed_; }
+
+    /**
+     * @brief Check whether a key is currently held down
+     * @param hid_code HID usage code (modifier or regular key)
+     * @return true if the key is pressed
+     */
+    [[nodiscard]] bool is_key_pressed(std::uint8_t hid_code) const noexcept {
+        if (is_modifier(hid_code)) {
+            return (modifiers_ & modifier_bit(hid_code)) != 0;
+        }
+        return (pressed_[hid_code >> 6] & bit_of(hid_code)) != 0;
     }
 
     /**
@@ -391,6 +585,8 @@ class KeyboardState {
      * @param pressed True for press, false for release
      */
     void set_key_state(std::uint8_t hid_code, bool pressed) noexcept {
+        report_dirty_ = true;
+
         if (is_modifier(hid_code)) {
             const auto bit = modifier_bit(hid_code);
             if (pressed) {
@@ -398,14 +594,41 @@ class KeyboardState {
             } else {
                 modifiers_ &= ~bit;
             }
-        } else {
-            if (pressed) {
-                pressed_keys_.insert(hid_code);
-            } else {
-                pressed_keys_.erase(hid_code);
+            return;
+        }
+
+        auto& word = pressed_[hid_code >> 6];
+        const auto bit = bit_of(hid_code);
+        const bool was_pressed = (word & bit) != 0;
+
+        if (pressed) {
+            if (was_pressed) {
+                return;  // Auto-repeat, keep the existing slot
+            }
+            word |= bit;
+            ++pressed_count_;
+            if (slot_count_ < MAX_SIMULTANEOUS_KEYS) {
+                slots_[slot_count_++] = hid_code;
+            }
+            return;
+        }
+
+        if (!was_pressed) {
+            return;
+        }
+        word &= ~bit;
+        --pressed_count_;
+        for (std::size_t i = 0; i < slot_count_; ++i) {
+            if (slots_[i] == hid_code) {
+                // Close the gap so the remaining keys keep their press order
+                for (std::size_t j = i + 1; j < slot_count_; ++j) {
+                    slots_[j - 1] = slots_[j];
+                }
+                slots_[--slot_count_] = 0;
+                fill_free_slots();
+                break;
             }
         }
-        report_dirty_ = true;
     }
 
     /**
@@ -413,11 +636,17 @@ class KeyboardState {
      */
     void clear() noexcept {
         modifiers_ = 0;
-        pressed_keys_.clear();
+        pressed_.fill(0);
+        slots_.fill(0);
+        slot_count_ = 0;
+        pressed_count_ = 0;
         report_dirty_ = true;
     }
 };
 
+static_assert(std::is_trivially_copyable_v<KeyboardState>,
+              "KeyboardState must stay trivially copyable for cheap snapshots");
+
 /**
  * @brief Apply a Linux EV_KEY event to the keyboard state
  * @param state Keyboard state to modify
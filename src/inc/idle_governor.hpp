@@ -0,0 +1,109 @@
+/**
+ * @file idle_governor.hpp
+ * @brief Switches the BLE links to a low-wake state while the keyboards are idle
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * The low-latency connection interval keeps the radios of battery-powered
+ * units busy even when nobody types. After `--idle-timeout` seconds
+ * without key input the owner requests the power-save profile on every
+ * link and slows its own timers; the first key afterwards restores the
+ * configured profile. That report is written at once on the existing link:
+ * the scheduler keeps pacing to the power-save interval until the peer
+ * confirms the update, so nothing waits for the negotiation.
+ *
+ * Recording activity only stores a time stamp, so the hot path never
+ * touches a timer. The owner's single-shot timer calls poll(), which either
+ * enters the idle state or returns how long to wait before asking again.
+ *
+ * The class only keeps the state; the caller owns the timer and the links.
+ *
+ * @section IdleUsage Usage Example
+ * @code
+ * ble::IdleGovernor idle(std::chrono::seconds(30));
+ * timer.start(idle.timeout());
+ * // timer fired:
+ * if (auto wait = idle.poll(Clock::now())) { timer.start(*wait); } else { go_idle(); }
+ * // every key report:
+ * if (idle.on_activity(Clock::now())) { wake(); timer.start(idle.timeout()); }
+ * @endcode
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace ble {
+
+/**
+ * @class IdleGovernor
+ * @brief Tracks key activity and decides when the bridge goes idle and wakes up
+ *
+ * @note Not thread-safe; driven from the Qt thread
+ */
+class IdleGovernor {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+  private:
+    Clock::duration timeout_;          //!< Inactivity before going idle
+    Clock::time_point last_activity_;  //!< Latest key activity (or start)
+    bool idle_ = false;                //!< The power-save state is in effect
+    std::uint64_t idle_entered_ = 0;   //!< Transitions to idle
+    std::uint64_t wakes_ = 0;          //!< Transitions back to active
+
+  public:
+    /**
+     * @brief Start out active
+     * @param timeout Inactivity before going idle (> 0)
+     * @param now Start of the first inactivity period
+     */
+    explicit IdleGovernor(Clock::duration timeout, Clock::time_point now = Clock::now()) noexcept
+        : timeout_(timeout), last_activity_(now) {}
+
+    /**
+     * @brief Record key activity (hot path: one store unless idle)
+     * @param now Time of the activity
+     * @return true if this woke the bridge up (restore the active profile)
+     */
+    bool on_activity(Clock::time_point now) noexcept {
+        last_activity_ = now;
+        if (!idle_) {
+            return false;
+        }
+        idle_ = false;
+        ++wakes_;
+        return true;
+    }
+
+    /**
+     * @brief Check for inactivity (call when the owner's timer fires)
+     * @param now Current time
+     * @return Time left before going idle, or nullopt if idle (just entered or already)
+     *
+     * The first call that finds timeout() elapsed enters the idle state;
+     * check entered with idle_entered() or by comparing idle() before the call.
+     */
+    std::optional<Clock::duration> poll(Clock::time_point now) noexcept {
+        if (idle_) {
+            return std::nullopt;
+        }
+        const Clock::duration quiet = now - last_activity_;
+        if (quiet < timeout_) {
+            return timeout_ - quiet;
+        }
+        idle_ = true;
+        ++idle_entered_;
+        return std::nullopt;
+    }
+
+    [[nodiscard]] bool idle() const noexcept { return idle_; }
+    [[nodiscard]] Clock::duration timeout() const noexcept { return timeout_; }
+    [[nodiscard]] std::uint64_t idle_entered() const noexcept { return idle_entered_; }
+    [[nodiscard]] std::uint64_t wakes() const noexcept { return wakes_; }
+};
+
+}  // namespace ble
@@ -0,0 +1,243 @@
+/**
+ * @file input_thread.hpp
+ * @brief Dedicated (optionally real-time) keyboard input thread
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * In threaded mode the input thread owns the KeyboardManager: it sleeps in
+ * poll() on every keyboard fd and the udev monitor fd, reads evdev events,
+ * runs them through a KeyEventProcessor and pushes finished reports into a
+ * lock-free SPSC ring. The Qt thread only waits on notify_fd(), drains the
+ * ring and performs the BLE writes, so slow Bluetooth work can no longer
+ * delay key handling.
+ *
+ * @section InputThreadUsage Usage Example
+ * @code
+ * pipeline::InputThread input(manager, {50, 2}, false);
+ * input.start();
+ * // In the Qt thread, when notify_fd() becomes readable:
+ * input.drain([&](const pipeline::Report& r) { send(r); });
+ * // Or, to keep the latency stamps of each report (--latency-stats):
+ * input.drain([&](const pipeline::Report& r, const pipeline::ReportTiming& t) { send(r, t); });
+ * @endcode
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+
+#include "key_event_processor.hpp"
+#include "spsc_ring.hpp"
+
+namespace device {
+class KeyboardManager;
+class Passthrough;
+}
+
+namespace metrics {
+class Metrics;
+}
+
+namespace trace {
+class TraceRecorder;
+}
+
+namespace pipeline {
+
+class LatencyTracker;
+
+/**
+ * @class InputThread
+ * @brief Reads keyboards on its own thread and queues HID reports for the BLE thread
+ *
+ * @note Once started, the KeyboardManager must only be used by the input thread
+ * @note Neither copyable nor movable; the thread captures `this`
+ */
+class InputThread {
+  public:
+    //! @brief Number of reports the ring can hold before the input thread waits
+    static constexpr std::size_t QUEUE_CAPACITY = 256;
+
+    /**
+     * @struct TimedReport
+     * @brief Queued report together with the stamps of the event that caused it
+     */
+    struct TimedReport {
+        Report report{};        //!< 8-byte HID report
+        ReportTiming timing{};  //!< Latency stamps (event_ns is 0 when not timed)
+    };
+
+    using Queue = SpscRing<TimedReport, QUEUE_CAPACITY>;
+
+    /**
+     * @struct Config
+     * @brief Scheduling and processing options for the input thread
+     */
+    struct Config {
+        int rt_priority = 0;           //!< SCHED_FIFO priority (1-99), 0 keeps the default policy
+        int cpu = -1;                  //!< CPU core to pin the thread to, -1 for no affinity
+        bool coalesce_frames = false;  //!< One report per SYN_REPORT frame
+
+        //! Records raw events and produced reports (--trace); must outlive the thread
+        trace::TraceRecorder* trace = nullptr;
+
+        //! Stamps every event for the latency histograms (--latency-stats); must outlive the thread
+        LatencyTracker* latency = nullptr;
+
+        //! Counts events and reports (--metrics); must outlive the thread
+        metrics::Metrics* metrics = nullptr;
+
+        //! Hotkey chords (--hotkeys)
+        hotkey::ChordMatcher chords = hotkey::ChordMatcher::defaults();
+
+        //! Re-injects input into the local host (--share-input); must outlive the thread
+        device::Passthrough* passthrough = nullptr;
+    };
+
+  private:
+    device::KeyboardManager& manager_;                //!< Keyboards read by the thread
+    Config config_;                                   //!< Scheduling options
+    KeyEventProcessor processor_;                     //!< Event → report conversion
+    Queue queue_;                                     //!< Reports waiting for the BLE thread
+    int notify_fd_{-1};                               //!< eventfd signalled when reports are queued
+    int wake_fd_{-1};                                 //!< eventfd that interrupts poll() on stop()
+    std::thread thread_;                              //!< The input thread itself
+    std::atomic<bool> stop_{false};                   //!< Request the thread to exit
+    std::atomic<bool> exit_requested_{false};         //!< Exit hotkey was pressed
+    std::atomic<std::uint32_t> actions_{0};           //!< Hotkey bits for take_actions()
+    static_assert(hotkey::ACTION_COUNT < 32, "one actions_ bit per hotkey::Action");
+    std::atomic<std::uint64_t> queue_full_waits_{0};  //!< Pushes that found the ring full
+    bool report_pending_{false};  //!< Reports queued since the last signal (input thread only)
+
+  public:
+    /**
+     * @brief Prepare the input thread (does not start it)
+     * @param manager Keyboard manager handed over to the thread on start()
+     * @param config Scheduling options
+     * @param verbose Emit per-event debug logging from the input thread
+     */
+    InputThread(device::KeyboardManager& manager, Config config, bool verbose);
+
+    /**
+     * @brief Stop and join the thread, release eventfds
+     */
+    ~InputThread();
+
+    InputThread(const InputThread&) = delete;
+    InputThread& operator=(const InputThread&) = delete;
+    InputThread(InputThread&&) = delete;
+    InputThread& operator=(InputThread&&) = delete;
+
+    /**
+     * @brief Check if the eventfds were created successfully
+     * @return true if start() can be called
+     */
+    [[nodiscard]] bool is_valid() const noexcept { return notify_fd_ >= 0 && wake_fd_ >= 0; }
+
+    /**
+     * @brief Launch the input thread
+     * @return true if the thread is running
+     */
+    bool start();
+
+    /**
+     * @brief Ask the thread to exit and join it (idempotent)
+     */
+    void stop();
+
+    /**
+     * @brief File descriptor that becomes readable when reports are queued
+     * @return eventfd for QSocketNotifier/poll() in the consumer thread
+     */
+    [[nodiscard]] int notify_fd() const noexcept { return notify_fd_; }
+
+    /**
+     * @brief Consume all queued reports (consumer thread only)
+     * @tparam Fn Callable taking `const Report&`, optionally followed by `const ReportTiming&`
+     * @param fn Called once per report, in production order
+     * @return Number of reports consumed
+     *
+     * Also resets notify_fd() so the next push wakes the consumer again.
+     */
+    template <typename Fn> std::size_t drain(Fn&& fn) {
+        clear_notification();
+        std::size_t count = 0;
+        TimedReport entry{};
+        while (queue_.try_pop(entry)) {
+            if constexpr (std::is_invocable_v<Fn&, const Report&, const ReportTiming&>) {
+                fn(entry.report, entry.timing);
+            } else {
+                fn(entry.report);
+            }
+            ++count;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Check whether the exit hotkey was pressed on the input thread
+     * @return true once the thread has queued its final release report and stopped reading
+     */
+    [[nodiscard]] bool exit_requested() const noexcept {
+        return exit_requested_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Collect the hotkeys pressed on the input thread since the last call
+     * @return Bit (1 << hotkey::Action) set for each NextTarget, DumpMetrics and link
+     *         routing (ToggleLink1 ... ToggleLink9, AllLinks) hotkey
+     *
+     * Exit is reported by exit_requested(); ToggleGrab and ToggleLocal are
+     * carried out on the input thread itself, which owns the keyboards. A hotkey raises
+     * notify_fd() like a queued report.
+     */
+    [[nodiscard]] std::uint32_t take_actions() noexcept {
+        return actions_.exchange(0, std::memory_order_acq_rel);
+    }
+
+    /**
+     * @brief Highest number of reports that were waiting in the ring at once
+     * @return Queue high-water mark
+     */
+    [[nodiscard]] std::size_t queue_high_water_mark() const noexcept {
+        return queue_.high_water_mark();
+    }
+
+    /**
+     * @brief Number of times the input thread had to wait for ring space
+     * @return Count of full-queue waits
+     */
+    [[nodiscard]] std::uint64_t queue_full_waits() const noexcept {
+        return queue_full_waits_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Number of reports queued for transmission
+     * @return Sent count after de-duplication
+     */
+    [[nodiscard]] std::uint64_t reports_sent() const noexcept { return processor_.reports_sent(); }
+
+    /**
+     * @brief Number of unchanged reports dropped before queueing
+     * @return Suppressed count
+     */
+    [[nodiscard]] std::uint64_t reports_suppressed() const noexcept {
+        return processor_.reports_suppressed();
+    }
+
+  private:
+    void run();
+    void apply_scheduling() const;
+    void toggle_grab();
+    void toggle_local();
+    void push_report(const Report& report);
+    void signal_consumer() const;
+    void clear_notification() const;
+};
+
+}  // namespace pipeline
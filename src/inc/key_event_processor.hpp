@@ -0,0 +1,178 @@
+/**
+ * @file key_event_processor.hpp
+ * @brief Conversion of raw EV_KEY events into outgoing HID reports
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * The processor owns the keyboard state and the hotkey chords and turns
+ * each key event into zero or more HID reports handed to a sink:
+ * keyboard reports (boot bytes plus any keys held beyond six, for NKRO)
+ * and consumer-control reports for media keys. Reports pass through a
+ * ReportDeduplicator first, so only actual state changes of either kind
+ * reach the sink. It is shared by the single-threaded event
+ * loop (sink writes to BLE directly) and the dedicated input thread (sink
+ * pushes into a queue).
+ *
+ * A key press that completes a hotkey chord (hotkey::ChordMatcher) is not
+ * forwarded, nor are its repeats and release; process() returns the chord's
+ * action for the caller to carry out.
+ *
+ * With frame coalescing enabled, key events only update the state and one
+ * report is produced per SYN_REPORT, so keys the kernel delivers in the
+ * same frame (chords, fast rollover) cost a single BLE write.
+ *
+ * With a trace recorder attached every report handed to the sink is also
+ * recorded (raw events are recorded by the callers, which know the device).
+ *
+ * With a latency tracker attached, the ReportTiming of the event that caused
+ * a report (the first event of the frame when coalescing) is stamped with
+ * the build time and can be read with last_timing() from inside the sink.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <linux/input.h>
+
+#include "chord_matcher.hpp"
+#include "hid_keycodes.hpp"
+#include "report_deduplicator.hpp"
+#include "report_types.hpp"
+
+namespace metrics {
+class Metrics;
+}
+
+namespace trace {
+class TraceRecorder;
+}
+
+namespace pipeline {
+
+class LatencyTracker;
+
+/**
+ * @class KeyEventProcessor
+ * @brief Stateful EV_KEY → HID report converter
+ *
+ * @note Not thread-safe; each instance must be driven from a single thread
+ */
+class KeyEventProcessor {
+  private:
+    ReportDeduplicator transmit_;           //!< Drops unchanged reports before the sink
+    hid::KeyboardState state_;              //!< Currently pressed keys and modifiers
+    hotkey::ChordMatcher chords_;           //!< Hotkey chords (--hotkeys)
+    std::uint8_t swallowed_{0};             //!< Usage of the chord key held down (0: none)
+    bool paused_{false};                    //!< Reports are held back (set_paused())
+    bool verbose_{false};                   //!< Emit per-event debug logging
+    bool coalesce_frames_{false};           //!< Send once per SYN_REPORT instead of per key
+    bool frame_pending_{false};             //!< State changed since the last SYN_REPORT
+    bool consumer_pending_{false};          //!< Consumer usage changed since the last SYN_REPORT
+    std::uint16_t consumer_usage_{0};       //!< Held consumer-control usage (0: none)
+    trace::TraceRecorder* trace_{nullptr};  //!< Records produced reports (--trace), optional
+    LatencyTracker* latency_{nullptr};      //!< Per-stage latency histograms, optional
+    metrics::Metrics* metrics_{nullptr};    //!< Sent/suppressed counters (--metrics), optional
+    ReportTiming pending_timing_{};         //!< Timing of the event behind the next report
+    ReportTiming last_timing_{};            //!< Timing of the report being handed to the sink
+
+    void transmit(const Report& report, const ReportTiming& timing);
+    void transmit_state(const ReportTiming& timing);
+    void transmit_consumer(const ReportTiming& timing);
+    bool apply_consumer_event(int linux_code, int value) noexcept;
+
+  public:
+    /**
+     * @brief Construct processor with a report sink
+     * @param sink Called with each report that should be transmitted
+     * @param verbose Emit per-event debug logging
+     * @param coalesce_frames Produce at most one report per SYN_REPORT frame
+     */
+    explicit KeyEventProcessor(ReportSink sink, bool verbose = false,
+                               bool coalesce_frames = false);
+
+    /**
+     * @brief Feed one input event through the processor
+     * @param ev Event read from the keyboard (EV_KEY, plus EV_SYN when coalescing)
+     * @param source Human-readable device name used in debug logging
+     * @param timing Event and read stamps for latency tracking (default: not timed)
+     * @return Action of the hotkey chord the event completed, else hotkey::Action::None.
+     *         For Action::Exit empty reports have already been sent to release
+     *         every key on the host.
+     */
+    hotkey::Action process(const input_event& ev, const std::string& source,
+                           const ReportTiming& timing = {});
+
+    /**
+     * @brief Replace the hotkey chords
+     * @param chords Chords to match (default: hotkey::ChordMatcher::defaults())
+     */
+    void set_chords(const hotkey::ChordMatcher& chords) noexcept { chords_ = chords; }
+
+    [[nodiscard]] const hotkey::ChordMatcher& chords() const noexcept { return chords_; }
+
+    /**
+     * @brief Hold reports back, e.g. while the keyboards belong to the local host
+     * @param paused true to release every key on the peer and stop sending;
+     *               false to send the current state again and carry on
+     *
+     * Key state is still tracked while paused, and hotkeys still fire.
+     */
+    void set_paused(bool paused);
+
+    [[nodiscard]] bool paused() const noexcept { return paused_; }
+
+    /**
+     * @brief Record every report handed to the sink
+     * @param recorder Trace recorder, or nullptr to stop recording; must outlive the processor
+     */
+    void set_trace(trace::TraceRecorder* recorder) noexcept { trace_ = recorder; }
+
+    /**
+     * @brief Record the kernel→read and read→report stages of every sent report
+     * @param tracker Latency tracker, or nullptr to stop; must outlive the processor
+     */
+    void set_latency_tracker(LatencyTracker* tracker) noexcept { latency_ = tracker; }
+
+    /**
+     * @brief Count sent and suppressed reports in a metrics registry
+     * @param registry Metrics registry, or nullptr to stop; must outlive the processor
+     */
+    void set_metrics(metrics::Metrics* registry) noexcept { metrics_ = registry; }
+
+    /**
+     * @brief Timing of the report currently being handed to the sink
+     * @return Stamps including built_ns (event_ns is 0 when the report is not timed)
+     */
+    [[nodiscard]] const ReportTiming& last_timing() const noexcept { return last_timing_; }
+
+    /**
+     * @brief Number of reports handed to the sink
+     * @return Sent count (readable from any thread)
+     */
+    [[nodiscard]] std::uint64_t reports_sent() const noexcept { return transmit_.sent_count(); }
+
+    /**
+     * @brief Number of reports dropped because they matched the last one sent
+     * @return Suppressed count (readable from any thread)
+     */
+    [[nodiscard]] std::uint64_t reports_suppressed() const noexcept {
+        return transmit_.suppressed_count();
+    }
+
+    /**
+     * @brief Get the current keyboard state
+     * @return Const reference to the tracked HID keyboard state
+     */
+    [[nodiscard]] const hid::KeyboardState& state() const noexcept { return state_; }
+
+    /**
+     * @brief Get the held consumer-control usage
+     * @return Usage of the media key held down, 0 if none
+     */
+    [[nodiscard]] std::uint16_t consumer_usage() const noexcept { return consumer_usage_; }
+};
+
+}  // namespace pipeline
@@ -0,0 +1,256 @@
+/**
+ * @file keymap.hpp
+ * @brief Key remapping with per-keyboard sections and hold-to-use layers
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * A keymap file (`--keymap`) is compiled once, when it is loaded, into flat
+ * tables indexed by Linux key code: one table per layer and per keyboard
+ * section. Remapping an event is then a single table index, and holding a
+ * layer key only swaps the table pointer. Events are remapped as they are
+ * read (KeyboardDevice::read_batch()), before anything else sees them, so
+ * the exit hotkey, traces and HID mapping all work on the remapped keys.
+ *
+ * @section KeymapFormat File Format
+ * @code
+ * # Lines before the first section apply to every keyboard
+ * CAPSLOCK = LEFTCTRL
+ *
+ * # Sections add to (and override) the lines above for one keyboard,
+ * # matched by its name or by its device path (symlinks are resolved)
+ * [keyboard Keychron K2]
+ * layer nav = RIGHTALT        # Hold Right Alt for the "nav" layer
+ * nav H = LEFT
+ * nav J = DOWN
+ * INSERT = NONE               # Disable a key
+ *
+ * [keyboard /dev/input/by-id/usb-0000_Keyboard-event-kbd]
+ * LEFTMETA = LEFTALT
+ *
+ * [keyboard *]                # Back to the lines for every keyboard
+ * SCROLLLOCK = MUTE
+ * @endcode
+ * Keys are `KEY_*` names with or without the prefix, case-insensitive, or
+ * decimal key codes (`0` to `9` are the number keys). Keys not bound on a
+ * layer behave as on the base layer.
+ *
+ * @section KeymapReload Reloading
+ * A KeymapStore publishes a new compiled keymap with one atomic pointer
+ * store; readers pick it up on their next batch. Published keymaps are
+ * immutable and kept until the store is destroyed, so a reader never sees
+ * one freed under it.
+ */
+
+#pragma once
+
+#include <linux/input.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace keymap {
+
+//! @brief Number of Linux key codes (table size)
+inline constexpr std::size_t KEY_COUNT = KEY_MAX + 1;
+
+//! @brief Most layers per keyboard, including the base layer
+inline constexpr std::size_t MAX_LAYERS = 8;
+
+//! @brief Table entry flag: the key holds the layer in the low byte
+inline constexpr std::uint16_t LAYER_FLAG = 0x8000;
+
+/**
+ * @brief One layer: Linux key code → remapped code
+ *
+ * 0 drops the key, LAYER_FLAG | n holds layer n, anything else is the code
+ * to send.
+ */
+using Table = std::array<std::uint16_t, KEY_COUNT>;
+
+/**
+ * @struct DeviceKeymap
+ * @brief Compiled layers of one keyboard section
+ */
+struct DeviceKeymap {
+    std::vector<Table> layers;             //!< layers[0] is the base layer
+    std::vector<std::string> layer_names;  //!< Name of each layer ("base" first)
+};
+
+/**
+ * @struct KeyboardMatch
+ * @brief Which keyboards a section applies to
+ */
+struct KeyboardMatch {
+    //! @brief What the section header names
+    enum class Kind {
+        Any,   //!< Lines before the first section
+        Name,  //!< `[keyboard <name>]`, libevdev device name
+        Path   //!< `[keyboard /path]`, device node or a symlink to it
+    };
+
+    Kind kind = Kind::Any;  //!< Match type
+    std::string value;      //!< Name or path (empty for Any)
+};
+
+/**
+ * @class Keymap
+ * @brief A compiled keymap file
+ *
+ * @note Immutable once built; safe to read from several threads
+ */
+class Keymap {
+  public:
+    //! @brief One section and its compiled tables
+    struct Section {
+        KeyboardMatch match;  //!< Keyboards it applies to
+        DeviceKeymap keymap;  //!< Tables (a named section includes the lines before it)
+    };
+
+    std::vector<Section> sections;  //!< The Any section (if any lines) first, then file order
+
+    /**
+     * @brief Find the tables for a keyboard
+     * @param name Device name
+     * @param path Device node path
+     * @return A path section, else a name section, else the Any section; nullptr for none
+     */
+    [[nodiscard]] const Section* for_device(const std::string& name,
+                                            const std::string& path) const;
+};
+
+/**
+ * @brief Resolve a key name or code as written in a keymap
+ * @param token `CAPSLOCK`, `KEY_CAPSLOCK`, `capslock`, `1` (KEY_1) or `58`
+ * @return Linux key code, or nullopt if unknown
+ */
+[[nodiscard]] std::optional<std::uint16_t> parse_key(const std::string& token);
+
+/**
+ * @brief Parse and compile a keymap
+ * @param in Keymap text
+ * @param error Receives "line N: ..." on failure
+ * @return Compiled keymap, or nullopt on the first invalid line
+ */
+[[nodiscard]] std::optional<Keymap> parse_keymap(std::istream& in, std::string& error);
+
+/**
+ * @brief Read and compile a keymap file
+ * @param path Keymap file
+ * @param error Receives the reason on failure
+ * @return Compiled keymap, or nullopt if the file cannot be read or is invalid
+ */
+[[nodiscard]] std::optional<Keymap> load_keymap(const std::string& path, std::string& error);
+
+/**
+ * @class KeymapStore
+ * @brief Current keymap, replaced atomically on reload
+ *
+ * @note publish() from one thread (the Qt thread); current() from any
+ */
+class KeymapStore {
+  private:
+    std::atomic<const Keymap*> current_{nullptr};           //!< Latest published keymap
+    std::vector<std::unique_ptr<const Keymap>> published_;  //!< Every keymap published so far
+
+  public:
+    /**
+     * @brief Make a keymap current
+     * @param keymap Compiled keymap; the previous one stays allocated for late readers
+     */
+    void publish(Keymap keymap) {
+        published_.push_back(std::make_unique<const Keymap>(std::move(keymap)));
+        current_.store(published_.back().get(), std::memory_order_release);
+    }
+
+    [[nodiscard]] const Keymap* current() const noexcept {
+        return current_.load(std::memory_order_acquire);
+    }
+};
+
+/**
+ * @class Remapper
+ * @brief Per-keyboard remapping state: keymap, active layer and held keys
+ *
+ * A key is released (and auto-repeated) as whatever it was pressed as, so
+ * switching layers or reloading the keymap while keys are held never leaves
+ * a key stuck on the host.
+ *
+ * @note Trivially copyable; lives in its KeyboardDevice
+ */
+class Remapper {
+  private:
+    const Keymap* source_{nullptr};        //!< Keymap the tables were taken from
+    const DeviceKeymap* keymap_{nullptr};  //!< Tables of this keyboard (nullptr: unmapped)
+    const Table* layer_{nullptr};          //!< Active layer
+    //! Table entry each held key was pressed as (0: not held or not remapped)
+    std::array<std::uint16_t, KEY_COUNT> pressed_as_{};
+
+  public:
+    /**
+     * @brief Follow the current keymap of a store
+     * @param keymap Current keymap (nullptr: none)
+     * @param name Device name
+     * @param path Device node path
+     * @return true if the keymap changed (the base layer is active again)
+     *
+     * Cheap when the keymap did not change: one pointer comparison.
+     */
+    bool update(const Keymap* keymap, const std::string& name, const std::string& path) {
+        if (keymap == source_) {
+            return false;
+        }
+        source_ = keymap;
+        const Keymap::Section* section = keymap ? keymap->for_device(name, path) : nullptr;
+        keymap_ = section ? &section->keymap : nullptr;
+        layer_ = keymap_ ? keymap_->layers.data() : nullptr;
+        return true;
+    }
+
+    //! @brief Tables in use, or nullptr if this keyboard is not remapped
+    [[nodiscard]] const DeviceKeymap* keymap() const noexcept { return keymap_; }
+
+    /**
+     * @brief Remap one event in place
+     * @param ev Event read from the keyboard
+     * @return false if the event is to be dropped (disabled key or layer key)
+     */
+    bool remap(input_event& ev) noexcept {
+        if (ev.type != EV_KEY || ev.code >= KEY_COUNT) {
+            return true;
+        }
+        std::uint16_t& held = pressed_as_[ev.code];
+        std::uint16_t to = 0;
+        if (ev.value != 1 && held != 0) {
+            to = held;  // Release or repeat as pressed, even after a reload
+        } else if (layer_) {
+            to = (*layer_)[ev.code];
+        } else {
+            held = 0;
+            return true;  // This keyboard is not remapped
+        }
+        held = ev.value == 0 ? 0 : to;
+
+        if (to & LAYER_FLAG) {
+            if (keymap_) {
+                const std::size_t layer = ev.value == 0 ? 0 : to & 0xFFU;
+                layer_ = &keymap_->layers[layer < keymap_->layers.size() ? layer : 0];
+            }
+            return false;
+        }
+        if (to == 0) {
+            return false;
+        }
+        ev.code = to;
+        return true;
+    }
+};
+
+}  // namespace keymap
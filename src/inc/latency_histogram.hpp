@@ -0,0 +1,161 @@
+/**
+ * @file latency_histogram.hpp
+ * @brief Lock-free log-linear latency histogram (HDR-style)
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * Values (nanoseconds) below 64 get a bucket each; above that every power of
+ * two is split into 32 linear sub-buckets, so any recorded value is known to
+ * within about 3 % from 64 ns up to several minutes with 1088 counters. This
+ * is the bucketing scheme of HdrHistogram with two significant binary
+ * digits less, which keeps a histogram at under 9 KiB.
+ *
+ * Recording is one relaxed atomic increment per counter and never blocks, so
+ * the input thread and the Qt thread can record while another thread reads
+ * a summary.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace pipeline {
+
+/**
+ * @class LatencyHistogram
+ * @brief Fixed-size histogram of nanosecond latencies
+ *
+ * @note record() may be called from any thread; summarize() gives a
+ *       consistent-enough snapshot while recording continues
+ */
+class LatencyHistogram {
+  public:
+    //! @brief Exact buckets below 64 ns, then 32 sub-buckets per power of two up to ~2^38 ns
+    static constexpr unsigned SUB_BUCKET_BITS = 6;
+    static constexpr std::size_t SUB_BUCKETS = std::size_t{1} << SUB_BUCKET_BITS;
+    static constexpr std::size_t HALF_SUB_BUCKETS = SUB_BUCKETS / 2;
+    static constexpr unsigned MAX_SHIFT = 32;
+    static constexpr std::size_t BUCKET_COUNT = SUB_BUCKETS + MAX_SHIFT * HALF_SUB_BUCKETS;
+
+    /**
+     * @struct Summary
+     * @brief Percentiles of everything recorded so far (nanoseconds)
+     */
+    struct Summary {
+        std::uint64_t count = 0;  //!< Number of recorded values
+        std::uint64_t sum = 0;    //!< Sum of all values
+        std::uint64_t mean = 0;   //!< Arithmetic mean
+        std::uint64_t p50 = 0;    //!< Median
+        std::uint64_t p99 = 0;    //!< 99th percentile
+        std::uint64_t p999 = 0;   //!< 99.9th percentile
+        std::uint64_t max = 0;    //!< Largest recorded value (exact)
+    };
+
+  private:
+    std::array<std::atomic<std::uint64_t>, BUCKET_COUNT> buckets_{};  //!< Per-bucket counts
+    std::atomic<std::uint64_t> count_{0};                              //!< Recorded values
+    std::atomic<std::uint64_t> sum_{0};                                //!< Sum for the mean
+    std::atomic<std::uint64_t> max_{0};                                //!< Exact maximum
+
+  public:
+    /**
+     * @brief Map a value to its bucket
+     * @param value Latency in nanoseconds
+     * @return Bucket index (values beyond the range land in the last bucket)
+     */
+    [[nodiscard]] static constexpr std::size_t bucket_for(std::uint64_t value) noexcept {
+        if (value < SUB_BUCKETS) {
+            return static_cast<std::size_t>(value);
+        }
+        const unsigned msb = 63U - static_cast<unsigned>(__builtin_clzll(value));
+        const unsigned shift = msb - SUB_BUCKET_BITS + 1;  // value >> shift is in [32, 64)
+        if (shift > MAX_SHIFT) {
+            return BUCKET_COUNT - 1;
+        }
+        return SUB_BUCKETS + (shift - 1) * HALF_SUB_BUCKETS +
+               static_cast<std::size_t>((value >> shift) - HALF_SUB_BUCKETS);
+    }
+
+    /**
+     * @brief Largest value that maps to a bucket
+     * @param bucket Bucket index
+     * @return Upper bound of the bucket in nanoseconds
+     */
+    [[nodiscard]] static constexpr std::uint64_t bucket_upper(std::size_t bucket) noexcept {
+        if (bucket < SUB_BUCKETS) {
+            return bucket;
+        }
+        const std::size_t offset = bucket - SUB_BUCKETS;
+        const unsigned shift = static_cast<unsigned>(offset / HALF_SUB_BUCKETS) + 1;
+        const std::uint64_t mantissa = offset % HALF_SUB_BUCKETS + HALF_SUB_BUCKETS;
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+    /**
+     * @brief Record one latency
+     * @param value_ns Latency in nanoseconds
+     */
+    void record(std::uint64_t value_ns) noexcept {
+        buckets_[bucket_for(value_ns)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value_ns, std::memory_order_relaxed);
+        std::uint64_t seen = max_.load(std::memory_order_relaxed);
+        while (value_ns > seen &&
+               !max_.compare_exchange_weak(seen, value_ns, std::memory_order_relaxed)) {
+            // seen was refreshed by the failed exchange; retry while still larger
+        }
+    }
+
+    [[nodiscard]] std::uint64_t count() const noexcept {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Value at or below which a fraction of the recorded values lie
+     * @param quantile Fraction in [0, 1], e.g. 0.99
+     * @return Bucket upper bound (capped at the exact maximum), 0 if empty
+     */
+    [[nodiscard]] std::uint64_t percentile(double quantile) const noexcept {
+        const std::uint64_t total = count();
+        if (total == 0) {
+            return 0;
+        }
+        auto rank = static_cast<std::uint64_t>(quantile * static_cast<double>(total) + 0.5);
+        rank = rank == 0 ? 1 : rank;
+
+        const std::uint64_t max = max_.load(std::memory_order_relaxed);
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                return bucket_upper(i) < max ? bucket_upper(i) : max;
+            }
+        }
+        return max;
+    }
+
+    /**
+     * @brief Summarize the distribution
+     * @return Count, sum, mean, p50/p99/p99.9 and max
+     */
+    [[nodiscard]] Summary summarize() const noexcept {
+        Summary s;
+        s.count = count();
+        if (s.count == 0) {
+            return s;
+        }
+        s.sum = sum_.load(std::memory_order_relaxed);
+        s.mean = s.sum / s.count;
+        s.p50 = percentile(0.50);
+        s.p99 = percentile(0.99);
+        s.p999 = percentile(0.999);
+        s.max = max_.load(std::memory_order_relaxed);
+        return s;
+    }
+};
+
+}  // namespace pipeline
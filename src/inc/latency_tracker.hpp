@@ -0,0 +1,168 @@
+/**
+ * @file latency_tracker.hpp
+ * @brief Per-stage, per-keyboard latency histograms for the report pipeline (--latency-stats)
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * Every timed report carries a ReportTiming from the key event that caused
+ * it to the BLE write. The tracker turns those stamps into four histograms:
+ *
+ * | Stage          | From                        | To                             |
+ * |----------------|-----------------------------|--------------------------------|
+ * | kernel→read    | input_event::time           | libevdev_next_event() returned |
+ * | read→report    | event read                  | report handed to the sink      |
+ * | report→write   | report handed to the sink   | writeCharacteristic() called   |
+ * | end-to-end     | input_event::time           | writeCharacteristic() called   |
+ *
+ * Each stage is kept once for all keyboards and once per keyboard, keyed by
+ * KeyboardDevice::path(). Keyboards that are unplugged keep their entry, so
+ * a replugged keyboard continues where it left off.
+ *
+ * @section LatencyUsage Usage Example
+ * @code
+ * pipeline::LatencyTracker latency;
+ * const auto slot = latency.keyboard_slot(kbd.path());
+ * // read site:   timing = {kernel_ns(ev), now_ns(), 0, slot}
+ * // report:      latency.on_report_built(timing);
+ * // BLE write:   latency.on_report_written(timing, now_ns());
+ * LOG_INFO_LINES(latency.summary());
+ * @endcode
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <linux/input.h>
+
+#include "latency_histogram.hpp"
+#include "report_types.hpp"
+
+namespace pipeline {
+
+//! @brief Pipeline stage a latency belongs to
+enum class LatencyStage : std::size_t {
+    KernelToRead = 0,   //!< Kernel event timestamp → event read by libevdev
+    ReadToReport = 1,   //!< Event read → report built
+    ReportToWrite = 2,  //!< Report built → BLE write issued
+    EndToEnd = 3,       //!< Kernel event timestamp → BLE write issued
+};
+
+//! @brief Number of LatencyStage values
+inline constexpr std::size_t LATENCY_STAGE_COUNT = 4;
+
+/**
+ * @brief Name of a stage for log output
+ * @param stage Stage
+ * @return Short name such as "kernel->read"
+ */
+[[nodiscard]] const char* to_string(LatencyStage stage) noexcept;
+
+/**
+ * @brief Current CLOCK_MONOTONIC time
+ * @return Nanoseconds on the steady_clock time base
+ */
+[[nodiscard]] inline std::uint64_t monotonic_now_ns() noexcept {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                          std::chrono::steady_clock::now().time_since_epoch())
+                                          .count());
+}
+
+/**
+ * @brief Kernel timestamp of an input event
+ * @param ev Event read from a device whose clock was set to CLOCK_MONOTONIC
+ * @return Nanoseconds on the steady_clock time base
+ */
+[[nodiscard]] inline std::uint64_t event_time_ns(const input_event& ev) noexcept {
+    return static_cast<std::uint64_t>(ev.input_event_sec) * 1000000000ULL +
+           static_cast<std::uint64_t>(ev.input_event_usec) * 1000ULL;
+}
+
+/**
+ * @class LatencyTracker
+ * @brief Collects ReportTiming stamps into lock-free histograms
+ *
+ * @note on_report_built()/on_report_written() may be called from any thread
+ *       and never block; keyboard_slot() only takes a lock the first time a
+ *       path is seen
+ */
+class LatencyTracker {
+  public:
+    //! @brief Keyboards that get their own breakdown; further ones only count in the totals
+    static constexpr std::size_t MAX_KEYBOARDS = 16;
+
+  private:
+    using StageHistograms = std::array<LatencyHistogram, LATENCY_STAGE_COUNT>;
+
+    struct Keyboard {
+        std::string path;                         //!< KeyboardDevice::path()
+        std::unique_ptr<StageHistograms> stages;  //!< Allocated when the slot is claimed
+    };
+
+    StageHistograms totals_;                         //!< All keyboards combined
+    std::array<Keyboard, MAX_KEYBOARDS> keyboards_;  //!< Per-keyboard breakdown
+    std::atomic<std::size_t> keyboard_count_{0};     //!< Published slots in keyboards_
+    std::mutex register_mutex_;                      //!< Serializes slot creation
+
+    void record(std::uint8_t keyboard, LatencyStage stage, std::uint64_t from_ns,
+                std::uint64_t to_ns) noexcept;
+
+  public:
+    LatencyTracker() = default;
+    LatencyTracker(const LatencyTracker&) = delete;
+    LatencyTracker& operator=(const LatencyTracker&) = delete;
+
+    /**
+     * @brief Find or create the slot of a keyboard
+     * @param path Device path (KeyboardDevice::path())
+     * @return Slot for ReportTiming::keyboard, or NO_KEYBOARD_SLOT if all slots are taken
+     */
+    [[nodiscard]] std::uint8_t keyboard_slot(const std::string& path);
+
+    /**
+     * @brief Record the kernel→read and read→report stages
+     * @param timing Stamps of the report just handed to the sink (ignored if event_ns is 0)
+     */
+    void on_report_built(const ReportTiming& timing) noexcept;
+
+    /**
+     * @brief Record the report→write and end-to-end stages
+     * @param timing Stamps carried with the report (ignored if event_ns is 0)
+     * @param write_ns Time the BLE write was issued
+     */
+    void on_report_written(const ReportTiming& timing, std::uint64_t write_ns) noexcept;
+
+    /**
+     * @brief Histogram of one stage over all keyboards
+     * @param stage Stage
+     * @return Histogram (live, keeps changing while recording continues)
+     */
+    [[nodiscard]] const LatencyHistogram& total(LatencyStage stage) const noexcept {
+        return totals_[static_cast<std::size_t>(stage)];
+    }
+
+    /**
+     * @brief Histogram of one stage for one keyboard
+     * @param path Device path
+     * @param stage Stage
+     * @return Histogram, or nullptr if the keyboard has no slot
+     */
+    [[nodiscard]] const LatencyHistogram* keyboard(const std::string& path,
+                                                   LatencyStage stage) const noexcept;
+
+    /**
+     * @brief Render every histogram as text, one line per stage
+     * @return Multi-line summary in microseconds (totals first, then per keyboard)
+     */
+    [[nodiscard]] std::string summary() const;
+};
+
+}  // namespace pipeline
@@ -0,0 +1,126 @@
+/**
+ * @file link_router.hpp
+ * @brief Routing of HID reports to a subset of several BLE links
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * With several `--target` devices every report is mirrored to all links
+ * by default. The `link-1` ... `link-9` hotkeys (hotkey::Action::ToggleLink1
+ * and on, Ctrl+Alt+1 ... Ctrl+Alt+9 unless rebound with `--hotkeys`) toggle
+ * a link (in `--target` order) in and out of the routed set with toggle(),
+ * and `all-links` (Ctrl+Alt+0) routes to all links again. The `next-target`
+ * hotkey (hotkey::Action::NextTarget) cycles through the links one at a
+ * time with next(). The chords are matched by the KeyEventProcessor like
+ * every other hotkey, so the key that completes one is never sent.
+ *
+ * The router is independent of Qt: main.cpp applies the hotkeys and sends a
+ * release report to links that leave the routed set, so no key stays held
+ * on a host that no longer receives input.
+ *
+ * @section RouterUsage Usage Example
+ * @code
+ * ble::LinkRouter router(links.size());
+ * // link-2 hotkey:
+ * release(router.toggle(1).left);
+ * // for every report:
+ * for (std::size_t i = 0; i < links.size(); ++i) {
+ *     if (router.routes_to(i)) links[i]->submit(report);
+ * }
+ * @endcode
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ble {
+
+//! @brief Most BLE links that can be driven at once (one routing hotkey each)
+inline constexpr std::size_t MAX_LINKS = 9;
+
+/**
+ * @class LinkRouter
+ * @brief Tracks which links receive reports
+ *
+ * @note Not thread-safe; driven from the Qt thread
+ */
+class LinkRouter {
+  public:
+    using Mask = std::uint16_t;  //!< Bit i set: link i receives reports
+
+    //! @brief Effect of a routing hotkey
+    struct Change {
+        Mask left = 0;    //!< Links that stopped receiving reports (send them a release)
+        Mask joined = 0;  //!< Links that started receiving reports again
+    };
+
+  private:
+    std::size_t link_count_;  //!< Number of links (at most MAX_LINKS)
+    Mask all_;                //!< Bits of every link
+    Mask active_;             //!< Links currently routed to
+
+  public:
+    /**
+     * @brief Route to all links
+     * @param link_count Number of links; clamped to MAX_LINKS
+     */
+    explicit LinkRouter(std::size_t link_count) noexcept
+        : link_count_(link_count < MAX_LINKS ? link_count : MAX_LINKS),
+          all_(static_cast<Mask>((1U << link_count_) - 1U)), active_(all_) {}
+
+    /**
+     * @brief Toggle one link in or out of the routed set
+     * @param link Link index (0 for the first --target)
+     * @return Links that left and joined. Nothing changes for a link that does
+     *         not exist or when the last routed link would be switched off.
+     */
+    Change toggle(std::size_t link) noexcept {
+        if (link >= link_count_) {
+            return {};
+        }
+        const Mask toggled = static_cast<Mask>(active_ ^ (1U << link));
+        return toggled != 0 ? route(toggled) : Change{};
+    }
+
+    /**
+     * @brief Route to every link again
+     * @return Links that joined
+     */
+    Change route_all() noexcept { return route(all_); }
+
+    /**
+     * @brief Route to an explicit set of links
+     * @param mask Links to route to; bits beyond link_count() are ignored
+     * @return Links that left and joined
+     */
+    Change route(Mask mask) noexcept {
+        const Mask next = static_cast<Mask>(mask & all_);
+        const Change change{static_cast<Mask>(active_ & ~next), static_cast<Mask>(next & ~active_)};
+        active_ = next;
+        return change;
+    }
+
+    /**
+     * @brief Route to the single link after the highest routed one, wrapping around
+     * @return Links that left and joined (nothing changes with one link)
+     */
+    Change next() noexcept {
+        std::size_t highest = link_count_;
+        while (highest > 0 && !((active_ >> (highest - 1)) & 1U)) {
+            --highest;
+        }
+        const std::size_t following = highest < link_count_ ? highest : 0;
+        return route(static_cast<Mask>(1U << following));
+    }
+
+    [[nodiscard]] bool routes_to(std::size_t link) const noexcept {
+        return link < link_count_ && (active_ >> link) & 1U;
+    }
+
+    [[nodiscard]] Mask active() const noexcept { return active_; }
+    [[nodiscard]] std::size_t link_count() const noexcept { return link_count_; }
+};
+
+}  // namespace ble
@@ -36,17 +36,40 @@
  * - LOG_INFO(msg): Informational logging
  * - LOG_WARN(msg): Warning level logging
  * - LOG_ERROR(msg): Error level logging
+ * - LOG_DEBUGF(fmt, ...), LOG_INFOF, LOG_WARNF, LOG_ERRORF: printf-style variants
+ * - LOG_INFO_LINES(text): multi-line reports, one record per line
  *
  * @section LoggingPerformance Performance Considerations
- * - Log level filtering happens before message formatting
- * - String formatting only occurs when message will be displayed
+ * - The macros check the level before evaluating their argument, so
+ *   `LOG_DEBUG("x=" + std::to_string(x))` builds no string unless DEBUG is enabled
+ * - The printf-style variants format into a reusable thread-local buffer
+ *   instead of building std::string temporaries
+ * - Levels below NINJA_LOG_MIN_LEVEL (0 = DEBUG ... 3 = ERROR) are compiled
+ *   out entirely; the STRIP_LOGS_IN_RELEASE CMake option sets it to WARN for
+ *   Release builds
+ * - With enable_async(true) (--log-async) callers only copy the message
+ *   into a lock-free ring; a background thread formats and writes records
+ *   in batches, so a slow terminal or journald pipe never blocks the input
+ *   path. A full ring drops the record and counts it instead of waiting.
  * - Thread-safe but minimal synchronization overhead
  * - Timestamps use high-resolution clock for accuracy
  */
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <string>
+#include <string_view>
+
+/**
+ * @def NINJA_LOG_MIN_LEVEL
+ * @brief Lowest level compiled into the binary (0: DEBUG, 1: INFO, 2: WARN, 3: ERROR)
+ */
+#ifndef NINJA_LOG_MIN_LEVEL
+#define NINJA_LOG_MIN_LEVEL 0
+#endif
 
 /**
  * @namespace logging
@@ -84,6 +107,9 @@ enum class Level {
     ERROR = 3   //!< Error messages about serious problems (highest severity)
 };
 
+//! @brief Levels below this are removed at compile time (see NINJA_LOG_MIN_LEVEL)
+inline constexpr Level COMPILED_MIN_LEVEL = static_cast<Level>(NINJA_LOG_MIN_LEVEL);
+
 /**
  * @class Logger
  * @brief Thread-safe singleton logging system with configurable levels and formatting
@@ -114,8 +140,12 @@ enum class Level {
  */
 class Logger {
   private:
-    static Level current_level_;     //!< Global minimum log level for filtering
-    static bool enable_timestamps_;  //!< Whether to include timestamps in output
+    class AsyncSink;  //!< Background writer used in async mode (logger.cpp)
+
+    static std::atomic<Level> current_level_;  //!< Global minimum log level for filtering
+    static bool enable_timestamps_;            //!< Whether to include timestamps in output
+
+    [[nodiscard]] static AsyncSink& async_sink();
 
   public:
     /**
@@ -132,7 +162,18 @@ class Logger {
      * Logger::set_level(Level::ERROR); // Show only errors
      * @endcode
      */
-    static void set_level(Level level) { current_level_ = level; }
+    static void set_level(Level level) { current_level_.store(level, std::memory_order_relaxed); }
+
+    /**
+     * @brief Check whether a message of the given level would be displayed
+     * @param level Message severity level
+     * @return true if @p level passes the runtime filter
+     *
+     * Used by the LOG_* macros to skip building the message entirely.
+     */
+    [[nodiscard]] static bool is_enabled(Level level) noexcept {
+        return level >= current_level_.load(std::memory_order_relaxed);
+    }
 
     /**
      * @brief Set global log level from string representation
@@ -216,6 +257,68 @@ class Logger {
      */
     static void error(const std::string& message);
 
+    /**
+     * @brief Log an already built message
+     * @param level Message severity level
+     * @param message Message content
+     *
+     * Entry point of the LOG_* macros; filtered like the level-specific methods.
+     */
+    static void write(Level level, std::string_view message) { log(level, message); }
+
+    /**
+     * @brief Log multi-line text as one record per line
+     * @param level Message severity level
+     * @param text Lines separated by '\n' (a trailing newline adds no empty record)
+     *
+     * For reports such as latency summaries or metrics pages: each line gets
+     * its own prefix and, with --log-async, its own record, so a long report
+     * is not cut at the record size.
+     */
+    static void write_lines(Level level, std::string_view text);
+
+    /**
+     * @brief Log a printf-style message
+     * @param level Message severity level
+     * @param fmt printf format string
+     *
+     * The message is formatted into a thread-local buffer that is reused
+     * between calls, so steady-state logging does not allocate. Nothing is
+     * formatted if @p level is filtered out.
+     */
+    static void format(Level level, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+    /**
+     * @brief Switch between synchronous output and the background writer
+     * @param enable true to queue records for a background thread (--log-async)
+     *
+     * In async mode a log call stamps the message with the monotonic clock,
+     * copies it (truncated to a fixed record size) into a lock-free MPSC
+     * ring and returns. Disabling writes every queued record and joins the
+     * writer thread; it is also done automatically at program exit.
+     */
+    static void enable_async(bool enable);
+
+    /**
+     * @brief Check whether the background writer is active
+     * @return true in async mode
+     */
+    [[nodiscard]] static bool async_enabled() noexcept;
+
+    /**
+     * @brief Wait until every queued record has been written
+     *
+     * No-op in synchronous mode. Waits at most one second so that a stuck
+     * output never hangs shutdown.
+     */
+    static void flush();
+
+    /**
+     * @brief Number of records dropped because the async ring was full
+     * @return Drop counter since start-up
+     */
+    [[nodiscard]] static std::uint64_t dropped_count() noexcept;
+
   private:
     /**
      * @brief Internal logging implementation with level checking and formatting
@@ -235,19 +338,32 @@ class Logger {
      * @note This function performs the actual level filtering and formatting
      * @note Thread-safe implementation with appropriate synchronization
      */
-    static void log(Level level, const std::string& message);
+    static void log(Level level, std::string_view message);
+
+    /**
+     * @brief Write one formatted line to stdout (DEBUG/INFO) or stderr (WARN/ERROR)
+     *
+     * Serialized by a mutex, so lines logged from different threads never interleave.
+     * @param level Message severity level
+     * @param message Message content
+     * @param when Wall-clock time shown in the timestamp
+     * @param flush Whether to flush the stream afterwards
+     */
+    static void write_line(Level level, std::string_view message,
+                           std::chrono::system_clock::time_point when, bool flush);
 
     /**
      * @brief Generate formatted timestamp string for log messages
-     * @return Formatted timestamp string in "YYYY-MM-DD HH:MM:SS.mmm" format
+     * @param when Time to format
+     * @return Formatted timestamp string in "HH:MM:SS.mmm" format
      *
-     * Creates a high-precision timestamp using the system's steady clock.
      * Used internally by the logging system when timestamps are enabled.
+     * Formats into a fixed buffer with localtime_r(), so it is safe to call
+     * from the async writer thread.
      *
-     * @note Uses high-resolution clock for sub-second precision
      * @note Format is consistent and sortable for log analysis
      */
-    static std::string get_timestamp();
+    static std::string get_timestamp(std::chrono::system_clock::time_point when);
 
     /**
      * @brief Convert log level enum to string representation
@@ -285,13 +401,56 @@ class Logger {
 //  Convenience Macros for Easy Logging
 // ============================================================================
 
+/**
+ * @def NINJA_LOG_AT(level, msg)
+ * @brief Log @p msg at @p level, evaluating it only if the level is enabled
+ *
+ * Levels below logging::COMPILED_MIN_LEVEL generate no code at all; the
+ * argument is still type-checked so stripped builds cannot rot.
+ */
+#define NINJA_LOG_AT(level, msg)                                   \
+    do {                                                           \
+        if constexpr ((level) >= logging::COMPILED_MIN_LEVEL) {    \
+            if (logging::Logger::is_enabled(level)) {              \
+                logging::Logger::write((level), (msg));            \
+            }                                                      \
+        }                                                          \
+    } while (false)
+
+/**
+ * @def NINJA_LOG_FORMAT_AT(level, ...)
+ * @brief printf-style counterpart of NINJA_LOG_AT
+ */
+#define NINJA_LOG_FORMAT_AT(level, ...)                            \
+    do {                                                           \
+        if constexpr ((level) >= logging::COMPILED_MIN_LEVEL) {    \
+            if (logging::Logger::is_enabled(level)) {              \
+                logging::Logger::format((level), __VA_ARGS__);     \
+            }                                                      \
+        }                                                          \
+    } while (false)
+
+/**
+ * @def NINJA_LOG_LINES_AT(level, text)
+ * @brief Multi-line counterpart of NINJA_LOG_AT (see Logger::write_lines())
+ */
+#define NINJA_LOG_LINES_AT(level, text)                            \
+    do {                                                           \
+        if constexpr ((level) >= logging::COMPILED_MIN_LEVEL) {    \
+            if (logging::Logger::is_enabled(level)) {              \
+                logging::Logger::write_lines((level), (text));     \
+            }                                                      \
+        }                                                          \
+    } while (false)
+
 /**
  * @def LOG_DEBUG(msg)
  * @brief Convenience macro for debug-level logging
  * @param msg Message string to log
  *
  * Provides a convenient interface for debug logging without requiring
- * explicit namespace qualification. Expands to logging::Logger::debug(msg).
+ * explicit namespace qualification. @p msg is only evaluated when DEBUG
+ * messages are enabled.
  *
  * @section Usage Usage Example
  * @code
@@ -301,7 +460,7 @@ class Logger {
  * @note Only displayed when log level is set to DEBUG
  * @note Message formatting occurs only if debug level is active
  */
-#define LOG_DEBUG(msg) logging::Logger::debug(msg)
+#define LOG_DEBUG(msg) NINJA_LOG_AT(logging::Level::DEBUG, msg)
 
 /**
  * @def LOG_INFO(msg)
@@ -316,7 +475,18 @@ class Logger {
  * LOG_INFO("Device connected: " + device_name);
  * @endcode
  */
-#define LOG_INFO(msg) logging::Logger::info(msg)
+#define LOG_INFO(msg) NINJA_LOG_AT(logging::Level::INFO, msg)
+
+/**
+ * @def LOG_INFO_LINES(text)
+ * @brief Informational logging of a multi-line report, one record per line
+ *
+ * @section Usage Usage Example
+ * @code
+ * LOG_INFO_LINES(latency.summary());
+ * @endcode
+ */
+#define LOG_INFO_LINES(text) NINJA_LOG_LINES_AT(logging::Level::INFO, text)
 
 /**
  * @def LOG_WARN(msg)
@@ -331,7 +501,7 @@ class Logger {
  * LOG_WARN("Device disconnected unexpectedly, retrying...");
  * @endcode
  */
-#define LOG_WARN(msg) logging::Logger::warn(msg)
+#define LOG_WARN(msg) NINJA_LOG_AT(logging::Level::WARN, msg)
 
 /**
  * @def LOG_ERROR(msg)
@@ -348,4 +518,24 @@ class Logger {
  *
  * @note Always displayed regardless of current log level
  */
-#define LOG_ERROR(msg) logging::Logger::error(msg)
+#define LOG_ERROR(msg) NINJA_LOG_AT(logging::Level::ERROR, msg)
+
+/**
+ * @def LOG_DEBUGF(fmt, ...)
+ * @brief printf-style debug logging into the thread-local buffer
+ *
+ * @section Usage Usage Example
+ * @code
+ * LOG_DEBUGF("Key event: code=%u value=%d", ev.code, ev.value);
+ * @endcode
+ */
+#define LOG_DEBUGF(...) NINJA_LOG_FORMAT_AT(logging::Level::DEBUG, __VA_ARGS__)
+
+//! @brief printf-style informational logging (see LOG_DEBUGF)
+#define LOG_INFOF(...) NINJA_LOG_FORMAT_AT(logging::Level::INFO, __VA_ARGS__)
+
+//! @brief printf-style warning logging (see LOG_DEBUGF)
+#define LOG_WARNF(...) NINJA_LOG_FORMAT_AT(logging::Level::WARN, __VA_ARGS__)
+
+//! @brief printf-style error logging (see LOG_DEBUGF)
+#define LOG_ERRORF(...) NINJA_LOG_FORMAT_AT(logging::Level::ERROR, __VA_ARGS__)
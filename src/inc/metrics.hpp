@@ -0,0 +1,144 @@
+/**
+ * @file metrics.hpp
+ * @brief Operational counters for the metrics endpoint (--metrics)
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * Every counter lives on its own cache line, so the input thread, the Qt
+ * thread and the metrics server never contend on a shared line. Updating a
+ * counter is a single relaxed atomic add; rendering only loads them, which
+ * makes a scrape safe at any time from any thread.
+ *
+ * @section MetricsUsage Usage Example
+ * @code
+ * metrics::Metrics m;
+ * const auto slot = m.device_slot(kbd.path());
+ * m.add_events(slot, 1);          // per input event
+ * m.reports_sent.add();           // per report
+ * std::string text = m.render();  // Prometheus text exposition format
+ * @endcode
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "spsc_ring.hpp"  // CACHE_LINE_SIZE
+
+namespace pipeline {
+class LatencyTracker;
+}
+
+namespace metrics {
+
+//! @brief Slot returned by Metrics::device_slot() once every device slot is taken
+inline constexpr std::uint8_t NO_DEVICE_SLOT = 0xFF;
+
+/**
+ * @struct Counter
+ * @brief Monotonic counter (or gauge) padded to a full cache line
+ */
+struct alignas(pipeline::CACHE_LINE_SIZE) Counter {
+    std::atomic<std::uint64_t> value{0};  //!< Current value
+
+    //! @brief Count events (hot path: one relaxed add)
+    void add(std::uint64_t n = 1) noexcept { value.fetch_add(n, std::memory_order_relaxed); }
+
+    //! @brief Overwrite the value (gauges such as queue depth)
+    void set(std::uint64_t v) noexcept { value.store(v, std::memory_order_relaxed); }
+
+    [[nodiscard]] std::uint64_t load() const noexcept {
+        return value.load(std::memory_order_relaxed);
+    }
+};
+
+static_assert(sizeof(Counter) == pipeline::CACHE_LINE_SIZE, "Counter must fill one cache line");
+
+/**
+ * @class Metrics
+ * @brief Registry of every counter exported by the metrics endpoint
+ *
+ * Counters are public members so producers can update them without any
+ * indirection. Per-device event counters are claimed by path, like the
+ * latency tracker's keyboard slots, and kept after the device is unplugged.
+ *
+ * @note All members may be used from any thread
+ */
+class Metrics {
+  public:
+    //! @brief Devices that get their own event counter; further ones count as "other"
+    static constexpr std::size_t MAX_DEVICES = 16;
+
+    Counter reports_sent;           //!< HID reports handed to the transmit stage
+    Counter reports_suppressed;     //!< Unchanged reports dropped by de-duplication
+    Counter ble_writes;             //!< Reports written to the BLE characteristic
+    Counter ble_collapsed;          //!< Waiting reports merged into a newer one
+    Counter ble_queue_depth;        //!< Reports waiting for a write slot (gauge)
+    Counter ble_connects;           //!< BLE connection attempts
+    Counter ble_reconnects;         //!< Connection attempts after the first one
+    Counter ble_disconnects;        //!< Links lost after connecting
+    Counter ble_reconnected;        //!< Lost links that were ready again
+    Counter ble_reconnect_us;       //!< Sum of loss-to-ready times in microseconds
+    Counter ble_last_reconnect_us;  //!< Loss-to-ready time of the latest reconnect (gauge)
+    Counter keyboards_added;        //!< Keyboards added by hot-plug
+    Counter keyboards_removed;      //!< Keyboards removed by hot-plug
+    Counter idle_entered;           //!< Switches to power-save after idle input (--idle-timeout)
+    Counter idle_wakes;             //!< Switches back on the first key after idling
+    Counter idle;                   //!< 1 while the links are in power-save (gauge)
+
+  private:
+    struct Device {
+        std::string path;  //!< KeyboardDevice::path()
+        Counter events;    //!< Input events read from the device
+    };
+
+    std::array<Device, MAX_DEVICES> devices_;   //!< Per-device event counters
+    Counter other_events_;                      //!< Events of devices without a slot
+    std::atomic<std::size_t> device_count_{0};  //!< Published slots in devices_
+    std::mutex register_mutex_;                 //!< Serializes slot creation
+
+  public:
+    Metrics() = default;
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+    /**
+     * @brief Find or create the event counter of a device
+     * @param path Device path (KeyboardDevice::path())
+     * @return Slot for add_events(), or NO_DEVICE_SLOT if all slots are taken
+     *
+     * Takes a lock only the first time a path is seen.
+     */
+    [[nodiscard]] std::uint8_t device_slot(const std::string& path);
+
+    /**
+     * @brief Count input events read from a device (hot path: one relaxed add)
+     * @param slot Slot from device_slot()
+     * @param n Number of events
+     */
+    void add_events(std::uint8_t slot, std::uint64_t n) noexcept {
+        (slot < MAX_DEVICES ? devices_[slot].events : other_events_).add(n);
+    }
+
+    /**
+     * @brief Events read from one device
+     * @param path Device path
+     * @return Event count (0 if the device has no slot)
+     */
+    [[nodiscard]] std::uint64_t events_read(const std::string& path) const noexcept;
+
+    /**
+     * @brief Render every counter in the Prometheus text exposition format
+     * @param latency Latency histograms to export as summaries (optional)
+     * @return Exposition text, including dropped log lines from the async logger
+     */
+    [[nodiscard]] std::string render(const pipeline::LatencyTracker* latency = nullptr) const;
+};
+
+}  // namespace metrics
@@ -0,0 +1,164 @@
+/**
+ * @file metrics_server.hpp
+ * @brief Minimal scrape endpoint for the metrics registry (--metrics)
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * Serves a rendered metrics page on its own thread, so scrapes never run on
+ * the Qt thread or the input thread. Two transports are supported:
+ *
+ * - **localhost HTTP** (`--metrics 9464`): a Prometheus-compatible
+ *   `GET /metrics` endpoint bound to 127.0.0.1 only.
+ * - **Unix domain socket** (`--metrics /run/ninja_util.sock`): the page is
+ *   written to every client that connects, no request needed
+ *   (`socat - UNIX-CONNECT:/run/ninja_util.sock`).
+ *
+ * Clients are served one at a time with short socket timeouts; the server
+ * is meant for a local agent scraping every few seconds, not for traffic.
+ *
+ * @section MetricsServerUsage Usage Example
+ * @code
+ * auto endpoint = metrics::parse_endpoint("9464");
+ * metrics::MetricsServer server(*endpoint, [&]() { return registry.render(); });
+ * if (!server.is_valid() || !server.start()) { ... }
+ * @endcode
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace metrics {
+
+/**
+ * @struct Endpoint
+ * @brief Where the metrics server listens
+ */
+struct Endpoint {
+    std::string unix_path;   //!< Unix socket path (empty for TCP)
+    std::uint16_t port = 0;  //!< TCP port on 127.0.0.1 (0 for a Unix socket)
+
+    [[nodiscard]] bool is_unix() const noexcept { return !unix_path.empty(); }
+
+    /**
+     * @brief Human-readable form for log messages
+     * @return "unix:<path>" or "http://127.0.0.1:<port>/metrics"
+     */
+    [[nodiscard]] std::string describe() const {
+        return is_unix() ? "unix:" + unix_path
+                         : "http://127.0.0.1:" + std::to_string(port) + "/metrics";
+    }
+};
+
+/**
+ * @brief Parse a --metrics value
+ * @param value Absolute socket path, or a port optionally prefixed with
+ *              "127.0.0.1:" or "localhost:"
+ * @return Endpoint, or nullopt for relative paths, other hosts and bad ports
+ */
+[[nodiscard]] inline std::optional<Endpoint> parse_endpoint(std::string_view value) {
+    if (value.empty()) {
+        return std::nullopt;
+    }
+    if (value.front() == '/') {
+        return Endpoint{std::string(value), 0};
+    }
+    for (const std::string_view host : {"127.0.0.1:", "localhost:"}) {
+        if (value.substr(0, host.size()) == host) {
+            value.remove_prefix(host.size());
+            break;
+        }
+    }
+    if (value.empty() || value.size() > 5) {
+        return std::nullopt;
+    }
+    unsigned port = 0;
+    for (const char c : value) {
+        if (c < '0' || c > '9') {
+            return std::nullopt;
+        }
+        port = port * 10 + static_cast<unsigned>(c - '0');
+    }
+    if (port == 0 || port > 65535) {
+        return std::nullopt;
+    }
+    return Endpoint{"", static_cast<std::uint16_t>(port)};
+}
+
+/**
+ * @class MetricsServer
+ * @brief Listening socket plus a thread that answers scrapes
+ *
+ * @note Neither copyable nor movable; the thread captures `this`
+ */
+class MetricsServer {
+  public:
+    //! @brief Produces the page for one scrape; called on the server thread
+    using Renderer = std::function<std::string()>;
+
+  private:
+    Endpoint endpoint_;                      //!< Transport and address
+    Renderer render_;                        //!< Page producer
+    int listen_fd_{-1};                      //!< Bound, listening socket
+    int wake_fd_{-1};                        //!< eventfd that interrupts poll() on stop()
+    std::thread thread_;                     //!< Server thread
+    std::atomic<bool> stop_{false};          //!< Request the thread to exit
+    std::atomic<std::uint64_t> scrapes_{0};  //!< Clients served
+
+    void run();
+    void serve(int client);
+
+  public:
+    /**
+     * @brief Create and bind the listening socket (does not start serving)
+     * @param endpoint Where to listen; a stale Unix socket at the path is replaced
+     * @param render Page producer, must be safe to call from another thread
+     */
+    MetricsServer(Endpoint endpoint, Renderer render);
+
+    /**
+     * @brief Stop the thread, close the socket and remove the Unix socket file
+     */
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+    MetricsServer(MetricsServer&&) = delete;
+    MetricsServer& operator=(MetricsServer&&) = delete;
+
+    /**
+     * @brief Check if the socket is listening
+     * @return true if start() can be called (errno describes the failure otherwise)
+     */
+    [[nodiscard]] bool is_valid() const noexcept { return listen_fd_ >= 0 && wake_fd_ >= 0; }
+
+    /**
+     * @brief Launch the server thread
+     * @return true if the thread is running
+     */
+    bool start();
+
+    /**
+     * @brief Ask the thread to exit and join it (idempotent)
+     */
+    void stop();
+
+    [[nodiscard]] const Endpoint& endpoint() const noexcept { return endpoint_; }
+
+    /**
+     * @brief Number of clients served so far
+     * @return Scrape count
+     */
+    [[nodiscard]] std::uint64_t scrapes() const noexcept {
+        return scrapes_.load(std::memory_order_relaxed);
+    }
+};
+
+}  // namespace metrics
@@ -0,0 +1,121 @@
+/**
+ * @file mpsc_ring.hpp
+ * @brief Fixed-size lock-free multi-producer/single-consumer ring buffer
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * Used by the asynchronous log sink: any thread may log, one background
+ * thread writes. Every slot carries a sequence number (bounded MPMC queue
+ * design by D. Vyukov, restricted to one consumer), so producers only
+ * contend on a single compare-and-swap of the head counter and never wait
+ * for each other or for the consumer.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+#include "spsc_ring.hpp"  // CACHE_LINE_SIZE
+
+namespace pipeline {
+
+/**
+ * @class MpscRing
+ * @brief Bounded lock-free MPSC queue
+ * @tparam T Trivially copyable element type
+ * @tparam Capacity Number of slots, must be a power of two
+ *
+ * A slot whose sequence equals the head counter is free for the producer
+ * that claims that counter value; once written its sequence becomes
+ * counter + 1, which tells the consumer it is ready. After reading, the
+ * consumer sets it to counter + Capacity, freeing it for the next lap.
+ */
+template <typename T, std::size_t Capacity> class MpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "MpscRing capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "MpscRing elements must be trivially copyable");
+
+  private:
+    static constexpr std::size_t MASK = Capacity - 1;
+
+    struct Slot {
+        std::atomic<std::size_t> sequence;  //!< Lap-tagged state of the slot
+        T value;                            //!< Element storage
+    };
+
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head_{0};  //!< Next counter to claim
+    alignas(CACHE_LINE_SIZE) std::size_t tail_{0};               //!< Next counter to read
+    alignas(CACHE_LINE_SIZE) std::array<Slot, Capacity> slots_;  //!< Ring storage
+
+    [[nodiscard]] static std::ptrdiff_t distance(std::size_t a, std::size_t b) noexcept {
+        return static_cast<std::ptrdiff_t>(a - b);
+    }
+
+  public:
+    MpscRing() noexcept {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    /**
+     * @brief Append an element (any thread)
+     * @param value Element to copy into the ring
+     * @return false if the ring is full and the element was not stored
+     */
+    bool try_push(const T& value) noexcept {
+        std::size_t pos = head_.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots_[pos & MASK];
+            const std::size_t seq = slot->sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t diff = distance(seq, pos);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // Consumer has not freed this slot yet: full
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->value = value;
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest element (consumer thread only)
+     * @param out Receives the element
+     * @return false if the ring is empty or the oldest element is still being written
+     */
+    bool try_pop(T& out) noexcept {
+        Slot& slot = slots_[tail_ & MASK];
+        const std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+        if (distance(seq, tail_ + 1) < 0) {
+            return false;
+        }
+
+        out = slot.value;
+        slot.sequence.store(tail_ + Capacity, std::memory_order_release);
+        ++tail_;
+        return true;
+    }
+
+    /**
+     * @brief Number of slots in the ring
+     * @return Compile-time capacity
+     */
+    [[nodiscard]] static constexpr std::size_t capacity() noexcept { return Capacity; }
+};
+
+}  // namespace pipeline
@@ -0,0 +1,151 @@
+/**
+ * @file passthrough.hpp
+ * @brief Shared input (`--share-input`): the grabbed keyboards keep typing on the local host
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * The bridge keeps its exclusive grab on the keyboards, so the local host
+ * only sees what the bridge lets through: events routed locally are
+ * re-injected into a single uinput keyboard (a VirtualKeyboard) that
+ * stands in for all of them. Each event goes to the BLE pipeline, to the
+ * local host or to both, decided by one routing bit per destination:
+ *
+ * - local: Passthrough::enabled(), toggled with the `local` hotkey
+ * - BLE: the KeyEventProcessor is not paused; with `--share-input` the
+ *   `grab` hotkey pauses it instead of dropping the grab
+ *
+ * Forwarding copies nothing: consecutive local events of one read batch
+ * are handed to write(2) straight from the batch buffer (PassthroughRun).
+ * Hotkey presses are not forwarded, and turning the local route off
+ * releases every key the local host still sees as held.
+ *
+ * @section PassthroughUsage Usage Example
+ * @code
+ * device::Passthrough local;
+ * manager.ignore_device(local.devnode());  // Do not read our own output
+ * // Per read batch:
+ * device::PassthroughRun run(&local);
+ * for (const input_event& ev : batch) {
+ *     const auto action = processor.process(ev, name);  // BLE route
+ *     run.route(ev, local.enabled() && action == hotkey::Action::None);
+ * }
+ * @endcode
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <linux/input.h>
+
+#include "event_batch.hpp"
+#include "virtual_keyboard.hpp"
+
+namespace device {
+
+/**
+ * @class Passthrough
+ * @brief uinput keyboard that re-injects routed input into the local host
+ *
+ * @note Not thread-safe; used by the thread that reads the keyboards
+ */
+class Passthrough {
+  private:
+    VirtualKeyboard keyboard_;       //!< Node the local host reads
+    KeyBitmap held_;                 //!< Keys the local host currently sees pressed
+    bool enabled_{true};             //!< Routing bit: deliver input locally
+    std::uint64_t forwarded_{0};     //!< Events written to the node
+    std::uint64_t write_errors_{0};  //!< Runs the kernel rejected
+
+  public:
+    //! @brief Name of the passthrough node
+    static constexpr const char* DEVICE_NAME = "ninjaUSB passthrough keyboard";
+
+    Passthrough() : keyboard_(DEVICE_NAME) {}
+
+    /**
+     * @brief Check if the uinput node was created
+     * @return true if input can be forwarded
+     */
+    [[nodiscard]] bool is_valid() const noexcept { return keyboard_.is_valid(); }
+
+    //! @brief errno of a failed creation (see VirtualKeyboard::error())
+    [[nodiscard]] int error() const noexcept { return keyboard_.error(); }
+
+    //! @brief Device node, for KeyboardManager::ignore_device()
+    [[nodiscard]] const std::string& devnode() const noexcept { return keyboard_.devnode(); }
+
+    //! @brief Local routing bit, checked once per event
+    [[nodiscard]] bool enabled() const noexcept { return enabled_; }
+
+    /**
+     * @brief Turn local delivery on or off
+     * @param enabled false releases every key the local host still sees pressed
+     */
+    void set_enabled(bool enabled) noexcept;
+
+    /**
+     * @brief Deliver consecutive events to the local host
+     * @param events Events straight from a read batch
+     * @param count Number of events
+     */
+    void forward(const input_event* events, std::size_t count) noexcept;
+
+    [[nodiscard]] std::uint64_t forwarded() const noexcept { return forwarded_; }
+    [[nodiscard]] std::uint64_t write_errors() const noexcept { return write_errors_; }
+};
+
+/**
+ * @class PassthroughRun
+ * @brief Gathers the locally routed events of one read batch into runs
+ *
+ * Create one per read batch: the runs point into the batch buffer, which
+ * the next read reuses. Events are routed in batch order; a run ends at the
+ * first event that is not routed locally, at flush() and on destruction,
+ * so each run costs one write(2).
+ */
+class PassthroughRun {
+  private:
+    Passthrough* passthrough_;           //!< Destination (nullptr: nothing is forwarded)
+    const input_event* begin_{nullptr};  //!< First event of the open run
+    const input_event* end_{nullptr};    //!< One past its last event
+
+  public:
+    explicit PassthroughRun(Passthrough* passthrough) noexcept : passthrough_(passthrough) {}
+    ~PassthroughRun() { flush(); }
+
+    PassthroughRun(const PassthroughRun&) = delete;
+    PassthroughRun& operator=(const PassthroughRun&) = delete;
+
+    /**
+     * @brief Route the next event of the batch
+     * @param ev Event inside the batch buffer
+     * @param local true to deliver it to the local host
+     */
+    void route(const input_event& ev, bool local) noexcept {
+        if (!local) {
+            flush();
+        } else if (begin_ == nullptr || end_ != &ev) {
+            flush();
+            begin_ = &ev;
+            end_ = &ev + 1;
+        } else {
+            ++end_;
+        }
+    }
+
+    /**
+     * @brief Forward the open run now (before the routing bit changes)
+     */
+    void flush() noexcept {
+        if (begin_ != nullptr && passthrough_ != nullptr) {
+            passthrough_->forward(begin_, static_cast<std::size_t>(end_ - begin_));
+        }
+        begin_ = end_ = nullptr;
+    }
+};
+
+}  // namespace device
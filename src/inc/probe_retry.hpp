@@ -0,0 +1,167 @@
+/**
+ * @file probe_retry.hpp
+ * @brief Backoff schedule for hot-plugged input nodes that cannot be opened yet
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * udev announces a new `/dev/input/eventN` node before its rules have run,
+ * so the first open() of a freshly plugged keyboard often fails with EACCES
+ * (ACLs or group not applied yet) or ENOENT (node not created yet). Instead
+ * of losing the keyboard until the next re-plug, the keyboard manager
+ * schedules the node for another probe with exponential backoff: 50 ms,
+ * 100 ms, 200 ms, ... for up to MAX_RETRIES attempts (about 3 s in total).
+ *
+ * The class only keeps the schedule; the caller owns the timer (a timerfd
+ * in KeyboardManager) and does the probing.
+ *
+ * @section ProbeRetryUsage Usage Example
+ * @code
+ * device::ProbeRetryQueue retries;
+ * // open() failed with a retryable errno:
+ * if (!retries.schedule(path, devnum, 1, now)) { give_up(path); }
+ * arm_timer(retries.next_due());
+ * // timer fired:
+ * for (const auto& probe : retries.take_due(Clock::now())) { try_open(probe); }
+ * @endcode
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <sys/types.h>
+#include <utility>
+#include <vector>
+
+namespace device {
+
+/**
+ * @class ProbeRetryQueue
+ * @brief Pending probes of hot-plugged device nodes and when they are due
+ *
+ * Holds at most one entry per path: a new add event for a path replaces the
+ * pending probe, a remove event cancels it.
+ *
+ * @note Not thread-safe; owned by KeyboardManager
+ */
+class ProbeRetryQueue {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    //! @brief Delay before the first retry; doubled for every further one
+    static constexpr std::chrono::milliseconds INITIAL_DELAY{50};
+    //! @brief Retries after the first failed probe before giving up
+    static constexpr int MAX_RETRIES = 6;
+
+    /**
+     * @struct Probe
+     * @brief One node waiting for another open() attempt
+     */
+    struct Probe {
+        std::string path;       //!< Device node (e.g. /dev/input/event7)
+        dev_t devnum = 0;       //!< Device number from udev (0 if unknown)
+        int failures = 0;       //!< Failed probes so far
+        Clock::time_point due;  //!< When to probe again
+    };
+
+  private:
+    std::vector<Probe> pending_;  //!< Unordered; a handful of entries at most
+
+  public:
+    /**
+     * @brief Check whether an open() failure is worth retrying
+     * @param error errno of the failed open()
+     * @return true for errors udev typically resolves shortly after the add event
+     */
+    [[nodiscard]] static constexpr bool is_retryable(int error) noexcept {
+        return error == EACCES || error == EPERM || error == ENOENT || error == EBUSY;
+    }
+
+    /**
+     * @brief Delay before the next probe
+     * @param failures Failed probes so far (>= 1)
+     * @return INITIAL_DELAY * 2^(failures - 1)
+     */
+    [[nodiscard]] static constexpr Clock::duration delay_after(int failures) noexcept {
+        return INITIAL_DELAY * (1 << std::clamp(failures - 1, 0, MAX_RETRIES));
+    }
+
+    /**
+     * @brief Schedule another probe of a node
+     * @param path Device node
+     * @param devnum Device number from udev (0 if unknown)
+     * @param failures Failed probes so far, including the one just made
+     * @param now Current time
+     * @return false if the node has used up its retries (nothing is scheduled)
+     */
+    bool schedule(const std::string& path, dev_t devnum, int failures, Clock::time_point now) {
+        cancel(path);
+        if (failures > MAX_RETRIES) {
+            return false;
+        }
+        pending_.push_back({path, devnum, failures, now + delay_after(failures)});
+        return true;
+    }
+
+    /**
+     * @brief Drop the pending probe of a node
+     * @param path Device node
+     * @return true if a probe was pending
+     */
+    bool cancel(const std::string& path) {
+        const auto it = std::find_if(pending_.begin(), pending_.end(),
+                                     [&path](const Probe& probe) { return probe.path == path; });
+        if (it == pending_.end()) {
+            return false;
+        }
+        if (it != pending_.end() - 1) {
+            *it = std::move(pending_.back());
+        }
+        pending_.pop_back();
+        return true;
+    }
+
+    /**
+     * @brief Remove and return every probe that is due
+     * @param now Current time
+     * @return Due probes (unordered)
+     */
+    [[nodiscard]] std::vector<Probe> take_due(Clock::time_point now) {
+        std::vector<Probe> due;
+        for (std::size_t i = 0; i < pending_.size();) {
+            if (pending_[i].due <= now) {
+                due.push_back(std::move(pending_[i]));
+                if (i + 1 != pending_.size()) {
+                    pending_[i] = std::move(pending_.back());
+                }
+                pending_.pop_back();
+            } else {
+                ++i;
+            }
+        }
+        return due;
+    }
+
+    /**
+     * @brief Earliest due time of the pending probes
+     * @return Time to arm the retry timer for, or nullopt if nothing is pending
+     */
+    [[nodiscard]] std::optional<Clock::time_point> next_due() const noexcept {
+        if (pending_.empty()) {
+            return std::nullopt;
+        }
+        return std::min_element(pending_.begin(), pending_.end(),
+                                [](const Probe& a, const Probe& b) { return a.due < b.due; })
+            ->due;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return pending_.size(); }
+    [[nodiscard]] bool empty() const noexcept { return pending_.empty(); }
+};
+
+}  // namespace device
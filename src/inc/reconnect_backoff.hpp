@@ -0,0 +1,117 @@
+/**
+ * @file reconnect_backoff.hpp
+ * @brief Backoff schedule for reconnecting a lost BLE link
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * A link that was ready and then dropped (interference, the peripheral
+ * rebooting, ...) is reconnected instead of ending the program. The first
+ * attempt starts after INITIAL_DELAY; every failed attempt doubles the wait
+ * up to MAX_DELAY, for as long as the program runs. Once the link is ready
+ * again the outage (loss to ready) is reported so it can be logged and
+ * exported, and the schedule starts over for the next loss.
+ *
+ * The class only keeps the schedule; the caller owns the timer and the link.
+ *
+ * @section ReconnectUsage Usage Example
+ * @code
+ * ble::ReconnectBackoff backoff;
+ * // link failed (the first loss or a failed attempt):
+ * start_timer(backoff.on_failure(Clock::now()));
+ * // timer fired:
+ * backoff.begin_attempt();
+ * link.reconnect();
+ * // link ready:
+ * if (auto outage = backoff.on_connected(Clock::now())) { report(*outage); }
+ * @endcode
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+
+namespace ble {
+
+/**
+ * @class ReconnectBackoff
+ * @brief Reconnect attempts of one link and the delay before each
+ *
+ * @note Not thread-safe; one per link, driven from the Qt thread
+ */
+class ReconnectBackoff {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    //! @brief Delay before the first attempt; doubled for every further one
+    static constexpr std::chrono::milliseconds INITIAL_DELAY{250};
+    //! @brief Longest delay between two attempts
+    static constexpr std::chrono::milliseconds MAX_DELAY{30000};
+
+    //! @brief Where the link is in the reconnect cycle
+    enum class State {
+        Idle,       //!< Connected (or never lost)
+        Waiting,    //!< Lost; waiting for the next attempt
+        Connecting  //!< An attempt is in progress
+    };
+
+  private:
+    State state_ = State::Idle;  //!< Current state
+    int attempts_ = 0;           //!< Attempts since the link was lost
+    Clock::time_point lost_at_;  //!< When the link was lost
+
+  public:
+    /**
+     * @brief Delay before an attempt
+     * @param attempt Attempt number (>= 1)
+     * @return INITIAL_DELAY * 2^(attempt - 1), at most MAX_DELAY
+     */
+    [[nodiscard]] static constexpr Clock::duration delay_before(int attempt) noexcept {
+        const int doublings = std::clamp(attempt - 1, 0, 8);  // 2^8 * 250 ms is past MAX_DELAY
+        return std::min<Clock::duration>(INITIAL_DELAY * (1 << doublings), MAX_DELAY);
+    }
+
+    /**
+     * @brief The link was lost, or an attempt failed
+     * @param now Current time (starts the outage if the link was connected)
+     * @return Delay before the next attempt
+     */
+    Clock::duration on_failure(Clock::time_point now) noexcept {
+        if (state_ == State::Idle) {
+            lost_at_ = now;
+            attempts_ = 0;
+        }
+        state_ = State::Waiting;
+        return delay_before(attempts_ + 1);
+    }
+
+    /**
+     * @brief The delay has passed and an attempt is being made
+     * @return Number of this attempt (1 for the first)
+     */
+    int begin_attempt() noexcept {
+        state_ = State::Connecting;
+        return ++attempts_;
+    }
+
+    /**
+     * @brief The link is ready
+     * @param now Current time
+     * @return Time since the link was lost, or nullopt if it was not reconnecting
+     */
+    std::optional<Clock::duration> on_connected(Clock::time_point now) noexcept {
+        if (state_ == State::Idle) {
+            return std::nullopt;
+        }
+        state_ = State::Idle;
+        return now - lost_at_;
+    }
+
+    [[nodiscard]] State state() const noexcept { return state_; }
+    [[nodiscard]] bool reconnecting() const noexcept { return state_ != State::Idle; }
+    [[nodiscard]] int attempts() const noexcept { return attempts_; }
+};
+
+}  // namespace ble
@@ -0,0 +1,107 @@
+/**
+ * @file report_deduplicator.hpp
+ * @brief Transmit stage that drops HID reports identical to the last one sent
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * Sits between KeyboardState::get_report() and the BLE writer. The host
+ * only cares about changes in keyboard state, so auto-repeat events and
+ * releases of unmapped keys, which leave the report unchanged, are
+ * suppressed instead of spending BLE airtime. Keyboard and consumer reports
+ * are compared with the last report of their own kind, so a media key in
+ * between does not make an unchanged keyboard report look new.
+ *
+ * @section DedupUsage Usage Example
+ * @code
+ * pipeline::ReportDeduplicator dedup([&](const pipeline::Report& r) { send(r); });
+ * dedup.submit(state.get_report());  // Sent
+ * dedup.submit(state.get_report());  // Suppressed (unchanged)
+ * @endcode
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "report_types.hpp"
+
+namespace pipeline {
+
+/**
+ * @class ReportDeduplicator
+ * @brief Forwards a report to its sink only if it differs from the previous one
+ *
+ * @note submit() and reset() must be called from a single thread; the
+ *       counters may be read from any thread
+ */
+class ReportDeduplicator {
+  private:
+    ReportSink sink_;                           //!< Receives reports that changed
+    std::array<Report, 2> last_sent_{};         //!< Most recent keyboard and consumer report
+    std::array<bool, 2> has_sent_{};            //!< Whether last_sent_ holds a real report
+    std::atomic<std::uint64_t> sent_{0};        //!< Reports forwarded to the sink
+    std::atomic<std::uint64_t> suppressed_{0};  //!< Duplicate reports dropped
+
+  public:
+    /**
+     * @brief Construct the stage with its downstream sink
+     * @param sink Called with every report that differs from the last one sent
+     */
+    explicit ReportDeduplicator(ReportSink sink) : sink_(std::move(sink)) {}
+
+    /**
+     * @brief Offer a report for transmission
+     * @param report Current keyboard or consumer report
+     * @return true if the report was forwarded, false if it was a duplicate
+     */
+    bool submit(const Report& report) {
+        const std::size_t kind = report.is_consumer() ? 1 : 0;
+        if (has_sent_[kind] && report == last_sent_[kind]) {
+            suppressed_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        last_sent_[kind] = report;
+        has_sent_[kind] = true;
+        sent_.fetch_add(1, std::memory_order_relaxed);
+        sink_(report);
+        return true;
+    }
+
+    /**
+     * @brief Forget the last sent report so the next submit() is always forwarded
+     *
+     * Used when the host may have lost track of the keyboard state, e.g.
+     * after the BLE link was re-established.
+     */
+    void reset() noexcept { has_sent_.fill(false); }
+
+    /**
+     * @brief Get the last keyboard report that was forwarded
+     * @return Last sent keyboard report (all zeros before the first send)
+     */
+    [[nodiscard]] const Report& last_sent() const noexcept { return last_sent_[0]; }
+
+    /**
+     * @brief Number of reports forwarded to the sink
+     * @return Sent count
+     */
+    [[nodiscard]] std::uint64_t sent_count() const noexcept {
+        return sent_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Number of duplicate reports that were dropped
+     * @return Suppressed count
+     */
+    [[nodiscard]] std::uint64_t suppressed_count() const noexcept {
+        return suppressed_.load(std::memory_order_relaxed);
+    }
+};
+
+}  // namespace pipeline
@@ -0,0 +1,156 @@
+/**
+ * @file report_map.hpp
+ * @brief Assignment of HID report types to the characteristics of a service
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * A peripheral exposes one writable characteristic per report it accepts.
+ * Characteristics that carry a Report Reference descriptor (0x2908) name
+ * their report ID, which is matched against hid::ReportId. Any other
+ * writable characteristic can only take the boot keyboard report, so a
+ * peripheral without descriptors gets exactly what it got before.
+ *
+ * @section ReportMapRules Rules
+ * - Report ID 1 is the keyboard, 2 consumer control, 3 the NKRO bitmap
+ * - Without a keyboard ID, the keyboard is the characteristic with the
+ *   cached UUID (GATT cache reconnect) or else the first writable one that
+ *   is not tagged with another report ID
+ * - With a cached UUID that is not found, nothing is mapped
+ *
+ * encode_report_write() then picks the characteristic and wire form of each
+ * report: NKRO when mapped, else the boot keyboard report; consumer reports
+ * only where a consumer characteristic is mapped.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "hid_keycodes.hpp"
+#include "report_types.hpp"
+
+namespace ble {
+
+/**
+ * @struct CharacteristicInfo
+ * @brief What service discovery found out about one characteristic
+ */
+struct CharacteristicInfo {
+    std::string uuid;                       //!< Characteristic UUID
+    bool writable = false;                  //!< Write or WriteNoResponse supported
+    std::optional<std::uint8_t> report_id;  //!< Report Reference report ID, if present
+};
+
+/**
+ * @struct ReportMap
+ * @brief Index into the CharacteristicInfo list for every report type
+ */
+struct ReportMap {
+    std::optional<std::size_t> keyboard;  //!< Boot keyboard report (required)
+    std::optional<std::size_t> nkro;      //!< NKRO bitmap report
+    std::optional<std::size_t> consumer;  //!< Consumer-control report
+};
+
+/**
+ * @brief Pick the characteristic for each report type
+ * @param characteristics Characteristics of one service, in discovery order
+ * @param keyboard_uuid Keyboard characteristic of the GATT cache, if reconnecting
+ * @return Mapping; keyboard unset if the service cannot take reports
+ */
+[[nodiscard]] inline ReportMap
+map_report_characteristics(const std::vector<CharacteristicInfo>& characteristics,
+                           const std::optional<std::string>& keyboard_uuid = std::nullopt) {
+    ReportMap map;
+    std::optional<std::size_t> first_untagged;
+    std::optional<std::size_t> cached;
+    for (std::size_t i = 0; i < characteristics.size(); ++i) {
+        const CharacteristicInfo& ch = characteristics[i];
+        if (!ch.writable) {
+            continue;
+        }
+        if (keyboard_uuid && ch.uuid == *keyboard_uuid && !cached) {
+            cached = i;
+        }
+        if (!ch.report_id) {
+            if (!first_untagged) {
+                first_untagged = i;
+            }
+            continue;
+        }
+        std::optional<std::size_t>* slot = nullptr;
+        switch (static_cast<hid::ReportId>(*ch.report_id)) {
+        case hid::ReportId::Keyboard:
+            slot = &map.keyboard;
+            break;
+        case hid::ReportId::Consumer:
+            slot = &map.consumer;
+            break;
+        case hid::ReportId::Nkro:
+            slot = &map.nkro;
+            break;
+        }
+        if (slot && !*slot) {
+            *slot = i;
+        }
+    }
+
+    if (keyboard_uuid) {
+        if (!cached) {
+            return {};  // Not the cached service any more
+        }
+        map.keyboard = cached;
+    } else if (!map.keyboard) {
+        map.keyboard = first_untagged;
+    }
+    if (!map.keyboard) {
+        return {};
+    }
+    return map;
+}
+
+/**
+ * @struct ReportWrite
+ * @brief One report in the form its characteristic takes
+ */
+struct ReportWrite {
+    hid::ReportId characteristic = hid::ReportId::Keyboard;   //!< Characteristic to write
+    std::array<std::uint8_t, hid::NKRO_REPORT_SIZE> bytes{};  //!< Wire bytes
+    std::size_t size = 0;                                     //!< Bytes used
+
+    [[nodiscard]] const std::uint8_t* data() const noexcept { return bytes.data(); }
+};
+
+/**
+ * @brief Encode a report for the characteristics a peer offers
+ * @param report Keyboard or consumer report
+ * @param nkro An NKRO characteristic is mapped
+ * @param consumer A consumer-control characteristic is mapped
+ * @return Characteristic and bytes to write, or nullopt if the peer cannot take the report
+ */
+[[nodiscard]] inline std::optional<ReportWrite>
+encode_report_write(const pipeline::Report& report, bool nkro, bool consumer) noexcept {
+    ReportWrite write;
+    if (report.is_consumer()) {
+        if (!consumer) {
+            return std::nullopt;
+        }
+        write.characteristic = hid::ReportId::Consumer;
+    } else if (nkro) {
+        write.characteristic = hid::ReportId::Nkro;
+        write.bytes = report.nkro();
+        write.size = hid::NKRO_REPORT_SIZE;
+        return write;
+    }
+    write.size = report.wire_size();
+    std::copy(report.begin(), report.begin() + write.size, write.bytes.begin());
+    return write;
+}
+
+}  // namespace ble
@@ -0,0 +1,119 @@
+/**
+ * @file report_types.hpp
+ * @brief Report types shared by the input → BLE pipeline stages
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "hid_keycodes.hpp"
+
+namespace pipeline {
+
+/**
+ * @struct Report
+ * @brief One finished HID report: keyboard state or consumer control
+ *
+ * A keyboard report carries the 8-byte boot report plus the keys held
+ * beyond its six slots, so every link can send whichever of the boot and
+ * NKRO forms its peripheral understands. A consumer report carries the
+ * pressed usage (little-endian) in bytes 0-1. Element access, size() and
+ * brace initialization work on the boot bytes, as with a plain array:
+ * `Report{modifiers, 0, key}` is a keyboard report.
+ */
+struct Report {
+    std::array<std::uint8_t, hid::KEYBOARD_REPORT_SIZE> bytes{};  //!< Boot report or usage
+    hid::ReportId id = hid::ReportId::Keyboard;                   //!< Keyboard or Consumer
+    std::array<std::uint8_t, hid::NKRO_BITMAP_SIZE> overflow{};   //!< Keys beyond the six slots
+
+    //! @brief Keyboard report from the boot bytes and the overflow bitmap
+    [[nodiscard]] static Report keyboard(
+        const std::array<std::uint8_t, hid::KEYBOARD_REPORT_SIZE>& boot,
+        const std::array<std::uint8_t, hid::NKRO_BITMAP_SIZE>& overflow = {}) noexcept {
+        return Report{boot, hid::ReportId::Keyboard, overflow};
+    }
+
+    //! @brief Consumer-control report (usage 0: released)
+    [[nodiscard]] static Report consumer(std::uint16_t usage) noexcept {
+        Report report{};
+        report.id = hid::ReportId::Consumer;
+        report.bytes[0] = static_cast<std::uint8_t>(usage & 0xFF);
+        report.bytes[1] = static_cast<std::uint8_t>(usage >> 8);
+        return report;
+    }
+
+    [[nodiscard]] bool is_consumer() const noexcept { return id == hid::ReportId::Consumer; }
+
+    //! @brief Pressed consumer usage (consumer reports only)
+    [[nodiscard]] std::uint16_t consumer_usage() const noexcept {
+        return static_cast<std::uint16_t>(bytes[0] | (bytes[1] << 8));
+    }
+
+    /**
+     * @brief Encode a keyboard report as an NKRO bitmap report
+     * @return Modifier byte followed by the bitmap of every held key
+     */
+    [[nodiscard]] std::array<std::uint8_t, hid::NKRO_REPORT_SIZE> nkro() const noexcept {
+        std::array<std::uint8_t, hid::NKRO_REPORT_SIZE> out{};
+        out[0] = bytes[0];
+        for (std::size_t i = 0; i < hid::NKRO_BITMAP_SIZE; ++i) {
+            out[1 + i] = overflow[i];
+        }
+        for (std::size_t i = 2; i < bytes.size(); ++i) {
+            if (bytes[i] != 0 && bytes[i] < hid::NKRO_USAGE_COUNT) {
+                out[1 + bytes[i] / 8] |= static_cast<std::uint8_t>(1U << (bytes[i] % 8));
+            }
+        }
+        return out;
+    }
+
+    //! @brief Wire size of the boot or consumer form
+    [[nodiscard]] std::size_t wire_size() const noexcept {
+        return is_consumer() ? hid::CONSUMER_REPORT_SIZE : hid::KEYBOARD_REPORT_SIZE;
+    }
+
+    [[nodiscard]] std::uint8_t& operator[](std::size_t i) noexcept { return bytes[i]; }
+    [[nodiscard]] std::uint8_t operator[](std::size_t i) const noexcept { return bytes[i]; }
+    [[nodiscard]] std::uint8_t* data() noexcept { return bytes.data(); }
+    [[nodiscard]] const std::uint8_t* data() const noexcept { return bytes.data(); }
+    [[nodiscard]] static constexpr std::size_t size() noexcept { return hid::KEYBOARD_REPORT_SIZE; }
+    [[nodiscard]] std::uint8_t* begin() noexcept { return bytes.data(); }
+    [[nodiscard]] std::uint8_t* end() noexcept { return bytes.data() + bytes.size(); }
+    [[nodiscard]] const std::uint8_t* begin() const noexcept { return bytes.data(); }
+    [[nodiscard]] const std::uint8_t* end() const noexcept { return bytes.data() + bytes.size(); }
+
+    friend bool operator==(const Report& a, const Report& b) noexcept {
+        return a.id == b.id && a.bytes == b.bytes && a.overflow == b.overflow;
+    }
+    friend bool operator!=(const Report& a, const Report& b) noexcept { return !(a == b); }
+};
+
+//! @brief Destination for finished reports (BLE writer, queue producer, test mock)
+using ReportSink = std::function<void(const Report&)>;
+
+//! @brief Keyboard slot used when a report is not attributed to a keyboard
+inline constexpr std::uint8_t NO_KEYBOARD_SLOT = 0xFF;
+
+/**
+ * @struct ReportTiming
+ * @brief Where a report spent its time, carried along with it (--latency-stats)
+ *
+ * All stamps are CLOCK_MONOTONIC nanoseconds (the clock of
+ * std::chrono::steady_clock and, once KeyboardDevice selected it, of
+ * input_event::time). An event_ns of 0 means the report is not being timed.
+ */
+struct ReportTiming {
+    std::uint64_t event_ns = 0;                //!< Kernel timestamp of the oldest event behind it
+    std::uint64_t read_ns = 0;                 //!< When that event was read from libevdev
+    std::uint64_t built_ns = 0;                //!< When the report was handed to the sink
+    std::uint8_t keyboard = NO_KEYBOARD_SLOT;  //!< LatencyTracker keyboard slot
+};
+
+}  // namespace pipeline
@@ -0,0 +1,202 @@
+/**
+ * @file scan_selector.hpp
+ * @brief Early-exit device selection while the BLE scan is still running
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * Waiting for QBluetoothDeviceDiscoveryAgent::finished means waiting for
+ * the whole --scan-timeout even when the device we want advertised in the
+ * first few hundred milliseconds. The selector looks at every discovered
+ * device instead:
+ * - a device matching --target is connected to immediately; with several
+ *   targets, once every one of them has been seen;
+ * - in auto-connect mode the first NinjaUSB device starts a short grace
+ *   window; if no second NinjaUSB device shows up before it expires, that
+ *   device is connected to. A second candidate cancels the early exit and
+ *   the scan runs to completion so the user can choose.
+ *
+ * The class is independent of Qt: main.cpp feeds it addresses and names
+ * and drives the grace timer.
+ *
+ * @section SelectorUsage Usage Example
+ * @code
+ * ble::ScanSelector selector(options.target_device, !options.disable_auto_connect,
+ *                            options.scan_grace);
+ * // deviceDiscovered(info):
+ * switch (selector.on_discovered(address, name)) {
+ *     case ble::ScanSelector::Action::ConnectNow: agent.stop(); connect(info); break;
+ *     case ble::ScanSelector::Action::StartGrace: candidate = info; timer.start(grace); break;
+ *     case ble::ScanSelector::Action::CancelGrace: timer.stop(); break;
+ *     case ble::ScanSelector::Action::None: break;
+ * }
+ * @endcode
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ble {
+
+/**
+ * @class ScanSelector
+ * @brief Decides from discovery events whether scanning can stop early
+ *
+ * @note Not thread-safe; driven from the Qt thread
+ */
+class ScanSelector {
+  public:
+    //! @brief What the caller should do after a discovery event
+    enum class Action {
+        None,         //!< Keep scanning
+        ConnectNow,   //!< Stop scanning and connect to this device
+        StartGrace,   //!< Remember this device and start the grace timer
+        CancelGrace   //!< Another candidate appeared; stop the grace timer, scan to the end
+    };
+
+  private:
+    std::vector<std::string> targets_;          //!< --target addresses or names (empty: none)
+    std::vector<bool> matched_;                 //!< matched_[i]: targets_[i] was seen
+    bool auto_connect_;                         //!< Auto-connect to a single NinjaUSB device
+    int grace_ms_;                              //!< Grace window for a second candidate
+    std::vector<std::string> ninja_addresses_;  //!< Distinct NinjaUSB devices seen so far
+    bool decided_{false};                       //!< An early connect was already requested
+
+    //! @brief Addresses match in either case (--target may be written in lower case)
+    static bool same_address(std::string_view a, std::string_view b) noexcept {
+        return a.size() == b.size() &&
+               std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+                   return std::tolower(static_cast<unsigned char>(x)) ==
+                          std::tolower(static_cast<unsigned char>(y));
+               });
+    }
+
+  public:
+    /**
+     * @brief Construct selector for the current options
+     * @param target Address or name given with --target (empty: none)
+     * @param auto_connect false with --disable-auto-connect
+     * @param grace_ms Grace window in milliseconds (0: connect to the first NinjaUSB device)
+     */
+    ScanSelector(std::string target, bool auto_connect, int grace_ms)
+        : ScanSelector(target.empty() ? std::vector<std::string>{}
+                                      : std::vector<std::string>{std::move(target)},
+                       auto_connect, grace_ms) {}
+
+    /**
+     * @brief Construct selector for several targets (multi-link fan-out)
+     * @param targets Addresses or names given with --target (empty: none)
+     * @param auto_connect false with --disable-auto-connect (unused with targets)
+     * @param grace_ms Grace window in milliseconds (unused with targets)
+     */
+    ScanSelector(std::vector<std::string> targets, bool auto_connect, int grace_ms)
+        : targets_(std::move(targets)), matched_(targets_.size(), false),
+          auto_connect_(auto_connect), grace_ms_(grace_ms) {}
+
+    /**
+     * @brief Check whether a device name looks like a NinjaUSB dongle
+     * @param name Advertised name
+     * @return true if the name contains "ninja" (case-insensitive)
+     */
+    [[nodiscard]] static bool is_ninja_name(std::string_view name) noexcept {
+        constexpr std::string_view needle = "ninja";
+        auto it = std::search(name.begin(), name.end(), needle.begin(), needle.end(),
+                              [](char a, char b) {
+                                  return std::tolower(static_cast<unsigned char>(a)) == b;
+                              });
+        return it != name.end();
+    }
+
+    /**
+     * @brief Feed a deviceDiscovered() event
+     * @param address Device address as text
+     * @param name Advertised name
+     * @return Action to take
+     */
+    [[nodiscard]] Action on_discovered(const std::string& address, const std::string& name) {
+        return on_discovered(address, name, is_ninja_name(name));
+    }
+
+    /**
+     * @brief Feed a deviceDiscovered() event that was already classified
+     * @param address Device address as text
+     * @param name Advertised name
+     * @param ninja The device is a NinjaUSB unit (see DeviceCache)
+     * @return Action to take
+     */
+    [[nodiscard]] Action on_discovered(const std::string& address, const std::string& name,
+                                       bool ninja) {
+        if (decided_) {
+            return Action::None;
+        }
+
+        if (!targets_.empty()) {
+            for (std::size_t i = 0; i < targets_.size(); ++i) {
+                if (!matched_[i] &&
+                    (same_address(address, targets_[i]) || name == targets_[i])) {
+                    matched_[i] = true;
+                    break;
+                }
+            }
+            if (std::find(matched_.begin(), matched_.end(), false) != matched_.end()) {
+                return Action::None;  // Still waiting for another target
+            }
+            decided_ = true;
+            return Action::ConnectNow;
+        }
+
+        if (!auto_connect_ || !ninja ||
+            std::find(ninja_addresses_.begin(), ninja_addresses_.end(), address) !=
+                ninja_addresses_.end()) {
+            return Action::None;
+        }
+
+        ninja_addresses_.push_back(address);
+        if (ninja_addresses_.size() > 1) {
+            return Action::CancelGrace;
+        }
+        if (grace_ms_ <= 0) {
+            decided_ = true;
+            return Action::ConnectNow;
+        }
+        return Action::StartGrace;
+    }
+
+    /**
+     * @brief Report that the grace timer expired
+     * @return true if the remembered device should be connected to now
+     */
+    [[nodiscard]] bool on_grace_expired() noexcept {
+        if (decided_ || ninja_addresses_.size() != 1) {
+            return false;
+        }
+        decided_ = true;
+        return true;
+    }
+
+    /**
+     * @brief Check whether an early connect was requested
+     * @return true once ConnectNow was returned or the grace window succeeded
+     */
+    [[nodiscard]] bool decided() const noexcept { return decided_; }
+
+    /**
+     * @brief Forget all candidates (e.g. before a new scan)
+     */
+    void reset() noexcept {
+        matched_.assign(matched_.size(), false);
+        ninja_addresses_.clear();
+        decided_ = false;
+    }
+
+    [[nodiscard]] int grace_ms() const noexcept { return grace_ms_; }
+};
+
+}  // namespace ble
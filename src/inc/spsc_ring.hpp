@@ -0,0 +1,120 @@
+/**
+ * @file spsc_ring.hpp
+ * @brief Fixed-size lock-free single-producer/single-consumer ring buffer
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * Used to hand finished HID reports from the input thread to the Qt/BLE
+ * thread without locks or allocation. Exactly one thread may call
+ * try_push() and exactly one (other) thread may call try_pop().
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace pipeline {
+
+//! @brief Assumed cache line size used to keep producer and consumer indices apart
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * @class SpscRing
+ * @brief Bounded wait-free SPSC queue
+ * @tparam T Trivially copyable element type
+ * @tparam Capacity Number of slots, must be a power of two
+ *
+ * Head and tail are free-running counters; the slot index is the counter
+ * masked with Capacity - 1, so all Capacity slots are usable.
+ */
+template <typename T, std::size_t Capacity> class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscRing capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "SpscRing elements must be trivially copyable");
+
+  private:
+    static constexpr std::size_t MASK = Capacity - 1;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head_{0};  //!< Next slot to write (producer)
+    std::size_t high_water_{0};                                  //!< Max occupancy (producer-owned)
+    std::atomic<std::size_t> high_water_published_{0};           //!< high_water_ readable by anyone
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail_{0};  //!< Next slot to read (consumer)
+    alignas(CACHE_LINE_SIZE) std::array<T, Capacity> slots_{};   //!< Element storage
+
+  public:
+    /**
+     * @brief Append an element (producer thread only)
+     * @param value Element to copy into the ring
+     * @return false if the ring is full and the element was not stored
+     */
+    bool try_push(const T& value) noexcept {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        if (head - tail >= Capacity) {
+            return false;
+        }
+
+        slots_[head & MASK] = value;
+        head_.store(head + 1, std::memory_order_release);
+
+        const std::size_t occupancy = head + 1 - tail;
+        if (occupancy > high_water_) {
+            high_water_ = occupancy;
+            high_water_published_.store(occupancy, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest element (consumer thread only)
+     * @param out Receives the element
+     * @return false if the ring was empty
+     */
+    bool try_pop(T& out) noexcept {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        const std::size_t head = head_.load(std::memory_order_acquire);
+        if (tail == head) {
+            return false;
+        }
+
+        out = slots_[tail & MASK];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Approximate number of queued elements (exact when called from either end)
+     * @return Current occupancy
+     */
+    [[nodiscard]] std::size_t size() const noexcept {
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        const std::size_t head = head_.load(std::memory_order_acquire);
+        return head - tail;
+    }
+
+    /**
+     * @brief Check whether the ring is empty
+     * @return true if no elements are queued
+     */
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+    /**
+     * @brief Highest occupancy observed since construction
+     * @return High-water mark in elements; safe to read from any thread
+     */
+    [[nodiscard]] std::size_t high_water_mark() const noexcept {
+        return high_water_published_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Number of slots in the ring
+     * @return Compile-time capacity
+     */
+    [[nodiscard]] static constexpr std::size_t capacity() noexcept { return Capacity; }
+};
+
+}  // namespace pipeline
@@ -0,0 +1,164 @@
+/**
+ * @file text_injector.hpp
+ * @brief Typing text into the host as a precomputed sequence of HID reports
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * `--type` and `--type-file` turn text into keyboard reports up front
+ * (compile_text()), so streaming it costs nothing per character beyond the
+ * BLE write. Characters are looked up as the Linux key that produces them
+ * on a US layout, plus Left Shift where needed, and that key through the
+ * kKeyboardUsage table, so injected text uses exactly the usages a
+ * physical keyboard would send.
+ *
+ * A key is released before it is typed again and before the shift state
+ * changes; any other key follows directly (rollover), so most text costs
+ * one report per character instead of two.
+ *
+ * TextInjector hands the reports out one at a time and keeps the progress.
+ * Like TransmitScheduler it is independent of Qt: the caller asks for the
+ * next report when the link's transmit queue is empty (see main.cpp), so
+ * nothing is collapsed and the text goes out at one report per connection
+ * interval. typing_step() decides whether the text can still go out once
+ * links drop.
+ *
+ * @section InjectUsage Usage Example
+ * @code
+ * std::string error;
+ * auto sequence = inject::compile_text("hello, world\n", error);
+ * inject::TextInjector injector(std::move(*sequence));
+ * while (auto report = injector.next(Clock::now())) {
+ *     link.submit(*report);  // once the previous one was written
+ * }
+ * @endcode
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "report_types.hpp"
+
+namespace inject {
+
+/**
+ * @struct KeySequence
+ * @brief Text compiled into keyboard reports
+ */
+struct KeySequence {
+    std::vector<pipeline::Report> reports;  //!< Press and release reports, ending with a release
+    std::size_t characters = 0;             //!< Characters typed by the reports
+};
+
+/**
+ * @brief Compile text into keyboard reports (US layout)
+ * @param text Printable ASCII, tab and newline; `\r` is skipped, so CRLF files type
+ *             one Enter per line
+ * @param error Receives the offending character and its offset on failure
+ * @return Report sequence, or nullopt if the text contains a character that cannot be typed
+ */
+[[nodiscard]] std::optional<KeySequence> compile_text(std::string_view text, std::string& error);
+
+/**
+ * @class TextInjector
+ * @brief Streams a KeySequence and measures how fast it goes out
+ *
+ * @note Not thread-safe; driven from the Qt thread
+ */
+class TextInjector {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+  private:
+    KeySequence sequence_;         //!< Reports to send
+    std::size_t next_{0};          //!< Index of the next report
+    std::size_t typed_{0};         //!< Press reports handed out so far
+    Clock::time_point started_{};  //!< Time of the first report
+    Clock::time_point last_{};     //!< Time of the latest report
+
+  public:
+    explicit TextInjector(KeySequence sequence) noexcept : sequence_(std::move(sequence)) {}
+
+    /**
+     * @brief Take the next report
+     * @param now Current time (the first call starts the clock)
+     * @return Report to submit, or nullopt once the whole sequence was handed out
+     */
+    [[nodiscard]] std::optional<pipeline::Report> next(Clock::time_point now) noexcept {
+        if (done()) {
+            return std::nullopt;
+        }
+        if (next_ == 0) {
+            started_ = now;
+        }
+        last_ = now;
+        const pipeline::Report& report = sequence_.reports[next_++];
+        if (report[2] != 0) {
+            ++typed_;  // One press per character
+        }
+        return report;
+    }
+
+    [[nodiscard]] bool done() const noexcept { return next_ >= sequence_.reports.size(); }
+
+    //! @brief Characters typed so far
+    [[nodiscard]] std::size_t typed() const noexcept { return typed_; }
+
+    //! @brief Characters in the sequence
+    [[nodiscard]] std::size_t characters() const noexcept { return sequence_.characters; }
+
+    //! @brief Reports in the sequence
+    [[nodiscard]] std::size_t reports() const noexcept { return sequence_.reports.size(); }
+
+    /**
+     * @brief Time from the first to the latest report
+     * @return Elapsed time (zero before the second report)
+     */
+    [[nodiscard]] Clock::duration elapsed() const noexcept { return last_ - started_; }
+
+    /**
+     * @brief Achieved typing rate
+     * @return Characters per second between the first and the latest report (0 until measurable)
+     */
+    [[nodiscard]] double chars_per_second() const noexcept {
+        const double seconds = std::chrono::duration<double>(elapsed()).count();
+        return seconds > 0.0 ? static_cast<double>(typed_) / seconds : 0.0;
+    }
+};
+
+/**
+ * @enum TypingStep
+ * @brief What the next typing step does, given the links the text is typed to
+ */
+enum class TypingStep {
+    Type,     //!< At least one typing link is ready
+    Wait,     //!< Every typing link is reconnecting
+    Abandon,  //!< No typing link is left; the rest of the text cannot be typed
+};
+
+/**
+ * @brief Decide the next typing step
+ * @param typing Bit i set: link i was typed to and has not been retired since
+ * @param ready Bit i set: link i is connected and ready
+ * @return Type, Wait while a typing link may come back, or Abandon
+ *
+ * A retired link's slot may be reused by another device, so its bit is cleared
+ * rather than waited for: leftover text never goes to a device it was not
+ * started on.
+ */
+[[nodiscard]] constexpr TypingStep typing_step(std::uint32_t typing, std::uint32_t ready) noexcept {
+    if (typing == 0) {
+        return TypingStep::Abandon;
+    }
+    return (typing & ready) != 0 ? TypingStep::Type : TypingStep::Wait;
+}
+
+}  // namespace inject
@@ -0,0 +1,251 @@
+/**
+ * @file trace_recorder.hpp
+ * @brief Binary event trace of the input → BLE pipeline (--trace)
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * Latency problems ("a key sometimes sticks", "chords arrive late") are hard
+ * to reproduce from logs. With --trace the pipeline appends fixed-size
+ * binary records to a preallocated, memory-mapped file: every raw
+ * input_event read from a keyboard, every HID report produced, every report
+ * written to the BLE characteristic and every controller state or
+ * connection-interval change, each stamped with CLOCK_MONOTONIC. Recording
+ * is a counter increment and a 32-byte copy, so it can stay enabled while
+ * measuring. The ninja_util-replay tool feeds a trace back through the
+ * pipeline offline.
+ *
+ * @section TraceFormat File Format
+ * A 64-byte TraceHeader followed by `capacity` 32-byte TraceRecords, all in
+ * host byte order. The header's record count is written when the recorder
+ * is closed and the file is truncated to the used size; a trace left behind
+ * by a crash has a count of 0 and is read up to the first all-zero record.
+ *
+ * @section TraceUsage Usage Example
+ * @code
+ * trace::TraceRecorder recorder("/tmp/ninja.trace", 16 * 1024 * 1024, 0);
+ * if (recorder.is_valid()) {
+ *     recorder.record_input(trace::device_id_from_path(kbd.path()), ev);
+ * }
+ * // Later, offline:
+ * if (auto t = trace::load_trace("/tmp/ninja.trace")) {
+ *     for (const auto& r : t->records) { ... }
+ * }
+ * @endcode
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <linux/input.h>
+
+#include "report_types.hpp"
+
+namespace trace {
+
+//! @brief Default trace file size (--trace-size) in MiB
+inline constexpr int DEFAULT_TRACE_SIZE_MB = 16;
+
+//! @brief Header flag: the trace was recorded with --coalesce-frames
+inline constexpr std::uint32_t TRACE_FLAG_COALESCE_FRAMES = 1u << 0;
+
+//! @brief Device id used for records that do not come from a keyboard
+inline constexpr std::uint16_t NO_DEVICE = 0xFFFF;
+
+//! @brief What a TraceRecord describes
+enum class RecordType : std::uint8_t {
+    InputEvent = 1,          //!< Raw input_event read from a keyboard
+    HidReport = 2,           //!< Report produced by the key event processor
+    BleWrite = 3,            //!< Report written to the BLE characteristic
+    ConnectionState = 4,     //!< QLowEnergyController state change (value = state)
+    ConnectionInterval = 5,  //!< Negotiated connection interval (value = microseconds)
+};
+
+/**
+ * @struct TraceRecord
+ * @brief One fixed-size trace entry
+ */
+struct TraceRecord {
+    std::uint64_t timestamp_ns;  //!< CLOCK_MONOTONIC time of the record
+    std::uint8_t type;           //!< RecordType
+    std::uint8_t report_id;      //!< hid::ReportId (HidReport, BleWrite; 0 in older traces), else 0
+    std::uint16_t device;        //!< Keyboard id (/dev/input/eventN → N) or NO_DEVICE
+    std::uint16_t event_type;    //!< input_event type (InputEvent only)
+    std::uint16_t event_code;    //!< input_event code (InputEvent only)
+    std::int32_t value;          //!< input_event value, controller state or interval
+    std::uint8_t report[8];      //!< Boot report or consumer usage (HidReport and BleWrite only)
+    std::uint32_t padding;       //!< Always 0, keeps the record at 32 bytes
+
+    [[nodiscard]] RecordType record_type() const noexcept {
+        return static_cast<RecordType>(type);
+    }
+};
+
+static_assert(sizeof(TraceRecord) == 32, "TraceRecord layout is part of the file format");
+
+/**
+ * @struct TraceHeader
+ * @brief File header at offset 0
+ */
+struct TraceHeader {
+    char magic[8];              //!< "NJTRACE" followed by a NUL byte
+    std::uint32_t version;      //!< Format version (TRACE_VERSION)
+    std::uint32_t record_size;  //!< sizeof(TraceRecord)
+    std::uint64_t capacity;     //!< Records the file was preallocated for
+    std::uint64_t count;        //!< Records written (0 until the recorder is closed)
+    std::uint64_t start_ns;     //!< CLOCK_MONOTONIC time the recording started
+    std::uint32_t flags;        //!< TRACE_FLAG_* bits
+    std::uint32_t reserved;     //!< Always 0
+    std::uint8_t padding[16];   //!< Always 0, keeps the header at 64 bytes
+};
+
+static_assert(sizeof(TraceHeader) == 64, "TraceHeader layout is part of the file format");
+
+//! @brief Current file format version
+inline constexpr std::uint32_t TRACE_VERSION = 1;
+
+/**
+ * @brief Read CLOCK_MONOTONIC
+ * @return Nanoseconds since an arbitrary fixed point
+ */
+[[nodiscard]] std::uint64_t monotonic_ns() noexcept;
+
+/**
+ * @brief Derive a compact keyboard id from its device node
+ * @param path Device path such as "/dev/input/event3"
+ * @return Trailing event number (3), or NO_DEVICE if the path has none
+ */
+[[nodiscard]] std::uint16_t device_id_from_path(const std::string& path) noexcept;
+
+/**
+ * @class TraceRecorder
+ * @brief Appends TraceRecords to a preallocated memory-mapped file
+ *
+ * The whole file is allocated and mapped up front, so recording never
+ * calls into the kernel. Once the file is full further records are counted
+ * as dropped; the recorder never grows the file.
+ *
+ * @note All record_*() functions may be called from any thread
+ * @note Neither copyable nor movable
+ */
+class TraceRecorder {
+  private:
+    int fd_{-1};                             //!< Trace file descriptor
+    void* map_{nullptr};                     //!< Start of the mapping
+    std::size_t map_size_{0};                //!< Mapping length in bytes
+    TraceHeader* header_{nullptr};           //!< Header inside the mapping
+    TraceRecord* records_{nullptr};          //!< Record array inside the mapping
+    std::uint64_t capacity_{0};              //!< Records that fit into the file
+    std::atomic<std::uint64_t> next_{0};     //!< Next record index to claim
+    std::atomic<std::uint64_t> dropped_{0};  //!< Records lost because the file was full
+
+  public:
+    /**
+     * @brief Create (or truncate) a trace file and map it
+     * @param path Trace file path
+     * @param size_bytes File size to preallocate, header included
+     * @param flags TRACE_FLAG_* bits describing the recording
+     *
+     * @note Does not throw; check is_valid() after construction
+     */
+    TraceRecorder(const std::string& path, std::size_t size_bytes, std::uint32_t flags);
+
+    /**
+     * @brief Finish the trace (see close())
+     */
+    ~TraceRecorder();
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    [[nodiscard]] bool is_valid() const noexcept { return records_ != nullptr; }
+
+    /**
+     * @brief Append a record
+     * @param record Record to store; the timestamp is used as given
+     * @return false if the file is full (or the recorder is invalid)
+     */
+    bool append(const TraceRecord& record) noexcept;
+
+    /**
+     * @brief Record a raw keyboard event
+     * @param device Keyboard id (see device_id_from_path())
+     * @param ev Event as read from libevdev
+     */
+    void record_input(std::uint16_t device, const input_event& ev) noexcept;
+
+    /**
+     * @brief Record a report
+     * @param type RecordType::HidReport or RecordType::BleWrite
+     * @param report Report contents
+     */
+    void record_report(RecordType type, const pipeline::Report& report) noexcept;
+
+    /**
+     * @brief Record a controller state change
+     * @param state QLowEnergyController::ControllerState as an integer
+     */
+    void record_connection_state(int state) noexcept;
+
+    /**
+     * @brief Record a negotiated connection interval
+     * @param interval Connection interval
+     */
+    void record_connection_interval(std::chrono::microseconds interval) noexcept;
+
+    /**
+     * @brief Number of records stored so far
+     * @return Stored count (at most capacity())
+     */
+    [[nodiscard]] std::uint64_t recorded() const noexcept;
+
+    /**
+     * @brief Number of records lost because the file was full
+     * @return Dropped count
+     */
+    [[nodiscard]] std::uint64_t dropped() const noexcept {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::uint64_t capacity() const noexcept { return capacity_; }
+
+    /**
+     * @brief Write the record count, unmap and truncate the file to its used size
+     *
+     * Must not race with record_*() calls; stop every producer first.
+     * Further records are ignored. Safe to call more than once.
+     */
+    void close() noexcept;
+};
+
+/**
+ * @struct Trace
+ * @brief A trace file read back into memory
+ */
+struct Trace {
+    TraceHeader header;                //!< File header as stored
+    std::vector<TraceRecord> records;  //!< Records in file order
+};
+
+/**
+ * @brief Read a trace file
+ * @param path Trace file path
+ * @return Trace contents, or nullopt if the file is missing or not a trace
+ */
+[[nodiscard]] std::optional<Trace> load_trace(const std::string& path);
+
+/**
+ * @brief Name of a record type for tool output
+ * @param type Record type
+ * @return Short lowercase name ("input", "report", ...)
+ */
+[[nodiscard]] const char* to_string(RecordType type) noexcept;
+
+}  // namespace trace
@@ -0,0 +1,223 @@
+/**
+ * @file transmit_queue.hpp
+ * @brief Bounded, edge-preserving backlog of HID reports waiting for the BLE link
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * When reports are produced faster than the connection interval allows,
+ * the newest report may replace the one still waiting at the back of the
+ * queue, as long as this does not hide a transition. A key that was
+ * pressed in the waiting report and released again in the new one (or the
+ * other way round) must reach the host, so such reports are queued
+ * separately instead of collapsed.
+ *
+ * @section CollapseRule Collapse Rule
+ * With B the state before the waiting tail report T and N the new report,
+ * T is replaced by N if no key or modifier that changed between B and T
+ * changes again between T and N:
+ * @code
+ * ((B ^ T) & (T ^ N)) == 0   // evaluated over modifiers and the key bitmap
+ * @endcode
+ * The rule must hold both for the full key set (boot slots plus overflow
+ * keys, as an NKRO peer sees it) and for the boot slots alone, so a key
+ * moving between the two is never lost on either kind of peer. Only
+ * keyboard reports collapse; consumer reports are queued as they come and
+ * B is the last keyboard report before T.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "report_types.hpp"
+
+namespace pipeline {
+
+/**
+ * @class TransmitQueue
+ * @brief Fixed-size FIFO of reports with lossless collapsing of the tail
+ *
+ * @note Not thread-safe; owned by the BLE (Qt) thread
+ */
+class TransmitQueue {
+  public:
+    //! @brief Maximum number of reports waiting for the link
+    static constexpr std::size_t CAPACITY = 32;
+
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @struct Entry
+     * @brief Queued report and the time its oldest contributing state was enqueued
+     */
+    struct Entry {
+        Report report{};             //!< Report to write
+        Clock::time_point enqueued;  //!< Enqueue time (kept when the tail is collapsed)
+        ReportTiming timing{};       //!< Latency stamps of the oldest contributing report
+    };
+
+    //! @brief Outcome of push()
+    enum class PushResult {
+        Queued,     //!< Appended as a new entry
+        Collapsed,  //!< Replaced the waiting tail entry without losing an edge
+        Full        //!< Not stored; the caller must make room first
+    };
+
+  private:
+    std::array<Entry, CAPACITY> entries_{};  //!< Ring storage
+    std::size_t head_{0};                    //!< Index of the oldest entry
+    std::size_t size_{0};                    //!< Number of queued entries
+    std::size_t high_water_{0};              //!< Largest size_ observed
+    Report baseline_{};                      //!< Last keyboard report removed by pop()
+
+    /**
+     * @brief Per-key view of a report: modifier byte plus 256-bit usage bitmap
+     */
+    struct KeySet {
+        std::uint8_t modifiers{0};
+        std::array<std::uint64_t, 4> keys{};
+    };
+
+    [[nodiscard]] static KeySet key_set(const Report& report, bool with_overflow) noexcept {
+        KeySet set;
+        set.modifiers = report[0];
+        for (std::size_t i = 2; i < report.size(); ++i) {
+            if (report[i] != 0) {
+                set.keys[report[i] >> 6] |= std::uint64_t{1} << (report[i] & 63U);
+            }
+        }
+        if (with_overflow) {
+            for (std::size_t byte = 0; byte < report.overflow.size(); ++byte) {
+                set.keys[byte / 8] |= std::uint64_t{report.overflow[byte]} << ((byte % 8) * 8);
+            }
+        }
+        return set;
+    }
+
+    [[nodiscard]] static bool keeps_edges(const KeySet& b, const KeySet& t,
+                                          const KeySet& n) noexcept {
+        if (((b.modifiers ^ t.modifiers) & (t.modifiers ^ n.modifiers)) != 0) {
+            return false;
+        }
+        for (std::size_t w = 0; w < b.keys.size(); ++w) {
+            if (((b.keys[w] ^ t.keys[w]) & (t.keys[w] ^ n.keys[w])) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //! @brief Last keyboard report before the tail, or the baseline
+    [[nodiscard]] const Report& before_tail() const noexcept {
+        for (std::size_t i = size_ - 1; i > 0; --i) {
+            const Report& report = entries_[(head_ + i - 1) % CAPACITY].report;
+            if (!report.is_consumer()) {
+                return report;
+            }
+        }
+        return baseline_;
+    }
+
+  public:
+    /**
+     * @brief Check whether the waiting report can be replaced without losing an edge
+     * @param before State the host will have before the tail report is written
+     * @param tail Report currently waiting at the back of the queue
+     * @param next Newer report
+     * @return true if writing only @p next is equivalent to writing both (edge-wise)
+     */
+    [[nodiscard]] static bool can_collapse(const Report& before, const Report& tail,
+                                           const Report& next) noexcept {
+        if (tail.is_consumer() || next.is_consumer()) {
+            return false;
+        }
+        return keeps_edges(key_set(before, true), key_set(tail, true), key_set(next, true)) &&
+               keeps_edges(key_set(before, false), key_set(tail, false), key_set(next, false));
+    }
+
+    /**
+     * @brief Queue a report, collapsing it into the waiting tail when lossless
+     * @param report Report to queue
+     * @param now Enqueue timestamp
+     * @param timing Latency stamps of the report (kept by the tail when collapsing)
+     * @return How the report was stored (or Full if it was not)
+     */
+    PushResult push(const Report& report, Clock::time_point now,
+                    const ReportTiming& timing = {}) noexcept {
+        if (size_ > 0) {
+            Entry& tail = entries_[(head_ + size_ - 1) % CAPACITY];
+            if (can_collapse(before_tail(), tail.report, report)) {
+                tail.report = report;  // Keep the older timestamp for latency accounting
+                return PushResult::Collapsed;
+            }
+        }
+
+        if (size_ == CAPACITY) {
+            return PushResult::Full;
+        }
+
+        entries_[(head_ + size_) % CAPACITY] = {report, now, timing};
+        ++size_;
+        if (size_ > high_water_) {
+            high_water_ = size_;
+        }
+        return PushResult::Queued;
+    }
+
+    /**
+     * @brief Remove the oldest report
+     * @param out Receives the entry
+     * @return false if the queue was empty
+     */
+    bool pop(Entry& out) noexcept {
+        if (size_ == 0) {
+            return false;
+        }
+        out = entries_[head_];
+        if (!out.report.is_consumer()) {
+            baseline_ = out.report;
+        }
+        head_ = (head_ + 1) % CAPACITY;
+        --size_;
+        return true;
+    }
+
+    /**
+     * @brief Record a report that bypassed the queue
+     * @param report Report written directly to the link
+     *
+     * Keeps the collapse baseline in sync when the queue is empty and a
+     * report is written immediately.
+     */
+    void note_written(const Report& report) noexcept {
+        if (!report.is_consumer()) {
+            baseline_ = report;
+        }
+    }
+
+    /**
+     * @brief Forget all waiting reports and reset the baseline to "all released"
+     */
+    void clear() noexcept {
+        head_ = 0;
+        size_ = 0;
+        baseline_ = Report{};
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+    /**
+     * @brief Largest number of reports that were waiting at once
+     * @return Queue high-water mark
+     */
+    [[nodiscard]] std::size_t high_water_mark() const noexcept { return high_water_; }
+
+    [[nodiscard]] static constexpr std::size_t capacity() noexcept { return CAPACITY; }
+};
+
+}  // namespace pipeline
@@ -0,0 +1,186 @@
+/**
+ * @file transmit_scheduler.hpp
+ * @brief Connection-interval-aware pacing of HID report writes to the BLE link
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * WriteWithoutResponse has no flow control: writing faster than the
+ * peripheral's connection interval only grows the Bluetooth stack's
+ * internal queue and adds latency to every later report. The scheduler
+ * writes at most `writes_per_interval` reports per connection interval and
+ * keeps everything else in a bounded TransmitQueue, where stale
+ * intermediate states are collapsed into the latest one without dropping
+ * any press/release edge.
+ *
+ * The class is independent of Qt: the caller supplies timestamps and arms
+ * a timer for the returned delay (see main.cpp). With a LatencyTracker
+ * attached, the ReportTiming passed to submit() is completed with the time
+ * of the actual write.
+ *
+ * @section SchedulerUsage Usage Example
+ * @code
+ * pipeline::TransmitScheduler scheduler([&](const pipeline::Report& r) { write_ble(r); });
+ * if (auto wait = scheduler.submit(report, Clock::now())) {
+ *     timer.start(ceil<milliseconds>(*wait));  // then call scheduler.service(Clock::now())
+ * }
+ * @endcode
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "report_types.hpp"
+#include "transmit_queue.hpp"
+
+namespace metrics {
+class Metrics;
+}
+
+namespace pipeline {
+
+class LatencyTracker;
+
+/**
+ * @struct TransmitStats
+ * @brief Counters describing scheduler behaviour since construction
+ */
+struct TransmitStats {
+    std::uint64_t submitted = 0;         //!< Reports handed to submit()
+    std::uint64_t written = 0;           //!< Reports written to the link
+    std::uint64_t collapsed = 0;         //!< Reports merged into a waiting report
+    std::uint64_t forced_writes = 0;     //!< Writes issued early because the queue was full
+    std::uint64_t latency_total_us = 0;  //!< Sum of enqueue → write latencies
+    std::uint64_t latency_max_us = 0;    //!< Largest enqueue → write latency
+
+    /**
+     * @brief Mean enqueue → write latency
+     * @return Average latency in microseconds (0 before the first write)
+     */
+    [[nodiscard]] std::uint64_t latency_mean_us() const noexcept {
+        return written == 0 ? 0 : latency_total_us / written;
+    }
+};
+
+/**
+ * @class TransmitScheduler
+ * @brief Paces report writes to the negotiated BLE connection interval
+ *
+ * @note Not thread-safe; owned by the BLE (Qt) thread
+ */
+class TransmitScheduler {
+  public:
+    using Clock = TransmitQueue::Clock;
+
+    //! @brief Interval assumed until the controller reports the negotiated one
+    static constexpr std::chrono::microseconds DEFAULT_INTERVAL{15000};
+
+    //! @brief Reports allowed per connection interval by default
+    static constexpr int DEFAULT_WRITES_PER_INTERVAL = 1;
+
+  private:
+    ReportSink writer_;                   //!< Performs the actual BLE write
+    TransmitQueue queue_;                 //!< Reports waiting for a write slot
+    std::chrono::microseconds interval_;  //!< Current connection interval
+    int writes_per_interval_;             //!< Write budget per interval
+    Clock::time_point next_write_{};      //!< Earliest time of the next write
+    TransmitStats stats_;                 //!< Behaviour counters
+    LatencyTracker* latency_{nullptr};    //!< Report→write histograms, optional
+    metrics::Metrics* metrics_{nullptr};  //!< Write/collapse/queue-depth counters, optional
+
+    [[nodiscard]] std::chrono::microseconds write_spacing() const noexcept {
+        return interval_ / writes_per_interval_;
+    }
+
+    void write(const TransmitQueue::Entry& entry, Clock::time_point now);
+
+  public:
+    /**
+     * @brief Construct scheduler with a low-level report writer
+     * @param writer Called for every report that is actually written
+     * @param interval Initial connection interval
+     * @param writes_per_interval Reports allowed per interval (clamped to >= 1)
+     */
+    explicit TransmitScheduler(ReportSink writer,
+                               std::chrono::microseconds interval = DEFAULT_INTERVAL,
+                               int writes_per_interval = DEFAULT_WRITES_PER_INTERVAL);
+
+    /**
+     * @brief Offer a report for transmission
+     * @param report Report to send
+     * @param now Current time
+     * @param timing Latency stamps of the report (default: not timed)
+     * @return Delay until service() must be called, or nullopt if nothing is waiting
+     *
+     * Writes immediately when the link is idle; otherwise the report is
+     * queued (or collapsed into the waiting one). If the queue is full the
+     * oldest report is written early so that no edge is ever dropped.
+     */
+    std::optional<Clock::duration> submit(const Report& report, Clock::time_point now,
+                                          const ReportTiming& timing = {});
+
+    /**
+     * @brief Write the next waiting report if its slot has arrived
+     * @param now Current time
+     * @return Delay until the next call is needed, or nullopt if the queue is empty
+     */
+    std::optional<Clock::duration> service(Clock::time_point now);
+
+    /**
+     * @brief Write every waiting report immediately (e.g. before exiting)
+     * @param now Current time
+     */
+    void flush(Clock::time_point now);
+
+    /**
+     * @brief Drop all waiting reports (e.g. after the link was lost)
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Update the pacing after a connection-parameter change
+     * @param interval Negotiated connection interval (ignored if not positive)
+     */
+    void set_connection_interval(std::chrono::microseconds interval) noexcept;
+
+    /**
+     * @brief Record the report→write and end-to-end stages of every write
+     * @param tracker Latency tracker, or nullptr to stop; must outlive the scheduler
+     *
+     * Write times are the `now` values passed in, so they must be on the
+     * steady_clock time base (as they are in main.cpp).
+     */
+    void set_latency_tracker(LatencyTracker* tracker) noexcept { latency_ = tracker; }
+
+    /**
+     * @brief Count writes and collapses and publish the queue depth in a metrics registry
+     * @param registry Metrics registry, or nullptr to stop; must outlive the scheduler
+     */
+    void set_metrics(metrics::Metrics* registry) noexcept { metrics_ = registry; }
+
+    [[nodiscard]] std::chrono::microseconds connection_interval() const noexcept {
+        return interval_;
+    }
+
+    /**
+     * @brief Number of reports currently waiting
+     * @return Queue depth
+     */
+    [[nodiscard]] std::size_t queue_depth() const noexcept { return queue_.size(); }
+
+    /**
+     * @brief Largest number of reports that were waiting at once
+     * @return Queue high-water mark
+     */
+    [[nodiscard]] std::size_t queue_high_water_mark() const noexcept {
+        return queue_.high_water_mark();
+    }
+
+    [[nodiscard]] const TransmitStats& stats() const noexcept { return stats_; }
+};
+
+}  // namespace pipeline
@@ -0,0 +1,122 @@
+/**
+ * @file virtual_keyboard.hpp
+ * @brief uinput keyboard for injecting key events into the local input stack
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * A VirtualKeyboard is a /dev/input/event* node backed by /dev/uinput.
+ * Events written to it go through the kernel input core exactly like the
+ * events of a USB keyboard, so udev announces the node, DeviceMonitor
+ * picks it up as a hot-plugged keyboard and KeyboardDevice reads it with
+ * kernel timestamps. The loopback benchmark (benchmarks/bench_loopback.cpp)
+ * uses it to drive the whole input side without hardware, and
+ * `--share-input` uses it to hand the grabbed keyboards' input back to the
+ * local host (see passthrough.hpp).
+ *
+ * The node offers every keyboard key (no mouse, joystick or gamepad
+ * buttons, so udev classifies it as a keyboard only) and no auto-repeat,
+ * so the only events it produces are the ones written.
+ *
+ * @section VirtualKeyboardUsage Usage Example
+ * @code
+ * device::VirtualKeyboard kbd("ninjaUSB loopback keyboard");
+ * if (!kbd.is_valid()) {
+ *     std::cerr << "uinput: " << std::strerror(kbd.error()) << "\n";
+ *     return 1;
+ * }
+ * kbd.key(KEY_A, 1);  // Press, followed by SYN_REPORT
+ * kbd.key(KEY_A, 0);
+ * @endcode
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+struct input_event;      //!< Kernel input event (linux/input.h)
+struct libevdev;         //!< Capability template of the virtual device
+struct libevdev_uinput;  //!< uinput device created from the template
+
+namespace device {
+
+/**
+ * @class VirtualKeyboard
+ * @brief RAII wrapper for a uinput keyboard node
+ *
+ * @note Creating the node needs write access to /dev/uinput (root or the
+ *       uinput group); is_valid() is false and error() tells why otherwise
+ * @note Neither copyable nor movable; the node is removed on destruction
+ */
+class VirtualKeyboard {
+  private:
+    libevdev* evdev_{nullptr};          //!< Capabilities the node was created with
+    libevdev_uinput* uinput_{nullptr};  //!< The uinput device
+    std::string devnode_;               //!< /dev/input/event* path of the node
+    int error_{0};                      //!< errno of a failed creation, 0 otherwise
+
+  public:
+    /**
+     * @brief Create the uinput node
+     * @param name Device name reported to the input core (and to log output)
+     */
+    explicit VirtualKeyboard(const std::string& name);
+
+    /**
+     * @brief Remove the node and free the template
+     */
+    ~VirtualKeyboard();
+
+    VirtualKeyboard(const VirtualKeyboard&) = delete;
+    VirtualKeyboard& operator=(const VirtualKeyboard&) = delete;
+    VirtualKeyboard(VirtualKeyboard&&) = delete;
+    VirtualKeyboard& operator=(VirtualKeyboard&&) = delete;
+
+    /**
+     * @brief Check if the node was created
+     * @return true if events can be written
+     */
+    [[nodiscard]] bool is_valid() const noexcept { return uinput_ != nullptr; }
+
+    /**
+     * @brief Reason the node could not be created
+     * @return errno value (EACCES, ENOENT, ...), 0 if is_valid()
+     */
+    [[nodiscard]] int error() const noexcept { return error_; }
+
+    /**
+     * @brief Device node of the virtual keyboard
+     * @return Path such as /dev/input/event7, empty if the kernel did not report one
+     *
+     * Matches KeyboardDevice::path() once the node was picked up.
+     */
+    [[nodiscard]] const std::string& devnode() const noexcept { return devnode_; }
+
+    /**
+     * @brief Write one raw event
+     * @param type Event type (EV_KEY, EV_SYN, ...)
+     * @param code Event code
+     * @param value Event value
+     * @return true if the kernel accepted the event
+     */
+    bool write(unsigned int type, unsigned int code, int value) noexcept;
+
+    /**
+     * @brief Write a run of events with a single write(2)
+     * @param events Events as read from a keyboard; their timestamps are ignored
+     * @param count Number of events
+     * @return true if the kernel accepted every event
+     */
+    bool write(const input_event* events, std::size_t count) noexcept;
+
+    /**
+     * @brief Press or release a key as its own frame
+     * @param code Linux KEY_* code
+     * @param value 1 press, 0 release
+     * @return true if both the key event and the SYN_REPORT were accepted
+     */
+    bool key(unsigned int code, int value) noexcept;
+};
+
+}  // namespace device
@@ -0,0 +1,310 @@
+/**
+ * @file input_thread.cpp
+ * @brief Implementation of the dedicated keyboard input thread
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include "input_thread.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <vector>
+
+#include <linux/input.h>
+
+#include "device_manager.hpp"
+#include "latency_tracker.hpp"
+#include "logger.hpp"
+#include "metrics.hpp"
+#include "passthrough.hpp"
+#include "trace_recorder.hpp"
+
+namespace pipeline {
+
+namespace {
+constexpr auto QUEUE_FULL_BACKOFF = std::chrono::microseconds(100);  //!< Wait before re-pushing
+}  // namespace
+
+InputThread::InputThread(device::KeyboardManager& manager, Config config, bool verbose)
+    : manager_(manager), config_(config),
+      processor_([this](const Report& report) { push_report(report); }, verbose,
+                 config.coalesce_frames) {
+    processor_.set_trace(config.trace);
+    processor_.set_latency_tracker(config.latency);
+    processor_.set_metrics(config.metrics);
+    processor_.set_chords(config.chords);
+    notify_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (!is_valid()) {
+        LOG_ERROR("Failed to create input thread eventfd (" + std::string(std::strerror(errno)) +
+                  ")");
+    }
+}
+
+InputThread::~InputThread() {
+    stop();
+    if (notify_fd_ >= 0) {
+        close(notify_fd_);
+    }
+    if (wake_fd_ >= 0) {
+        close(wake_fd_);
+    }
+}
+
+/**
+ * @brief Launch the input thread
+ * @return true if the thread is running
+ *
+ * After this call the KeyboardManager belongs to the input thread, which also
+ * takes over hot-plug processing through the udev monitor fd.
+ */
+bool InputThread::start() {
+    if (!is_valid() || thread_.joinable()) {
+        return false;
+    }
+
+    stop_.store(false, std::memory_order_release);
+    thread_ = std::thread([this]() { run(); });
+    return true;
+}
+
+void InputThread::stop() {
+    if (!thread_.joinable()) {
+        return;
+    }
+
+    stop_.store(true, std::memory_order_release);
+    const std::uint64_t one = 1;
+    [[maybe_unused]] ssize_t written = write(wake_fd_, &one, sizeof(one));
+    thread_.join();
+}
+
+/**
+ * @brief Input thread main loop
+ *
+ * Sleeps in poll() on all keyboard fds, the udev monitor and the wake fd.
+ * Readable keyboards are drained completely before the consumer is signalled
+ * once, so a burst of events costs a single wake-up of the BLE thread.
+ */
+void InputThread::run() {
+    apply_scheduling();
+
+    // Private copy of the manager's cached pollfd array plus the wake fd. It is only
+    // refreshed after update_devices() changes the keyboard list, so entry i keeps
+    // matching keyboards()[i] and steady-state iterations do not allocate.
+    std::vector<pollfd> pfds;
+    std::size_t keyboard_count = 0;
+    auto refresh_poll_fds = [&]() {
+        const device::PollFdSet set = manager_.poll_fds();
+        pfds.assign(set.begin(), set.end());
+        pfds.push_back({wake_fd_, POLLIN, 0});
+        keyboard_count = set.keyboard_count;
+    };
+    refresh_poll_fds();
+
+    while (!stop_.load(std::memory_order_acquire)) {
+        if (poll(pfds.data(), pfds.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_ERROR("Input thread poll() failed (" + std::string(std::strerror(errno)) + ")");
+            break;
+        }
+
+        if (pfds.back().revents & POLLIN) {
+            continue;  // stop() was called
+        }
+
+        for (std::size_t i = 0; i < keyboard_count; ++i) {
+            if (!(pfds[i].revents & (POLLIN | POLLERR | POLLHUP))) {
+                continue;
+            }
+
+            auto& kbd = manager_.keyboard(i);
+            const std::uint16_t trace_id =
+                config_.trace ? trace::device_id_from_path(kbd.path()) : trace::NO_DEVICE;
+            ReportTiming timing{};
+            if (config_.latency) {
+                timing.keyboard = config_.latency->keyboard_slot(kbd.path());
+            }
+            const std::uint8_t metrics_slot = config_.metrics
+                                                  ? config_.metrics->device_slot(kbd.path())
+                                                  : metrics::NO_DEVICE_SLOT;
+            int rc = 0;
+            while (rc == 0) {
+                const device::EventBatch batch = kbd.read_batch();
+                rc = batch.status;
+                if (config_.metrics) {
+                    config_.metrics->add_events(metrics_slot, batch.count);
+                }
+                if (config_.latency) {
+                    timing.read_ns = monotonic_now_ns();
+                }
+                device::PassthroughRun local(config_.passthrough);
+                for (const input_event& ev : batch) {
+                    if (config_.trace) {
+                        config_.trace->record_input(trace_id, ev);
+                    }
+                    if (config_.latency) {
+                        timing.event_ns = event_time_ns(ev);
+                    }
+                    const hotkey::Action action = processor_.process(ev, kbd.name(), timing);
+                    local.route(ev, action == hotkey::Action::None && config_.passthrough &&
+                                        config_.passthrough->enabled());
+                    if (action == hotkey::Action::None) {
+                        continue;
+                    }
+                    if (action == hotkey::Action::Exit) {
+                        exit_requested_.store(true, std::memory_order_release);
+                        signal_consumer();
+                        return;
+                    }
+                    if (action == hotkey::Action::ToggleGrab) {
+                        toggle_grab();
+                    } else if (action == hotkey::Action::ToggleLocal) {
+                        toggle_local();
+                    } else {
+                        actions_.fetch_or(1U << static_cast<unsigned>(action),
+                                          std::memory_order_release);
+                        report_pending_ = true;  // Wake the consumer with the reports
+                    }
+                }
+            }
+            if (rc < 0 && rc != -EAGAIN) {
+                // Stop polling the device until udev removes it; poll() skips negative fds
+                pfds[i].fd = -1;
+            }
+        }
+
+        if (report_pending_) {
+            report_pending_ = false;
+            signal_consumer();
+        }
+
+        // Hot-plug last (udev monitor or probe retry timer): update_devices() may
+        // invalidate the keyboards reference
+        const device::PollFdSet hotplug{pfds.data(), pfds.size() - 1, keyboard_count};
+        if (hotplug.hotplug_ready()) {
+            if (manager_.update_devices()) {
+                refresh_poll_fds();
+                LOG_DEBUG("Device list updated");
+            }
+        }
+    }
+}
+
+/**
+ * @brief Hand the keyboards to the local host, or take them back
+ *
+ * Runs on the input thread, which owns the keyboards; the peer gets a
+ * release report before the grab is dropped. With `--share-input` the grab
+ * stays and only the BLE route is paused.
+ */
+void InputThread::toggle_grab() {
+    if (config_.passthrough) {
+        // Shared input keeps the grab; only the BLE route is switched
+        const bool pause = !processor_.paused();
+        processor_.set_paused(pause);
+        LOG_INFO(pause ? "BLE route off; input only reaches the local host"
+                       : "BLE route on; forwarding input");
+        return;
+    }
+    const bool release = manager_.grabbed();
+    processor_.set_paused(release);
+    manager_.set_grabbed(!release);
+    LOG_INFO(release ? "Keyboards released to the local host; input is not forwarded"
+                     : "Keyboards grabbed again; forwarding input");
+}
+
+/**
+ * @brief Start or stop delivering input to the local host (`--share-input`)
+ */
+void InputThread::toggle_local() {
+    if (!config_.passthrough) {
+        LOG_INFO("Input is not shared (--share-input); local hotkey ignored");
+        return;
+    }
+    const bool enable = !config_.passthrough->enabled();
+    config_.passthrough->set_enabled(enable);
+    LOG_INFO(enable ? "Local route on; input also reaches the local host"
+                    : "Local route off; input only goes to BLE");
+}
+
+/**
+ * @brief Apply SCHED_FIFO priority and CPU affinity to the calling thread
+ *
+ * Failures (typically missing CAP_SYS_NICE) are logged and the thread keeps
+ * running with the default policy.
+ */
+void InputThread::apply_scheduling() const {
+    if (config_.rt_priority > 0) {
+        sched_param param{};
+        param.sched_priority = config_.rt_priority;
+        const int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (err != 0) {
+            LOG_WARN("Failed to set SCHED_FIFO priority " + std::to_string(config_.rt_priority) +
+                     " for input thread (" + std::strerror(err) + ")");
+        } else {
+            LOG_DEBUG("Input thread running with SCHED_FIFO priority " +
+                      std::to_string(config_.rt_priority));
+        }
+    }
+
+    if (config_.cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(config_.cpu, &cpus);
+        const int err = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (err != 0) {
+            LOG_WARN("Failed to pin input thread to CPU " + std::to_string(config_.cpu) + " (" +
+                     std::strerror(err) + ")");
+        } else {
+            LOG_DEBUG("Input thread pinned to CPU " + std::to_string(config_.cpu));
+        }
+    }
+}
+
+/**
+ * @brief Queue one report for the BLE thread
+ * @param report Finished 8-byte HID report
+ *
+ * The report is queued with the processor's last_timing(), so the BLE thread
+ * can finish the latency measurement when it writes the report.
+ *
+ * Reports are never dropped: a full ring means the BLE thread is stalled, so
+ * the input thread wakes it and backs off until a slot frees up (the kernel
+ * keeps buffering input in the meantime).
+ */
+void InputThread::push_report(const Report& report) {
+    const TimedReport entry{report, processor_.last_timing()};
+    while (!queue_.try_push(entry)) {
+        queue_full_waits_.fetch_add(1, std::memory_order_relaxed);
+        signal_consumer();
+        if (stop_.load(std::memory_order_acquire)) {
+            return;
+        }
+        std::this_thread::sleep_for(QUEUE_FULL_BACKOFF);
+    }
+    report_pending_ = true;
+}
+
+void InputThread::signal_consumer() const {
+    const std::uint64_t one = 1;
+    [[maybe_unused]] ssize_t written = write(notify_fd_, &one, sizeof(one));
+}
+
+void InputThread::clear_notification() const {
+    std::uint64_t value = 0;
+    [[maybe_unused]] ssize_t bytes = read(notify_fd_, &value, sizeof(value));
+}
+
+}  // namespace pipeline
@@ -0,0 +1,225 @@
+/**
+ * @file key_event_processor.cpp
+ * @brief Implementation of the EV_KEY → HID report converter
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include "key_event_processor.hpp"
+
+#include <string>
+#include <utility>
+
+#include "latency_tracker.hpp"
+#include "logger.hpp"
+#include "metrics.hpp"
+#include "trace_recorder.hpp"
+
+namespace pipeline {
+
+KeyEventProcessor::KeyEventProcessor(ReportSink sink, bool verbose, bool coalesce_frames)
+    : transmit_([this, sink = std::move(sink)](const Report& report) {
+          if (trace_) {
+              trace_->record_report(trace::RecordType::HidReport, report);  // Before the write
+          }
+          sink(report);
+      }),
+      chords_(hotkey::ChordMatcher::defaults()), verbose_(verbose),
+      coalesce_frames_(coalesce_frames) {}
+
+/**
+ * @brief Offer a report to the de-duplication stage
+ * @param report Keyboard or consumer report
+ * @param timing Stamps of the event behind the report
+ */
+void KeyEventProcessor::transmit(const Report& report, const ReportTiming& timing) {
+    if (paused_) {
+        return;
+    }
+    last_timing_ = timing;
+    if (latency_ && last_timing_.event_ns != 0) {
+        last_timing_.built_ns = monotonic_now_ns();
+    }
+    const bool sent = transmit_.submit(report);
+    if (sent && latency_) {
+        latency_->on_report_built(last_timing_);
+    }
+    if (metrics_) {
+        (sent ? metrics_->reports_sent : metrics_->reports_suppressed).add();
+    }
+    if (!verbose_) {
+        return;
+    }
+
+    if (!sent) {
+        LOG_DEBUG("Suppressed unchanged HID report");
+    } else if (report.is_consumer()) {
+        LOG_DEBUGF("Sent consumer report: usage 0x%04x", report.consumer_usage());
+    } else {
+        LOG_DEBUGF("Sent HID report: [%u, %u, %u, %u, %u, %u, %u, %u]", report[0], report[1],
+                   report[2], report[3], report[4], report[5], report[6], report[7]);
+    }
+}
+
+/**
+ * @brief Offer the current keyboard state, including keys beyond the six slots
+ */
+void KeyEventProcessor::transmit_state(const ReportTiming& timing) {
+    transmit(Report::keyboard(state_.get_report(), state_.get_overflow_bitmap()), timing);
+}
+
+/**
+ * @brief Offer the current consumer-control usage
+ */
+void KeyEventProcessor::transmit_consumer(const ReportTiming& timing) {
+    transmit(Report::consumer(consumer_usage_), timing);
+}
+
+/**
+ * @brief Track the held media key
+ * @param linux_code Linux input event code
+ * @param value Event value (0=release, 1=press, 2=repeat)
+ * @return true if the held consumer usage changed
+ *
+ * A consumer report holds a single usage, so the latest press wins and
+ * releasing an older media key leaves it in place.
+ */
+bool KeyEventProcessor::apply_consumer_event(int linux_code, int value) noexcept {
+    const auto usage = hid::get_consumer_usage(linux_code);
+    if (!usage) {
+        return false;
+    }
+    const std::uint16_t next = value == 1 ? *usage
+                               : value == 0 && consumer_usage_ == *usage ? std::uint16_t{0}
+                                                                         : consumer_usage_;
+    if (next == consumer_usage_) {
+        return false;
+    }
+    consumer_usage_ = next;
+    return true;
+}
+
+/**
+ * @brief Stop or resume sending reports
+ * @param paused true to release everything on the peer first
+ *
+ * Reports are still de-duplicated against the last one sent, so resuming
+ * only sends what differs from the release sent when pausing.
+ */
+void KeyEventProcessor::set_paused(bool paused) {
+    if (paused == paused_) {
+        return;
+    }
+    if (paused) {
+        transmit(Report{}, {});
+        if (consumer_usage_ != 0) {
+            transmit(Report::consumer(0), {});
+        }
+        frame_pending_ = false;
+        consumer_pending_ = false;
+        pending_timing_ = {};
+        paused_ = true;
+        return;
+    }
+    paused_ = false;
+    transmit_state({});
+    if (consumer_usage_ != 0) {
+        transmit_consumer({});
+    }
+}
+
+/**
+ * @brief Feed one input event through the processor
+ * @param ev Event read from the keyboard
+ * @param source Human-readable device name used in debug logging
+ * @param timing Event and read stamps for latency tracking
+ * @return Action of the hotkey chord completed by the event, or hotkey::Action::None
+ *
+ * Press, auto-repeat and release events all transmit the resulting state,
+ * so a release reports the keys that are still held. Media keys update the
+ * consumer report instead. Unchanged reports (auto-repeat, unmapped keys)
+ * are dropped by the de-duplication stage. When coalescing, the reports are
+ * deferred to the next SYN_REPORT.
+ */
+hotkey::Action KeyEventProcessor::process(const input_event& ev, const std::string& source,
+                                          const ReportTiming& timing) {
+    if (ev.type == EV_SYN) {
+        if (coalesce_frames_ && ev.code == SYN_REPORT && (frame_pending_ || consumer_pending_)) {
+            const ReportTiming frame_timing = std::exchange(pending_timing_, ReportTiming{});
+            if (std::exchange(frame_pending_, false)) {
+                transmit_state(frame_timing);
+            }
+            if (std::exchange(consumer_pending_, false)) {
+                transmit_consumer(frame_timing);
+            }
+        }
+        return hotkey::Action::None;
+    }
+
+    if (ev.type != EV_KEY) {
+        return hotkey::Action::None;
+    }
+
+    if (verbose_) {
+        LOG_DEBUGF("Key event: code=%u value=%d from %s", static_cast<unsigned>(ev.code), ev.value,
+                   source.c_str());
+    }
+
+    const auto usage = hid::get_keyboard_usage(ev.code);
+    if (usage && swallowed_ != 0 && *usage == swallowed_) {
+        if (ev.value == 0) {
+            swallowed_ = 0;  // The chord key was never sent, so neither is its release
+        }
+        return hotkey::Action::None;
+    }
+
+    const bool keyboard = hid::apply_key_event(state_, ev.code, ev.value);
+    if (keyboard && ev.value == 1) {
+        const hotkey::Action action = chords_.match(state_, *usage);
+        if (action != hotkey::Action::None) {
+            if (verbose_) {
+                LOG_DEBUG("Hotkey: " + std::string(hotkey::action_name(action)));
+            }
+            state_.set_key_state(*usage, false);  // The chord key itself is not forwarded
+            if (action != hotkey::Action::Exit) {
+                swallowed_ = *usage;
+                return action;
+            }
+
+            // Send empty reports to release all keys before exit
+            state_.clear();
+            frame_pending_ = false;
+            consumer_pending_ = false;
+            pending_timing_ = {};
+            transmit_state(timing);
+            if (consumer_usage_ != 0) {
+                consumer_usage_ = 0;
+                transmit_consumer(timing);
+            }
+            if (verbose_) {
+                LOG_DEBUG("Sent empty HID report before exit");
+            }
+            return action;
+        }
+    }
+    if (!keyboard && !apply_consumer_event(ev.code, ev.value)) {
+        return hotkey::Action::None;  // Unmapped key or unknown value, state unchanged
+    }
+
+    if (!coalesce_frames_) {
+        if (keyboard) {
+            transmit_state(timing);
+        } else {
+            transmit_consumer(timing);
+        }
+        return hotkey::Action::None;
+    }
+    if (!frame_pending_ && !consumer_pending_) {
+        pending_timing_ = timing;  // The frame's reports are as old as its first change
+    }
+    (keyboard ? frame_pending_ : consumer_pending_) = true;
+    return hotkey::Action::None;
+}
+
+}  // namespace pipeline
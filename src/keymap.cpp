@@ -0,0 +1,307 @@
+/**
+ * @file keymap.cpp
+ * @brief Keymap file parser and table compiler
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include "keymap.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <sstream>
+#include <system_error>
+#include <utility>
+
+#include <libevdev/libevdev.h>
+
+namespace keymap {
+
+namespace {
+
+/**
+ * @brief One `FROM = TO` line
+ */
+struct Binding {
+    std::string layer;   //!< Layer it is bound on (empty: base)
+    std::uint16_t from;  //!< Key as read from the keyboard
+    std::uint16_t to;    //!< Key to send (0: drop), unless hold is set
+    std::string hold;    //!< Layer the key holds (`layer NAME = KEY`), empty otherwise
+};
+
+/**
+ * @brief A section as written in the file, before compiling
+ */
+struct RawSection {
+    KeyboardMatch match;
+    std::vector<std::string> layers;  //!< Layers defined in this section
+    std::vector<Binding> bindings;    //!< In file order
+};
+
+std::string trim(const std::string& text) {
+    const auto begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) {
+        return {};
+    }
+    const auto end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+std::string upper(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    return text;
+}
+
+std::vector<std::string> split_words(const std::string& text) {
+    std::istringstream in(text);
+    std::vector<std::string> words;
+    for (std::string word; in >> word;) {
+        words.push_back(word);
+    }
+    return words;
+}
+
+/**
+ * @brief Find a layer by name, case-insensitive
+ * @return Index into names, or nullopt
+ */
+std::optional<std::size_t> find_layer(const std::vector<std::string>& names,
+                                      const std::string& name) {
+    const std::string wanted = upper(name);
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        if (upper(names[i]) == wanted) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Build the tables of a section
+ * @param inherited Lines that apply to every keyboard (nullptr for the Any section itself)
+ * @param own The section
+ * @return Base layer first, then one table per layer
+ */
+DeviceKeymap compile(const RawSection* inherited, const RawSection& own) {
+    DeviceKeymap keymap;
+    keymap.layer_names.push_back("base");
+    for (const RawSection* section : {inherited, &own}) {
+        if (!section) {
+            continue;
+        }
+        for (const auto& name : section->layers) {
+            if (!find_layer(keymap.layer_names, name)) {
+                keymap.layer_names.push_back(name);
+            }
+        }
+    }
+
+    Table base{};
+    for (std::size_t code = 0; code < KEY_COUNT; ++code) {
+        base[code] = static_cast<std::uint16_t>(code);
+    }
+    keymap.layers.assign(keymap.layer_names.size(), base);
+
+    // Base bindings first: every layer falls back to them
+    for (const bool on_layer : {false, true}) {
+        for (const RawSection* section : {inherited, &own}) {
+            if (!section) {
+                continue;
+            }
+            for (const Binding& binding : section->bindings) {
+                if (binding.layer.empty() == on_layer) {
+                    continue;
+                }
+                const std::uint16_t to =
+                    binding.hold.empty()
+                        ? binding.to
+                        : static_cast<std::uint16_t>(
+                              LAYER_FLAG | *find_layer(keymap.layer_names, binding.hold));
+                if (on_layer) {
+                    keymap.layers[*find_layer(keymap.layer_names, binding.layer)][binding.from] =
+                        to;
+                } else {
+                    for (Table& layer : keymap.layers) {
+                        layer[binding.from] = to;
+                    }
+                }
+            }
+        }
+    }
+    return keymap;
+}
+
+}  // namespace
+
+std::optional<std::uint16_t> parse_key(const std::string& token) {
+    std::string name = upper(token);
+    if (name.rfind("KEY_", 0) != 0 && name.rfind("BTN_", 0) != 0) {
+        name = "KEY_" + name;
+    }
+    int code = libevdev_event_code_from_name(EV_KEY, name.c_str());
+    if (code < 0 && !token.empty() && token.size() <= 4 &&
+        std::all_of(token.begin(), token.end(), [](unsigned char c) { return std::isdigit(c); })) {
+        code = std::stoi(token);  // Not a digit key: a key code
+    }
+    if (code <= 0 || code > KEY_MAX) {
+        return std::nullopt;
+    }
+    return static_cast<std::uint16_t>(code);
+}
+
+const Keymap::Section* Keymap::for_device(const std::string& name,
+                                          const std::string& path) const {
+    std::error_code ec;
+    const std::filesystem::path device = std::filesystem::canonical(path, ec);
+    const Section* by_name = nullptr;
+    const Section* any = nullptr;
+    for (const Section& section : sections) {
+        switch (section.match.kind) {
+            case KeyboardMatch::Kind::Path: {
+                const std::filesystem::path wanted =
+                    std::filesystem::canonical(section.match.value, ec);
+                if (section.match.value == path || (!ec && !device.empty() && wanted == device)) {
+                    return &section;
+                }
+                break;
+            }
+            case KeyboardMatch::Kind::Name:
+                if (!by_name && section.match.value == name) {
+                    by_name = &section;
+                }
+                break;
+            case KeyboardMatch::Kind::Any:
+                any = &section;
+                break;
+        }
+    }
+    return by_name ? by_name : any;
+}
+
+std::optional<Keymap> parse_keymap(std::istream& in, std::string& error) {
+    std::vector<RawSection> raw(1);  // raw[0]: every keyboard
+    RawSection* current = &raw[0];
+    std::size_t line_number = 0;
+
+    auto fail = [&](const std::string& message) {
+        error = "line " + std::to_string(line_number) + ": " + message;
+        return std::nullopt;
+    };
+    // Layers visible in the current section (its own and those for every keyboard)
+    auto visible_layer = [&](const std::string& name) {
+        return find_layer(current->layers, name) || find_layer(raw[0].layers, name);
+    };
+
+    for (std::string line; std::getline(in, line);) {
+        ++line_number;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) {
+            continue;
+        }
+
+        if (line.front() == '[') {
+            if (line.back() != ']') {
+                return fail("unterminated section header");
+            }
+            const std::string header = trim(line.substr(1, line.size() - 2));
+            const auto space = header.find_first_of(" \t");
+            if (space == std::string::npos || upper(header.substr(0, space)) != "KEYBOARD") {
+                return fail("expected [keyboard <name or /path>]");
+            }
+            const std::string value = trim(header.substr(space));
+            if (value == "*") {
+                current = &raw[0];
+                continue;
+            }
+            RawSection section;
+            section.match = {value.front() == '/' ? KeyboardMatch::Kind::Path
+                                                  : KeyboardMatch::Kind::Name,
+                             value};
+            raw.push_back(std::move(section));
+            current = &raw.back();
+            continue;
+        }
+
+        const auto equals = line.find('=');
+        if (equals == std::string::npos) {
+            return fail("expected KEY = KEY");
+        }
+        const std::vector<std::string> left = split_words(line.substr(0, equals));
+        const std::vector<std::string> right = split_words(line.substr(equals + 1));
+        if (left.empty() || left.size() > 2 || right.size() != 1) {
+            return fail("expected KEY = KEY, LAYER KEY = KEY or layer NAME = KEY");
+        }
+
+        if (left.size() == 2 && upper(left[0]) == "LAYER") {
+            // layer NAME = KEY: holding KEY selects the layer
+            const std::string& name = left[1];
+            const auto key = parse_key(right[0]);
+            if (!key) {
+                return fail("unknown key '" + right[0] + "'");
+            }
+            if (upper(name) == "BASE") {
+                return fail("'base' is the layer without a layer key");
+            }
+            if (!visible_layer(name)) {
+                const std::size_t inherited = current == &raw[0] ? 0 : raw[0].layers.size();
+                if (1 + inherited + current->layers.size() >= MAX_LAYERS) {
+                    return fail("more than " + std::to_string(MAX_LAYERS - 1) + " layers");
+                }
+                current->layers.push_back(name);
+            }
+            current->bindings.push_back({"", *key, 0, name});
+            continue;
+        }
+
+        const auto from = parse_key(left.back());
+        if (!from) {
+            return fail("unknown key '" + left.back() + "'");
+        }
+        std::uint16_t to = 0;
+        if (upper(right[0]) != "NONE") {
+            const auto code = parse_key(right[0]);
+            if (!code) {
+                return fail("unknown key '" + right[0] + "'");
+            }
+            to = *code;
+        }
+        std::string layer;
+        if (left.size() == 2) {
+            if (!visible_layer(left[0])) {
+                return fail("unknown layer '" + left[0] + "' (define it with layer " + left[0] +
+                            " = KEY first)");
+            }
+            layer = left[0];
+        }
+        current->bindings.push_back({layer, *from, to, ""});
+    }
+
+    Keymap keymap;
+    if (!raw[0].bindings.empty()) {
+        keymap.sections.push_back({raw[0].match, compile(nullptr, raw[0])});
+    }
+    for (std::size_t i = 1; i < raw.size(); ++i) {
+        keymap.sections.push_back({raw[i].match, compile(&raw[0], raw[i])});
+    }
+    return keymap;
+}
+
+std::optional<Keymap> load_keymap(const std::string& path, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path;
+        return std::nullopt;
+    }
+    auto keymap = parse_keymap(in, error);
+    if (!keymap) {
+        error = path + ": " + error;
+    }
+    return keymap;
+}
+
+}  // namespace keymap
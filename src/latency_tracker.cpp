@@ -0,0 +1,124 @@
+/**
+ * @file latency_tracker.cpp
+ * @brief Implementation of the pipeline latency histograms
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include "latency_tracker.hpp"
+
+#include <cstdio>
+
+namespace pipeline {
+
+namespace {
+
+//! @brief One summary line: "  <stage>  n=... p50=... p99=... p99.9=... max=... us"
+void append_line(std::string& out, const char* stage, const LatencyHistogram& histogram) {
+    const auto s = histogram.summarize();
+    char line[160];
+    std::snprintf(line, sizeof(line),
+                  "\n  %-14s n=%-8llu mean=%.1f p50=%.1f p99=%.1f p99.9=%.1f max=%.1f us", stage,
+                  static_cast<unsigned long long>(s.count), s.mean / 1000.0, s.p50 / 1000.0,
+                  s.p99 / 1000.0, s.p999 / 1000.0, s.max / 1000.0);
+    out += line;
+}
+
+}  // namespace
+
+const char* to_string(LatencyStage stage) noexcept {
+    switch (stage) {
+        case LatencyStage::KernelToRead:
+            return "kernel->read";
+        case LatencyStage::ReadToReport:
+            return "read->report";
+        case LatencyStage::ReportToWrite:
+            return "report->write";
+        case LatencyStage::EndToEnd:
+            return "end-to-end";
+    }
+    return "unknown";
+}
+
+std::uint8_t LatencyTracker::keyboard_slot(const std::string& path) {
+    // Fast path: published slots never change, so no lock is needed to find one
+    const std::size_t published = keyboard_count_.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < published; ++i) {
+        if (keyboards_[i].path == path) {
+            return static_cast<std::uint8_t>(i);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(register_mutex_);
+    const std::size_t count = keyboard_count_.load(std::memory_order_relaxed);
+    for (std::size_t i = published; i < count; ++i) {
+        if (keyboards_[i].path == path) {
+            return static_cast<std::uint8_t>(i);
+        }
+    }
+    if (count == MAX_KEYBOARDS) {
+        return NO_KEYBOARD_SLOT;
+    }
+    keyboards_[count].path = path;
+    keyboards_[count].stages = std::make_unique<StageHistograms>();
+    keyboard_count_.store(count + 1, std::memory_order_release);
+    return static_cast<std::uint8_t>(count);
+}
+
+void LatencyTracker::record(std::uint8_t keyboard, LatencyStage stage, std::uint64_t from_ns,
+                            std::uint64_t to_ns) noexcept {
+    // Kernel stamps only have microsecond resolution; never turn rounding into a huge value
+    const std::uint64_t latency = to_ns > from_ns ? to_ns - from_ns : 0;
+    const auto index = static_cast<std::size_t>(stage);
+    totals_[index].record(latency);
+    if (keyboard < keyboard_count_.load(std::memory_order_acquire)) {
+        (*keyboards_[keyboard].stages)[index].record(latency);
+    }
+}
+
+void LatencyTracker::on_report_built(const ReportTiming& timing) noexcept {
+    if (timing.event_ns == 0) {
+        return;
+    }
+    record(timing.keyboard, LatencyStage::KernelToRead, timing.event_ns, timing.read_ns);
+    record(timing.keyboard, LatencyStage::ReadToReport, timing.read_ns, timing.built_ns);
+}
+
+void LatencyTracker::on_report_written(const ReportTiming& timing,
+                                       std::uint64_t write_ns) noexcept {
+    if (timing.event_ns == 0) {
+        return;
+    }
+    record(timing.keyboard, LatencyStage::ReportToWrite, timing.built_ns, write_ns);
+    record(timing.keyboard, LatencyStage::EndToEnd, timing.event_ns, write_ns);
+}
+
+const LatencyHistogram* LatencyTracker::keyboard(const std::string& path,
+                                                 LatencyStage stage) const noexcept {
+    const std::size_t count = keyboard_count_.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (keyboards_[i].path == path) {
+            return &(*keyboards_[i].stages)[static_cast<std::size_t>(stage)];
+        }
+    }
+    return nullptr;
+}
+
+std::string LatencyTracker::summary() const {
+    std::string out = "Report latency (all keyboards):";
+    for (std::size_t s = 0; s < LATENCY_STAGE_COUNT; ++s) {
+        append_line(out, to_string(static_cast<LatencyStage>(s)), totals_[s]);
+    }
+
+    const std::size_t count = keyboard_count_.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < count; ++i) {
+        out += "\nReport latency (" + keyboards_[i].path + "):";
+        for (std::size_t s = 0; s < LATENCY_STAGE_COUNT; ++s) {
+            append_line(out, to_string(static_cast<LatencyStage>(s)), (*keyboards_[i].stages)[s]);
+        }
+    }
+    return out;
+}
+
+}  // namespace pipeline
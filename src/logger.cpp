@@ -10,9 +10,16 @@
 
 #include <algorithm>
 #include <chrono>
-#include <iomanip>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
 #include <iostream>
-#include <sstream>
+#include <mutex>
+#include <thread>
+
+#include "mpsc_ring.hpp"
 
 namespace logging {
 
@@ -22,8 +29,8 @@ namespace logging {
  * These static members maintain the global logging state across the application.
  * The default logging level is INFO, and timestamps are enabled by default.
  */
-Level Logger::current_level_ = Level::INFO;  //!< Current minimum logging level
-bool Logger::enable_timestamps_ = true;      //!< Whether to include timestamps in log output
+std::atomic<Level> Logger::current_level_{Level::INFO};  //!< Current minimum logging level
+bool Logger::enable_timestamps_ = true;  //!< Whether to include timestamps in log output
 
 /**
  * @brief Set the minimum logging level from a string
@@ -44,13 +51,13 @@ void Logger::set_level(const std::string& level) {
     std::transform(lower_level.begin(), lower_level.end(), lower_level.begin(), ::tolower);
 
     if (lower_level == "debug") {
-        current_level_ = Level::DEBUG;
+        set_level(Level::DEBUG);
     } else if (lower_level == "info") {
-        current_level_ = Level::INFO;
+        set_level(Level::INFO);
     } else if (lower_level == "warn" || lower_level == "warning") {
-        current_level_ = Level::WARN;
+        set_level(Level::WARN);
     } else if (lower_level == "error") {
-        current_level_ = Level::ERROR;
+        set_level(Level::ERROR);
     }
 }
 
@@ -98,6 +105,249 @@ void Logger::error(const std::string& message) {
     log(Level::ERROR, message);
 }
 
+/**
+ * @brief Log each line of a multi-line text as its own message
+ * @param level The severity level of the lines
+ * @param text Lines separated by '\n'
+ *
+ * Callers check the level first (see NINJA_LOG_LINES_AT); log() checks it
+ * again per line, which is a relaxed load.
+ */
+void Logger::write_lines(Level level, std::string_view text) {
+    while (!text.empty()) {
+        const std::size_t end = text.find('\n');
+        log(level, text.substr(0, end));
+        if (end == std::string_view::npos) {
+            break;
+        }
+        text.remove_prefix(end + 1);
+    }
+}
+
+/**
+ * @brief Log a printf-style message through a reusable thread-local buffer
+ * @param level The severity level of the message
+ * @param fmt printf format string
+ *
+ * The buffer only grows, so after the first few messages formatting no
+ * longer allocates.
+ */
+void Logger::format(Level level, const char* fmt, ...) {
+    if (!is_enabled(level)) {
+        return;
+    }
+
+    thread_local std::string buffer(256, '\0');
+
+    va_list args;
+    va_start(args, fmt);
+    va_list retry;
+    va_copy(retry, args);
+    int length = std::vsnprintf(buffer.data(), buffer.size(), fmt, args);
+    va_end(args);
+    if (length >= 0 && static_cast<std::size_t>(length) >= buffer.size()) {
+        buffer.resize(static_cast<std::size_t>(length) + 1);
+        length = std::vsnprintf(buffer.data(), buffer.size(), fmt, retry);
+    }
+    va_end(retry);
+
+    if (length < 0) {
+        return;  // Invalid format
+    }
+    log(level, std::string_view(buffer.data(), static_cast<std::size_t>(length)));
+}
+
+// ---------------------------------------------------------------------------
+//  Asynchronous sink
+// ---------------------------------------------------------------------------
+
+/**
+ * @class Logger::AsyncSink
+ * @brief Lock-free record queue drained by a background writer thread
+ *
+ * Producers never block: a record that does not fit into the ring is
+ * dropped and counted. The writer sleeps on a condition variable while the
+ * ring is empty and is woken by producers (a periodic timeout covers a
+ * wake-up that races with falling asleep).
+ */
+class Logger::AsyncSink {
+  public:
+    //! @brief Longest message kept in a record; longer messages are truncated
+    static constexpr std::size_t MESSAGE_CAPACITY = 240;
+
+    //! @brief Records the ring can hold before new ones are dropped
+    static constexpr std::size_t RING_CAPACITY = 1024;
+
+    //! @brief Records written per batch before the streams are flushed
+    static constexpr std::size_t BATCH_SIZE = 64;
+
+    ~AsyncSink() { stop(); }
+
+    [[nodiscard]] bool running() const noexcept {
+        return running_.load(std::memory_order_acquire);
+    }
+
+    void start() {
+        std::lock_guard<std::mutex> control(control_mutex_);
+        if (running()) {
+            return;
+        }
+        steady_anchor_ = std::chrono::steady_clock::now();
+        system_anchor_ = std::chrono::system_clock::now();
+        running_.store(true, std::memory_order_release);
+        thread_ = std::thread([this] { run(); });
+    }
+
+    void stop() {
+        std::lock_guard<std::mutex> control(control_mutex_);
+        if (!running()) {
+            return;
+        }
+        running_.store(false, std::memory_order_release);
+        wake_.notify_one();
+        thread_.join();
+        while (drain()) {
+            // The writer has exited; write whatever is left from this thread
+        }
+    }
+
+    /**
+     * @brief Queue a message without blocking
+     * @return false if the ring was full and the message was dropped
+     */
+    bool submit(Level level, std::string_view message) noexcept {
+        Record record;
+        record.steady_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now().time_since_epoch())
+                               .count();
+        record.level = level;
+        record.truncated = message.size() > MESSAGE_CAPACITY;
+        record.length = static_cast<std::uint16_t>(std::min(message.size(), MESSAGE_CAPACITY));
+        std::memcpy(record.text, message.data(), record.length);
+
+        if (!ring_.try_push(record)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        accepted_.fetch_add(1, std::memory_order_release);
+        if (sleeping_.load(std::memory_order_acquire)) {
+            wake_.notify_one();
+        }
+        return true;
+    }
+
+    void flush() {
+        const std::uint64_t target = accepted_.load(std::memory_order_acquire);
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        wake_.notify_one();
+        while (running() && written_.load(std::memory_order_acquire) < target &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    [[nodiscard]] std::uint64_t dropped() const noexcept {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    struct Record {
+        std::int64_t steady_ns;       //!< Capture time on the monotonic clock
+        Level level;                  //!< Message severity
+        std::uint16_t length;         //!< Bytes used in text
+        bool truncated;               //!< Message was longer than MESSAGE_CAPACITY
+        char text[MESSAGE_CAPACITY];  //!< Message bytes (not NUL-terminated)
+    };
+
+    pipeline::MpscRing<Record, RING_CAPACITY> ring_;       //!< Pending records
+    std::thread thread_;                                   //!< Writer thread
+    std::atomic<bool> running_{false};                     //!< Writer should keep running
+    std::atomic<bool> sleeping_{false};                    //!< Writer is waiting for records
+    std::atomic<std::uint64_t> accepted_{0};               //!< Records queued
+    std::atomic<std::uint64_t> written_{0};                //!< Records written
+    std::atomic<std::uint64_t> dropped_{0};                //!< Records lost to a full ring
+    std::mutex wake_mutex_;                                //!< Guards the writer's sleep
+    std::condition_variable wake_;                         //!< Wakes the writer
+    std::mutex control_mutex_;                             //!< Serializes start()/stop()
+    std::chrono::steady_clock::time_point steady_anchor_;  //!< Monotonic time at start()
+    std::chrono::system_clock::time_point system_anchor_;  //!< Wall-clock time at start()
+
+    //! @brief Convert a record's monotonic capture time to wall-clock time
+    [[nodiscard]] std::chrono::system_clock::time_point wall_time(const Record& record) const {
+        const auto since_anchor =
+            std::chrono::nanoseconds(record.steady_ns) - steady_anchor_.time_since_epoch();
+        return system_anchor_ +
+               std::chrono::duration_cast<std::chrono::system_clock::duration>(since_anchor);
+    }
+
+    void run() {
+        while (running()) {
+            if (drain()) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            sleeping_.store(true, std::memory_order_release);
+            wake_.wait_for(lock, std::chrono::milliseconds(10));
+            sleeping_.store(false, std::memory_order_release);
+        }
+    }
+
+    /**
+     * @brief Write up to BATCH_SIZE records and flush once
+     * @return false if the ring was empty
+     */
+    bool drain() {
+        Record record;
+        std::size_t count = 0;
+        while (count < BATCH_SIZE && ring_.try_pop(record)) {
+            const auto when = wall_time(record);
+            std::string_view message(record.text, record.length);
+            if (record.truncated) {
+                std::string text(message);
+                text += "...";
+                write_line(record.level, text, when, false);
+            } else {
+                write_line(record.level, message, when, false);
+            }
+            ++count;
+        }
+        if (count == 0) {
+            return false;
+        }
+        std::cout.flush();
+        std::cerr.flush();
+        written_.fetch_add(count, std::memory_order_release);
+        return true;
+    }
+};
+
+/**
+ * @brief Get the process-wide async sink
+ * @return Sink instance; stopped (and flushed) by its destructor at exit
+ */
+Logger::AsyncSink& Logger::async_sink() {
+    static AsyncSink sink;
+    return sink;
+}
+
+void Logger::enable_async(bool enable) {
+    if (enable) {
+        async_sink().start();
+    } else {
+        async_sink().stop();
+    }
+}
+
+bool Logger::async_enabled() noexcept { return async_sink().running(); }
+
+void Logger::flush() {
+    if (async_sink().running()) {
+        async_sink().flush();
+    }
+}
+
+std::uint64_t Logger::dropped_count() noexcept { return async_sink().dropped(); }
+
 /**
  * @brief Core logging function that handles message formatting and output
  * @param level The severity level of the message
@@ -105,48 +355,83 @@ void Logger::error(const std::string& message) {
  *
  * This function performs the actual logging work:
  * - Checks if the message level meets the current threshold
- * - Selects appropriate output stream (stdout for info/debug, stderr for warn/error)
- * - Adds timestamp if enabled
- * - Applies color coding based on message level
- * - Outputs the formatted message
+ * - In async mode, hands the message to the background writer and returns
+ * - Otherwise writes it immediately (see write_line())
  *
  * @note Messages below the current logging level are silently discarded
- * @note Color codes are ANSI escape sequences for terminal display
  */
-void Logger::log(Level level, const std::string& message) {
-    if (level < current_level_) {
+void Logger::log(Level level, std::string_view message) {
+    if (!is_enabled(level)) {
+        return;
+    }
+
+    AsyncSink& sink = async_sink();
+    if (sink.running()) {
+        sink.submit(level, message);
         return;
     }
 
+    write_line(level, message, std::chrono::system_clock::now(), true);
+}
+
+/**
+ * @brief Format and output one log line
+ * @param level The severity level of the message
+ * @param message The message content
+ * @param when Wall-clock time for the timestamp
+ * @param flush Flush the stream (synchronous mode) or leave it to the batch
+ *
+ * - Selects appropriate output stream (stdout for info/debug, stderr for warn/error)
+ * - Adds timestamp if enabled
+ * - Applies color coding based on message level
+ *
+ * Lines are written under a mutex: in synchronous mode the input thread and
+ * the Qt thread log concurrently, and their operator<< chains must not
+ * interleave. The async writer is the only caller in async mode, so there
+ * the lock is never contended.
+ *
+ * @note Color codes are ANSI escape sequences for terminal display
+ */
+void Logger::write_line(Level level, std::string_view message,
+                        std::chrono::system_clock::time_point when, bool flush) {
+    static std::mutex output_mutex;
     std::ostream& output = (level >= Level::WARN) ? std::cerr : std::cout;
+    std::lock_guard<std::mutex> lock(output_mutex);
 
     if (enable_timestamps_) {
-        output << get_timestamp() << " ";
+        output << get_timestamp(when) << " ";
     }
 
     output << level_to_color(level) << "[" << level_to_string(level) << "] " << message << "\033[0m"
-           << std::endl;
+           << '\n';
+    if (flush) {
+        output.flush();
+    }
 }
 
 /**
  * @brief Generate a formatted timestamp string for log messages
+ * @param when Time to format
  * @return Formatted timestamp string in HH:MM:SS.mmm format
  *
- * Creates a timestamp with millisecond precision using the system clock.
+ * Creates a timestamp with millisecond precision.
  * The format is "HH:MM:SS.mmm" where mmm represents milliseconds.
  *
  * @note Uses local time zone for timestamp display
  * @note Millisecond precision helps with debugging timing-sensitive operations
  */
-std::string Logger::get_timestamp() {
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
+std::string Logger::get_timestamp(std::chrono::system_clock::time_point when) {
+    const std::time_t seconds = std::chrono::system_clock::to_time_t(when);
+    const auto ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(when.time_since_epoch()) % 1000;
+
+    std::tm local{};
+    localtime_r(&seconds, &local);
 
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&time_t), "%H:%M:%S");
-    ss << '.' << std::setfill('0') << std::setw(3) << ms.count();
-    return ss.str();
+    char buffer[16];
+    const std::size_t length = std::strftime(buffer, sizeof(buffer), "%H:%M:%S", &local);
+    std::snprintf(buffer + length, sizeof(buffer) - length, ".%03d", static_cast<int>(ms.count()));
+    return buffer;
 }
 
 /**
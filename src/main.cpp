@@ -20,49 +20,84 @@
  *
  * @section DataFlow Data Flow
  * 1. Enumerate and monitor USB keyboards via udev
- * 2. Poll keyboard devices for input events using libevdev
+ * 2. Read keyboard input events with libevdev as soon as their fds become readable
  * 3. Convert Linux key events to USB HID usage codes
  * 4. Generate 8-byte HID keyboard reports
- * 5. Discover and connect to BLE devices using Qt Bluetooth
- * 6. Transmit HID reports to BLE device characteristics
+ * 5. Discover and connect to BLE devices using Qt Bluetooth (one BleLink each)
+ * 6. Transmit HID reports to BLE device characteristics, mirrored to every routed link
  *
  * @section Threading Threading Model
- * Single-threaded event-driven architecture:
+ * Single-threaded event-driven architecture by default:
  * - Main thread handles all I/O operations
- * - Event loop polls keyboard devices and processes Qt events
+ * - Every keyboard fd and the udev monitor fd are registered with the Qt event loop
+ *   via QSocketNotifier, so the process sleeps while no input is pending
+ * - `--poll-interval` selects the legacy timer-driven poll() loop instead
  * - Atomic flags for clean signal handling and shutdown
  *
+ * With `--input-thread` a dedicated (optionally SCHED_FIFO, CPU-pinned) thread
+ * reads evdev, builds reports and pushes them into a lock-free SPSC ring; the
+ * Qt thread only drains the ring and performs BLE writes.
+ *
  * @section Performance Performance Considerations
- * - Direct device polling for minimal input latency
+ * - fd notifications instead of timer polling: no added latency, no idle wake-ups
  * - Efficient O(1) HID key mapping
- * - BLE transmission without response for speed
+ * - BLE transmission without response for speed, paced to the connection interval
+ *   with a bounded, edge-preserving backlog (TransmitScheduler)
  * - RAII resource management for reliability
  */
 
-#include <array>
+#include <algorithm>
 #include <atomic>  // Add missing atomic header
+#include <cerrno>
+#include <chrono>
 #include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <functional>  // Add missing functional header
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <optional>
 #include <poll.h>
+#include <QBluetoothAddress>
 #include <QBluetoothDeviceDiscoveryAgent>
 #include <QBluetoothDeviceInfo>
-#include <QBluetoothUuid>
-#include <QByteArray>
 #include <QCoreApplication>
-#include <QLowEnergyController>
-#include <QLowEnergyService>
+#include <QSocketNotifier>
 #include <QThread>
 #include <QTimer>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <unordered_map>
 #include <vector>
 
-#include <libevdev/libevdev.h>
+#include <linux/input.h>
 
 #include "args.hpp"                  // Command-line argument parsing
+#include "ble_link.hpp"              // One BLE peripheral connection and its write pacing
+#include "chord_matcher.hpp"         // Hotkey chords (--hotkeys)
+#include "connection_tuner.hpp"      // BLE connection-parameter profiles
+#include "control_server.hpp"        // Daemon control socket (--daemon)
+#include "device_cache.hpp"          // Known BLE peripherals, ranked for selection
 #include "device_manager.hpp"        // Device enumeration and hot-plug support
-#include "exit_hotkey_detector.hpp"  // Exit hotkey detection
-#include "hid_keycodes.hpp"          // HID keyboard mappings and state management
+#include "gatt_cache.hpp"            // Last-device cache for fast reconnect
+#include "idle_governor.hpp"         // Power-save connection parameters while idle
+#include "input_thread.hpp"          // Dedicated input thread and report queue
+#include "key_event_processor.hpp"   // Key event to HID report conversion
+#include "keymap.hpp"                // Per-keyboard key remapping (--keymap)
+#include "latency_tracker.hpp"       // Report latency histograms (--latency-stats)
+#include "link_router.hpp"           // Multi-link report routing and hotkeys
 #include "logger.hpp"                // Logging utilities
+#include "metrics.hpp"               // Operational counters (--metrics)
+#include "metrics_server.hpp"        // Metrics scrape endpoint
+#include "passthrough.hpp"           // Shared input with the local host (--share-input)
+#include "reconnect_backoff.hpp"     // Backoff schedule for lost BLE links
+#include "scan_selector.hpp"         // Early-exit BLE device selection
+#include "text_injector.hpp"         // Typing text into the host (--type, --type-file)
+#include "trace_recorder.hpp"        // Binary event trace (--trace)
+#include "transmit_scheduler.hpp"    // Connection-interval-aware BLE write pacing
 #include "version.hpp"               // Version information
 
 //! @namespace Global application state and configuration
@@ -71,6 +106,17 @@ namespace {
 //! @brief Global program configuration options set from command-line arguments
 args::Options g_options;
 
+//! @brief Legacy poll timer interval while input is idle (--poll-interval with --idle-timeout)
+constexpr int IDLE_POLL_INTERVAL_MS = 100;
+
+//! @brief Background scans (daemon and fan-out modes): a short LE scan every period
+constexpr int BACKGROUND_SCAN_PERIOD_MS = 30000;
+constexpr int BACKGROUND_SCAN_WINDOW_MS = 2000;
+
+//! @brief Devices seen this recently rank as present; unseen this long they are forgotten
+constexpr std::chrono::minutes DEVICE_FRESH_FOR{2};
+constexpr std::chrono::minutes DEVICE_MAX_AGE{30};
+
 }  // anonymous namespace
 
 // ---------------------------------------------------------------------------
@@ -85,6 +131,16 @@ args::Options g_options;
  */
 std::atomic<bool> g_running{true};
 
+/**
+ * @brief eventfd the SIGTERM handler signals to request shutdown (-1: disabled)
+ */
+int g_shutdown_fd = -1;
+
+/**
+ * @brief Shutdown signal caught last, logged by the event loop
+ */
+volatile std::sig_atomic_t g_shutdown_signal = 0;
+
 /**
  * @brief Signal handler for graceful shutdown
  * @param signum Signal number (SIGINT, SIGTERM, etc.)
@@ -94,7 +150,9 @@ std::atomic<bool> g_running{true};
  * - SIGTERM: Still triggers graceful shutdown
  *
  * @note This function is called from signal context and must be signal-safe.
- *       Only async-signal-safe functions should be used here.
+ *       Only async-signal-safe functions should be used here: the shutdown is
+ *       logged by a QSocketNotifier on g_shutdown_fd, since logging allocates
+ *       and may take the async logger's lock.
  */
 void signal_handler(int signum) {
     if (signum == SIGINT) {
@@ -102,45 +160,46 @@ void signal_handler(int signum) {
         return;
     }
 
-    LOG_INFO("Caught signal " + std::to_string(signum) + ", exiting...");
     g_running = false;
+    g_shutdown_signal = signum;
+    if (g_shutdown_fd >= 0) {
+        const std::uint64_t one = 1;
+        [[maybe_unused]] const ssize_t written = write(g_shutdown_fd, &one, sizeof(one));
+    }
 }
 
-// ---------------------------------------------------------------------------
-//  BLE Communication Helpers
-// ---------------------------------------------------------------------------
+/**
+ * @brief eventfd the SIGUSR1 handler signals to request a latency dump (-1: disabled)
+ */
+int g_latency_dump_fd = -1;
 
 /**
- * @brief Factory function to create HID report writer for BLE characteristic
- * @param service Pointer to the BLE GATT service
- * @param ch The writable characteristic for HID reports
- * @return Lambda function that writes HID reports to the BLE characteristic
+ * @brief SIGUSR1 handler: ask the event loop to log the latency histograms
+ * @param signum Signal number (unused)
  *
- * This function returns a lambda that captures the service and characteristic
- * for writing HID keyboard reports. The lambda validates the service and
- * characteristic before each write operation.
- *
- * @section HIDReport HID Report Format
- * The function writes 8-byte HID keyboard reports in the standard format:
- * - Byte 0: Modifier keys (Ctrl, Alt, Shift, etc.)
- * - Byte 1: Reserved (always 0)
- * - Bytes 2-7: Up to 6 simultaneous key codes
- *
- * @note Uses WriteWithoutResponse for minimal latency
- * @note The returned lambda is safe to call even if service/characteristic become invalid
+ * Only writes to an eventfd, which is async-signal-safe; the summary is
+ * formatted and logged by a QSocketNotifier on the Qt thread.
  */
-auto make_report_writer(QLowEnergyService* service, QLowEnergyCharacteristic ch) {
-    return [service, ch](const std::array<uint8_t, 8>& report) {
-        // Validate service and characteristic before writing
-        if (!service || !ch.isValid()) {
-            LOG_INFO("Invalid service or characteristic, skipping HID report");
-            return;
-        }
+void latency_dump_handler(int /*signum*/) {
+    const std::uint64_t one = 1;
+    [[maybe_unused]] const ssize_t written = write(g_latency_dump_fd, &one, sizeof(one));
+}
 
-        // Convert HID report to QByteArray and transmit
-        QByteArray data(reinterpret_cast<const char*>(report.data()), 8);
-        service->writeCharacteristic(ch, data, QLowEnergyService::WriteWithoutResponse);
-    };
+/**
+ * @brief eventfd the SIGHUP handler signals to request a keymap reload (-1: disabled)
+ */
+int g_keymap_reload_fd = -1;
+
+/**
+ * @brief SIGHUP handler: ask the event loop to reload the keymap file
+ * @param signum Signal number (unused)
+ *
+ * Like latency_dump_handler(), only writes to an eventfd; the file is read
+ * and compiled on the Qt thread.
+ */
+void keymap_reload_handler(int /*signum*/) {
+    const std::uint64_t one = 1;
+    [[maybe_unused]] const ssize_t written = write(g_keymap_reload_fd, &one, sizeof(one));
 }
 
 // ---------------------------------------------------------------------------
@@ -172,7 +231,8 @@ auto make_report_writer(QLowEnergyService* service, QLowEnergyCharacteristic ch)
  *
  * @section EventLoop Main Event Loop
  * The main loop performs these operations:
- * - Poll keyboard devices for input events (1ms interval)
+ * - Read keyboard devices when their fds become readable (or poll on a timer
+ *   with `--poll-interval`)
  * - Process Qt events for BLE communication
  * - Convert input events to HID reports
  * - Transmit HID reports to connected BLE device
@@ -183,6 +243,8 @@ auto make_report_writer(QLowEnergyService* service, QLowEnergyCharacteristic ch)
  * - Invalid arguments: Display help and exit with code 1
  * - Device initialization failure: Log error and exit
  * - BLE connection failure: Continue scanning for devices
+ * - Lost BLE link: Reconnect with exponential backoff (cached handles), resending the
+ *   current key state once it is ready; keyboards stay grabbed meanwhile
  * - Runtime errors: Log appropriately and attempt recovery
  *
  * @section Privileges Required Privileges
@@ -222,6 +284,10 @@ int main(int argc, char* argv[]) {
         logging::Logger::set_level(g_options.log_level);
     }
     logging::Logger::enable_timestamps(g_options.verbose);
+    if (g_options.log_async) {
+        // Keep terminal/journald back-pressure off the input and BLE paths
+        logging::Logger::enable_async(true);
+    }
 
     if (g_options.verbose) {
         LOG_INFO("Starting " + std::string(version::APP_NAME) + " " + version::get_version());
@@ -230,6 +296,116 @@ int main(int argc, char* argv[]) {
         LOG_DEBUG("Poll interval: " + std::to_string(g_options.poll_interval) + "ms");
     }
 
+    // ------------------ Event trace ------------------
+    std::unique_ptr<trace::TraceRecorder> traceRecorder;
+    if (!g_options.trace.empty()) {
+        traceRecorder = std::make_unique<trace::TraceRecorder>(
+            g_options.trace, static_cast<std::size_t>(g_options.trace_size) * 1024 * 1024,
+            g_options.coalesce_frames ? trace::TRACE_FLAG_COALESCE_FRAMES : 0);
+        if (!traceRecorder->is_valid()) {
+            LOG_ERROR("Cannot create trace file " + g_options.trace + " (" +
+                      std::string(std::strerror(errno)) + ")");
+            return 1;
+        }
+        LOG_INFO("Recording event trace to " + g_options.trace + " (room for " +
+                 std::to_string(traceRecorder->capacity()) + " records)");
+    }
+    trace::TraceRecorder* const tracer = traceRecorder.get();
+
+    // ------------------ Latency histograms ------------------
+    std::unique_ptr<pipeline::LatencyTracker> latencyTracker;
+    if (g_options.latency_stats) {
+        latencyTracker = std::make_unique<pipeline::LatencyTracker>();
+        g_latency_dump_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (g_latency_dump_fd < 0) {
+            LOG_WARN("Cannot create eventfd for SIGUSR1 latency dumps (" +
+                     std::string(std::strerror(errno)) + "); printing them at exit only");
+        }
+    }
+    pipeline::LatencyTracker* const latency = latencyTracker.get();
+
+    // ------------------ Metrics endpoint ------------------
+    std::unique_ptr<metrics::Metrics> metricsRegistry;
+    std::unique_ptr<metrics::MetricsServer> metricsServer;
+    if (!g_options.metrics.empty()) {
+        metricsRegistry = std::make_unique<metrics::Metrics>();
+        metricsServer = std::make_unique<metrics::MetricsServer>(
+            *metrics::parse_endpoint(g_options.metrics),  // Validated by the argument parser
+            [registry = metricsRegistry.get(), latency]() { return registry->render(latency); });
+        if (!metricsServer->is_valid() || !metricsServer->start()) {
+            LOG_ERROR("Cannot serve metrics on " + metricsServer->endpoint().describe() + " (" +
+                      std::string(std::strerror(errno)) + ")");
+            return 1;
+        }
+        LOG_INFO("Serving metrics on " + metricsServer->endpoint().describe());
+    }
+    metrics::Metrics* const counters = metricsRegistry.get();
+
+    // ------------------ Key remapping ------------------
+    keymap::KeymapStore keymaps;
+    if (!g_options.keymap.empty()) {
+        std::string error;
+        auto loaded = keymap::load_keymap(g_options.keymap, error);
+        if (!loaded) {
+            LOG_ERROR("Cannot load keymap: " + error);
+            return 1;
+        }
+        LOG_INFO("Loaded keymap " + g_options.keymap + " (" +
+                 std::to_string(loaded->sections.size()) + " section(s))");
+        keymaps.publish(std::move(*loaded));
+        g_keymap_reload_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (g_keymap_reload_fd < 0) {
+            LOG_WARN("Cannot create eventfd for SIGHUP keymap reloads (" +
+                     std::string(std::strerror(errno)) + ")");
+        }
+    }
+
+    // ------------------ Hotkeys ------------------
+    // Link switching chords only exist with several --target devices
+    hotkey::ChordMatcher chords = hotkey::ChordMatcher::defaults(g_options.targets.size());
+    if (!g_options.hotkeys.empty()) {
+        std::string error;
+        if (!hotkey::parse_hotkeys(g_options.hotkeys, chords, error)) {
+            LOG_ERROR("Invalid --hotkeys: " + error);
+            return 1;
+        }
+    }
+    const std::string exitChord = hotkey::describe(*chords.chord(hotkey::Action::Exit));
+
+    // ------------------ Text injection ------------------
+    std::optional<inject::TextInjector> injector;
+    if (!g_options.type_text.empty() || !g_options.type_file.empty()) {
+        std::string text = g_options.type_text;
+        if (!g_options.type_file.empty()) {
+            std::ifstream file;
+            if (g_options.type_file != "-") {
+                file.open(g_options.type_file, std::ios::binary);
+                if (!file) {
+                    LOG_ERROR("Cannot open " + g_options.type_file);
+                    return 1;
+                }
+            }
+            std::istream& in = g_options.type_file == "-" ? std::cin : file;
+            text.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        std::string error;
+        auto sequence = inject::compile_text(text, error);
+        if (!sequence) {
+            LOG_ERROR("Cannot type the text: " + error);
+            return 1;
+        }
+        if (sequence->reports.empty()) {
+            LOG_WARN("Nothing to type");
+        } else {
+            injector.emplace(std::move(*sequence));
+        }
+    }
+
+    g_shutdown_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (g_shutdown_fd < 0) {
+        LOG_WARN("Cannot create eventfd for SIGTERM (" + std::string(std::strerror(errno)) +
+                 "); it will not stop the event loop");
+    }
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
 
@@ -239,133 +415,1068 @@ int main(int argc, char* argv[]) {
         LOG_ERROR("Failed to initialize device monitoring");
         return 1;
     }
+    keyboard_manager.set_metrics(counters);
+    keyboard_manager.set_batch_reads(g_options.batch_reads);
+    if (!g_options.keymap.empty()) {
+        keyboard_manager.set_keymaps(&keymaps);
+    }
+
+    // Shared input: the keyboards stay grabbed and routed events are re-injected locally
+    std::optional<device::Passthrough> passthrough;
+    if (g_options.share_input) {
+        passthrough.emplace();
+        if (!passthrough->is_valid()) {
+            LOG_ERROR("Cannot create the passthrough keyboard for --share-input (" +
+                      std::string(std::strerror(passthrough->error())) + ")");
+            return 1;
+        }
+        keyboard_manager.ignore_device(passthrough->devnode());  // Do not read our own output
+        LOG_INFO("Sharing input with the local host through " + passthrough->devnode());
+    }
 
     LOG_INFO("Found " + std::to_string(keyboard_manager.device_count()) + " keyboard(s)");
     if (g_options.verbose) {
         LOG_DEBUG("Monitoring keyboards (hot-plug supported)...");
     }
 
-    hid::KeyboardState kb_state;
-
     // ------------------ Qt setup ------------------
     QCoreApplication app(argc, argv);
     QBluetoothDeviceDiscoveryAgent discoveryAgent;
-    discoveryAgent.setLowEnergyDiscoveryTimeout(g_options.scan_timeout);
 
+    std::unique_ptr<QSocketNotifier> shutdownNotifier;
+    if (g_shutdown_fd >= 0) {
+        shutdownNotifier = std::make_unique<QSocketNotifier>(g_shutdown_fd, QSocketNotifier::Read);
+        QObject::connect(shutdownNotifier.get(), &QSocketNotifier::activated, [&]() {
+            std::uint64_t requests = 0;
+            [[maybe_unused]] const ssize_t bytes = read(g_shutdown_fd, &requests, sizeof(requests));
+            LOG_INFO("Caught signal " + std::to_string(g_shutdown_signal) + ", exiting...");
+            app.quit();  // The cleanup after app.exec() removes the control socket
+        });
+    }
+
+    std::unique_ptr<QSocketNotifier> latencyDumpNotifier;
+    if (g_latency_dump_fd >= 0) {
+        latencyDumpNotifier =
+            std::make_unique<QSocketNotifier>(g_latency_dump_fd, QSocketNotifier::Read);
+        QObject::connect(latencyDumpNotifier.get(), &QSocketNotifier::activated, [&]() {
+            std::uint64_t requests = 0;
+            [[maybe_unused]] const ssize_t bytes =
+                read(g_latency_dump_fd, &requests, sizeof(requests));
+            LOG_INFO_LINES(latency->summary());
+        });
+        signal(SIGUSR1, latency_dump_handler);
+        LOG_INFO("Latency histograms enabled (kill -USR1 " + std::to_string(getpid()) +
+                 " prints them)");
+    }
+
+    std::unique_ptr<QSocketNotifier> keymapReloadNotifier;
+    if (g_keymap_reload_fd >= 0) {
+        keymapReloadNotifier =
+            std::make_unique<QSocketNotifier>(g_keymap_reload_fd, QSocketNotifier::Read);
+        QObject::connect(keymapReloadNotifier.get(), &QSocketNotifier::activated, [&]() {
+            std::uint64_t requests = 0;
+            [[maybe_unused]] const ssize_t bytes =
+                read(g_keymap_reload_fd, &requests, sizeof(requests));
+            // Compiled off to the side; keyboards switch with their next batch
+            std::string error;
+            auto reloaded = keymap::load_keymap(g_options.keymap, error);
+            if (!reloaded) {
+                LOG_WARN("Keymap reload failed, keeping the current keymap: " + error);
+                return;
+            }
+            keymaps.publish(std::move(*reloaded));
+            LOG_INFO("Reloaded keymap " + g_options.keymap);
+        });
+        signal(SIGHUP, keymap_reload_handler);
+    }
     // Handle list devices option
     if (g_options.list_devices) {
         LOG_INFO("Scanning for BLE devices...");
         // We'll just start discovery and exit after listing
     }
 
-    QList<QBluetoothDeviceInfo> foundDevices;
-    QLowEnergyController* controller = nullptr;
-    QLowEnergyService* service = nullptr;
-    QLowEnergyCharacteristic targetChar;
-    std::function<void(const std::array<uint8_t, 8>&)> sendReport;
+    // Every peripheral any scan has seen, classified once (see DeviceCache)
+    ble::DeviceCache deviceCache;
+    bool backgroundScan = false;  // The running scan only refreshes deviceCache
+
+    auto record_sighting = [&](const QBluetoothDeviceInfo& info) {
+        ble::DeviceCache::Sighting sighting;
+        sighting.address = info.address().toString().toStdString();
+        sighting.name = info.name().toStdString();
+        sighting.rssi = info.rssi();
+        if (const QList<quint16> ids = info.manufacturerIds(); !ids.isEmpty()) {
+            const QByteArray data = info.manufacturerData(ids.first());
+            sighting.manufacturer_id = ids.first();
+            sighting.manufacturer_data.assign(data.begin(), data.end());
+        }
+        return deviceCache.on_seen(sighting, ble::DeviceCache::Clock::now());
+    };
+
+    // Connect by address and name, like the GATT cache path does
+    auto device_info = [](const ble::DeviceCache::Device& device) {
+        QBluetoothDeviceInfo info(QBluetoothAddress(QString::fromStdString(device.address)),
+                                  QString::fromStdString(device.name), 0);
+        info.setCoreConfigurations(QBluetoothDeviceInfo::LowEnergyCoreConfiguration);
+        info.setRssi(device.rssi);
+        return info;
+    };
+
+    auto start_scan = [&](bool background) {
+        backgroundScan = background;
+        if (background) {
+            discoveryAgent.setLowEnergyDiscoveryTimeout(BACKGROUND_SCAN_WINDOW_MS);
+            discoveryAgent.start(QBluetoothDeviceDiscoveryAgent::LowEnergyMethod);
+            return;
+        }
+        discoveryAgent.setLowEnergyDiscoveryTimeout(g_options.scan_timeout);
+        discoveryAgent.start();
+    };
+    std::function<void(const pipeline::Report&, const pipeline::ReportTiming&)> sendReport;
+
+    // ------------------ BLE links ------------------
+    // One BleLink per --target device (a single link otherwise). Every link paces and
+    // queues its own writes, so a slow or stalled peer does not hold up the others.
+    const bool multiLink = g_options.targets.size() > 1;
+    const bool daemonMode = !g_options.daemon.empty();  // Never prompts or quits for lack of a link
+    const std::size_t linkCount = multiLink ? g_options.targets.size() : 1;
+    std::vector<std::unique_ptr<ble::BleLink>> links(linkCount);
+    std::vector<std::unique_ptr<ble::BleLink>> retiredLinks;  // Freed after their handlers ran
+    std::vector<int> linkAttempts(linkCount, 0);
+    std::vector<std::uint64_t> linkIds(linkCount, 0);  // Tells a replaced link's timers apart
+    std::uint64_t nextLinkId = 0;
+    std::vector<ble::ReconnectBackoff> reconnects(linkCount);
+    ble::LinkRouter router(linkCount);
+    pipeline::Report currentReport{};  // Latest key state, resent after a reconnect
+    pipeline::Report currentConsumer = pipeline::Report::consumer(0);  // Latest media key
+    std::uint64_t reportsRouted = 0;          // Keyboard reports handed to the links
+    std::uint64_t reportsInjected = 0;        // Reports injected through the control socket
+    bool typing = false;                      // --type text is being streamed
+    ble::LinkRouter::Mask typingLinks = 0;    // Links the text is typed to
+    std::size_t typedTenths = 0;              // Progress last logged, in tenths
+    QTimer typeTimer;                         // Next typing step
+    typeTimer.setSingleShot(true);
+
+    // A link must not be destroyed from inside its own signal handlers
+    auto retire_link = [&](std::size_t slot) {
+        // Whatever connects in this slot next gets no leftover --type text
+        typingLinks = static_cast<ble::LinkRouter::Mask>(typingLinks & ~(1U << slot));
+        if (links[slot]) {
+            retiredLinks.push_back(std::move(links[slot]));
+            QTimer::singleShot(0, &app, [&]() { retiredLinks.clear(); });
+        }
+    };
+
+    auto describe_route = [&]() {
+        std::string routed;
+        for (std::size_t i = 0; i < links.size(); ++i) {
+            if (router.routes_to(i)) {
+                routed += (routed.empty() ? "" : ", ") + std::to_string(i + 1);
+            }
+        }
+        return routed;
+    };
+
+    auto apply_route_change = [&](const ble::LinkRouter::Change& change) {
+        for (std::size_t i = 0; i < links.size(); ++i) {
+            if (((change.left >> i) & 1U) && links[i]) {
+                // Release everything on that host
+                links[i]->submit(pipeline::Report{});
+                links[i]->submit(pipeline::Report::consumer(0));
+            }
+        }
+        if (change.left != 0 || change.joined != 0) {
+            LOG_INFO("Routing input to link(s) " + describe_route());
+        }
+    };
+
+    // Legacy fallback: wake up every poll_interval ms and run a zero-timeout poll()
+    QTimer pollTimer;
+
+    // ------------------ Idle governor ------------------
+    // After --idle-timeout seconds without key reports every link is asked for power-save
+    // parameters and the legacy poll timer slows down; the first key restores both.
+    std::optional<ble::IdleGovernor> idleGovernor;
+    QTimer idleTimer;
+    idleTimer.setSingleShot(true);
+
+    auto set_power_save = [&](bool idle) {
+        for (auto& link : links) {
+            if (link) {
+                link->set_power_save(idle);
+            }
+        }
+        if (pollTimer.isActive()) {
+            pollTimer.setInterval(idle ? std::max(g_options.poll_interval, IDLE_POLL_INTERVAL_MS)
+                                       : g_options.poll_interval);
+        }
+        if (counters) {
+            (idle ? counters->idle_entered : counters->idle_wakes).add();
+            counters->idle.set(idle ? 1 : 0);
+        }
+    };
+
+    // Called after the report that ended the idle period was submitted; it is already on
+    // its way over the power-save connection
+    auto wake_up = [&]() {
+        LOG_INFO("Input active again; restoring " + g_options.conn_profile +
+                 " connection parameters");
+        set_power_save(false);
+        idleTimer.start(
+            std::chrono::duration_cast<std::chrono::milliseconds>(idleGovernor->timeout()));
+    };
+
+    // Mirrors every report to the routed links; the link hotkeys change the route
+    auto route_report = [&](const pipeline::Report& report, const pipeline::ReportTiming& timing) {
+        const bool woke =
+            idleGovernor && idleGovernor->on_activity(ble::IdleGovernor::Clock::now());
+        (report.is_consumer() ? currentConsumer : currentReport) = report;
+        ++reportsRouted;
+        if (!typing) {  // Otherwise sent once the text is typed
+            for (std::size_t i = 0; i < links.size(); ++i) {
+                if (router.routes_to(i) && links[i]) {
+                    links[i]->submit(report, timing);
+                }
+            }
+        }
+        if (woke) {
+            wake_up();
+        }
+    };
+
+    QObject::connect(&idleTimer, &QTimer::timeout, [&]() {
+        const auto now = ble::IdleGovernor::Clock::now();
+        if (typing) {
+            idleGovernor->on_activity(now);  // Typed text keeps the links busy too
+        }
+        if (const auto wait = idleGovernor->poll(now)) {
+            idleTimer.start(std::chrono::ceil<std::chrono::milliseconds>(*wait));
+            return;
+        }
+        LOG_INFO("No key input for " + std::to_string(g_options.idle_timeout) +
+                 " s; requesting power-save connection parameters");
+        set_power_save(true);
+    });
+
+    // ------------------ Text injection streaming ------------------
+    // One report is handed to each link while its queue is empty, so the scheduler writes
+    // it in the next free slot and nothing is collapsed. The timer ticks twice per
+    // connection interval to keep the next report waiting for its slot.
+    auto for_typing_links = [&](const std::function<void(ble::BleLink&)>& fn) {
+        for (std::size_t i = 0; i < links.size(); ++i) {
+            if (((typingLinks >> i) & 1U) && links[i] && links[i]->ready()) {
+                fn(*links[i]);
+            }
+        }
+    };
+
+    auto log_typing = [&](const std::string& what) {
+        char rate[32];
+        std::snprintf(rate, sizeof(rate), "%.1f", injector->chars_per_second());
+        LOG_INFO(what + " " + std::to_string(injector->typed()) + "/" +
+                 std::to_string(injector->characters()) + " characters in " +
+                 std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                    injector->elapsed())
+                                    .count()) +
+                 " ms (" + rate + " chars/s)");
+    };
+
+    // Ends typing and hands the links back to the keyboards
+    auto finish_typing = [&](bool completed) {
+        typing = false;
+        typeTimer.stop();
+        if (!completed) {
+            for_typing_links([](ble::BleLink& link) { link.submit(pipeline::Report{}); });
+        }
+        log_typing(completed ? "Typed" : "Typing stopped after");
+        for (std::size_t i = 0; i < links.size(); ++i) {
+            if (router.routes_to(i) && links[i]) {
+                links[i]->submit(currentReport);
+                links[i]->submit(currentConsumer);
+            }
+        }
+    };
+
+    auto type_step = [&]() {
+        std::uint32_t ready = 0;
+        for (std::size_t i = 0; i < links.size(); ++i) {
+            if (links[i] && links[i]->ready()) {
+                ready |= 1U << i;
+            }
+        }
+        if (inject::typing_step(typingLinks, ready) == inject::TypingStep::Abandon) {
+            LOG_WARN("Every link the text was typed to is gone; the rest is not typed");
+            finish_typing(false);
+            return;
+        }
+        std::chrono::microseconds interval{0};
+        bool waiting = false;
+        for_typing_links([&](ble::BleLink& link) {
+            interval = std::max(interval, link.scheduler()->connection_interval());
+            waiting = waiting || link.scheduler()->queue_depth() != 0;
+        });
+        if (interval.count() == 0) {
+            typeTimer.start(100);  // Every typing link is reconnecting
+            return;
+        }
+        // Top up: a report written at once leaves room for the next one to wait
+        while (!waiting) {
+            const auto report = injector->next(std::chrono::steady_clock::now());
+            if (!report) {
+                finish_typing(true);
+                return;
+            }
+            for_typing_links([&](ble::BleLink& link) {
+                link.submit(*report);
+                waiting = waiting || link.scheduler()->queue_depth() != 0;
+            });
+            const std::size_t tenth = injector->typed() * 10 / injector->characters();
+            if (injector->characters() >= 100 && tenth > typedTenths && !injector->done()) {
+                typedTenths = tenth;
+                log_typing("Typing: " + std::to_string(tenth * 10) + "%,");
+            }
+        }
+        typeTimer.start(static_cast<int>(std::max<std::int64_t>(1, interval.count() / 2000)));
+    };
+    QObject::connect(&typeTimer, &QTimer::timeout, type_step);
+
+    auto start_typing = [&]() {
+        for (std::size_t i = 0; i < links.size(); ++i) {
+            if (router.routes_to(i) && links[i] && links[i]->ready()) {
+                typingLinks = static_cast<ble::LinkRouter::Mask>(typingLinks | (1U << i));
+            }
+        }
+        typing = true;
+        LOG_INFO("Typing " + std::to_string(injector->characters()) + " characters (" +
+                 std::to_string(injector->reports()) +
+                 " reports); keyboard input is held back until done");
+        type_step();
+    };
+
+    // Push out anything still waiting, e.g. the final release report before exit
+    auto flush_transmit = [&]() {
+        if (typing) {
+            finish_typing(false);
+        }
+        for (auto& link : links) {
+            if (link) {
+                link->flush();
+            }
+        }
+    };
+
+    // ------------------ Input processing ------------------
+    // Converts key events into HID reports for the single-threaded paths
+    pipeline::KeyEventProcessor key_processor(
+        [&](const pipeline::Report& report) { sendReport(report, key_processor.last_timing()); },
+        g_options.verbose, g_options.coalesce_frames);
+    key_processor.set_trace(tracer);
+    key_processor.set_latency_tracker(latency);
+    key_processor.set_metrics(counters);
+    key_processor.set_chords(chords);
+
+    // Carries out the hotkeys other than exit (ToggleGrab only without the input thread,
+    // which handles it itself)
+    auto run_hotkey = [&](hotkey::Action action) {
+        switch (action) {
+            case hotkey::Action::NextTarget:
+                if (links.size() < 2) {
+                    LOG_INFO("Only one BLE link; next-target hotkey ignored");
+                    break;
+                }
+                apply_route_change(router.next());
+                break;
+            case hotkey::Action::ToggleLink1:
+            case hotkey::Action::ToggleLink2:
+            case hotkey::Action::ToggleLink3:
+            case hotkey::Action::ToggleLink4:
+            case hotkey::Action::ToggleLink5:
+            case hotkey::Action::ToggleLink6:
+            case hotkey::Action::ToggleLink7:
+            case hotkey::Action::ToggleLink8:
+            case hotkey::Action::ToggleLink9:
+                // Nothing changes for a link that does not exist or the last routed one
+                apply_route_change(router.toggle(*hotkey::toggled_link(action)));
+                break;
+            case hotkey::Action::AllLinks:
+                apply_route_change(router.route_all());
+                break;
+            case hotkey::Action::ToggleGrab: {
+                if (passthrough) {
+                    // Shared input keeps the grab; only the BLE route is switched
+                    const bool pause = !key_processor.paused();
+                    key_processor.set_paused(pause);
+                    LOG_INFO(pause ? "BLE route off; input only reaches the local host"
+                                   : "BLE route on; forwarding input");
+                    break;
+                }
+                const bool release = keyboard_manager.grabbed();
+                key_processor.set_paused(release);
+                keyboard_manager.set_grabbed(!release);
+                LOG_INFO(release ? "Keyboards released to the local host; input is not forwarded"
+                                 : "Keyboards grabbed again; forwarding input");
+                break;
+            }
+            case hotkey::Action::DumpMetrics:
+                if (latency) {
+                    LOG_INFO_LINES(latency->summary());
+                }
+                if (counters) {
+                    LOG_INFO("Metrics:");
+                    LOG_INFO_LINES(counters->render(latency));
+                }
+                if (!latency && !counters) {
+                    LOG_INFO("Nothing to dump: start with --latency-stats or --metrics");
+                }
+                break;
+            case hotkey::Action::ToggleLocal:
+                if (!passthrough) {
+                    LOG_INFO("Input is not shared (--share-input); local hotkey ignored");
+                    break;
+                }
+                passthrough->set_enabled(!passthrough->enabled());
+                LOG_INFO(passthrough->enabled()
+                             ? "Local route on; input also reaches the local host"
+                             : "Local route off; input only goes to BLE");
+                break;
+            case hotkey::Action::Exit:
+            case hotkey::Action::None:
+                break;
+        }
+    };
+
+    // Drains all pending events of one keyboard and forwards them as HID reports.
+    // Returns the final read status (-EAGAIN once the device queue is empty).
+    auto process_keyboard_events = [&](device::KeyboardDevice& keyboard) -> int {
+        const std::uint16_t traceId =
+            tracer ? trace::device_id_from_path(keyboard.path()) : trace::NO_DEVICE;
+        pipeline::ReportTiming timing{};
+        if (latency) {
+            timing.keyboard = latency->keyboard_slot(keyboard.path());
+        }
+        const std::uint8_t metricsSlot =
+            counters ? counters->device_slot(keyboard.path()) : metrics::NO_DEVICE_SLOT;
+        int rc = 0;
+        while (rc == 0) {
+            const device::EventBatch batch = keyboard.read_batch();
+            rc = batch.status;
+            if (counters) {
+                counters->add_events(metricsSlot, batch.count);
+            }
+            if (latency) {
+                timing.read_ns = pipeline::monotonic_now_ns();
+            }
+            device::PassthroughRun local(passthrough ? &*passthrough : nullptr);
+            for (const input_event& ev : batch) {
+                if (tracer) {
+                    tracer->record_input(traceId, ev);
+                }
+                if (latency) {
+                    timing.event_ns = pipeline::event_time_ns(ev);
+                }
+                const hotkey::Action action = key_processor.process(ev, keyboard.name(), timing);
+                local.route(ev, action == hotkey::Action::None && passthrough &&
+                                    passthrough->enabled());
+                if (action == hotkey::Action::Exit) {
+                    flush_transmit();
+                    LOG_INFO("Exit hotkey detected (" + exitChord + ") - stopping program...");
+                    LOG_INFO("Stopping HID reports and exiting...");
+                    logging::Logger::flush();
+                    g_running = false;
+                    app.quit();
+                    return rc;
+                }
+                if (action != hotkey::Action::None) {
+                    run_hotkey(action);
+                }
+            }
+        }
+        return rc;
+    };
+
+    // Event-driven mode: one read notifier per keyboard fd plus one each for the udev
+    // monitor and the probe retry timer, so reports go out as soon as the kernel delivers
+    // an event and the process sleeps while idle.
+    std::unordered_map<int, std::unique_ptr<QSocketNotifier>> inputNotifiers;
+    std::unique_ptr<QSocketNotifier> hotplugNotifier;
+    std::unique_ptr<QSocketNotifier> hotplugRetryNotifier;
+    bool inputEnabled = false;
+
+    // Keyboard notifiers stay disabled until the BLE link is ready, so queued input is
+    // left in the kernel instead of being spun on by a level-triggered notifier.
+    auto set_input_enabled = [&](bool enabled) {
+        inputEnabled = enabled;
+        for (auto& [fd, notifier] : inputNotifiers) {
+            notifier->setEnabled(enabled);
+        }
+    };
+
+    // Bring the notifier set in line with the current keyboard list after hot-plug
+    auto sync_input_notifiers = [&]() {
+        const auto& keyboards = keyboard_manager.keyboards();
+
+        for (auto it = inputNotifiers.begin(); it != inputNotifiers.end();) {
+            if (keyboard_manager.device_index_for_fd(it->first)) {
+                // fd numbers are reused, so a kept notifier may now serve a new device
+                it->second->setEnabled(inputEnabled);
+                ++it;
+            } else {
+                it = inputNotifiers.erase(it);
+            }
+        }
+
+        for (const auto& kbd : keyboards) {
+            if (!kbd.is_valid() || inputNotifiers.count(kbd.fd()) != 0)
+                continue;
+
+            const int fd = kbd.fd();
+            auto notifier = std::make_unique<QSocketNotifier>(fd, QSocketNotifier::Read);
+            QSocketNotifier* raw = notifier.get();
+            QObject::connect(raw, &QSocketNotifier::activated, [&, fd, raw]() {
+                if (!g_running || !sendReport) {
+                    // Nothing consumes the events: leave them queued instead of spinning on
+                    // the readable fd until start_input() enables the notifiers again
+                    set_input_enabled(false);
+                    return;
+                }
+
+                const auto index = keyboard_manager.device_index_for_fd(fd);
+                if (!index) {
+                    raw->setEnabled(false);  // Stale fd; the next sync drops the notifier
+                    return;
+                }
+
+                const int rc = process_keyboard_events(keyboard_manager.keyboard(*index));
+                if (rc < 0 && rc != -EAGAIN) {
+                    // Device went away (e.g. -ENODEV); stop spinning until udev removes it
+                    raw->setEnabled(false);
+                }
+            });
+            notifier->setEnabled(inputEnabled);
+            inputNotifiers.emplace(fd, std::move(notifier));
+        }
+    };
+
+    // Threaded mode: the input thread owns the keyboards and queues finished reports;
+    // this thread only drains the queue and performs the BLE writes.
+    std::unique_ptr<pipeline::InputThread> inputThread;
+    std::unique_ptr<QSocketNotifier> inputThreadNotifier;
+
+    // Called once the writable characteristic is known
+    auto start_input = [&]() {
+        if (!g_options.input_thread) {
+            set_input_enabled(true);
+            if (g_options.legacy_polling && !pollTimer.isActive()) {
+                pollTimer.start();
+            }
+            return;
+        }
+        if (inputThread) {
+            return;
+        }
+
+        inputThread = std::make_unique<pipeline::InputThread>(
+            keyboard_manager,
+            pipeline::InputThread::Config{g_options.input_rt_priority, g_options.input_cpu,
+                                          g_options.coalesce_frames, tracer, latency, counters,
+                                          chords, passthrough ? &*passthrough : nullptr},
+            g_options.verbose);
+        inputThreadNotifier =
+            std::make_unique<QSocketNotifier>(inputThread->notify_fd(), QSocketNotifier::Read);
+        QObject::connect(inputThreadNotifier.get(), &QSocketNotifier::activated, [&]() {
+            auto forward = [&](const pipeline::Report& report,
+                               const pipeline::ReportTiming& timing) {
+                if (sendReport) {
+                    sendReport(report, timing);
+                }
+            };
+            inputThread->drain(forward);
+            const std::uint32_t actions = inputThread->take_actions();
+            for (unsigned bit = 0; bit <= hotkey::ACTION_COUNT; ++bit) {
+                if (actions & (1U << bit)) {
+                    run_hotkey(static_cast<hotkey::Action>(bit));
+                }
+            }
+            if (inputThread->exit_requested()) {
+                inputThread->drain(forward);  // Final release report queued with the exit flag
+                flush_transmit();
+                LOG_INFO("Exit hotkey detected (" + exitChord + ") - stopping program...");
+                LOG_INFO("Stopping HID reports and exiting...");
+                logging::Logger::flush();
+                g_running = false;
+                app.quit();
+            }
+        });
+
+        if (!inputThread->start()) {
+            LOG_ERROR("Failed to start input thread");
+            g_running = false;
+            app.quit();
+            return;
+        }
+        if (g_options.verbose) {
+            LOG_DEBUG("Input thread started (queue capacity " +
+                      std::to_string(pipeline::InputThread::QUEUE_CAPACITY) + " reports)");
+        }
+    };
+
+    if (g_options.input_thread) {
+        // Keyboards and hot-plug are handled by the input thread once BLE is ready
+    } else if (g_options.legacy_polling) {
+        pollTimer.setInterval(g_options.poll_interval);
+        QObject::connect(&pollTimer, &QTimer::timeout, [&] {
+            if (!g_running || !sendReport) {
+                pollTimer.stop();  // Restarted by start_input() once reports have a sink
+                return;
+            }
+
+            // Cached pollfd array: keyboards first (index-aligned), monitor last
+            device::PollFdSet set = keyboard_manager.poll_fds();
+            if (set.count == 0)
+                return;
+
+            if (poll(set.fds, set.count, 0) <= 0)
+                return;  // non-blocking
+
+            // Process keyboard events
+            for (size_t i = 0; i < set.keyboard_count; ++i) {
+                if (!(set.fds[i].revents & POLLIN))
+                    continue;
+
+                process_keyboard_events(keyboard_manager.keyboard(i));
+                if (!g_running)
+                    return;
+            }
+
+            // Handle hot-plug events and probe retries last; the update may
+            // rebuild the cached array
+            if (set.hotplug_ready() && keyboard_manager.update_devices() && g_options.verbose) {
+                LOG_DEBUG("Device list updated");
+            }
+        });
+        if (g_options.verbose) {
+            LOG_DEBUG("Using legacy timer polling every " +
+                      std::to_string(g_options.poll_interval) + "ms");
+        }
+    } else {
+        auto on_hotplug = [&]() {
+            if (keyboard_manager.update_devices()) {
+                if (g_options.verbose) {
+                    LOG_DEBUG("Device list updated");
+                }
+                sync_input_notifiers();
+            }
+        };
+        hotplugNotifier =
+            std::make_unique<QSocketNotifier>(keyboard_manager.monitor_fd(), QSocketNotifier::Read);
+        QObject::connect(hotplugNotifier.get(), &QSocketNotifier::activated, on_hotplug);
+        if (keyboard_manager.retry_fd() >= 0) {
+            hotplugRetryNotifier = std::make_unique<QSocketNotifier>(keyboard_manager.retry_fd(),
+                                                                     QSocketNotifier::Read);
+            QObject::connect(hotplugRetryNotifier.get(), &QSocketNotifier::activated, on_hotplug);
+        }
+        sync_input_notifiers();
+        if (g_options.verbose) {
+            LOG_DEBUG("Using event-driven input (" + std::to_string(inputNotifiers.size()) +
+                      " keyboard notifier(s))");
+        }
+    }
+
+    // ----- Early-exit scanning -----
+    // Scanning stops as soon as the device to use is known instead of running for the whole
+    // --scan-timeout (see ScanSelector).
+    ble::ScanSelector scanSelector(g_options.targets, !g_options.disable_auto_connect,
+                                   g_options.scan_grace);
+    QBluetoothDeviceInfo graceCandidate;  // Single NinjaUSB device seen during the grace window
+    QTimer scanGraceTimer;
+    scanGraceTimer.setSingleShot(true);
+
+    // ----- GATT cache / fast reconnect -----
+    // The last working device is remembered so the next start can connect to it directly
+    // instead of scanning and walking the whole GATT database. Only used with one link.
+    const auto startTime = std::chrono::steady_clock::now();
+    const std::string gattCachePath =
+        g_options.gatt_cache.empty() ? ble::default_gatt_cache_path() : g_options.gatt_cache;
+    std::optional<ble::GattCacheEntry> gattCache;
+    if (!multiLink && !g_options.no_gatt_cache && !g_options.list_devices &&
+        !gattCachePath.empty()) {
+        gattCache = ble::load_gatt_cache(gattCachePath);
+        if (gattCache && !gattCache->matches_target(g_options.target_device)) {
+            gattCache.reset();  // --target asks for a different device
+        }
+    }
+    bool usingGattCache = false;  // True while the cached reconnect is in progress
+    std::function<void(std::size_t, const QBluetoothDeviceInfo&)> connect_to_device;
+
+    auto fall_back_to_discovery = [&](const std::string& reason) {
+        LOG_WARN("Cached device unavailable (" + reason + "), falling back to full discovery");
+        usingGattCache = false;
+        retire_link(0);
+        scanSelector.reset();
+        start_scan(false);
+    };
+
+    // Starts the report path with the first ready link and remembers a single link's
+    // device for the next start. A reconnected link is sent the current key state.
+    auto on_link_ready = [&](std::size_t slot, ble::BleLink& link) {
+        if (links[slot].get() != &link) {
+            return;  // Replaced by a select command
+        }
+        if (const auto outage = reconnects[slot].on_connected(std::chrono::steady_clock::now())) {
+            const auto us = std::chrono::duration_cast<std::chrono::microseconds>(*outage);
+            LOG_INFO(link.label() + "Reconnected after " + std::to_string(us.count() / 1000) +
+                     " ms (" + std::to_string(reconnects[slot].attempts()) + " attempt(s))");
+            if (counters) {
+                counters->ble_reconnected.add();
+                counters->ble_reconnect_us.add(static_cast<std::uint64_t>(us.count()));
+                counters->ble_last_reconnect_us.set(static_cast<std::uint64_t>(us.count()));
+            }
+            // The host dropped its key state with the link; a link that is not routed
+            // only needs to know that nothing is held
+            const bool routed = router.routes_to(slot);
+            link.submit(routed ? currentReport : pipeline::Report{});
+            link.submit(routed ? currentConsumer : pipeline::Report::consumer(0));
+            return;
+        }
+
+        const bool cached = usingGattCache;
+        const bool first = !sendReport;
+        usingGattCache = false;
+        sendReport = route_report;
+        start_input();
+        if (first && g_options.idle_timeout > 0) {
+            idleGovernor.emplace(std::chrono::seconds(g_options.idle_timeout));
+            idleTimer.start(std::chrono::seconds(g_options.idle_timeout));
+        }
+        LOG_INFO(link.label() + "✔ Found writable characteristic: " +
+                 link.characteristic().uuid().toString().toStdString());
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startTime);
+        LOG_INFO(link.label() + "Link ready " + std::to_string(elapsed.count()) +
+                 " ms after start" + (cached ? " (cached device)" : ""));
+
+        if (!multiLink && !g_options.no_gatt_cache && !gattCachePath.empty() &&
+            !ble::save_gatt_cache(gattCachePath, *link.gatt_entry())) {
+            LOG_WARN("Could not write GATT cache " + gattCachePath);
+        }
+        if (first) {
+            LOG_INFO("Ready! Start typing – " + exitChord + " to quit (Ctrl+C disabled).");
+            for (unsigned i = 1; i <= hotkey::ACTION_COUNT; ++i) {
+                const auto action = static_cast<hotkey::Action>(i);
+                const auto link = hotkey::toggled_link(action);
+                if (action == hotkey::Action::Exit || (link && *link >= links.size())) {
+                    continue;
+                }
+                if (const hotkey::Chord* chord = chords.chord(action)) {
+                    LOG_INFO(hotkey::describe(*chord) + ": " +
+                             std::string(hotkey::action_name(action)));
+                }
+            }
+            if (injector) {
+                start_typing();
+            }
+        }
+    };
+
+    // A link that was ready is reconnected with backoff instead of ending the program. The
+    // keyboards stay grabbed meanwhile and keep updating currentReport.
+    auto schedule_reconnect = [&](std::size_t slot, ble::BleLink& link,
+                                  const ble::LinkFailure& failure) {
+        ble::ReconnectBackoff& backoff = reconnects[slot];
+        const bool lost = !backoff.reconnecting();
+        const auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(
+            backoff.on_failure(std::chrono::steady_clock::now()));
+        if (lost) {
+            LOG_WARN(link.label() + "BLE link lost (" + failure.reason + "), reconnecting in " +
+                     std::to_string(delay.count()) + " ms");
+        } else {
+            LOG_WARN(link.label() + "Reconnect attempt " + std::to_string(backoff.attempts()) +
+                     " failed (" + failure.reason + "), retrying in " +
+                     std::to_string(delay.count()) + " ms");
+        }
+
+        // A peer that no longer offers the handles gets a full service discovery
+        const bool useHandles = failure.kind != ble::LinkFailure::Kind::NoCharacteristic;
+        const std::uint64_t id = linkIds[slot];
+        QTimer::singleShot(static_cast<int>(delay.count()), &app, [&, slot, useHandles, id]() {
+            if (!g_running || !links[slot] || linkIds[slot] != id) {
+                return;  // Dropped, or replaced by a select command meanwhile
+            }
+            const int attempt = reconnects[slot].begin_attempt();
+            if (counters) {
+                counters->ble_connects.add();
+                counters->ble_reconnects.add();
+            }
+            ++linkAttempts[slot];
+            if (g_options.verbose) {
+                LOG_DEBUG(links[slot]->label() + "Reconnect attempt " + std::to_string(attempt) +
+                          (useHandles ? " (cached handles)" : " (full discovery)"));
+            }
+            links[slot]->reconnect(useHandles);
+        });
+    };
+
+    // A cached startup connect falls back to a scan and a lost link is reconnected;
+    // otherwise the link is dropped and the program exits once no link is left (a daemon
+    // waits for a select command instead)
+    auto on_link_failed = [&](std::size_t slot, ble::BleLink& link,
+                              const ble::LinkFailure& failure) {
+        if (links[slot].get() != &link) {
+            return;  // Replaced by a select command
+        }
+        if (usingGattCache) {
+            fall_back_to_discovery(failure.reason);
+            return;
+        }
+        if (reconnects[slot].reconnecting() || (link.gatt_entry() && !g_options.no_reconnect)) {
+            schedule_reconnect(slot, link, failure);
+            return;
+        }
+        switch (failure.kind) {
+            case ble::LinkFailure::Kind::Timeout:
+                LOG_ERROR(link.label() +
+                          "BLE connection timeout - failed to connect within 30 seconds");
+                break;
+            case ble::LinkFailure::Kind::Disconnected:
+                LOG_WARN(link.label() + "Disconnected from BLE device");
+                break;
+            case ble::LinkFailure::Kind::Error:
+                LOG_ERROR(link.label() + "BLE connection failed: " + failure.reason);
+                break;
+            case ble::LinkFailure::Kind::NoCharacteristic:
+                LOG_ERROR(link.label() + "No writable characteristic found");
+                break;
+        }
+        retire_link(slot);
+        if (std::none_of(links.begin(), links.end(), [](const auto& l) { return l != nullptr; })) {
+            if (daemonMode) {
+                LOG_INFO("No BLE link left; waiting for a select command on " + g_options.daemon);
+                return;
+            }
+            g_running = false;
+            app.quit();
+        }
+    };
 
     // ----- Device discovery -----
+    // Multi-link: connect to every --target device that was found
+    auto connect_targets = [&]() {
+        std::size_t connecting = 0;
+        for (std::size_t slot = 0; slot < g_options.targets.size(); ++slot) {
+            const std::string& target = g_options.targets[slot];
+            const ble::DeviceCache::Device* device = deviceCache.match(target);
+            if (!device) {
+                LOG_ERROR("Target device not found: " + target +
+                          " (connecting once a background scan sees it)");
+                continue;
+            }
+            LOG_INFO("Found target device: " + target);
+            connect_to_device(slot, device_info(*device));
+            ++connecting;
+        }
+        if (connecting == 0 && !daemonMode) {
+            app.quit();
+        }
+    };
+
+    auto connect_early = [&](const QBluetoothDeviceInfo& info) {
+        scanGraceTimer.stop();
+        discoveryAgent.stop();
+        if (multiLink) {
+            LOG_INFO("Stopping scan early, all target devices found");
+            connect_targets();
+            return;
+        }
+        LOG_INFO("Stopping scan early, connecting to " + info.name().toStdString() + " [" +
+                 info.address().toString().toStdString() + "]");
+        connect_to_device(0, info);
+    };
+
+    QObject::connect(&scanGraceTimer, &QTimer::timeout, [&]() {
+        if (scanSelector.on_grace_expired()) {
+            connect_early(graceCandidate);
+        }
+    });
+
+    // Device picked by the last select command; replaces --target for a daemon's link
+    std::optional<QBluetoothDeviceInfo> selectedDevice;
+
+    // Fan-out targets not found at startup, and a daemon's target once its link has
+    // failed, are connected as soon as a background scan sees them
+    auto connect_if_missing = [&](const ble::DeviceCache::Device& device) {
+        const std::string single = selectedDevice
+                                       ? selectedDevice->address().toString().toStdString()
+                                       : g_options.target_device;
+        for (std::size_t slot = 0; slot < links.size(); ++slot) {
+            const std::string& target = multiLink ? g_options.targets[slot] : single;
+            if (links[slot] || target.empty() || deviceCache.match(target) != &device) {
+                continue;
+            }
+            discoveryAgent.stop();
+            LOG_INFO("Target " + target + " seen by the background scan; connecting");
+            connect_to_device(slot, device_info(device));
+            return;
+        }
+    };
+
+    auto on_device_discovered = [&](const QBluetoothDeviceInfo& info) {
+        const auto seen = record_sighting(info);
+        if (backgroundScan) {
+            if (seen.added && g_options.verbose) {
+                LOG_DEBUG("Background scan found " + seen.device.name + " [" +
+                          seen.device.address + "]");
+            }
+            connect_if_missing(seen.device);
+            return;
+        }
+        LOG_INFO("Found device " + std::to_string(seen.position) + ": " + seen.device.name +
+                 " [" + seen.device.address + "]");
+        if (g_options.list_devices) {
+            return;
+        }
+
+        switch (scanSelector.on_discovered(seen.device.address, seen.device.name,
+                                           seen.device.ninja)) {
+            case ble::ScanSelector::Action::ConnectNow:
+                connect_early(info);
+                break;
+            case ble::ScanSelector::Action::StartGrace:
+                graceCandidate = info;
+                scanGraceTimer.start(scanSelector.grace_ms());
+                break;
+            case ble::ScanSelector::Action::CancelGrace:
+                if (g_options.verbose) {
+                    LOG_DEBUG("Several NinjaUSB devices, scanning to the end");
+                }
+                scanGraceTimer.stop();
+                break;
+            case ble::ScanSelector::Action::None:
+                break;
+        }
+    };
+
+    // RSSI and advertising data changes of devices already reported in this scan
+    auto on_device_updated = [&](const QBluetoothDeviceInfo& info, QBluetoothDeviceInfo::Fields) {
+        const auto seen = record_sighting(info);
+        if (backgroundScan) {
+            connect_if_missing(seen.device);
+        }
+    };
+
     QObject::connect(&discoveryAgent, &QBluetoothDeviceDiscoveryAgent::deviceDiscovered,
-                     [&](const QBluetoothDeviceInfo& info) {
-                         LOG_INFO("Found device " + std::to_string(foundDevices.size()) + ": " +
-                                  info.name().toStdString() + " [" +
-                                  info.address().toString().toStdString() + "]");
-                         foundDevices.append(info);
-                     });
+                     on_device_discovered);
+    QObject::connect(&discoveryAgent, &QBluetoothDeviceDiscoveryAgent::deviceUpdated,
+                     on_device_updated);
+
+    QObject::connect(&discoveryAgent, &QBluetoothDeviceDiscoveryAgent::canceled,
+                     [&]() { backgroundScan = false; });
 
     QObject::connect(&discoveryAgent, &QBluetoothDeviceDiscoveryAgent::finished, [&]() {
+        if (backgroundScan) {
+            backgroundScan = false;
+            const std::size_t forgotten =
+                deviceCache.prune(ble::DeviceCache::Clock::now(), DEVICE_MAX_AGE);
+            if (g_options.verbose) {
+                LOG_DEBUG("Background scan done: " + std::to_string(deviceCache.size()) +
+                          " known device(s), " + std::to_string(forgotten) + " forgotten");
+            }
+            return;
+        }
+        scanGraceTimer.stop();
+        if (scanSelector.decided()) {
+            return;  // Already connecting to the early match
+        }
         if (g_options.list_devices) {
             LOG_INFO("BLE device discovery completed. Found " +
-                     std::to_string(foundDevices.size()) + " devices");
+                     std::to_string(deviceCache.size()) + " devices");
             app.quit();
             return;
         }
 
-        if (foundDevices.empty()) {
+        if (deviceCache.empty()) {
+            if (daemonMode) {
+                LOG_WARN("No BLE devices found; waiting for a select command");
+                return;
+            }
             LOG_ERROR("No BLE devices found – exiting.");
             app.quit();
             return;
         }
 
+        if (multiLink) {
+            connect_targets();
+            return;
+        }
+
+        const auto& devices = deviceCache.devices();
+        auto describe = [&](std::size_t i) {
+            return "  " + std::to_string(i) + ": " + devices[i].name + " [" + devices[i].address +
+                   "]";
+        };
         int index = 0;
 
         // Check if target device specified
         if (!g_options.target_device.empty()) {
-            bool found = false;
-            for (int i = 0; i < foundDevices.size(); ++i) {
-                if (foundDevices[i].address().toString().toStdString() == g_options.target_device ||
-                    foundDevices[i].name().toStdString() == g_options.target_device) {
-                    index = i;
-                    found = true;
-                    LOG_INFO("Found target device: " + g_options.target_device);
-                    break;
-                }
-            }
-            if (!found) {
+            const ble::DeviceCache::Device* target = deviceCache.match(g_options.target_device);
+            if (!target) {
                 LOG_ERROR("Target device not found: " + g_options.target_device);
-                app.quit();
+                if (!daemonMode) {
+                    app.quit();
+                }
                 return;
             }
+            LOG_INFO("Found target device: " + g_options.target_device);
+            index = static_cast<int>(target - devices.data());
         } else {
-            // Filter NinjaUSB devices
-            QList<QBluetoothDeviceInfo> ninjaDevices;
-            for (const auto& device : foundDevices) {
-                QString deviceName = device.name();
-                if (deviceName.contains("ninja", Qt::CaseInsensitive) ||
-                    deviceName.contains("NinjaUSB", Qt::CaseInsensitive)) {
-                    ninjaDevices.append(device);
-                }
-            }
+            const std::size_t ninjaCount = deviceCache.ninja_count();
 
             // Auto-connect logic
-            if (!g_options.disable_auto_connect && ninjaDevices.size() == 1) {
+            if (!g_options.disable_auto_connect && ninjaCount == 1) {
                 // Auto-connect to the single NinjaUSB device
-                for (int i = 0; i < foundDevices.size(); ++i) {
-                    if (foundDevices[i].address() == ninjaDevices[0].address()) {
-                        index = i;
-                        break;
-                    }
-                }
-                LOG_INFO("Auto-connecting to NinjaUSB device: " +
-                         ninjaDevices[0].name().toStdString());
+                const auto ninja = std::find_if(devices.begin(), devices.end(),
+                                                [](const auto& device) { return device.ninja; });
+                index = static_cast<int>(ninja - devices.begin());
+                LOG_INFO("Auto-connecting to NinjaUSB device: " + ninja->name);
                 if (g_options.verbose) {
                     LOG_DEBUG("Auto-connect enabled and exactly one NinjaUSB device found");
                 }
-            } else if (ninjaDevices.size() > 1) {
+            } else if (ninjaCount > 1) {
                 // Multiple NinjaUSB devices found, show them to the user
                 LOG_INFO("Multiple NinjaUSB devices found:");
-                for (int i = 0; i < foundDevices.size(); ++i) {
-                    const auto& device = foundDevices[i];
-                    QString deviceName = device.name();
-                    if (deviceName.contains("ninja", Qt::CaseInsensitive) ||
-                        deviceName.contains("NinjaUSB", Qt::CaseInsensitive)) {
-                        LOG_INFO("  " + std::to_string(i) + ": " + device.name().toStdString() +
-                                 " [" + device.address().toString().toStdString() + "]");
+                for (std::size_t i = 0; i < devices.size(); ++i) {
+                    if (devices[i].ninja) {
+                        LOG_INFO(describe(i));
                     }
                 }
+                if (daemonMode) {
+                    LOG_INFO("Waiting for a select command on " + g_options.daemon);
+                    return;
+                }
                 LOG_INFO("Choose device number: ");
                 std::cin >> index;
-                if (index < 0 || index >= foundDevices.size()) {
+                if (index < 0 || static_cast<std::size_t>(index) >= devices.size()) {
                     LOG_ERROR("Invalid device index");
                     app.quit();
                     return;
                 }
             } else {
                 // No NinjaUSB devices found or auto-connect disabled, show all devices
-                if (g_options.disable_auto_connect && ninjaDevices.size() == 1) {
+                if (g_options.disable_auto_connect && ninjaCount == 1) {
                     LOG_INFO("Auto-connect disabled. Please choose from available devices:");
-                } else if (ninjaDevices.empty()) {
+                } else if (ninjaCount == 0) {
                     LOG_INFO("No NinjaUSB devices found. Available devices:");
                 }
 
-                for (int i = 0; i < foundDevices.size(); ++i) {
-                    const auto& device = foundDevices[i];
-                    LOG_INFO("  " + std::to_string(i) + ": " + device.name().toStdString() + " [" +
-                             device.address().toString().toStdString() + "]");
+                for (std::size_t i = 0; i < devices.size(); ++i) {
+                    LOG_INFO(describe(i));
+                }
+                if (daemonMode) {
+                    LOG_INFO("Waiting for a select command on " + g_options.daemon);
+                    return;
                 }
                 LOG_INFO("Choose device number: ");
                 std::cin >> index;
-                if (index < 0 || index >= foundDevices.size()) {
+                if (index < 0 || static_cast<std::size_t>(index) >= devices.size()) {
                     LOG_ERROR("Invalid device index");
                     app.quit();
                     return;
@@ -373,264 +1484,372 @@ int main(int argc, char* argv[]) {
             }
         }
 
-        const QBluetoothDeviceInfo& device = foundDevices[index];
-        controller = QLowEnergyController::createCentral(device);
-
-        LOG_INFO("Connecting to device: " + device.name().toStdString());
-
-        QObject::connect(controller, &QLowEnergyController::connected, [&]() {
-            LOG_INFO("Connected. Discovering services...");
-            controller->discoverServices();
-        });
-        QObject::connect(controller, &QLowEnergyController::disconnected, [&]() {
-            LOG_WARN("Disconnected from BLE device");
-            g_running = false;
-            app.quit();
-        });
-
-        // Handle connection errors
-        QObject::connect(
-            controller,
-            QOverload<QLowEnergyController::Error>::of(&QLowEnergyController::errorOccurred),
-            [&](QLowEnergyController::Error error) {
-                QString errorString;
-                switch (error) {
-                    case QLowEnergyController::NoError:
-                        return;  // No error, continue
-                    case QLowEnergyController::UnknownError:
-                        errorString = "Unknown error";
-                        break;
-                    case QLowEnergyController::UnknownRemoteDeviceError:
-                        errorString = "Unknown remote device error";
-                        break;
-                    case QLowEnergyController::NetworkError:
-                        errorString = "Network error";
-                        break;
-                    case QLowEnergyController::InvalidBluetoothAdapterError:
-                        errorString = "Invalid Bluetooth adapter";
-                        break;
-                    case QLowEnergyController::ConnectionError:
-                        errorString = "Connection error";
-                        break;
-                    case QLowEnergyController::AdvertisingError:
-                        errorString = "Advertising error";
-                        break;
-                    case QLowEnergyController::RemoteHostClosedError:
-                        errorString = "Remote host closed connection";
-                        break;
-                    case QLowEnergyController::AuthorizationError:
-                        errorString = "Authorization error";
-                        break;
-                    default:
-                        errorString = "Error code: " + QString::number(static_cast<int>(error));
-                        break;
-                }
-                LOG_ERROR("BLE connection failed: " + errorString.toStdString());
-                g_running = false;
-                app.quit();
-            });
-
-        // Handle connection state changes
-        QObject::connect(controller, &QLowEnergyController::stateChanged,
-                         [&](QLowEnergyController::ControllerState state) {
-                             if (g_options.verbose) {
-                                 QString stateString;
-                                 switch (state) {
-                                     case QLowEnergyController::UnconnectedState:
-                                         stateString = "Unconnected";
-                                         break;
-                                     case QLowEnergyController::ConnectingState:
-                                         stateString = "Connecting";
-                                         break;
-                                     case QLowEnergyController::ConnectedState:
-                                         stateString = "Connected";
-                                         break;
-                                     case QLowEnergyController::DiscoveringState:
-                                         stateString = "Discovering";
-                                         break;
-                                     case QLowEnergyController::DiscoveredState:
-                                         stateString = "Discovered";
-                                         break;
-                                     case QLowEnergyController::ClosingState:
-                                         stateString = "Closing";
-                                         break;
-                                     case QLowEnergyController::AdvertisingState:
-                                         stateString = "Advertising";
-                                         break;
-                                     default:
-                                         stateString = "Unknown state: " +
-                                                       QString::number(static_cast<int>(state));
-                                         break;
-                                 }
-                                 LOG_DEBUG("BLE Controller state: " + stateString.toStdString());
-                             }
-                         });
-
-        QObject::connect(controller, &QLowEnergyController::serviceDiscovered,
-                         [&](const QBluetoothUuid& uuid) {
-                             if (g_options.verbose) {
-                                 LOG_DEBUG("Service discovered: " + uuid.toString().toStdString());
-                             }
-                         });
-
-        QObject::connect(controller, &QLowEnergyController::discoveryFinished, [&]() {
-            if (g_options.verbose) {
-                LOG_DEBUG("Service discovery finished");
-            }
-            // Pick first service and search for writable char
-            for (const QBluetoothUuid& uuid : controller->services()) {
-                service = controller->createServiceObject(uuid);
-                if (!service)
-                    continue;
+        connect_to_device(0, device_info(devices[static_cast<std::size_t>(index)]));
+    });
 
-                QObject::connect(
-                    service, &QLowEnergyService::stateChanged,
-                    [&](QLowEnergyService::ServiceState s) {
-                        if (s != QLowEnergyService::RemoteServiceDiscovered)
-                            return;
-                        for (const auto& c : service->characteristics()) {
-                            if (c.properties() & (QLowEnergyCharacteristic::Write |
-                                                  QLowEnergyCharacteristic::WriteNoResponse)) {
-                                targetChar = c;
-                                sendReport = make_report_writer(service, targetChar);
-                                LOG_INFO("✔ Found writable characteristic: " +
-                                         c.uuid().toString().toStdString());
-                                LOG_INFO(
-                                    "Ready! Start typing – Alt+Ctrl+H to quit (Ctrl+C disabled).");
-                            }
-                        }
-                    });
-                service->discoverDetails();
-                if (targetChar.isValid())
-                    break;
+    // Creates the link of one slot and starts connecting; on the cached path only the cached
+    // service is inspected and every failure falls back to a scan.
+    connect_to_device = [&](std::size_t slot, const QBluetoothDeviceInfo& device) {
+        if (counters) {
+            if (linkAttempts[slot] > 0) {
+                counters->ble_reconnects.add();
             }
-            if (!targetChar.isValid()) {
-                LOG_ERROR("No writable characteristic found");
-                app.quit();
-            }
-        });
-
-        // Set up connection timeout (30 seconds)
-        QTimer* connectionTimer = new QTimer();
-        connectionTimer->setSingleShot(true);
-        connectionTimer->setInterval(30000);  // 30 seconds
-
-        QObject::connect(connectionTimer, &QTimer::timeout, [&, connectionTimer]() {
-            LOG_ERROR("BLE connection timeout - failed to connect within 30 seconds");
-            connectionTimer->deleteLater();
-            g_running = false;
-            app.quit();
-        });
-
-        // Stop timer when connected successfully
-        QObject::connect(controller, &QLowEnergyController::connected, [connectionTimer]() {
-            connectionTimer->stop();
-            connectionTimer->deleteLater();
-        });
-
-        // Start connection timeout timer before attempting connection
-        connectionTimer->start();
-        controller->connectToDevice();
-    });
+            counters->ble_connects.add();
+        }
+        ++linkAttempts[slot];
+        linkIds[slot] = ++nextLinkId;
 
-    discoveryAgent.start();
+        ble::BleLink::Config config;
+        config.profile = ble::parse_connection_profile(g_options.conn_profile)
+                             .value_or(ble::ConnectionProfile::LowLatency);
+        if (usingGattCache) {
+            config.cached = gattCache;
+        }
+        if (multiLink) {
+            config.label = "[link " + std::to_string(slot + 1) + "] ";
+        }
+        config.verbose = g_options.verbose;
+        config.trace = tracer;
+        config.latency = latency;
+        config.metrics = counters;
 
-    // ------------------ Input processing loop ------------------
-    QTimer pollTimer;
-    pollTimer.setInterval(g_options.poll_interval);
-    QObject::connect(&pollTimer, &QTimer::timeout, [&] {
-        if (!g_running || !sendReport)
-            return;
+        links[slot] = std::make_unique<ble::BleLink>(
+            device, std::move(config),
+            ble::BleLink::Callbacks{
+                [&, slot](ble::BleLink& link) { on_link_ready(slot, link); },
+                [&, slot](ble::BleLink& link, const ble::LinkFailure& failure) {
+                    on_link_failed(slot, link, failure);
+                }});
+        links[slot]->connect();
+    };
 
-        // Update device list (handle hot-plug events)
-        if (keyboard_manager.update_devices() && g_options.verbose) {
-            LOG_DEBUG("Device list updated");
+    // ------------------ Daemon control socket ------------------
+    // Select, list, inject and stats requests are answered on this thread, between input
+    // notifications; see control_protocol.hpp for the frames.
+    auto find_device = [&](const std::string& address) -> std::optional<QBluetoothDeviceInfo> {
+        const QBluetoothAddress wanted(QString::fromStdString(address));
+        if (selectedDevice && selectedDevice->address() == wanted) {
+            return selectedDevice;  // Still known after the cache has forgotten it
         }
+        if (const ble::DeviceCache::Device* device = deviceCache.find(address)) {
+            return device_info(*device);
+        }
+        if (gattCache && QBluetoothAddress(QString::fromStdString(gattCache->address)) == wanted) {
+            QBluetoothDeviceInfo cachedDevice(wanted, QString::fromStdString(gattCache->name), 0);
+            cachedDevice.setCoreConfigurations(QBluetoothDeviceInfo::LowEnergyCoreConfiguration);
+            return cachedDevice;
+        }
+        return std::nullopt;
+    };
 
-        // Get poll file descriptors
-        std::vector<int> fds = keyboard_manager.get_poll_fds();
-        if (fds.empty())
-            return;
+    // Switches the single link to another device: the old host is sent a release first and
+    // the keyboards stay grabbed throughout
+    auto select_target = [&](const QBluetoothDeviceInfo& device) {
+        scanGraceTimer.stop();
+        discoveryAgent.stop();
+        usingGattCache = false;
+        selectedDevice = device;
+        if (links[0]) {
+            if (links[0]->device().address() == device.address()) {
+                return;  // Already the target
+            }
+            links[0]->submit(pipeline::Report{});
+            links[0]->submit(pipeline::Report::consumer(0));
+            links[0]->flush();
+            retire_link(0);
+        }
+        LOG_INFO("Selecting " + device.name().toStdString() + " [" +
+                 device.address().toString().toStdString() + "]");
+        reconnects[0] = ble::ReconnectBackoff{};
+        connect_to_device(0, device);
+    };
 
-        // Create pollfd structures
-        std::vector<struct pollfd> pfds;
-        pfds.reserve(fds.size());
-        for (int fd : fds) {
-            pfds.push_back({fd, POLLIN, 0});
+    // The report goes to the routed, ready links only; it does not change the key state
+    // resent after a reconnect
+    auto inject_report = [&](const pipeline::Report& report) -> control::Status {
+        if (typing) {
+            return control::Status::NotReady;
+        }
+        bool sent = false;
+        const bool woke =
+            idleGovernor && idleGovernor->on_activity(ble::IdleGovernor::Clock::now());
+        for (std::size_t i = 0; i < links.size(); ++i) {
+            if (router.routes_to(i) && links[i] && links[i]->ready()) {
+                links[i]->submit(report);
+                sent = true;
+            }
+        }
+        if (woke) {
+            wake_up();
         }
+        if (!sent) {
+            return control::Status::NotReady;
+        }
+        ++reportsInjected;
+        return control::Status::Ok;
+    };
 
-        if (poll(pfds.data(), pfds.size(), 0) <= 0)
-            return;  // non-blocking
+    auto control_stats = [&]() {
+        control::Stats stats{};
+        auto stat = [&](control::Stat which) -> std::uint64_t& {
+            return stats[static_cast<std::size_t>(which)];
+        };
+        for (const auto& link : links) {
+            const pipeline::TransmitScheduler* scheduler = link ? link->scheduler() : nullptr;
+            if (link && link->ready()) {
+                ++stat(control::Stat::ReadyLinks);
+            }
+            if (scheduler) {
+                stat(control::Stat::BleWritten) += scheduler->stats().written;
+                stat(control::Stat::BleCollapsed) += scheduler->stats().collapsed;
+                stat(control::Stat::BleQueueDepth) += scheduler->queue_depth();
+            }
+        }
+        for (const int attempts : linkAttempts) {
+            stat(control::Stat::BleConnects) += static_cast<std::uint64_t>(attempts);
+        }
+        stat(control::Stat::ReportsRouted) = reportsRouted;
+        stat(control::Stat::ReportsInjected) = reportsInjected;
+        stat(control::Stat::Idle) = idleGovernor && idleGovernor->idle() ? 1 : 0;
+        stat(control::Stat::KnownDevices) = deviceCache.size();
+        stat(control::Stat::UptimeMs) = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - startTime)
+                .count());
+        return stats;
+    };
 
-        // Process keyboard events
-        const auto& keyboards = keyboard_manager.keyboards();
-        for (size_t i = 0; i < keyboards.size(); ++i) {
-            if (i >= pfds.size() || !(pfds[i].revents & POLLIN))
+    // Ranked like automatic selection; linked devices no scan has seen (GATT cache) last
+    auto list_devices = [&]() {
+        const auto now = ble::DeviceCache::Clock::now();
+        std::vector<control::DeviceEntry> entries;
+        auto add = [&](const std::string& address, const std::string& name, std::int16_t rssi,
+                       std::uint8_t flags) {
+            control::DeviceEntry entry;
+            entry.address = control::parse_address(address).value_or(entry.address);
+            entry.rssi = rssi;
+            entry.name = name;
+            entry.flags = flags;
+            for (const auto& link : links) {
+                if (link && link->device().address().toString().toStdString() == address) {
+                    entry.flags |= control::DEVICE_SELECTED;
+                    if (link->ready()) {
+                        entry.flags |= control::DEVICE_READY;
+                    }
+                }
+            }
+            entries.push_back(std::move(entry));
+        };
+        for (const ble::DeviceCache::Device* device : deviceCache.ranked(now, DEVICE_FRESH_FOR)) {
+            std::uint8_t flags = device->ninja ? control::DEVICE_NINJA : 0;
+            if (now - device->last_seen > DEVICE_FRESH_FOR) {
+                flags |= control::DEVICE_STALE;
+            }
+            add(device->address, device->name, device->rssi, flags);
+        }
+        for (const auto& link : links) {
+            if (!link) {
                 continue;
+            }
+            const std::string address = link->device().address().toString().toStdString();
+            const std::string name = link->device().name().toStdString();
+            if (!deviceCache.find(address)) {
+                add(address, name, link->device().rssi(),
+                    ble::ScanSelector::is_ninja_name(name) ? control::DEVICE_NINJA : 0);
+            }
+        }
+        return control::encode_devices(entries);
+    };
 
-            input_event ev{};
-            while (libevdev_next_event(keyboards[i].evdev(), LIBEVDEV_READ_FLAG_NORMAL, &ev) == 0) {
-                if (ev.type != EV_KEY)
-                    continue;
-
-                if (g_options.verbose) {
-                    LOG_DEBUG("Key event: code=" + std::to_string(ev.code) + " value=" +
-                              std::to_string(ev.value) + " from " + keyboards[i].name());
-                }
-
-                // Check for exit hotkey (Alt+Ctrl+H)
-                static ExitHotkeyDetector hotkey_detector(true);  // Enable logging
-                if (hotkey_detector.process_key_event(ev.code, ev.value)) {
-                    LOG_INFO("Exit hotkey detected (Alt+Ctrl+H) - stopping program...");
-                    // Send empty report to release all keys before exit
-                    if (sendReport) {
-                        sendReport({0, 0, 0, 0, 0, 0, 0, 0});
-                        if (g_options.verbose) {
-                            LOG_DEBUG("Sent empty HID report before exit");
-                        }
+    auto handle_control = [&](const control::Frame& request) {
+        control::Frame response;
+        switch (static_cast<control::Command>(request.command)) {
+            case control::Command::ListDevices:
+                response.payload = list_devices();
+                break;
+            case control::Command::SelectTarget: {
+                if (!request.payload.empty() && request.payload.size() != control::ADDRESS_SIZE) {
+                    response.status = control::Status::BadRequest;
+                    break;
+                }
+                if (multiLink) {
+                    response.status = control::Status::Unsupported;  // Targets are fixed
+                    break;
+                }
+                std::optional<QBluetoothDeviceInfo> device;
+                if (request.payload.empty()) {
+                    // Best NinjaUSB unit of the recent scans
+                    if (const ble::DeviceCache::Device* best =
+                            deviceCache.best(ble::DeviceCache::Clock::now(), DEVICE_FRESH_FOR)) {
+                        device = device_info(*best);
                     }
-                    LOG_INFO("Stopping HID reports and exiting...");
-                    g_running = false;
-                    app.quit();
-                    return;
+                } else {
+                    std::array<std::uint8_t, control::ADDRESS_SIZE> address{};
+                    std::copy(request.payload.begin(), request.payload.end(), address.begin());
+                    device = find_device(control::format_address(address));
                 }
-
-                if (g_options.verbose) {
-                    LOG_DEBUG("Hotkey state: " + hotkey_detector.get_state_description());
-                }
-
-                switch (ev.value) {
-                    case 1:  // key down
-                    case 2:  // auto-repeat
-                        if (hid::apply_key_event(kb_state, ev.code, ev.value)) {
-                            auto report = kb_state.get_report();
-                            sendReport(report);
-                            if (g_options.verbose) {
-                                LOG_DEBUG(
-                                    "Sent HID report: [" + std::to_string(report[0]) + ", " +
-                                    std::to_string(report[1]) + ", " + std::to_string(report[2]) +
-                                    ", " + std::to_string(report[3]) + ", " +
-                                    std::to_string(report[4]) + ", " + std::to_string(report[5]) +
-                                    ", " + std::to_string(report[6]) + ", " +
-                                    std::to_string(report[7]) + "]");
-                            }
-                        }
-                        break;
-                    case 0:  // key release
-                        [[maybe_unused]] bool changed =
-                            hid::apply_key_event(kb_state, ev.code, ev.value);
-                        // Send all-zero release report to stop the key
-                        sendReport({0, 0, 0, 0, 0, 0, 0, 0});
-                        if (g_options.verbose) {
-                            LOG_DEBUG("Sent key release HID report: [0, 0, 0, 0, 0, 0, 0, 0]");
-                        }
-                        break;
+                if (!device) {
+                    response.status = control::Status::NotFound;
+                    break;
                 }
+                select_target(*device);
+                break;
+            }
+            case control::Command::InjectReport:
+                if (const auto report = control::decode_report(request.payload)) {
+                    response.status = inject_report(*report);
+                } else {
+                    response.status = control::Status::BadRequest;
+                }
+                break;
+            case control::Command::QueryStats:
+                response.payload = control::encode_stats(control_stats());
+                break;
+            default:
+                response.status = control::Status::Unsupported;
+                break;
+        }
+        return response;
+    };
+
+    std::unique_ptr<control::ControlServer> controlServer;
+    std::unique_ptr<QSocketNotifier> controlNotifier;
+    std::unordered_map<int, std::unique_ptr<QSocketNotifier>> controlClients;
+    if (daemonMode) {
+        controlServer = std::make_unique<control::ControlServer>(g_options.daemon, handle_control);
+        if (!controlServer->is_valid()) {
+            LOG_ERROR("Cannot listen on control socket " + g_options.daemon + " (" +
+                      std::string(std::strerror(errno)) + ")");
+            return 1;
+        }
+        controlNotifier =
+            std::make_unique<QSocketNotifier>(controlServer->listen_fd(), QSocketNotifier::Read);
+        QObject::connect(controlNotifier.get(), &QSocketNotifier::activated, [&]() {
+            const int fd = controlServer->accept_client();
+            if (fd < 0) {
+                return;
             }
+            auto notifier = std::make_unique<QSocketNotifier>(fd, QSocketNotifier::Read);
+            QObject::connect(notifier.get(), &QSocketNotifier::activated, [&, fd]() {
+                if (controlServer->service(fd)) {
+                    return;
+                }
+                // The notifier is inside its own handler: disable it now, delete it later
+                auto it = controlClients.find(fd);
+                it->second->setEnabled(false);
+                it->second.release()->deleteLater();
+                controlClients.erase(it);
+                controlServer->close_client(fd);
+            });
+            controlClients.emplace(fd, std::move(notifier));
+        });
+        LOG_INFO("Daemon mode; control socket " + g_options.daemon);
+    }
+
+    if (gattCache) {
+        // Known device: skip the scan and connect to the cached address right away
+        LOG_INFO("Reconnecting to cached device " + gattCache->name + " [" + gattCache->address +
+                 "]");
+        usingGattCache = true;
+        const QBluetoothAddress cachedAddress(QString::fromStdString(gattCache->address));
+        const QString cachedName = QString::fromStdString(gattCache->name);
+        QBluetoothDeviceInfo cachedDevice(cachedAddress, cachedName, 0);
+        cachedDevice.setCoreConfigurations(QBluetoothDeviceInfo::LowEnergyCoreConfiguration);
+        connect_to_device(0, cachedDevice);
+    } else {
+        start_scan(false);
+    }
+
+    // Daemon and fan-out: keep deviceCache current with short scans between connects, so a
+    // select command or a missing target never waits for a full --scan-timeout scan
+    QTimer backgroundScanTimer;
+    QObject::connect(&backgroundScanTimer, &QTimer::timeout, [&]() {
+        // Scanning shares the radio with connection setup and typing
+        const bool connecting = std::any_of(links.begin(), links.end(), [](const auto& link) {
+            return link && !link->ready();
+        });
+        if (!g_running || discoveryAgent.isActive() || connecting || typing) {
+            return;
         }
+        start_scan(true);
     });
-    pollTimer.start();
+    if (daemonMode || multiLink) {
+        backgroundScanTimer.start(BACKGROUND_SCAN_PERIOD_MS);
+    }
 
     int ret = app.exec();
+
+    std::uint64_t reports_sent = key_processor.reports_sent();
+    std::uint64_t reports_suppressed = key_processor.reports_suppressed();
+    if (inputThread) {
+        inputThread->stop();
+        LOG_INFO("Input queue high-water mark: " +
+                 std::to_string(inputThread->queue_high_water_mark()) + "/" +
+                 std::to_string(pipeline::InputThread::QUEUE_CAPACITY) + " reports (" +
+                 std::to_string(inputThread->queue_full_waits()) + " full-queue waits)");
+        reports_sent = inputThread->reports_sent();
+        reports_suppressed = inputThread->reports_suppressed();
+    }
+    LOG_INFO("HID reports: " + std::to_string(reports_sent) + " sent, " +
+             std::to_string(reports_suppressed) + " unchanged suppressed");
+    for (const auto& link : links) {
+        const pipeline::TransmitScheduler* scheduler = link ? link->scheduler() : nullptr;
+        if (!scheduler) {
+            continue;
+        }
+        const auto& stats = scheduler->stats();
+        LOG_INFO(link->label() + "BLE transmit: " + std::to_string(stats.written) + " written, " +
+                 std::to_string(stats.collapsed) + " collapsed, " +
+                 std::to_string(stats.forced_writes) + " forced; queue high-water " +
+                 std::to_string(scheduler->queue_high_water_mark()) + "/" +
+                 std::to_string(pipeline::TransmitQueue::CAPACITY) + "; latency mean " +
+                 std::to_string(stats.latency_mean_us()) + " us, max " +
+                 std::to_string(stats.latency_max_us) + " us");
+    }
+    if (latencyTracker) {
+        LOG_INFO_LINES(latencyTracker->summary());
+    }
+    if (metricsServer) {
+        metricsServer->stop();
+        LOG_INFO("Metrics endpoint served " + std::to_string(metricsServer->scrapes()) +
+                 " scrape(s)");
+    }
+    if (g_latency_dump_fd >= 0) {
+        signal(SIGUSR1, SIG_DFL);
+        latencyDumpNotifier.reset();
+        close(g_latency_dump_fd);
+        g_latency_dump_fd = -1;
+    }
+    if (g_keymap_reload_fd >= 0) {
+        signal(SIGHUP, SIG_DFL);
+        keymapReloadNotifier.reset();
+        close(g_keymap_reload_fd);
+        g_keymap_reload_fd = -1;
+    }
+    if (g_shutdown_fd >= 0) {
+        signal(SIGTERM, SIG_DFL);
+        shutdownNotifier.reset();
+        close(g_shutdown_fd);
+        g_shutdown_fd = -1;
+    }
+    if (traceRecorder) {
+        // Every producer has stopped: the input thread is joined and the event loop is done
+        const std::uint64_t recorded = traceRecorder->recorded();
+        const std::uint64_t dropped = traceRecorder->dropped();
+        traceRecorder->close();
+        LOG_INFO("Event trace: " + std::to_string(recorded) + " records written to " +
+                 g_options.trace);
+        if (dropped > 0) {
+            LOG_WARN(std::to_string(dropped) + " trace records dropped (trace file full, "
+                                               "raise --trace-size)");
+        }
+    }
+    if (logging::Logger::async_enabled()) {
+        const std::uint64_t dropped = logging::Logger::dropped_count();
+        if (dropped > 0) {
+            LOG_WARN(std::to_string(dropped) + " log messages dropped (async log ring full)");
+        }
+        logging::Logger::enable_async(false);  // Write everything still queued
+    }
     return ret;
 }
\ No newline at end of file
@@ -0,0 +1,199 @@
+/**
+ * @file metrics.cpp
+ * @brief Implementation of the operational counters and their text rendering
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include "metrics.hpp"
+
+#include <cstdio>
+#include <utility>
+
+#include "latency_tracker.hpp"
+#include "logger.hpp"
+
+namespace metrics {
+
+namespace {
+
+constexpr const char* PREFIX = "ninja_util_";  //!< Common metric name prefix
+
+//! @brief "# HELP" and "# TYPE" lines of one metric family
+void append_header(std::string& out, const char* name, const char* type, const char* help) {
+    out += "# HELP ";
+    out += PREFIX;
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += PREFIX;
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+//! @brief One sample line; @p labels is either empty or "{...}"
+void append_sample(std::string& out, const char* name, const std::string& labels,
+                   std::uint64_t value) {
+    out += PREFIX;
+    out += name;
+    out += labels;
+    out += ' ';
+    out += std::to_string(value);
+    out += '\n';
+}
+
+void append_sample(std::string& out, const char* name, const std::string& labels, double value) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.9g", value);
+    out += PREFIX;
+    out += name;
+    out += labels;
+    out += ' ';
+    out += text;
+    out += '\n';
+}
+
+void append_counter(std::string& out, const char* name, const char* help, std::uint64_t value) {
+    append_header(out, name, "counter", help);
+    append_sample(out, name, "", value);
+}
+
+//! @brief Label value with backslash, quote and newline escaped
+std::string escape_label(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (const char c : value) {
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+//! @brief One latency stage as a Prometheus summary in seconds
+void append_latency(std::string& out, pipeline::LatencyStage stage,
+                    const pipeline::LatencyHistogram& histogram) {
+    static constexpr const char* NAME = "report_latency_seconds";
+    const auto s = histogram.summarize();
+    const std::string stage_label = std::string("stage=\"") + pipeline::to_string(stage) + '"';
+    const std::pair<const char*, std::uint64_t> quantiles[] = {
+        {"0.5", s.p50}, {"0.99", s.p99}, {"0.999", s.p999}, {"1", s.max}};
+    for (const auto& [quantile, value] : quantiles) {
+        append_sample(out, NAME, "{" + stage_label + ",quantile=\"" + quantile + "\"}",
+                      static_cast<double>(value) / 1e9);
+    }
+    append_sample(out, "report_latency_seconds_sum", "{" + stage_label + "}",
+                  static_cast<double>(s.sum) / 1e9);
+    append_sample(out, "report_latency_seconds_count", "{" + stage_label + "}", s.count);
+}
+
+}  // namespace
+
+std::uint8_t Metrics::device_slot(const std::string& path) {
+    // Fast path: published slots never change, so no lock is needed to find one
+    const std::size_t published = device_count_.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < published; ++i) {
+        if (devices_[i].path == path) {
+            return static_cast<std::uint8_t>(i);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(register_mutex_);
+    const std::size_t count = device_count_.load(std::memory_order_relaxed);
+    for (std::size_t i = published; i < count; ++i) {
+        if (devices_[i].path == path) {
+            return static_cast<std::uint8_t>(i);
+        }
+    }
+    if (count == MAX_DEVICES) {
+        return NO_DEVICE_SLOT;
+    }
+    devices_[count].path = path;
+    device_count_.store(count + 1, std::memory_order_release);
+    return static_cast<std::uint8_t>(count);
+}
+
+std::uint64_t Metrics::events_read(const std::string& path) const noexcept {
+    const std::size_t count = device_count_.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (devices_[i].path == path) {
+            return devices_[i].events.load();
+        }
+    }
+    return 0;
+}
+
+std::string Metrics::render(const pipeline::LatencyTracker* latency) const {
+    std::string out;
+    out.reserve(4096);
+
+    append_header(out, "events_read_total", "counter", "Input events read per keyboard.");
+    const std::size_t count = device_count_.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < count; ++i) {
+        append_sample(out, "events_read_total",
+                      "{device=\"" + escape_label(devices_[i].path) + "\"}",
+                      devices_[i].events.load());
+    }
+    if (other_events_.load() != 0) {
+        append_sample(out, "events_read_total", "{device=\"other\"}", other_events_.load());
+    }
+
+    append_counter(out, "reports_sent_total", "HID reports handed to the transmit stage.",
+                   reports_sent.load());
+    append_counter(out, "reports_suppressed_total", "Unchanged HID reports dropped.",
+                   reports_suppressed.load());
+    append_counter(out, "ble_writes_total", "HID reports written to the BLE characteristic.",
+                   ble_writes.load());
+    append_counter(out, "ble_reports_collapsed_total",
+                   "Waiting HID reports merged into a newer one.", ble_collapsed.load());
+    append_header(out, "ble_queue_depth", "gauge", "HID reports waiting for a BLE write slot.");
+    append_sample(out, "ble_queue_depth", "", ble_queue_depth.load());
+    append_counter(out, "ble_connects_total", "BLE connection attempts.", ble_connects.load());
+    append_counter(out, "ble_reconnects_total", "BLE connection attempts after the first.",
+                   ble_reconnects.load());
+    append_counter(out, "ble_disconnects_total", "BLE links lost after connecting.",
+                   ble_disconnects.load());
+    append_header(out, "ble_reconnect_seconds", "summary",
+                  "Time from losing a BLE link until it was ready again.");
+    append_sample(out, "ble_reconnect_seconds_sum", "",
+                  static_cast<double>(ble_reconnect_us.load()) / 1e6);
+    append_sample(out, "ble_reconnect_seconds_count", "", ble_reconnected.load());
+    append_header(out, "ble_last_reconnect_seconds", "gauge",
+                  "Time from losing a BLE link until it was ready again, latest reconnect.");
+    append_sample(out, "ble_last_reconnect_seconds", "",
+                  static_cast<double>(ble_last_reconnect_us.load()) / 1e6);
+    append_counter(out, "keyboards_added_total", "Keyboards added by hot-plug.",
+                   keyboards_added.load());
+    append_counter(out, "keyboards_removed_total", "Keyboards removed by hot-plug.",
+                   keyboards_removed.load());
+    append_counter(out, "idle_entered_total",
+                   "Switches to power-save connection parameters after idle input.",
+                   idle_entered.load());
+    append_counter(out, "idle_wakes_total", "Switches back to the active profile on a key.",
+                   idle_wakes.load());
+    append_header(out, "idle", "gauge", "1 while input is idle and the links are in power-save.");
+    append_sample(out, "idle", "", idle.load());
+    append_counter(out, "log_dropped_total", "Log lines dropped because the async ring was full.",
+                   logging::Logger::dropped_count());
+
+    if (latency) {
+        append_header(out, "report_latency_seconds", "summary",
+                      "Report latency per pipeline stage (all keyboards).");
+        for (std::size_t s = 0; s < pipeline::LATENCY_STAGE_COUNT; ++s) {
+            const auto stage = static_cast<pipeline::LatencyStage>(s);
+            append_latency(out, stage, latency->total(stage));
+        }
+    }
+    return out;
+}
+
+}  // namespace metrics
@@ -0,0 +1,232 @@
+/**
+ * @file metrics_server.cpp
+ * @brief Implementation of the metrics scrape endpoint
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include "metrics_server.hpp"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <utility>
+
+#include "logger.hpp"
+
+namespace metrics {
+
+namespace {
+
+constexpr int LISTEN_BACKLOG = 8;               //!< Pending scrapes before connects are refused
+constexpr std::size_t MAX_REQUEST_SIZE = 4096;  //!< Request bytes read before answering
+constexpr timeval CLIENT_TIMEOUT{1, 0};         //!< Per-client send/receive timeout
+
+int open_unix_socket(const std::string& path) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    // Replace a socket left behind by a previous run, but never any other file
+    struct stat st{};
+    if (lstat(path.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            errno = EEXIST;
+            return -1;
+        }
+        unlink(path.c_str());
+    }
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(fd, LISTEN_BACKLOG) < 0) {
+        const int err = errno;
+        close(fd);
+        errno = err;
+        return -1;
+    }
+    return fd;
+}
+
+int open_tcp_socket(std::uint16_t& port) {
+    const int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    const int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);  // Never reachable from the network
+    addr.sin_port = htons(port);
+    socklen_t len = sizeof(addr);
+    if (bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(fd, LISTEN_BACKLOG) < 0 ||
+        getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) < 0) {
+        const int err = errno;
+        close(fd);
+        errno = err;
+        return -1;
+    }
+    port = ntohs(addr.sin_port);  // Resolves port 0 to the one the kernel picked
+    return fd;
+}
+
+bool send_all(int fd, const std::string& data) {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        const ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        sent += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+//! @brief Read up to the end of the request headers; returns the request line
+std::string read_request_line(int fd) {
+    std::string request;
+    char buffer[512];
+    while (request.size() < MAX_REQUEST_SIZE && request.find("\r\n\r\n") == std::string::npos) {
+        const ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;  // Timeout, error or the client closed its side
+        }
+        request.append(buffer, static_cast<std::size_t>(n));
+    }
+    return request.substr(0, request.find("\r\n"));
+}
+
+std::string http_response(const char* status, const std::string& body) {
+    return std::string("HTTP/1.1 ") + status +
+           "\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: " +
+           std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+}
+
+}  // namespace
+
+MetricsServer::MetricsServer(Endpoint endpoint, Renderer render)
+    : endpoint_(std::move(endpoint)), render_(std::move(render)) {
+    listen_fd_ = endpoint_.is_unix() ? open_unix_socket(endpoint_.unix_path)
+                                     : open_tcp_socket(endpoint_.port);
+    if (listen_fd_ < 0) {
+        return;
+    }
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+        if (endpoint_.is_unix()) {
+            unlink(endpoint_.unix_path.c_str());
+        }
+    }
+    if (wake_fd_ >= 0) {
+        close(wake_fd_);
+    }
+}
+
+bool MetricsServer::start() {
+    if (!is_valid() || thread_.joinable()) {
+        return false;
+    }
+    stop_.store(false, std::memory_order_release);
+    thread_ = std::thread([this]() { run(); });
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (!thread_.joinable()) {
+        return;
+    }
+    stop_.store(true, std::memory_order_release);
+    const std::uint64_t one = 1;
+    [[maybe_unused]] const ssize_t written = write(wake_fd_, &one, sizeof(one));
+    thread_.join();
+}
+
+/**
+ * @brief Server thread main loop: accept and answer one client at a time
+ */
+void MetricsServer::run() {
+    pollfd fds[2] = {{listen_fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+    while (!stop_.load(std::memory_order_acquire)) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_ERROR("Metrics server poll() failed (" + std::string(std::strerror(errno)) + ")");
+            return;
+        }
+        if (fds[1].revents & POLLIN) {
+            return;  // stop() was called
+        }
+        if (!(fds[0].revents & POLLIN)) {
+            continue;
+        }
+
+        const int client = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) {
+            continue;  // Client gave up already, or out of fds: try again on the next scrape
+        }
+        serve(client);
+        close(client);
+    }
+}
+
+/**
+ * @brief Answer one client
+ * @param client Accepted connection
+ *
+ * Unix socket clients get the page right away. HTTP clients get it for
+ * `GET /metrics` (or `/`), anything else is answered with 404.
+ */
+void MetricsServer::serve(int client) {
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &CLIENT_TIMEOUT, sizeof(CLIENT_TIMEOUT));
+    setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &CLIENT_TIMEOUT, sizeof(CLIENT_TIMEOUT));
+    scrapes_.fetch_add(1, std::memory_order_relaxed);
+
+    if (endpoint_.is_unix()) {
+        [[maybe_unused]] const bool sent = send_all(client, render_());
+        return;
+    }
+
+    // "GET /metrics?query HTTP/1.1" -> "/metrics"
+    const std::string line = read_request_line(client);
+    std::string target;
+    if (line.rfind("GET ", 0) == 0) {
+        target = line.substr(4, line.find_first_of(" ?", 4) - 4);
+    }
+    const bool metrics_page = target == "/metrics" || target == "/";
+    [[maybe_unused]] const bool sent =
+        send_all(client, metrics_page ? http_response("200 OK", render_())
+                                      : http_response("404 Not Found", "Try GET /metrics\n"));
+}
+
+}  // namespace metrics
@@ -0,0 +1,54 @@
+/**
+ * @file passthrough.cpp
+ * @brief Local re-injection of shared input (`--share-input`)
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include "passthrough.hpp"
+
+namespace device {
+
+void Passthrough::set_enabled(bool enabled) noexcept {
+    if (enabled == enabled_) {
+        return;
+    }
+    enabled_ = enabled;
+    if (enabled) {
+        return;
+    }
+
+    // Keys held while the route closes would otherwise stay down on the local host
+    input_event release[KEY_CNT + 1] = {};
+    std::size_t count = 0;
+    for (unsigned code = 0; code < KEY_CNT; ++code) {
+        if (held_.test(code)) {
+            release[count].type = EV_KEY;
+            release[count].code = static_cast<std::uint16_t>(code);
+            release[count].value = 0;
+            ++count;
+        }
+    }
+    if (count == 0) {
+        return;
+    }
+    release[count].type = EV_SYN;
+    release[count].code = SYN_REPORT;
+    forward(release, count + 1);
+}
+
+void Passthrough::forward(const input_event* events, std::size_t count) noexcept {
+    for (std::size_t i = 0; i < count; ++i) {
+        if (events[i].type == EV_KEY) {
+            held_.set(events[i].code, events[i].value != 0);
+        }
+    }
+    if (keyboard_.write(events, count)) {
+        forwarded_ += count;
+    } else {
+        ++write_errors_;
+    }
+}
+
+}  // namespace device
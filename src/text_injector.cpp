@@ -0,0 +1,109 @@
+/**
+ * @file text_injector.cpp
+ * @brief Text → HID keyboard report compiler
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include "text_injector.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+
+namespace inject {
+
+namespace {
+
+/**
+ * @brief Key that types a character on a US layout
+ */
+struct TypedKey {
+    std::uint16_t code = 0;  //!< Linux KEY_* code (0: cannot be typed)
+    bool shift = false;      //!< Needs Shift held
+};
+
+constexpr std::array<TypedKey, 128> make_ascii_keys() {
+    std::array<TypedKey, 128> keys{};
+    constexpr std::uint16_t letters[] = {KEY_A, KEY_B, KEY_C, KEY_D, KEY_E, KEY_F, KEY_G,
+                                         KEY_H, KEY_I, KEY_J, KEY_K, KEY_L, KEY_M, KEY_N,
+                                         KEY_O, KEY_P, KEY_Q, KEY_R, KEY_S, KEY_T, KEY_U,
+                                         KEY_V, KEY_W, KEY_X, KEY_Y, KEY_Z};
+    for (int i = 0; i < 26; ++i) {
+        keys['a' + i] = {letters[i], false};
+        keys['A' + i] = {letters[i], true};
+    }
+    constexpr std::uint16_t digits[] = {KEY_0, KEY_1, KEY_2, KEY_3, KEY_4,
+                                        KEY_5, KEY_6, KEY_7, KEY_8, KEY_9};
+    constexpr char shifted_digits[] = ")!@#$%^&*(";
+    for (int i = 0; i < 10; ++i) {
+        keys['0' + i] = {digits[i], false};
+        keys[static_cast<unsigned char>(shifted_digits[i])] = {digits[i], true};
+    }
+
+    // Punctuation: plain and shifted character of each key
+    constexpr struct {
+        char plain;
+        char shifted;
+        std::uint16_t code;
+    } punctuation[] = {{'-', '_', KEY_MINUS},      {'=', '+', KEY_EQUAL},
+                       {'[', '{', KEY_LEFTBRACE},  {']', '}', KEY_RIGHTBRACE},
+                       {'\\', '|', KEY_BACKSLASH}, {';', ':', KEY_SEMICOLON},
+                       {'\'', '"', KEY_APOSTROPHE}, {'`', '~', KEY_GRAVE},
+                       {',', '<', KEY_COMMA},      {'.', '>', KEY_DOT},
+                       {'/', '?', KEY_SLASH}};
+    for (const auto& key : punctuation) {
+        keys[static_cast<unsigned char>(key.plain)] = {key.code, false};
+        keys[static_cast<unsigned char>(key.shifted)] = {key.code, true};
+    }
+
+    keys[' '] = {KEY_SPACE, false};
+    keys['\t'] = {KEY_TAB, false};
+    keys['\n'] = {KEY_ENTER, false};
+    return keys;
+}
+
+constexpr std::array<TypedKey, 128> kAsciiKeys = make_ascii_keys();
+
+//! @brief Left Shift in the report's modifier byte
+constexpr std::uint8_t SHIFT_MODIFIER = hid::modifier_bit(0xE1);
+
+}  // namespace
+
+std::optional<KeySequence> compile_text(std::string_view text, std::string& error) {
+    KeySequence sequence;
+    sequence.reports.reserve(text.size() + text.size() / 2 + 1);
+    pipeline::Report held{};  // Last report of the sequence
+
+    for (std::size_t offset = 0; offset < text.size(); ++offset) {
+        const auto c = static_cast<unsigned char>(text[offset]);
+        if (c == '\r') {
+            continue;
+        }
+        const TypedKey key = c < kAsciiKeys.size() ? kAsciiKeys[c] : TypedKey{};
+        const auto usage = key.code != 0 ? hid::get_keyboard_usage(key.code) : std::nullopt;
+        if (!usage) {
+            char hex[8];
+            std::snprintf(hex, sizeof(hex), "0x%02X", c);
+            error = "cannot type character " + std::string(hex) + " at offset " +
+                    std::to_string(offset) + " (US layout: printable ASCII, tab and newline)";
+            return std::nullopt;
+        }
+
+        const std::uint8_t modifiers = key.shift ? SHIFT_MODIFIER : 0;
+        // Release first to type a key again or to change Shift; else roll over to the next key
+        if (held[2] != 0 && (held[2] == *usage || held[0] != modifiers)) {
+            sequence.reports.push_back(pipeline::Report{});
+        }
+        held = pipeline::Report{modifiers, 0, *usage};
+        sequence.reports.push_back(held);
+        ++sequence.characters;
+    }
+    if (held[2] != 0) {
+        sequence.reports.push_back(pipeline::Report{});
+    }
+    return sequence;
+}
+
+}  // namespace inject
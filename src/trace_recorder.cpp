@@ -0,0 +1,211 @@
+/**
+ * @file trace_recorder.cpp
+ * @brief Implementation of the memory-mapped event trace
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include "trace_recorder.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace trace {
+
+namespace {
+
+constexpr char TRACE_MAGIC[8] = {'N', 'J', 'T', 'R', 'A', 'C', 'E', '\0'};
+
+//! @brief Record with the timestamp and type filled in, everything else zero
+TraceRecord make_record(RecordType type, std::uint16_t device) noexcept {
+    TraceRecord record{};
+    record.timestamp_ns = monotonic_ns();
+    record.type = static_cast<std::uint8_t>(type);
+    record.device = device;
+    return record;
+}
+
+}  // namespace
+
+std::uint64_t monotonic_ns() noexcept {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ULL +
+           static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+std::uint16_t device_id_from_path(const std::string& path) noexcept {
+    const auto end = path.find_last_not_of("0123456789");
+    const std::size_t digits = end == std::string::npos ? path.size() : path.size() - end - 1;
+    if (digits == 0 || digits > 5) {
+        return NO_DEVICE;
+    }
+    unsigned long id = 0;
+    for (std::size_t i = path.size() - digits; i < path.size(); ++i) {
+        id = id * 10 + static_cast<unsigned long>(path[i] - '0');
+    }
+    return id < NO_DEVICE ? static_cast<std::uint16_t>(id) : NO_DEVICE;
+}
+
+TraceRecorder::TraceRecorder(const std::string& path, std::size_t size_bytes,
+                             std::uint32_t flags) {
+    if (size_bytes < sizeof(TraceHeader) + sizeof(TraceRecord)) {
+        return;
+    }
+    const std::uint64_t capacity = (size_bytes - sizeof(TraceHeader)) / sizeof(TraceRecord);
+    const std::size_t file_size = sizeof(TraceHeader) + capacity * sizeof(TraceRecord);
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        return;
+    }
+
+    // Reserve the blocks now so the hot path never hits a page that cannot be backed
+    const int rc = posix_fallocate(fd_, 0, static_cast<off_t>(file_size));
+    if (rc != 0 && (rc != EOPNOTSUPP || ftruncate(fd_, static_cast<off_t>(file_size)) != 0)) {
+        ::close(fd_);
+        fd_ = -1;
+        return;
+    }
+
+    // MAP_POPULATE pre-faults the pages, so recording does not take page faults either
+    void* map =
+        mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, 0);
+    if (map == MAP_FAILED) {
+        ::close(fd_);
+        fd_ = -1;
+        return;
+    }
+
+    map_ = map;
+    map_size_ = file_size;
+    capacity_ = capacity;
+    header_ = static_cast<TraceHeader*>(map);
+    std::memset(header_, 0, sizeof(TraceHeader));
+    std::memcpy(header_->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    header_->version = TRACE_VERSION;
+    header_->record_size = sizeof(TraceRecord);
+    header_->capacity = capacity;
+    header_->start_ns = monotonic_ns();
+    header_->flags = flags;
+    records_ = reinterpret_cast<TraceRecord*>(static_cast<char*>(map) + sizeof(TraceHeader));
+}
+
+TraceRecorder::~TraceRecorder() { close(); }
+
+bool TraceRecorder::append(const TraceRecord& record) noexcept {
+    if (!records_) {
+        return false;
+    }
+    const std::uint64_t index = next_.fetch_add(1, std::memory_order_relaxed);
+    if (index >= capacity_) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    records_[index] = record;
+    return true;
+}
+
+void TraceRecorder::record_input(std::uint16_t device, const input_event& ev) noexcept {
+    TraceRecord record = make_record(RecordType::InputEvent, device);
+    record.event_type = ev.type;
+    record.event_code = ev.code;
+    record.value = ev.value;
+    append(record);
+}
+
+void TraceRecorder::record_report(RecordType type, const pipeline::Report& report) noexcept {
+    TraceRecord record = make_record(type, NO_DEVICE);
+    record.report_id = static_cast<std::uint8_t>(report.id);
+    std::memcpy(record.report, report.data(), sizeof(record.report));
+    append(record);
+}
+
+void TraceRecorder::record_connection_state(int state) noexcept {
+    TraceRecord record = make_record(RecordType::ConnectionState, NO_DEVICE);
+    record.value = state;
+    append(record);
+}
+
+void TraceRecorder::record_connection_interval(std::chrono::microseconds interval) noexcept {
+    TraceRecord record = make_record(RecordType::ConnectionInterval, NO_DEVICE);
+    record.value = static_cast<std::int32_t>(interval.count());
+    append(record);
+}
+
+std::uint64_t TraceRecorder::recorded() const noexcept {
+    return std::min(next_.load(std::memory_order_relaxed), capacity_);
+}
+
+void TraceRecorder::close() noexcept {
+    if (!map_) {
+        return;
+    }
+
+    const std::uint64_t count = recorded();
+    records_ = nullptr;
+    header_->count = count;
+    munmap(map_, map_size_);
+    map_ = nullptr;
+    header_ = nullptr;
+
+    // Drop the unused preallocated tail. On failure the file simply keeps its full
+    // size; readers only look at the first header.count records.
+    [[maybe_unused]] const int truncated =
+        ftruncate(fd_, static_cast<off_t>(sizeof(TraceHeader) + count * sizeof(TraceRecord)));
+    ::close(fd_);
+    fd_ = -1;
+}
+
+std::optional<Trace> load_trace(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return std::nullopt;
+    }
+
+    Trace trace{};
+    if (!in.read(reinterpret_cast<char*>(&trace.header), sizeof(TraceHeader)) ||
+        std::memcmp(trace.header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0 ||
+        trace.header.version != TRACE_VERSION || trace.header.record_size != sizeof(TraceRecord)) {
+        return std::nullopt;
+    }
+
+    const bool complete = trace.header.count != 0;
+    TraceRecord record{};
+    while (!complete || trace.records.size() < trace.header.count) {
+        if (!in.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+            break;
+        }
+        if (!complete && record.timestamp_ns == 0 && record.type == 0) {
+            break;  // Unused preallocated space of an unfinished trace
+        }
+        trace.records.push_back(record);
+    }
+    return trace;
+}
+
+const char* to_string(RecordType type) noexcept {
+    switch (type) {
+        case RecordType::InputEvent:
+            return "input";
+        case RecordType::HidReport:
+            return "report";
+        case RecordType::BleWrite:
+            return "ble-write";
+        case RecordType::ConnectionState:
+            return "conn-state";
+        case RecordType::ConnectionInterval:
+            return "conn-interval";
+    }
+    return "unknown";
+}
+
+}  // namespace trace
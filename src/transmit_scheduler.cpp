@@ -0,0 +1,122 @@
+/**
+ * @file transmit_scheduler.cpp
+ * @brief Implementation of the connection-interval-aware BLE transmit scheduler
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include "transmit_scheduler.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "latency_tracker.hpp"
+#include "metrics.hpp"
+
+namespace pipeline {
+
+TransmitScheduler::TransmitScheduler(ReportSink writer, std::chrono::microseconds interval,
+                                     int writes_per_interval)
+    : writer_(std::move(writer)),
+      interval_(interval.count() > 0 ? interval : DEFAULT_INTERVAL),
+      writes_per_interval_(std::max(1, writes_per_interval)) {}
+
+/**
+ * @brief Write one report and book the next write slot
+ * @param entry Report, its enqueue time and latency stamps
+ * @param now Current time
+ */
+void TransmitScheduler::write(const TransmitQueue::Entry& entry, Clock::time_point now) {
+    writer_(entry.report);
+    next_write_ = now + write_spacing();
+    if (latency_) {
+        const auto write_ns =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+        latency_->on_report_written(entry.timing, static_cast<std::uint64_t>(write_ns));
+    }
+    if (metrics_) {
+        metrics_->ble_writes.add();
+        metrics_->ble_queue_depth.set(queue_.size());
+    }
+
+    const auto latency =
+        std::chrono::duration_cast<std::chrono::microseconds>(now - entry.enqueued).count();
+    const auto latency_us = static_cast<std::uint64_t>(std::max<decltype(latency)>(latency, 0));
+    ++stats_.written;
+    stats_.latency_total_us += latency_us;
+    stats_.latency_max_us = std::max(stats_.latency_max_us, latency_us);
+}
+
+std::optional<TransmitScheduler::Clock::duration>
+TransmitScheduler::submit(const Report& report, Clock::time_point now,
+                          const ReportTiming& timing) {
+    ++stats_.submitted;
+
+    // Idle link: no reason to delay
+    if (queue_.empty() && now >= next_write_) {
+        queue_.note_written(report);
+        write({report, now, timing}, now);
+        return std::nullopt;
+    }
+
+    auto result = queue_.push(report, now, timing);
+    if (result == TransmitQueue::PushResult::Full) {
+        // Never drop an edge: hand the oldest report to the stack early
+        TransmitQueue::Entry oldest;
+        queue_.pop(oldest);
+        write(oldest, now);
+        ++stats_.forced_writes;
+        result = queue_.push(report, now, timing);
+    }
+    if (result == TransmitQueue::PushResult::Collapsed) {
+        ++stats_.collapsed;
+    }
+    if (metrics_) {
+        if (result == TransmitQueue::PushResult::Collapsed) {
+            metrics_->ble_collapsed.add();
+        }
+        metrics_->ble_queue_depth.set(queue_.size());
+    }
+
+    return service(now);
+}
+
+std::optional<TransmitScheduler::Clock::duration>
+TransmitScheduler::service(Clock::time_point now) {
+    if (queue_.empty()) {
+        return std::nullopt;
+    }
+
+    if (now >= next_write_) {
+        TransmitQueue::Entry entry;
+        queue_.pop(entry);
+        write(entry, now);
+        if (queue_.empty()) {
+            return std::nullopt;
+        }
+    }
+    return next_write_ - now;
+}
+
+void TransmitScheduler::flush(Clock::time_point now) {
+    TransmitQueue::Entry entry;
+    while (queue_.pop(entry)) {
+        write(entry, now);
+    }
+}
+
+void TransmitScheduler::clear() noexcept {
+    queue_.clear();
+    if (metrics_) {
+        metrics_->ble_queue_depth.set(0);
+    }
+}
+
+void TransmitScheduler::set_connection_interval(std::chrono::microseconds interval) noexcept {
+    if (interval.count() > 0) {
+        interval_ = interval;
+    }
+}
+
+}  // namespace pipeline
@@ -0,0 +1,84 @@
+/**
+ * @file virtual_keyboard.cpp
+ * @brief uinput keyboard node implementation
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include "virtual_keyboard.hpp"
+
+#include <cerrno>
+#include <string>
+#include <unistd.h>
+
+#include <libevdev/libevdev-uinput.h>
+#include <libevdev/libevdev.h>
+#include <linux/input.h>
+
+namespace device {
+
+namespace {
+
+//! @brief Keyboard keys: below the BTN_* block, or KEY_OK up to the trigger-happy buttons
+constexpr bool is_keyboard_key(int code) noexcept {
+    return (code > KEY_RESERVED && code < BTN_MISC) || (code >= KEY_OK && code < BTN_TRIGGER_HAPPY);
+}
+
+}  // namespace
+
+VirtualKeyboard::VirtualKeyboard(const std::string& name) : evdev_(libevdev_new()) {
+    if (evdev_ == nullptr) {
+        error_ = ENOMEM;
+        return;
+    }
+    libevdev_set_name(evdev_, name.c_str());
+    libevdev_set_id_bustype(evdev_, BUS_VIRTUAL);
+
+    // No EV_REP, so the kernel adds no repeats of its own
+    libevdev_enable_event_type(evdev_, EV_KEY);
+    for (int code = 0; code <= KEY_MAX; ++code) {
+        if (is_keyboard_key(code)) {
+            libevdev_enable_event_code(evdev_, EV_KEY, static_cast<unsigned int>(code), nullptr);
+        }
+    }
+
+    const int rc = libevdev_uinput_create_from_device(evdev_, LIBEVDEV_UINPUT_OPEN_MANAGED,
+                                                      &uinput_);
+    if (rc < 0) {
+        uinput_ = nullptr;
+        error_ = -rc;
+        return;
+    }
+    if (const char* node = libevdev_uinput_get_devnode(uinput_)) {
+        devnode_ = node;
+    }
+}
+
+VirtualKeyboard::~VirtualKeyboard() {
+    if (uinput_ != nullptr) {
+        libevdev_uinput_destroy(uinput_);
+    }
+    if (evdev_ != nullptr) {
+        libevdev_free(evdev_);
+    }
+}
+
+bool VirtualKeyboard::write(unsigned int type, unsigned int code, int value) noexcept {
+    return uinput_ != nullptr && libevdev_uinput_write_event(uinput_, type, code, value) == 0;
+}
+
+bool VirtualKeyboard::write(const input_event* events, std::size_t count) noexcept {
+    if (uinput_ == nullptr) {
+        return false;
+    }
+    const std::size_t size = count * sizeof(input_event);
+    const ssize_t written = ::write(libevdev_uinput_get_fd(uinput_), events, size);
+    return written == static_cast<ssize_t>(size);
+}
+
+bool VirtualKeyboard::key(unsigned int code, int value) noexcept {
+    return write(EV_KEY, code, value) && write(EV_SYN, SYN_REPORT, 0);
+}
+
+}  // namespace device
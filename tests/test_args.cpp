@@ -185,6 +185,35 @@ void test_target_device_option() {
 
     assert(opts.has_value());
     assert(opts->target_device == "AA:BB:CC:DD:EE:FF");
+    assert(opts->targets.size() == 1);
+
+    std::cout << "PASSED\n";
+}
+
+void test_multiple_targets_option() {
+    auto [argc, argv] =
+        make_argv({"ninja_util", "--target", "AA:BB:CC:DD:EE:FF,Desk,11:22:33:44:55:66"});
+    args::ArgumentParser parser(argc, argv);
+    auto opts = parser.parse();
+
+    assert(opts.has_value());
+    assert(opts->targets.size() == 3);
+    assert(opts->targets[1] == "Desk");
+    assert(opts->target_device == "AA:BB:CC:DD:EE:FF");
+
+    // Empty list entries
+    auto [argc2, argv2] = make_argv({"ninja_util", "--target", "AA:BB:CC:DD:EE:FF,"});
+    args::ArgumentParser parser2(argc2, argv2);
+    assert(!parser2.parse().has_value());
+
+    auto [argc3, argv3] = make_argv({"ninja_util", "--target", ",Desk"});
+    args::ArgumentParser parser3(argc3, argv3);
+    assert(!parser3.parse().has_value());
+
+    // One routing hotkey digit per device
+    auto [argc4, argv4] = make_argv({"ninja_util", "--target", "a,b,c,d,e,f,g,h,i,j"});
+    args::ArgumentParser parser4(argc4, argv4);
+    assert(!parser4.parse().has_value());
 
     std::cout << "PASSED\n";
 }
@@ -196,6 +225,425 @@ void test_poll_interval_option() {
 
     assert(opts.has_value());
     assert(opts->poll_interval == 5);
+    assert(opts->legacy_polling == true);
+
+    // Without --poll-interval the input pipeline is event-driven
+    auto [argc2, argv2] = make_argv({"ninja_util"});
+    args::ArgumentParser parser2(argc2, argv2);
+    auto opts2 = parser2.parse();
+
+    assert(opts2.has_value());
+    assert(opts2->legacy_polling == false);
+
+    std::cout << "PASSED\n";
+}
+
+void test_input_thread_options() {
+    auto [argc, argv] = make_argv({"ninja_util", "--input-thread"});
+    args::ArgumentParser parser(argc, argv);
+    auto opts = parser.parse();
+
+    assert(opts.has_value());
+    assert(opts->input_thread == true);
+    assert(opts->input_rt_priority == 0);
+    assert(opts->input_cpu == -1);
+
+    // Scheduling options imply the input thread
+    auto [argc2, argv2] = make_argv({"ninja_util", "--input-rt-priority", "80", "--input-cpu=2"});
+    args::ArgumentParser parser2(argc2, argv2);
+    auto opts2 = parser2.parse();
+
+    assert(opts2.has_value());
+    assert(opts2->input_thread == true);
+    assert(opts2->input_rt_priority == 80);
+    assert(opts2->input_cpu == 2);
+
+    // Out-of-range priority is rejected
+    auto [argc3, argv3] = make_argv({"ninja_util", "--input-rt-priority", "100"});
+    args::ArgumentParser parser3(argc3, argv3);
+    assert(!parser3.parse().has_value());
+
+    // The input thread replaces the polling loop, so both cannot be requested
+    auto [argc4, argv4] = make_argv({"ninja_util", "--input-thread", "--poll-interval", "5"});
+    args::ArgumentParser parser4(argc4, argv4);
+    assert(!parser4.parse().has_value());
+
+    std::cout << "PASSED\n";
+}
+
+void test_coalesce_frames_option() {
+    auto [argc, argv] = make_argv({"ninja_util", "--coalesce-frames"});
+    args::ArgumentParser parser(argc, argv);
+    auto opts = parser.parse();
+
+    assert(opts.has_value());
+    assert(opts->coalesce_frames == true);
+
+    auto [argc2, argv2] = make_argv({"ninja_util"});
+    args::ArgumentParser parser2(argc2, argv2);
+    auto opts2 = parser2.parse();
+
+    assert(opts2.has_value());
+    assert(opts2->coalesce_frames == false);
+
+    std::cout << "PASSED\n";
+}
+
+void test_no_reconnect_option() {
+    auto [argc, argv] = make_argv({"ninja_util", "--no-reconnect"});
+    args::ArgumentParser parser(argc, argv);
+    auto opts = parser.parse();
+
+    assert(opts.has_value());
+    assert(opts->no_reconnect == true);
+
+    auto [argc2, argv2] = make_argv({"ninja_util"});
+    args::ArgumentParser parser2(argc2, argv2);
+    auto opts2 = parser2.parse();
+
+    assert(opts2.has_value());
+    assert(opts2->no_reconnect == false);
+
+    std::cout << "PASSED\n";
+}
+
+void test_share_input_option() {
+    auto [argc, argv] = make_argv({"ninja_util", "--share-input"});
+    args::ArgumentParser parser(argc, argv);
+    auto opts = parser.parse();
+
+    assert(opts.has_value());
+    assert(opts->share_input == true);
+
+    auto [argc2, argv2] = make_argv({"ninja_util"});
+    args::ArgumentParser parser2(argc2, argv2);
+    auto opts2 = parser2.parse();
+
+    assert(opts2.has_value());
+    assert(opts2->share_input == false);
+
+    std::cout << "PASSED\n";
+}
+
+void test_batch_reads_option() {
+    auto [argc, argv] = make_argv({"ninja_util", "--batch-reads", "--input-thread"});
+    args::ArgumentParser parser(argc, argv);
+    auto opts = parser.parse();
+
+    assert(opts.has_value());
+    assert(opts->batch_reads == true);
+    assert(opts->input_thread == true);
+
+    auto [argc2, argv2] = make_argv({"ninja_util"});
+    args::ArgumentParser parser2(argc2, argv2);
+    auto opts2 = parser2.parse();
+
+    assert(opts2.has_value());
+    assert(opts2->batch_reads == false);
+
+    std::cout << "PASSED\n";
+}
+
+void test_idle_timeout_option() {
+    auto [argc, argv] = make_argv({"ninja_util"});
+    args::ArgumentParser parser(argc, argv);
+    auto opts = parser.parse();
+
+    assert(opts.has_value());
+    assert(opts->idle_timeout == 0);
+
+    auto [argc2, argv2] = make_argv({"ninja_util", "--idle-timeout", "30"});
+    args::ArgumentParser parser2(argc2, argv2);
+    auto opts2 = parser2.parse();
+
+    assert(opts2.has_value());
+    assert(opts2->idle_timeout == 30);
+
+    auto [argc3, argv3] = make_argv({"ninja_util", "--idle-timeout=600"});
+    args::ArgumentParser parser3(argc3, argv3);
+    auto opts3 = parser3.parse();
+
+    assert(opts3.has_value());
+    assert(opts3->idle_timeout == 600);
+
+    auto [argc4, argv4] = make_argv({"ninja_util", "--idle-timeout", "-1"});
+    args::ArgumentParser parser4(argc4, argv4);
+    assert(!parser4.parse().has_value());
+
+    std::cout << "PASSED\n";
+}
+
+void test_conn_profile_option() {
+    auto [argc, argv] = make_argv({"ninja_util"});
+    args::ArgumentParser parser(argc, argv);
+    auto opts = parser.parse();
+
+    assert(opts.has_value());
+    assert(opts->conn_profile == "low-latency");
+
+    auto [argc2, argv2] = make_argv({"ninja_util", "--conn-profile", "power-save"});
+    args::ArgumentParser parser2(argc2, argv2);
+    auto opts2 = parser2.parse();
+
+    assert(opts2.has_value());
+    assert(opts2->conn_profile == "power-save");
+
+    auto [argc3, argv3] = make_argv({"ninja_util", "--conn-profile=balanced"});
+    args::ArgumentParser parser3(argc3, argv3);
+    auto opts3 = parser3.parse();
+
+    assert(opts3.has_value());
+    assert(opts3->conn_profile == "balanced");
+
+    auto [argc4, argv4] = make_argv({"ninja_util", "--conn-profile", "turbo"});
+    args::ArgumentParser parser4(argc4, argv4);
+    assert(!parser4.parse().has_value());
+
+    std::cout << "PASSED\n";
+}
+
+void test_scan_grace_option() {
+    auto [argc, argv] = make_argv({"ninja_util"});
+    args::ArgumentParser parser(argc, argv);
+    auto opts = parser.parse();
+
+    assert(opts.has_value());
+    assert(opts->scan_grace == 500);
+
+    auto [argc2, argv2] = make_argv({"ninja_util", "--scan-grace", "0"});
+    args::ArgumentParser parser2(argc2, argv2);
+    auto opts2 = parser2.parse();
+
+    assert(opts2.has_value());
+    assert(opts2->scan_grace == 0);
+
+    auto [argc3, argv3] = make_argv({"ninja_util", "--scan-grace=20000"});
+    args::ArgumentParser parser3(argc3, argv3);
+    assert(!parser3.parse().has_value());
+
+    std::cout << "PASSED\n";
+}
+
+void test_gatt_cache_options() {
+    auto [argc, argv] = make_argv({"ninja_util"});
+    args::ArgumentParser parser(argc, argv);
+    auto opts = parser.parse();
+
+    assert(opts.has_value());
+    assert(opts->gatt_cache.empty());
+    assert(opts->no_gatt_cache == false);
+
+    auto [argc2, argv2] = make_argv({"ninja_util", "--gatt-cache", "/tmp/ninja.cache"});
+    args::ArgumentParser parser2(argc2, argv2);
+    auto opts2 = parser2.parse();
+
+    assert(opts2.has_value());
+    assert(opts2->gatt_cache == "/tmp/ninja.cache");
+
+    auto [argc3, argv3] = make_argv({"ninja_util", "--gatt-cache=/tmp/x", "--no-gatt-cache"});
+    args::ArgumentParser parser3(argc3, argv3);
+    auto opts3 = parser3.parse();
+
+    assert(opts3.has_value());
+    assert(opts3->gatt_cache == "/tmp/x");
+    assert(opts3->no_gatt_cache == true);
+
+    std::cout << "PASSED\n";
+}
+
+void test_log_async_option() {
+    auto [argc, argv] = make_argv({"ninja_util", "--log-async"});
+    args::ArgumentParser parser(argc, argv);
+    auto opts = parser.parse();
+
+    assert(opts.has_value());
+    assert(opts->log_async == true);
+
+    auto [argc2, argv2] = make_argv({"ninja_util"});
+    args::ArgumentParser parser2(argc2, argv2);
+    auto opts2 = parser2.parse();
+
+    assert(opts2.has_value());
+    assert(opts2->log_async == false);
+
+    std::cout << "PASSED\n";
+}
+
+void test_trace_options() {
+    auto [argc, argv] = make_argv({"ninja_util"});
+    args::ArgumentParser parser(argc, argv);
+    auto opts = parser.parse();
+
+    assert(opts.has_value());
+    assert(opts->trace.empty());
+    assert(opts->trace_size == 16);
+
+    auto [argc2, argv2] =
+        make_argv({"ninja_util", "--trace", "/tmp/ninja.trace", "--trace-size=64"});
+    args::ArgumentParser parser2(argc2, argv2);
+    auto opts2 = parser2.parse();
+
+    assert(opts2.has_value());
+    assert(opts2->trace == "/tmp/ninja.trace");
+    assert(opts2->trace_size == 64);
+
+    auto [argc3, argv3] = make_argv({"ninja_util", "--trace", "/tmp/t", "--trace-size", "0"});
+    args::ArgumentParser parser3(argc3, argv3);
+    assert(!parser3.parse().has_value());
+
+    std::cout << "PASSED\n";
+}
+
+void test_latency_stats_option() {
+    auto [argc, argv] = make_argv({"ninja_util", "--latency-stats"});
+    args::ArgumentParser parser(argc, argv);
+    auto opts = parser.parse();
+
+    assert(opts.has_value());
+    assert(opts->latency_stats == true);
+
+    auto [argc2, argv2] = make_argv({"ninja_util"});
+    args::ArgumentParser parser2(argc2, argv2);
+    auto opts2 = parser2.parse();
+
+    assert(opts2.has_value());
+    assert(opts2->latency_stats == false);
+
+    std::cout << "PASSED\n";
+}
+
+void test_metrics_option() {
+    auto [argc, argv] = make_argv({"ninja_util"});
+    args::ArgumentParser parser(argc, argv);
+    auto opts = parser.parse();
+    assert(opts.has_value());
+    assert(opts->metrics.empty());
+
+    auto [argc2, argv2] = make_argv({"ninja_util", "--metrics", "9464"});
+    args::ArgumentParser parser2(argc2, argv2);
+    auto opts2 = parser2.parse();
+    assert(opts2.has_value());
+    assert(opts2->metrics == "9464");
+
+    auto [argc3, argv3] = make_argv({"ninja_util", "--metrics=/run/ninja_util.sock"});
+    args::ArgumentParser parser3(argc3, argv3);
+    auto opts3 = parser3.parse();
+    assert(opts3.has_value());
+    assert(opts3->metrics == "/run/ninja_util.sock");
+
+    for (const char* bad : {"0", "65536", "0.0.0.0:9464", "relative.sock", "port"}) {
+        auto [argc4, argv4] = make_argv({"ninja_util", "--metrics", bad});
+        args::ArgumentParser parser4(argc4, argv4);
+        assert(!parser4.parse().has_value());
+    }
+
+    std::cout << "PASSED\n";
+}
+
+void test_keymap_option() {
+    auto [argc, argv] = make_argv({"ninja_util"});
+    args::ArgumentParser parser(argc, argv);
+    auto opts = parser.parse();
+    assert(opts.has_value());
+    assert(opts->keymap.empty());
+
+    auto [argc2, argv2] = make_argv({"ninja_util", "--keymap", "/etc/ninja_util/keymap"});
+    args::ArgumentParser parser2(argc2, argv2);
+    auto opts2 = parser2.parse();
+    assert(opts2.has_value());
+    assert(opts2->keymap == "/etc/ninja_util/keymap");
+
+    auto [argc3, argv3] = make_argv({"ninja_util", "--keymap", ""});
+    args::ArgumentParser parser3(argc3, argv3);
+    assert(!parser3.parse().has_value());
+
+    std::cout << "PASSED\n";
+}
+
+void test_hotkeys_option() {
+    auto [argc, argv] = make_argv({"ninja_util"});
+    args::ArgumentParser parser(argc, argv);
+    auto opts = parser.parse();
+    assert(opts.has_value());
+    assert(opts->hotkeys.empty());
+
+    auto [argc2, argv2] =
+        make_argv({"ninja_util", "--hotkeys", "grab=ctrl+alt+g,next-target=ctrl+alt+n"});
+    args::ArgumentParser parser2(argc2, argv2);
+    auto opts2 = parser2.parse();
+    assert(opts2.has_value());
+    assert(opts2->hotkeys == "grab=ctrl+alt+g,next-target=ctrl+alt+n");
+
+    auto [argc3, argv3] = make_argv({"ninja_util", "--hotkeys=exit=ctrl+alt+q"});
+    args::ArgumentParser parser3(argc3, argv3);
+    auto opts3 = parser3.parse();
+    assert(opts3.has_value());
+    assert(opts3->hotkeys == "exit=ctrl+alt+q");
+
+    auto [argc4, argv4] = make_argv({"ninja_util", "--hotkeys", ""});
+    args::ArgumentParser parser4(argc4, argv4);
+    assert(!parser4.parse().has_value());
+
+    std::cout << "PASSED\n";
+}
+
+void test_type_options() {
+    auto [argc, argv] = make_argv({"ninja_util"});
+    args::ArgumentParser parser(argc, argv);
+    auto opts = parser.parse();
+    assert(opts.has_value());
+    assert(opts->type_text.empty() && opts->type_file.empty());
+
+    auto [argc2, argv2] = make_argv({"ninja_util", "--type", "hello world"});
+    args::ArgumentParser parser2(argc2, argv2);
+    auto opts2 = parser2.parse();
+    assert(opts2.has_value());
+    assert(opts2->type_text == "hello world");
+
+    auto [argc3, argv3] = make_argv({"ninja_util", "--type-file=-"});
+    args::ArgumentParser parser3(argc3, argv3);
+    auto opts3 = parser3.parse();
+    assert(opts3.has_value());
+    assert(opts3->type_file == "-" && opts3->type_text.empty());
+
+    auto [argc4, argv4] = make_argv({"ninja_util", "--type", "a", "--type-file", "/tmp/b"});
+    args::ArgumentParser parser4(argc4, argv4);
+    assert(!parser4.parse().has_value());
+
+    auto [argc5, argv5] = make_argv({"ninja_util", "--type", ""});
+    args::ArgumentParser parser5(argc5, argv5);
+    assert(!parser5.parse().has_value());
+
+    std::cout << "PASSED\n";
+}
+
+void test_daemon_option() {
+    auto [argc, argv] = make_argv({"ninja_util"});
+    args::ArgumentParser parser(argc, argv);
+    auto opts = parser.parse();
+    assert(opts.has_value());
+    assert(opts->daemon.empty());
+
+    auto [argc2, argv2] = make_argv({"ninja_util", "--daemon", "/run/ninja_util.ctl"});
+    args::ArgumentParser parser2(argc2, argv2);
+    auto opts2 = parser2.parse();
+    assert(opts2.has_value());
+    assert(opts2->daemon == "/run/ninja_util.ctl");
+
+    auto [argc3, argv3] = make_argv({"ninja_util", "--daemon=/tmp/ctl", "--share-input"});
+    args::ArgumentParser parser3(argc3, argv3);
+    auto opts3 = parser3.parse();
+    assert(opts3.has_value());
+    assert(opts3->daemon == "/tmp/ctl" && opts3->share_input);
+
+    // Relative paths and scan-and-exit runs are rejected
+    auto [argc4, argv4] = make_argv({"ninja_util", "--daemon", "ninja.ctl"});
+    args::ArgumentParser parser4(argc4, argv4);
+    assert(!parser4.parse().has_value());
+
+    auto [argc5, argv5] = make_argv({"ninja_util", "--daemon", "/tmp/ctl", "--list-devices"});
+    args::ArgumentParser parser5(argc5, argv5);
+    assert(!parser5.parse().has_value());
 
     std::cout << "PASSED\n";
 }
@@ -214,5 +662,23 @@ int main() {
          {"disable auto connect option", test_disable_auto_connect_option},
          {"list devices option", test_list_devices_option},
          {"target device option", test_target_device_option},
-         {"poll interval option", test_poll_interval_option}});
+         {"multiple targets option", test_multiple_targets_option},
+         {"poll interval option", test_poll_interval_option},
+         {"input thread options", test_input_thread_options},
+         {"coalesce frames option", test_coalesce_frames_option},
+         {"batch reads option", test_batch_reads_option},
+         {"no reconnect option", test_no_reconnect_option},
+         {"share input option", test_share_input_option},
+         {"conn profile option", test_conn_profile_option},
+         {"idle timeout option", test_idle_timeout_option},
+         {"scan grace option", test_scan_grace_option},
+         {"gatt cache options", test_gatt_cache_options},
+         {"log async option", test_log_async_option},
+         {"trace options", test_trace_options},
+         {"latency stats option", test_latency_stats_option},
+         {"metrics option", test_metrics_option},
+         {"keymap option", test_keymap_option},
+         {"hotkeys option", test_hotkeys_option},
+         {"type options", test_type_options},
+         {"daemon option", test_daemon_option}});
 }
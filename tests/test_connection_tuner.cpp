@@ -0,0 +1,119 @@
+/**
+ * @file test_connection_tuner.cpp
+ * @brief Unit tests for BLE connection profiles and the tuning fallback logic
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include <cassert>
+#include <string_view>
+
+#include "connection_tuner.hpp"
+#include "test_framework.hpp"
+
+namespace {
+
+using ble::ConnectionProfile;
+using ble::ConnectionTuner;
+
+void test_profile_names() {
+    for (const auto profile : {ConnectionProfile::LowLatency, ConnectionProfile::Balanced,
+                               ConnectionProfile::PowerSave}) {
+        assert(ble::parse_connection_profile(ble::to_string(profile)) == profile);
+    }
+    assert(!ble::parse_connection_profile("fast"));
+    assert(!ble::parse_connection_profile(""));
+}
+
+void test_profile_parameters_valid() {
+    for (const auto profile : {ConnectionProfile::LowLatency, ConnectionProfile::Balanced,
+                               ConnectionProfile::PowerSave}) {
+        const auto p = ble::parameters_for(profile);
+        // Core spec limits: 7.5 ms - 4 s interval, timeout > (1 + latency) * max interval * 2
+        assert(p.min_interval_ms >= 7.5 && p.min_interval_ms <= p.max_interval_ms);
+        assert(p.max_interval_ms <= 4000.0);
+        assert(p.supervision_timeout_ms > (1 + p.latency) * p.max_interval_ms * 2);
+    }
+    assert(ble::parameters_for(ConnectionProfile::LowLatency).max_interval_ms <
+           ble::parameters_for(ConnectionProfile::Balanced).max_interval_ms);
+}
+
+void test_accepted() {
+    ConnectionTuner tuner(ConnectionProfile::LowLatency);
+    assert(tuner.state() == ConnectionTuner::State::Idle);
+
+    const auto requested = tuner.start();
+    assert(requested.max_interval_ms == 15.0);
+    assert(tuner.pending());
+
+    assert(!tuner.on_updated(11.25));
+    assert(tuner.state() == ConnectionTuner::State::Accepted);
+    assert(tuner.active_profile() == ConnectionProfile::LowLatency);
+
+    // Later peer-initiated updates are only observed
+    assert(!tuner.on_updated(50.0));
+    assert(tuner.state() == ConnectionTuner::State::Accepted);
+}
+
+void test_fallback_on_out_of_range_interval() {
+    ConnectionTuner tuner(ConnectionProfile::LowLatency);
+    (void)tuner.start();
+
+    const auto fallback = tuner.on_updated(45.0);
+    assert(fallback);
+    assert(fallback->min_interval_ms ==
+           ble::parameters_for(ConnectionProfile::Balanced).min_interval_ms);
+    assert(tuner.state() == ConnectionTuner::State::FallingBack);
+    assert(tuner.active_profile() == ConnectionProfile::Balanced);
+
+    assert(!tuner.on_updated(30.0));
+    assert(tuner.state() == ConnectionTuner::State::Accepted);
+}
+
+void test_fallback_on_timeout() {
+    ConnectionTuner tuner(ConnectionProfile::PowerSave);
+    (void)tuner.start();
+
+    assert(tuner.on_timeout());
+    assert(tuner.state() == ConnectionTuner::State::FallingBack);
+
+    // Balanced refused as well: give up, no further requests
+    assert(!tuner.on_timeout());
+    assert(tuner.state() == ConnectionTuner::State::Refused);
+    assert(!tuner.pending());
+    assert(!tuner.on_timeout());
+}
+
+void test_balanced_has_no_fallback() {
+    ConnectionTuner tuner(ConnectionProfile::Balanced);
+    (void)tuner.start();
+    assert(!tuner.on_updated(100.0));
+    assert(tuner.state() == ConnectionTuner::State::Refused);
+}
+
+void test_retarget() {
+    ConnectionTuner tuner(ConnectionProfile::LowLatency);
+    (void)tuner.start();
+    assert(!tuner.on_updated(7.5));
+
+    const auto requested = tuner.retarget(ConnectionProfile::PowerSave);
+    assert(requested.latency == ble::parameters_for(ConnectionProfile::PowerSave).latency);
+    assert(tuner.pending());
+    assert(!tuner.on_updated(90.0));
+    assert(tuner.active_profile() == ConnectionProfile::PowerSave);
+}
+
+}  // namespace
+
+int main() {
+    return test_framework::run_test_suite(
+        "Connection Tuner Unit Tests",
+        {{"profile names", test_profile_names},
+         {"profile parameters valid", test_profile_parameters_valid},
+         {"accepted", test_accepted},
+         {"fallback on out-of-range interval", test_fallback_on_out_of_range_interval},
+         {"fallback on timeout", test_fallback_on_timeout},
+         {"balanced has no fallback", test_balanced_has_no_fallback},
+         {"retarget", test_retarget}});
+}
@@ -0,0 +1,298 @@
+/**
+ * @file test_control_server.cpp
+ * @brief Unit tests for the daemon control protocol and socket
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include <cassert>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <poll.h>
+#include <string>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+#include "control_protocol.hpp"
+#include "control_server.hpp"
+#include "test_framework.hpp"
+
+namespace {
+
+using control::Command;
+using control::Frame;
+using control::Status;
+
+//! @brief Scratch directory removed again at the end of each test
+struct TempDir {
+    std::filesystem::path path;
+
+    TempDir() {
+        path = std::filesystem::temp_directory_path() /
+               ("ninja_control_test_" + std::to_string(::getpid()));
+        std::filesystem::remove_all(path);
+        std::filesystem::create_directories(path);
+    }
+    ~TempDir() { std::filesystem::remove_all(path); }
+};
+
+int connect_unix(const std::string& path) {
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    assert(connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0);
+    return fd;
+}
+
+void send_bytes(int fd, const std::vector<std::uint8_t>& data) {
+    assert(send(fd, data.data(), data.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(data.size()));
+}
+
+//! @brief Read one response frame (the server answers before service() returns)
+Frame receive_frame(int fd) {
+    std::vector<std::uint8_t> data;
+    Frame frame;
+    for (;;) {
+        const auto used = control::decode_frame(data.data(), data.size(), frame);
+        assert(used);
+        if (*used != 0) {
+            return frame;
+        }
+        std::uint8_t buffer[256];
+        const ssize_t n = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        assert(n > 0);
+        data.insert(data.end(), buffer, buffer + n);
+    }
+}
+
+//! @brief Echoes the payload back; Unsupported for anything but QueryStats
+Frame echo(const Frame& request) {
+    Frame response;
+    if (request.command != static_cast<std::uint8_t>(Command::QueryStats)) {
+        response.status = Status::Unsupported;
+    }
+    response.payload = request.payload;
+    return response;
+}
+
+void test_frame_round_trip() {
+    std::vector<std::uint8_t> out;
+    control::append_frame(out, Command::SelectTarget, Status::Ok, {1, 2, 3, 4, 5, 6});
+    control::append_frame(out, Command::QueryStats);
+    assert(out.size() == control::HEADER_SIZE * 2 + 6);
+    assert(out[0] == 2 && out[1] == 0 && out[2] == 6 && out[3] == 0);
+
+    Frame frame;
+    assert(*control::decode_frame(out.data(), 3, frame) == 0);  // Header incomplete
+    assert(*control::decode_frame(out.data(), 9, frame) == 0);  // Payload incomplete
+    assert(*control::decode_frame(out.data(), out.size(), frame) == 10);
+    assert(frame.command == 2 && frame.payload.size() == 6 && frame.payload[5] == 6);
+    assert(*control::decode_frame(out.data() + 10, 4, frame) == 4);
+    assert(frame.command == 4 && frame.payload.empty());
+
+    // A length past MAX_PAYLOAD cannot be resynchronized
+    const std::uint8_t bad[] = {1, 0, 0xFF, 0xFF};
+    assert(!control::decode_frame(bad, sizeof(bad), frame));
+}
+
+void test_address_format() {
+    const auto address = control::parse_address("aa:BB:0c:1D:e2:F3");
+    assert(address);
+    assert((*address)[0] == 0xAA && (*address)[5] == 0xF3);
+    assert(control::format_address(*address) == "AA:BB:0C:1D:E2:F3");
+
+    assert(!control::parse_address(""));
+    assert(!control::parse_address("AA:BB:CC:DD:EE"));
+    assert(!control::parse_address("AA-BB-CC-DD-EE-FF"));
+    assert(!control::parse_address("AA:BB:CC:DD:EE:FG"));
+}
+
+void test_device_list_round_trip() {
+    control::DeviceEntry ninja;
+    ninja.address = *control::parse_address("11:22:33:44:55:66");
+    ninja.rssi = -58;
+    ninja.flags = control::DEVICE_NINJA | control::DEVICE_SELECTED | control::DEVICE_READY;
+    ninja.name = "NinjaUSB";
+    control::DeviceEntry other;
+    other.address = *control::parse_address("AA:BB:CC:DD:EE:FF");
+    other.name = "Headphones";
+
+    const auto payload = control::encode_devices({ninja, other});
+    assert(payload[0] == 2);
+    const auto devices = control::decode_devices(payload);
+    assert(devices && devices->size() == 2);
+    assert((*devices)[0].address == ninja.address && (*devices)[0].rssi == -58);
+    assert((*devices)[0].flags == ninja.flags && (*devices)[0].name == "NinjaUSB");
+    assert((*devices)[1].name == "Headphones" && (*devices)[1].flags == 0);
+
+    // Truncated payloads are rejected
+    assert(!control::decode_devices({}));
+    assert(!control::decode_devices(std::vector<std::uint8_t>(payload.begin(), payload.end() - 1)));
+}
+
+void test_report_payloads() {
+    const auto keyboard = pipeline::Report::keyboard({0x02, 0, 0x04, 0, 0, 0, 0, 0});
+    const auto decoded = control::decode_report(control::encode_report(keyboard));
+    assert(decoded && decoded->id == hid::ReportId::Keyboard);
+    assert(decoded->wire_size() == hid::KEYBOARD_REPORT_SIZE);
+    assert(decoded->begin()[0] == 0x02 && decoded->begin()[2] == 0x04);
+
+    const auto volume = control::decode_report({2, 0xE9, 0x00});
+    assert(volume && volume->is_consumer());
+    assert(volume->begin()[0] == 0xE9 && volume->begin()[1] == 0x00);
+
+    assert(!control::decode_report({}));
+    assert(!control::decode_report({1, 0, 0}));  // Keyboard report too short
+    assert(!control::decode_report({3, 0, 0, 0, 0, 0, 0, 0, 0}));  // NKRO is not injectable
+}
+
+void test_stats_round_trip() {
+    control::Stats stats{};
+    stats[static_cast<std::size_t>(control::Stat::ReadyLinks)] = 1;
+    stats[static_cast<std::size_t>(control::Stat::UptimeMs)] = 0x0102030405060708ULL;
+    const auto payload = control::encode_stats(stats);
+    assert(payload.size() == 1 + control::STAT_COUNT * 8);
+    const auto decoded = control::decode_stats(payload);
+    assert(decoded && *decoded == stats);
+
+    // Values appended by a newer daemon are ignored, missing ones read as 0
+    std::vector<std::uint8_t> longer = payload;
+    longer[0] = static_cast<std::uint8_t>(control::STAT_COUNT + 1);
+    longer.insert(longer.end(), 8, 0xFF);
+    assert(control::decode_stats(longer) == stats);
+    const auto shorter = control::decode_stats({1, 7, 0, 0, 0, 0, 0, 0, 0});
+    assert(shorter && (*shorter)[0] == 7 && (*shorter)[1] == 0);
+    assert(!control::decode_stats({2, 7, 0, 0, 0, 0, 0, 0, 0}));
+}
+
+void test_server_answers_in_order() {
+    TempDir dir;
+    const std::string path = (dir.path / "ctl.sock").string();
+    const mode_t mask = umask(0);  // Even with a permissive umask
+    control::ControlServer server(path, echo);
+    assert(umask(mask) == 0);  // The process umask is left alone
+    assert(server.is_valid());
+
+    struct stat st{};
+    assert(stat(path.c_str(), &st) == 0);
+    assert(S_ISSOCK(st.st_mode) && (st.st_mode & 0777) == 0600);  // Owner only
+
+    assert(server.accept_client() < 0);  // Nothing pending
+    const int client = connect_unix(path);
+    const int fd = server.accept_client();
+    assert(fd >= 0 && server.client_count() == 1);
+
+    // Two requests, the second split across reads
+    std::vector<std::uint8_t> requests;
+    control::append_frame(requests, Command::QueryStats, Status::Ok, {9, 8});
+    control::append_frame(requests, Command::ListDevices);
+    send_bytes(client, std::vector<std::uint8_t>(requests.begin(), requests.end() - 2));
+    assert(server.service(fd));
+    const Frame first = receive_frame(client);
+    assert(first.command == static_cast<std::uint8_t>(Command::QueryStats));
+    assert(first.status == Status::Ok && first.payload == std::vector<std::uint8_t>({9, 8}));
+    assert(server.requests() == 1);
+
+    send_bytes(client, std::vector<std::uint8_t>(requests.end() - 2, requests.end()));
+    assert(server.service(fd));
+    const Frame second = receive_frame(client);
+    assert(second.command == static_cast<std::uint8_t>(Command::ListDevices));
+    assert(second.status == Status::Unsupported);
+
+    // Unknown commands are echoed with their raw value
+    send_bytes(client, {0x7F, 0, 0, 0});
+    assert(server.service(fd));
+    assert(receive_frame(client).command == 0x7F);
+
+    close(client);
+    assert(!server.service(fd));
+    server.close_client(fd);
+    assert(server.client_count() == 0);
+}
+
+void test_server_drops_garbage() {
+    TempDir dir;
+    const std::string path = (dir.path / "ctl.sock").string();
+    control::ControlServer server(path, echo);
+    const int client = connect_unix(path);
+    const int fd = server.accept_client();
+    send_bytes(client, {'G', 'E', 'T', ' '});  // 0x2054 bytes announced
+    assert(!server.service(fd));
+    server.close_client(fd);
+    close(client);
+}
+
+void test_socket_file_handling() {
+    TempDir dir;
+    const std::string path = (dir.path / "ctl.sock").string();
+    {
+        control::ControlServer server(path, echo);
+        assert(server.is_valid());
+    }
+    assert(!std::filesystem::exists(path));  // Removed on shutdown
+
+    {
+        control::ControlServer first(path, echo);
+        control::ControlServer second(path, echo);  // Stale socket replaced
+        assert(second.is_valid());
+    }
+
+    const std::string file = (dir.path / "regular").string();
+    std::ofstream(file) << "keep";
+    control::ControlServer refused(file, echo);
+    assert(!refused.is_valid());
+    assert(std::filesystem::file_size(file) == 4);
+}
+
+int g_shutdown_fd = -1;
+
+//! @brief Same forwarding as main.cpp's SIGTERM handler
+void forward_shutdown(int /*signum*/) {
+    const std::uint64_t one = 1;
+    [[maybe_unused]] const ssize_t written = write(g_shutdown_fd, &one, sizeof(one));
+}
+
+void test_sigterm_removes_socket() {
+    TempDir dir;
+    const std::string path = (dir.path / "ctl.sock").string();
+    g_shutdown_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    assert(g_shutdown_fd >= 0);
+    signal(SIGTERM, forward_shutdown);
+    {
+        control::ControlServer server(path, echo);
+        assert(server.is_valid() && std::filesystem::exists(path));
+        raise(SIGTERM);
+
+        // The event loop: the eventfd becomes readable and ends it
+        pollfd fds[] = {{server.listen_fd(), POLLIN, 0}, {g_shutdown_fd, POLLIN, 0}};
+        assert(poll(fds, 2, 1000) == 1 && (fds[1].revents & POLLIN));
+    }
+    assert(!std::filesystem::exists(path));  // The server went out of scope after the loop
+    signal(SIGTERM, SIG_DFL);
+    close(g_shutdown_fd);
+    g_shutdown_fd = -1;
+}
+
+}  // namespace
+
+int main() {
+    return test_framework::run_test_suite(
+        "Control Server Tests", {{"frame round trip", test_frame_round_trip},
+                                 {"address format", test_address_format},
+                                 {"device list round trip", test_device_list_round_trip},
+                                 {"report payloads", test_report_payloads},
+                                 {"stats round trip", test_stats_round_trip},
+                                 {"server answers in order", test_server_answers_in_order},
+                                 {"server drops garbage", test_server_drops_garbage},
+                                 {"socket file handling", test_socket_file_handling},
+                                 {"SIGTERM removes socket", test_sigterm_removes_socket}});
+}
@@ -0,0 +1,134 @@
+/**
+ * @file test_device_cache.cpp
+ * @brief Unit tests for the ranked BLE device cache
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "device_cache.hpp"
+#include "test_framework.hpp"
+
+namespace {
+
+using ble::DeviceCache;
+using Clock = DeviceCache::Clock;
+using std::chrono::minutes;
+using std::chrono::seconds;
+
+DeviceCache::Sighting sighting(const std::string& address, const std::string& name,
+                               std::int16_t rssi = 0) {
+    DeviceCache::Sighting seen;
+    seen.address = address;
+    seen.name = name;
+    seen.rssi = rssi;
+    return seen;
+}
+
+void test_one_entry_per_address() {
+    const Clock::time_point t0{};
+    DeviceCache cache;
+    const auto first = cache.on_seen(sighting("AA:00:00:00:00:01", "NinjaUSB", -60), t0);
+    assert(first.added && first.position == 0);
+    assert(first.device.ninja);
+    const auto second = cache.on_seen(sighting("AA:00:00:00:00:02", "Mouse", -50), t0);
+    assert(second.added && second.position == 1 && !second.device.ninja);
+
+    const auto again =
+        cache.on_seen(sighting("AA:00:00:00:00:01", "NinjaUSB", -45), t0 + seconds(5));
+    assert(!again.added && again.position == 0);
+    assert(cache.size() == 2 && cache.ninja_count() == 1);
+
+    const DeviceCache::Device* device = cache.find("AA:00:00:00:00:01");
+    assert(device && device->rssi == -45 && device->sightings == 2);
+    assert(device->first_seen == t0 && device->last_seen == t0 + seconds(5));
+    assert(!cache.find("AA:00:00:00:00:03"));
+}
+
+void test_updates_keep_known_fields() {
+    const Clock::time_point t0{};
+    DeviceCache cache;
+    DeviceCache::Sighting advert = sighting("AA:00:00:00:00:01", "", -70);
+    advert.manufacturer_id = 0x02E5;
+    advert.manufacturer_data = {1, 2, 3};
+    assert(!cache.on_seen(advert, t0).device.ninja);  // No name yet
+
+    // The scan response names it; an update without RSSI or data keeps the old values
+    const auto named =
+        cache.on_seen(sighting("AA:00:00:00:00:01", "ninjaUSB-2"), t0 + seconds(1));
+    assert(named.device.ninja && named.device.name == "ninjaUSB-2");
+    assert(named.device.rssi == -70);
+    assert(named.device.manufacturer_id == 0x02E5);
+    assert(named.device.manufacturer_data == std::vector<std::uint8_t>({1, 2, 3}));
+
+    // An empty name does not undo the classification
+    assert(cache.on_seen(sighting("AA:00:00:00:00:01", ""), t0 + seconds(2)).device.ninja);
+}
+
+void test_match_by_address_or_name() {
+    const Clock::time_point t0{};
+    DeviceCache cache;
+    cache.on_seen(sighting("AA:00:00:00:00:01", "Desk"), t0);
+    cache.on_seen(sighting("AA:00:00:00:00:02", "Desk"), t0 + seconds(10));
+    assert(cache.match("AA:00:00:00:00:01")->address == "AA:00:00:00:00:01");
+    assert(cache.match("aa:00:00:00:00:01")->address == "AA:00:00:00:00:01");
+    assert(cache.match("Desk")->address == "AA:00:00:00:00:02");  // Latest sighting
+    assert(!cache.match("Lab"));
+}
+
+void test_ranking() {
+    const Clock::time_point t0{};
+    DeviceCache cache;
+    cache.on_seen(sighting("AA:00:00:00:00:01", "Speaker", -30), t0 + minutes(10));
+    cache.on_seen(sighting("AA:00:00:00:00:02", "NinjaUSB far", -80), t0 + minutes(10));
+    cache.on_seen(sighting("AA:00:00:00:00:03", "NinjaUSB gone", -20), t0);
+    cache.on_seen(sighting("AA:00:00:00:00:04", "NinjaUSB near", -40), t0 + minutes(10));
+    cache.on_seen(sighting("AA:00:00:00:00:05", "NinjaUSB quiet"), t0 + minutes(10));
+
+    const auto now = t0 + minutes(11);
+    const auto order = cache.ranked(now, minutes(2));
+    assert(order.size() == 5);
+    assert(order[0]->name == "NinjaUSB near");
+    assert(order[1]->name == "NinjaUSB far");
+    assert(order[2]->name == "NinjaUSB quiet");  // Unknown RSSI below real readings
+    assert(order[3]->name == "NinjaUSB gone");   // Stale despite the strongest signal
+    assert(order[4]->name == "Speaker");
+
+    assert(cache.best(now, minutes(2))->name == "NinjaUSB near");
+    assert(cache.best(now, minutes(20))->name == "NinjaUSB gone");
+    assert(!cache.best(now + minutes(5), minutes(2)));  // Nothing fresh
+}
+
+void test_prune_renumbers() {
+    const Clock::time_point t0{};
+    DeviceCache cache;
+    cache.on_seen(sighting("AA:00:00:00:00:01", "Old"), t0);
+    cache.on_seen(sighting("AA:00:00:00:00:02", "New"), t0 + minutes(20));
+    assert(cache.prune(t0 + minutes(31), minutes(30)) == 1);
+    assert(cache.size() == 1 && !cache.find("AA:00:00:00:00:01"));
+    assert(cache.find("AA:00:00:00:00:02") == &cache.devices()[0]);
+
+    // The index stays consistent for new devices
+    const auto added = cache.on_seen(sighting("AA:00:00:00:00:03", "Newer"), t0 + minutes(32));
+    assert(added.position == 1 && cache.find("AA:00:00:00:00:03")->name == "Newer");
+
+    cache.clear();
+    assert(cache.empty() && !cache.find("AA:00:00:00:00:02"));
+}
+
+}  // namespace
+
+int main() {
+    return test_framework::run_test_suite(
+        "Device Cache Tests", {{"one entry per address", test_one_entry_per_address},
+                               {"updates keep known fields", test_updates_keep_known_fields},
+                               {"match by address or name", test_match_by_address_or_name},
+                               {"ranking", test_ranking},
+                               {"prune renumbers", test_prune_renumbers}});
+}
@@ -7,8 +7,10 @@
  */
 
 #include <cassert>
+#include <cerrno>
 #include <iostream>
 #include <string>
+#include <utility>
 
 #include "device_manager.hpp"
 
@@ -21,6 +23,13 @@ void test_keyboard_device_invalid_path() {
     // Test with non-existent path
     device::KeyboardDevice kbd2("/dev/input/nonexistent");
     assert(!kbd2.is_valid());
+    assert(kbd2.open_error() == ENOENT);
+    assert(kbd2.devnum() == 0);
+
+    // The open error survives a move (the manager stores devices by value)
+    device::KeyboardDevice moved(std::move(kbd2));
+    assert(moved.open_error() == ENOENT);
+    assert(moved.path() == "/dev/input/nonexistent");
 
     std::cout << "PASSED\n";
 }
@@ -39,6 +48,46 @@ void test_keyboard_manager_basic() {
 
     std::cout << "PASSED\n";
 }
+
+void test_keyboard_manager_poll_fds() {
+    device::KeyboardManager manager;
+    const device::PollFdSet set = manager.poll_fds();
+
+    // One entry per keyboard, index-aligned with keyboards(), then the monitor and
+    // the probe retry timer
+    const std::size_t hotplug_entries =
+        manager.is_valid() ? 1U + (manager.retry_fd() >= 0 ? 1U : 0U) : 0U;
+    assert(set.keyboard_count == manager.device_count());
+    assert(set.count == set.keyboard_count + hotplug_entries);
+    assert((set.monitor() != nullptr) == manager.is_valid());
+    if (set.monitor() != nullptr) {
+        assert(set.monitor()->fd == manager.monitor_fd());
+    }
+    assert((set.retry_timer() != nullptr) == (hotplug_entries == 2));
+    if (set.retry_timer() != nullptr) {
+        assert(set.retry_timer()->fd == manager.retry_fd());
+    }
+    assert(!set.hotplug_ready());  // revents untouched until poll() runs
+
+    // The legacy list has no retry timer
+    const auto legacy = manager.get_poll_fds();
+    assert(legacy.size() == set.keyboard_count + (manager.is_valid() ? 1U : 0U));
+
+    for (std::size_t i = 0; i < set.keyboard_count; ++i) {
+        assert(set.fds[i].fd == manager.keyboards()[i].fd());
+        assert(set.fds[i].events == POLLIN);
+        const auto index = manager.device_index_for_fd(set.fds[i].fd);
+        assert(index && *index == i);
+    }
+    assert(!manager.device_index_for_fd(-1));
+
+    // No hot-plug happened, so the cached array is handed out unchanged
+    assert(manager.poll_fds().fds == set.fds);
+    assert(!manager.update_devices());
+    assert(manager.poll_fds().fds == set.fds);
+
+    std::cout << "PASSED\n";
+}
 }  // namespace
 
 int main() {
@@ -48,6 +97,7 @@ int main() {
         test_keyboard_device_invalid_path();
         test_device_monitor_creation();
         test_keyboard_manager_basic();
+        test_keyboard_manager_poll_fds();
 
         std::cout << "\n=== All tests completed ===\n";
         return 0;
@@ -0,0 +1,108 @@
+/**
+ * @file test_device_probe.cpp
+ * @brief Unit tests for udev classification, the negative cache and parallel probing
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "device_probe.hpp"
+#include "test_framework.hpp"
+
+namespace {
+
+using device::UdevKeyboardClass;
+
+void test_classify_udev_properties() {
+    using device::classify_udev_properties;
+    assert(classify_udev_properties("1", "1") == UdevKeyboardClass::Keyboard);
+    // Keyboard flag without ID_INPUT still counts
+    assert(classify_udev_properties(nullptr, "1") == UdevKeyboardClass::Keyboard);
+    // Touchpads, power buttons, HDMI-CEC: classified, but not as keyboards
+    assert(classify_udev_properties("1", nullptr) == UdevKeyboardClass::NotKeyboard);
+    assert(classify_udev_properties("1", "0") == UdevKeyboardClass::NotKeyboard);
+    // No udev database (containers, missing rules): must be probed
+    assert(classify_udev_properties(nullptr, nullptr) == UdevKeyboardClass::Unknown);
+    assert(classify_udev_properties("0", nullptr) == UdevKeyboardClass::Unknown);
+}
+
+void test_negative_cache() {
+    device::NegativeProbeCache cache;
+    const std::string touchpad = "/sys/devices/platform/i8042/serio1/input/input7/event6";
+    assert(!cache.contains(touchpad));
+    cache.insert(touchpad);
+    cache.insert(touchpad);
+    assert(cache.contains(touchpad));
+    assert(cache.size() == 1);
+
+    // A re-plugged device gets a new syspath, so it is probed again
+    assert(!cache.contains("/sys/devices/platform/i8042/serio1/input/input8/event6"));
+
+    assert(cache.erase(touchpad));
+    assert(!cache.erase(touchpad));
+    assert(cache.size() == 0);
+}
+
+void test_worker_count() {
+    using device::MAX_PROBE_WORKERS;
+    using device::probe_worker_count;
+    assert(probe_worker_count(0, 4) == 1);
+    assert(probe_worker_count(1, 4) == 1);
+    assert(probe_worker_count(3, 4) == 3);
+    assert(probe_worker_count(20, 4) == 4);
+    // Blocking opens overlap even on one core
+    assert(probe_worker_count(20, 1) == 2);
+    assert(probe_worker_count(20, 0) == 2);
+    assert(probe_worker_count(100, 64) == MAX_PROBE_WORKERS);
+}
+
+void test_parallel_for_visits_each_index_once() {
+    for (const std::size_t workers : {1U, 2U, 5U, 16U}) {
+        constexpr std::size_t COUNT = 37;
+        std::vector<std::atomic<int>> visits(COUNT);
+        device::parallel_for(COUNT, workers, [&](std::size_t i) { visits[i].fetch_add(1); });
+        for (const auto& v : visits) {
+            assert(v.load() == 1);
+        }
+    }
+    // Nothing to do
+    device::parallel_for(0, 4, [](std::size_t) { assert(false); });
+}
+
+void test_parallel_for_overlaps_slow_items() {
+    // Four items that each block for 50 ms finish in far less than 200 ms on four workers
+    constexpr auto SLOW = std::chrono::milliseconds(50);
+    std::atomic<int> running{0};
+    std::atomic<int> peak{0};
+    const auto start = std::chrono::steady_clock::now();
+    device::parallel_for(4, 4, [&](std::size_t) {
+        const int now = running.fetch_add(1) + 1;
+        int seen = peak.load();
+        while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+        }
+        std::this_thread::sleep_for(SLOW);
+        running.fetch_sub(1);
+    });
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    assert(peak.load() > 1);
+    assert(elapsed < 4 * SLOW);
+}
+
+}  // namespace
+
+int main() {
+    return test_framework::run_test_suite(
+        "Device Probe Tests",
+        {{"classify udev properties", test_classify_udev_properties},
+         {"negative cache", test_negative_cache},
+         {"worker count", test_worker_count},
+         {"parallel_for visits each index once", test_parallel_for_visits_each_index_once},
+         {"parallel_for overlaps slow items", test_parallel_for_overlaps_slow_items}});
+}
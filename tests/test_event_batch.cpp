@@ -0,0 +1,192 @@
+/**
+ * @file test_event_batch.cpp
+ * @brief Unit tests for batched evdev read filtering and SYN_DROPPED resync
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include <linux/input.h>
+
+#include "event_batch.hpp"
+#include "test_framework.hpp"
+
+namespace {
+
+using device::KeyBitmap;
+
+input_event make_event(unsigned short type, unsigned short code, int value) {
+    input_event ev{};
+    ev.type = type;
+    ev.code = code;
+    ev.value = value;
+    return ev;
+}
+
+input_event key(unsigned short code, int value) {
+    return make_event(EV_KEY, code, value);
+}
+
+input_event syn(unsigned short code = SYN_REPORT) {
+    return make_event(EV_SYN, code, 0);
+}
+
+bool same(const input_event& a, const input_event& b) {
+    return a.type == b.type && a.code == b.code && a.value == b.value;
+}
+
+void test_key_bitmap() {
+    KeyBitmap bits;
+    assert(!bits.test(KEY_A));
+    bits.set(KEY_A, true);
+    bits.set(KEY_MAX, true);
+    assert(bits.test(KEY_A) && bits.test(KEY_MAX));
+    bits.set(KEY_A, false);
+    assert(!bits.test(KEY_A));
+
+    // Out of range codes are ignored rather than written past the end
+    bits.set(KEY_CNT, true);
+    assert(!bits.test(KEY_CNT));
+
+    // Matches the EVIOCGKEY buffer size
+    assert(KeyBitmap::byte_size() * 8 >= KEY_CNT);
+
+    KeyBitmap other;
+    assert(bits != other);
+    other.set(KEY_MAX, true);
+    assert(bits == other);
+}
+
+void test_filter_keeps_keys_and_reports() {
+    std::vector<input_event> events = {make_event(EV_MSC, MSC_SCAN, 0x70004),
+                                       key(KEY_A, 1),
+                                       make_event(EV_LED, LED_CAPSL, 1),
+                                       syn(),
+                                       key(KEY_A, 2),
+                                       syn(),
+                                       key(KEY_A, 0),
+                                       syn()};
+    KeyBitmap delivered;
+    bool dropping = false;
+    const auto result =
+        device::filter_key_frames(events.data(), events.size(), delivered, dropping);
+
+    assert(result.kept == 6);
+    assert(result.scanned == events.size());
+    assert(!result.resync && !dropping);
+    const std::array<input_event, 6> expected = {key(KEY_A, 1), syn(), key(KEY_A, 2),
+                                                 syn(),         key(KEY_A, 0), syn()};
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        assert(same(events[i], expected[i]));
+    }
+    assert(!delivered.test(KEY_A));
+}
+
+void test_filter_tracks_delivered_state() {
+    // A frame split across two reads is delivered in two parts
+    std::vector<input_event> first = {key(KEY_LEFTSHIFT, 1), syn(), key(KEY_B, 1)};
+    KeyBitmap delivered;
+    bool dropping = false;
+    const auto result = device::filter_key_frames(first.data(), first.size(), delivered, dropping);
+    assert(result.kept == 3);
+    assert(delivered.test(KEY_LEFTSHIFT) && delivered.test(KEY_B));
+}
+
+void test_filter_drops_gap_and_stops() {
+    std::vector<input_event> events = {key(KEY_A, 1), syn(),
+                                       key(KEY_B, 1),  // Frame cut short by the overflow
+                                       syn(SYN_DROPPED), key(KEY_C, 1), syn(),
+                                       key(KEY_D, 1),  syn()};
+    KeyBitmap delivered;
+    bool dropping = false;
+    const auto result =
+        device::filter_key_frames(events.data(), events.size(), delivered, dropping);
+
+    // Only the complete frame survives; scanning stops after the SYN_REPORT closing the gap
+    assert(result.kept == 2);
+    assert(same(events[0], key(KEY_A, 1)) && same(events[1], syn()));
+    assert(result.resync && !dropping);
+    assert(result.scanned == 6);
+    assert(same(events[result.scanned - 1], syn()));
+    assert(delivered.test(KEY_A) && !delivered.test(KEY_B) && !delivered.test(KEY_C));
+
+    // The rest of the batch is untouched and filtered on the next call
+    const auto rest = device::filter_key_frames(events.data() + result.scanned,
+                                                events.size() - result.scanned, delivered,
+                                                dropping);
+    assert(rest.kept == 2 && !rest.resync);
+    assert(same(events[result.scanned], key(KEY_D, 1)));
+}
+
+void test_filter_gap_spans_reads() {
+    std::vector<input_event> first = {key(KEY_A, 1), syn(SYN_DROPPED), key(KEY_B, 1)};
+    KeyBitmap delivered;
+    bool dropping = false;
+    auto result = device::filter_key_frames(first.data(), first.size(), delivered, dropping);
+    assert(result.kept == 0 && !result.resync && dropping);
+    assert(result.scanned == first.size());
+
+    std::vector<input_event> second = {key(KEY_C, 0), syn(), key(KEY_D, 1), syn()};
+    result = device::filter_key_frames(second.data(), second.size(), delivered, dropping);
+    assert(result.kept == 0 && result.resync && !dropping);
+    assert(result.scanned == 2);
+}
+
+void test_resync_releases_then_presses() {
+    KeyBitmap delivered;
+    delivered.set(KEY_LEFTCTRL, true);
+    delivered.set(KEY_A, true);
+    KeyBitmap actual;
+    actual.set(KEY_A, true);
+    actual.set(KEY_Z, true);
+
+    input_event stamp = syn();
+    stamp.input_event_sec = 42;
+    stamp.input_event_usec = 7;
+    std::vector<input_event> out(device::MAX_RESYNC_EVENTS);
+    const std::size_t n = device::build_resync(delivered, actual, stamp, out.data(), out.size());
+
+    assert(n == 3);
+    assert(same(out[0], key(KEY_LEFTCTRL, 0)));
+    assert(same(out[1], key(KEY_Z, 1)));
+    assert(same(out[2], syn()));
+    for (std::size_t i = 0; i < n; ++i) {
+        assert(out[i].input_event_sec == 42 && out[i].input_event_usec == 7);
+    }
+    assert(delivered == actual);
+
+    // Nothing changed: no frame at all
+    assert(device::build_resync(delivered, actual, stamp, out.data(), out.size()) == 0);
+}
+
+void test_resync_worst_case_fits() {
+    KeyBitmap delivered;
+    KeyBitmap actual;
+    for (unsigned code = 0; code < KEY_CNT; ++code) {
+        actual.set(code, true);
+    }
+    std::vector<input_event> out(device::MAX_RESYNC_EVENTS);
+    const std::size_t n =
+        device::build_resync(delivered, actual, syn(), out.data(), out.size());
+    assert(n == device::MAX_RESYNC_EVENTS);
+    assert(same(out[n - 1], syn()));
+}
+
+}  // namespace
+
+int main() {
+    return test_framework::run_test_suite(
+        "Event Batch Tests",
+        {{"key bitmap", test_key_bitmap},
+         {"filter keeps keys and reports", test_filter_keeps_keys_and_reports},
+         {"filter tracks delivered state", test_filter_tracks_delivered_state},
+         {"filter drops gap and stops", test_filter_drops_gap_and_stops},
+         {"filter gap spans reads", test_filter_gap_spans_reads},
+         {"resync releases then presses", test_resync_releases_then_presses},
+         {"resync worst case fits", test_resync_worst_case_fits}});
+}
@@ -0,0 +1,121 @@
+/**
+ * @file test_gatt_cache.cpp
+ * @brief Unit tests for the persistent GATT cache
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include <cassert>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+#include "gatt_cache.hpp"
+#include "test_framework.hpp"
+
+namespace {
+
+//! @brief Scratch directory removed again at the end of each test
+struct TempDir {
+    std::filesystem::path path;
+
+    TempDir() {
+        path = std::filesystem::temp_directory_path() /
+               ("ninja_gatt_cache_test_" + std::to_string(::getpid()));
+        std::filesystem::remove_all(path);
+    }
+    ~TempDir() { std::filesystem::remove_all(path); }
+};
+
+ble::GattCacheEntry sample_entry() {
+    return {"AA:BB:CC:DD:EE:FF", "NinjaUSB", "{0000ffe0-0000-1000-8000-00805f9b34fb}",
+            "{0000ffe1-0000-1000-8000-00805f9b34fb}"};
+}
+
+void test_round_trip() {
+    TempDir dir;
+    // Parent directories are created on demand
+    const std::string path = (dir.path / "nested" / "gatt_cache").string();
+
+    assert(ble::save_gatt_cache(path, sample_entry()));
+    assert(!std::filesystem::exists(path + ".tmp"));
+
+    auto loaded = ble::load_gatt_cache(path);
+    assert(loaded.has_value());
+    assert(loaded->address == "AA:BB:CC:DD:EE:FF");
+    assert(loaded->name == "NinjaUSB");
+    assert(loaded->service_uuid == "{0000ffe0-0000-1000-8000-00805f9b34fb}");
+    assert(loaded->characteristic_uuid == "{0000ffe1-0000-1000-8000-00805f9b34fb}");
+
+    // Saving again replaces the previous device
+    auto other = sample_entry();
+    other.address = "11:22:33:44:55:66";
+    other.name = "multi\nline";
+    assert(ble::save_gatt_cache(path, other));
+    loaded = ble::load_gatt_cache(path);
+    assert(loaded.has_value());
+    assert(loaded->address == "11:22:33:44:55:66");
+    assert(loaded->name == "multi line");
+}
+
+void test_missing_or_malformed() {
+    TempDir dir;
+    std::filesystem::create_directories(dir.path);
+    const std::string path = (dir.path / "gatt_cache").string();
+
+    assert(!ble::load_gatt_cache(path).has_value());
+
+    // Wrong header
+    std::ofstream(path) << "address=AA:BB:CC:DD:EE:FF\nservice=s\ncharacteristic=c\n";
+    assert(!ble::load_gatt_cache(path).has_value());
+
+    // Incomplete entry
+    std::ofstream(path) << "ninja_util-gatt-cache 1\naddress=AA:BB:CC:DD:EE:FF\nservice=s\n";
+    assert(!ble::load_gatt_cache(path).has_value());
+
+    // Unknown keys and junk lines are ignored
+    std::ofstream(path) << "ninja_util-gatt-cache 1\nfuture=1\njunk\naddress=A\nservice=s\n"
+                           "characteristic=c\n";
+    auto loaded = ble::load_gatt_cache(path);
+    assert(loaded.has_value());
+    assert(loaded->name.empty());
+
+    // Incomplete entries are never written
+    assert(!ble::save_gatt_cache(path, ble::GattCacheEntry{"A", "n", "", "c"}));
+    assert(!ble::save_gatt_cache("", sample_entry()));
+}
+
+void test_matches_target() {
+    const auto entry = sample_entry();
+    assert(entry.matches_target(""));
+    assert(entry.matches_target("AA:BB:CC:DD:EE:FF"));
+    assert(entry.matches_target("aa:bb:cc:dd:ee:ff"));
+    assert(entry.matches_target("NinjaUSB"));
+    assert(!entry.matches_target("11:22:33:44:55:66"));
+    assert(!entry.matches_target("ninjausb"));
+}
+
+void test_default_path() {
+    setenv("XDG_CACHE_HOME", "/tmp/xdg", 1);
+    assert(ble::default_gatt_cache_path() == "/tmp/xdg/ninja_util/gatt_cache");
+
+    unsetenv("XDG_CACHE_HOME");
+    setenv("HOME", "/home/user", 1);
+    assert(ble::default_gatt_cache_path() == "/home/user/.cache/ninja_util/gatt_cache");
+
+    unsetenv("HOME");
+    assert(ble::default_gatt_cache_path().empty());
+}
+
+}  // namespace
+
+int main() {
+    return test_framework::run_test_suite("GATT Cache Unit Tests",
+                                          {{"save and load round trip", test_round_trip},
+                                           {"missing or malformed files", test_missing_or_malformed},
+                                           {"target matching", test_matches_target},
+                                           {"default cache path", test_default_path}});
+}
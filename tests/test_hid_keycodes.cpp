@@ -8,7 +8,9 @@
 
 #include <array>
 #include <cassert>
+#include <cstdint>
 #include <iostream>
+#include <type_traits>
 
 #include "hid_keycodes.hpp"
 
@@ -116,6 +118,101 @@ void test_key_rollover() {
     std::cout << "PASSED\n";
 }
 
+void test_rollover_slot_promotion() {
+    hid::KeyboardState state;
+
+    // Press order is preserved in the report, not sorted by usage code
+    state.set_key_state(0x10, true);  // 'M'
+    state.set_key_state(0x04, true);  // 'A'
+    auto report = state.get_report();
+    assert(report[2] == 0x10);
+    assert(report[3] == 0x04);
+
+    // Auto-repeat of a held key does not take another slot
+    state.set_key_state(0x10, true);
+    assert(state.get_pressed_key_count() == 2);
+    report = state.get_report();
+    assert(report[4] == 0);
+
+    // Fill all six slots, then hold two more keys
+    for (std::uint8_t code = 0x05; code <= 0x0A; ++code) {
+        state.set_key_state(code, true);
+    }
+    assert(state.get_pressed_key_count() == 8);
+    report = state.get_report();
+    assert(report[7] == 0x08);  // 0x09 and 0x0A are held but unreported
+    assert(state.is_key_pressed(0x0A));
+
+    // Releasing a reported key promotes the lowest held-but-unreported key
+    state.set_key_state(0x04, false);
+    report = state.get_report();
+    assert(report[2] == 0x10);
+    assert(report[3] == 0x05);
+    assert(report[7] == 0x09);
+
+    // Releasing an unreported key leaves the report untouched
+    state.set_key_state(0x0A, false);
+    assert(state.get_pressed_key_count() == 6);
+    assert(state.get_report() == report);
+
+    // Releasing a key that is not held is a no-op
+    state.set_key_state(0x20, false);
+    assert(state.get_pressed_key_count() == 6);
+    assert(!state.is_key_pressed(0x20));
+
+    std::cout << "PASSED\n";
+}
+
+void test_overflow_bitmap() {
+    hid::KeyboardState state;
+
+    // Nothing beyond the six slots: all zeros
+    for (std::uint8_t code = 0x04; code <= 0x09; ++code) {
+        state.set_key_state(code, true);
+    }
+    auto overflow = state.get_overflow_bitmap();
+    for (const auto byte : overflow) {
+        assert(byte == 0);
+    }
+
+    // Keys held beyond the slots appear as bit (usage % 8) of byte (usage / 8)
+    state.set_key_state(0x0A, true);
+    state.set_key_state(0x51, true);  // Down arrow
+    overflow = state.get_overflow_bitmap();
+    assert(overflow[0x0A / 8] == (1U << (0x0A % 8)));
+    assert(overflow[0x51 / 8] == (1U << (0x51 % 8)));
+    assert(overflow[0x04 / 8] == 0);  // Slotted keys are not repeated
+
+    // A promoted key leaves the bitmap
+    state.set_key_state(0x04, false);
+    overflow = state.get_overflow_bitmap();
+    assert(state.get_report()[7] == 0x0A);
+    assert(overflow[0x0A / 8] == 0);
+    assert(overflow[0x51 / 8] == (1U << (0x51 % 8)));
+
+    std::cout << "PASSED\n";
+}
+
+void test_state_snapshot() {
+    static_assert(std::is_trivially_copyable_v<hid::KeyboardState>);
+
+    hid::KeyboardState state;
+    state.set_key_state(0xE1, true);  // Left Shift
+    state.set_key_state(0x04, true);  // 'A'
+
+    const hid::KeyboardState snapshot = state;
+    state.clear();
+
+    assert(snapshot.is_key_pressed(0xE1));
+    assert(snapshot.is_key_pressed(0x04));
+    assert(snapshot.get_report()[0] == 0x02);
+    assert(snapshot.get_report()[2] == 0x04);
+    assert(state.get_pressed_key_count() == 0);
+    assert(!state.is_key_pressed(0x04));
+
+    std::cout << "PASSED\n";
+}
+
 void test_combined_modifiers_and_keys() {
     hid::KeyboardState state;
 
@@ -211,6 +308,31 @@ void test_dirty_flag() {
     std::cout << "PASSED\n";
 }
 
+void test_flat_usage_tables() {
+    // Lookups are usable in constant expressions
+    static_assert(hid::get_keyboard_usage(KEY_A) == std::uint8_t{0x04});
+    static_assert(hid::get_consumer_usage(KEY_VOLUMEUP) == std::uint16_t{0x00E9});
+    static_assert(!hid::get_keyboard_usage(KEY_VOLUMEUP));
+
+    // Every source row is reachable through the flat table
+    for (const auto& entry : hid::kKeyboardUsage) {
+        assert(hid::get_keyboard_usage(entry.linux_code) == entry.usage);
+    }
+    for (const auto& entry : hid::kConsumerUsage) {
+        assert(hid::get_consumer_usage(entry.linux_code) == entry.usage);
+    }
+
+    // Unmapped and out-of-range codes report nullopt
+    assert(!hid::get_keyboard_usage(KEY_RESERVED));
+    assert(!hid::get_keyboard_usage(-1));
+    assert(!hid::get_keyboard_usage(KEY_MAX + 1));
+    assert(!hid::get_consumer_usage(KEY_A));
+    assert(!hid::get_consumer_usage(-1));
+    assert(!hid::get_consumer_usage(KEY_MAX + 1));
+
+    std::cout << "PASSED\n";
+}
+
 }  // namespace
 
 int main() {
@@ -221,10 +343,14 @@ int main() {
         test_modifier_keys();
         test_regular_keys();
         test_key_rollover();
+        test_rollover_slot_promotion();
+        test_overflow_bitmap();
+        test_state_snapshot();
         test_combined_modifiers_and_keys();
         test_linux_key_mapping();
         test_state_clear();
         test_dirty_flag();
+        test_flat_usage_tables();
 
         std::cout << "\n=== All HID keycodes tests completed ===\n";
         return 0;
@@ -1,186 +1,265 @@
 /**
  * @file test_hotkey_detector.cpp
- * @brief Unit tests for exit hotkey detection functionality
+ * @brief Unit tests for hotkey chord matching and `--hotkeys` parsing
  * @author Dharun A P
  * @license SPDX-License-Identifier: Apache-2.0
  * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
  */
 
 #include <cassert>
+#include <string>
 
-#include "exit_hotkey_detector.hpp"
+#include "chord_matcher.hpp"
 #include "test_framework.hpp"
 
 namespace {
 
-void test_individual_keys() {
-    ExitHotkeyDetector detector;
-
-    // Test Ctrl key
-    bool exit_triggered = detector.process_key_event(KEY_LEFTCTRL, 1);  // Press
-    assert(!exit_triggered);
-    assert(detector.is_ctrl_pressed());
+/**
+ * @brief Keyboard state plus matcher, driven the way KeyEventProcessor drives them
+ */
+struct Keys {
+    hid::KeyboardState state;
+    hotkey::ChordMatcher matcher = hotkey::ChordMatcher::defaults();
+
+    hotkey::Action event(int code, int value) {
+        if (!hid::apply_key_event(state, code, value) || value != 1) {
+            return hotkey::Action::None;
+        }
+        return matcher.match(state, *hid::get_keyboard_usage(code));
+    }
+    hotkey::Action press(int code) { return event(code, 1); }
+    void release(int code) { event(code, 0); }
+};
+
+hotkey::ChordMatcher parsed(const std::string& spec) {
+    hotkey::ChordMatcher matcher = hotkey::ChordMatcher::defaults();
+    std::string error;
+    [[maybe_unused]] const bool ok = hotkey::parse_hotkeys(spec, matcher, error);
+    assert(ok && error.empty());
+    return matcher;
+}
 
-    exit_triggered = detector.process_key_event(KEY_LEFTCTRL, 0);  // Release
-    assert(!exit_triggered);
-    assert(!detector.is_ctrl_pressed());
+void test_individual_keys() {
+    Keys keys;
+    for (const int code : {KEY_LEFTCTRL, KEY_LEFTALT, KEY_H}) {
+        assert(keys.press(code) == hotkey::Action::None);
+        keys.release(code);
+    }
+}
 
-    // Test Alt key
-    exit_triggered = detector.process_key_event(KEY_LEFTALT, 1);  // Press
-    assert(!exit_triggered);
-    assert(detector.is_alt_pressed());
+void test_partial_combinations() {
+    Keys keys;
+    keys.press(KEY_LEFTCTRL);
+    keys.press(KEY_LEFTALT);
+    assert(keys.press(KEY_A) == hotkey::Action::None);  // 'A' instead of 'H'
 
-    exit_triggered = detector.process_key_event(KEY_LEFTALT, 0);  // Release
-    assert(!exit_triggered);
-    assert(!detector.is_alt_pressed());
+    Keys keys2;
+    keys2.press(KEY_LEFTCTRL);
+    assert(keys2.press(KEY_H) == hotkey::Action::None);  // No Alt
 
-    // Test H key
-    exit_triggered = detector.process_key_event(KEY_H, 1);  // Press
-    assert(!exit_triggered);
-    assert(detector.is_h_pressed());
+    Keys keys3;
+    keys3.press(KEY_LEFTALT);
+    assert(keys3.press(KEY_H) == hotkey::Action::None);  // No Ctrl
 
-    exit_triggered = detector.process_key_event(KEY_H, 0);  // Release
-    assert(!exit_triggered);
-    assert(!detector.is_h_pressed());
+    std::cout << "PASSED\n";
 }
 
-void test_partial_combinations() {
-    ExitHotkeyDetector detector;
-
-    // Test Ctrl+Alt (without H)
-    detector.process_key_event(KEY_LEFTCTRL, 1);
-    detector.process_key_event(KEY_LEFTALT, 1);
-    bool exit_triggered = detector.process_key_event(KEY_A, 1);  // Press 'A' instead of 'H'
-    assert(!exit_triggered);
-
-    // Test Ctrl+H (without Alt)
-    ExitHotkeyDetector detector2;
-    detector2.process_key_event(KEY_LEFTCTRL, 1);
-    exit_triggered = detector2.process_key_event(KEY_H, 1);
-    assert(!exit_triggered);
-
-    // Test Alt+H (without Ctrl)
-    ExitHotkeyDetector detector3;
-    detector3.process_key_event(KEY_LEFTALT, 1);
-    exit_triggered = detector3.process_key_event(KEY_H, 1);
-    assert(!exit_triggered);
+void test_full_combination() {
+    Keys keys;
+    assert(keys.press(KEY_LEFTCTRL) == hotkey::Action::None);
+    assert(keys.press(KEY_LEFTALT) == hotkey::Action::None);
+    assert(keys.press(KEY_H) == hotkey::Action::Exit);
 
     std::cout << "PASSED\n";
 }
 
-void test_full_combination() {
-    ExitHotkeyDetector detector;
-
-    // Press Ctrl first
-    bool exit_triggered = detector.process_key_event(KEY_LEFTCTRL, 1);
-    assert(!exit_triggered);
+void test_different_key_orders() {
+    Keys keys;
+    keys.press(KEY_LEFTALT);
+    keys.press(KEY_LEFTCTRL);
+    assert(keys.press(KEY_H) == hotkey::Action::Exit);
+
+    // H held before the modifiers: only a fresh press of H fires
+    Keys keys2;
+    keys2.press(KEY_H);
+    assert(keys2.press(KEY_LEFTCTRL) == hotkey::Action::None);
+    assert(keys2.press(KEY_LEFTALT) == hotkey::Action::None);
+    keys2.release(KEY_H);
+    assert(keys2.press(KEY_H) == hotkey::Action::Exit);
 
-    // Press Alt second
-    exit_triggered = detector.process_key_event(KEY_LEFTALT, 1);
-    assert(!exit_triggered);
+    std::cout << "PASSED\n";
+}
 
-    // Press H - should trigger exit
-    exit_triggered = detector.process_key_event(KEY_H, 1);
-    assert(exit_triggered);
+void test_right_side_modifiers() {
+    Keys keys;
+    keys.press(KEY_RIGHTCTRL);
+    keys.press(KEY_RIGHTALT);
+    assert(keys.press(KEY_H) == hotkey::Action::Exit);
 
     std::cout << "PASSED\n";
 }
 
-void test_different_key_orders() {
-    // Order: Alt, Ctrl, H
-    ExitHotkeyDetector detector1;
-    detector1.process_key_event(KEY_LEFTALT, 1);
-    detector1.process_key_event(KEY_LEFTCTRL, 1);
-    bool exit_triggered = detector1.process_key_event(KEY_H, 1);
-    assert(exit_triggered);
-
-    // Order: H, Ctrl, Alt (H pressed first, but no trigger until all are pressed)
-    ExitHotkeyDetector detector2;
-    detector2.process_key_event(KEY_H, 1);
-    assert(!detector2.process_key_event(KEY_LEFTCTRL, 1));
-    // At this point, H is already pressed, so when Alt is pressed,
-    // we need to simulate the H press again to trigger
-    detector2.process_key_event(KEY_LEFTALT, 1);
-    // The combination should not trigger because H was pressed before all modifiers
-    exit_triggered = detector2.process_key_event(KEY_H, 0);  // Release H
-    assert(!exit_triggered);
-    exit_triggered = detector2.process_key_event(KEY_H, 1);  // Press H again
-    assert(exit_triggered);
+void test_mixed_modifiers() {
+    Keys keys;
+    keys.press(KEY_LEFTCTRL);
+    keys.press(KEY_RIGHTALT);
+    assert(keys.press(KEY_H) == hotkey::Action::Exit);
+
+    // Extra modifiers do not prevent a match
+    Keys keys2;
+    keys2.press(KEY_LEFTCTRL);
+    keys2.press(KEY_LEFTALT);
+    keys2.press(KEY_LEFTSHIFT);
+    assert(keys2.press(KEY_H) == hotkey::Action::Exit);
 
     std::cout << "PASSED\n";
 }
 
-void test_right_side_modifiers() {
-    ExitHotkeyDetector detector;
+void test_key_release_behavior() {
+    Keys keys;
+    keys.press(KEY_LEFTCTRL);
+    keys.press(KEY_LEFTALT);
+    keys.press(KEY_H);
 
-    // Test with right Ctrl and right Alt
-    detector.process_key_event(KEY_RIGHTCTRL, 1);
-    detector.process_key_event(KEY_RIGHTALT, 1);
-    bool exit_triggered = detector.process_key_event(KEY_H, 1);
-    assert(exit_triggered);
+    keys.release(KEY_LEFTCTRL);
+    keys.release(KEY_H);
+    assert(keys.press(KEY_H) == hotkey::Action::None);  // Ctrl is released
 
     std::cout << "PASSED\n";
 }
 
-void test_mixed_modifiers() {
-    ExitHotkeyDetector detector;
-
-    // Test with left Ctrl and right Alt
-    detector.process_key_event(KEY_LEFTCTRL, 1);
-    detector.process_key_event(KEY_RIGHTALT, 1);
-    bool exit_triggered = detector.process_key_event(KEY_H, 1);
-    assert(exit_triggered);
+void test_key_repeat() {
+    Keys keys;
+    keys.press(KEY_LEFTCTRL);
+    keys.press(KEY_LEFTALT);
+    assert(keys.press(KEY_H) == hotkey::Action::Exit);
+    assert(keys.event(KEY_H, 2) == hotkey::Action::None);  // Auto-repeat
 
     std::cout << "PASSED\n";
 }
 
-void test_key_release_behavior() {
-    ExitHotkeyDetector detector;
+void test_multiple_chords() {
+    Keys keys;
+    keys.matcher = parsed("next-target=ctrl+alt+n,grab=ctrl+alt+g,metrics=meta+m,local=ctrl+alt+l");
+    keys.press(KEY_LEFTCTRL);
+    keys.press(KEY_RIGHTALT);
+    assert(keys.press(KEY_N) == hotkey::Action::NextTarget);
+    assert(keys.press(KEY_G) == hotkey::Action::ToggleGrab);
+    assert(keys.press(KEY_L) == hotkey::Action::ToggleLocal);
+    assert(keys.press(KEY_H) == hotkey::Action::Exit);
+    assert(keys.press(KEY_M) == hotkey::Action::None);  // Needs Meta
+
+    Keys keys2;
+    keys2.matcher = keys.matcher;
+    keys2.press(KEY_RIGHTMETA);
+    assert(keys2.press(KEY_M) == hotkey::Action::DumpMetrics);
 
-    // Set up the combination
-    detector.process_key_event(KEY_LEFTCTRL, 1);
-    detector.process_key_event(KEY_LEFTALT, 1);
-    detector.process_key_event(KEY_H, 1);
+    std::cout << "PASSED\n";
+}
 
-    // Release one key
-    detector.process_key_event(KEY_LEFTCTRL, 0);
+void test_multi_key_chord() {
+    Keys keys;
+    keys.matcher = parsed("grab=ctrl+g+b");
+    keys.press(KEY_LEFTCTRL);
+    assert(keys.press(KEY_G) == hotkey::Action::None);
+    assert(keys.press(KEY_B) == hotkey::Action::ToggleGrab);  // Completed by its last key
 
-    // Pressing H again should not trigger (Ctrl is released)
-    bool exit_triggered = detector.process_key_event(KEY_H, 0);  // Release
-    exit_triggered = detector.process_key_event(KEY_H, 1);       // Press again
-    assert(!exit_triggered);
+    Keys keys2;
+    keys2.matcher = keys.matcher;
+    keys2.press(KEY_LEFTCTRL);
+    keys2.press(KEY_B);
+    assert(keys2.press(KEY_G) == hotkey::Action::ToggleGrab);  // Any order
 
     std::cout << "PASSED\n";
 }
 
-void test_state_description() {
-    ExitHotkeyDetector detector;
+void test_bind_and_unbind() {
+    hotkey::ChordMatcher matcher = parsed("exit=ctrl+alt+q,grab=ctrl+alt+g");
+    const hotkey::Chord* exit = matcher.chord(hotkey::Action::Exit);
+    assert(exit != nullptr);
+    assert(hotkey::describe(*exit) == "Ctrl+Alt+Q");  // Replaced, not added
+
+    Keys keys;
+    keys.matcher = matcher;
+    keys.press(KEY_LEFTCTRL);
+    keys.press(KEY_LEFTALT);
+    assert(keys.press(KEY_H) == hotkey::Action::None);
+    assert(keys.press(KEY_Q) == hotkey::Action::Exit);
+
+    matcher.unbind(hotkey::Action::ToggleGrab);
+    assert(matcher.chord(hotkey::Action::ToggleGrab) == nullptr);
+    assert(matcher.chord(hotkey::Action::Exit) != nullptr);
+    keys.matcher = matcher;
+    assert(keys.press(KEY_G) == hotkey::Action::None);
+
+    hotkey::Chord empty;
+    empty.action = hotkey::Action::NextTarget;
+    empty.modifiers = hotkey::MOD_CTRL;
+    assert(!matcher.bind(empty));  // Modifiers alone are not a chord
+
+    std::cout << "PASSED\n";
+}
 
-    std::string state = detector.get_state_description();
-    assert(state.find("Ctrl: OFF") != std::string::npos);
-    assert(state.find("Alt: OFF") != std::string::npos);
-    assert(state.find("H: OFF") != std::string::npos);
+void test_parse_errors() {
+    for (const char* spec : {"grab", "jump=ctrl+j", "grab=ctrl+", "grab=ctrl+alt",
+                             "grab=ctrl+nosuchkey", "exit=none", "grab=ctrl+g,"}) {
+        hotkey::ChordMatcher matcher = hotkey::ChordMatcher::defaults();
+        std::string error;
+        assert(!hotkey::parse_hotkeys(spec, matcher, error));
+        assert(!error.empty());
+    }
 
-    detector.process_key_event(KEY_LEFTCTRL, 1);
-    state = detector.get_state_description();
-    assert(state.find("Ctrl: ON") != std::string::npos);
-    assert(state.find("Alt: OFF") != std::string::npos);
+    hotkey::ChordMatcher matcher = parsed("GRAB=Ctrl+Alt+G,grab=none");
+    assert(matcher.chord(hotkey::Action::ToggleGrab) == nullptr);
 
     std::cout << "PASSED\n";
 }
 
-void test_key_repeat() {
-    ExitHotkeyDetector detector;
+void test_link_chords() {
+    // One link: Ctrl+Alt+digit is an ordinary shortcut on the host
+    Keys single;
+    single.press(KEY_LEFTCTRL);
+    single.press(KEY_LEFTALT);
+    assert(single.press(KEY_1) == hotkey::Action::None);
+    assert(single.press(KEY_0) == hotkey::Action::None);
+
+    // Several links: Ctrl+Alt+1 ... Ctrl+Alt+<links> and Ctrl+Alt+0 by default
+    Keys keys;
+    keys.matcher = hotkey::ChordMatcher::defaults(3);
+    keys.press(KEY_RIGHTCTRL);
+    keys.press(KEY_LEFTALT);
+    assert(keys.press(KEY_1) == hotkey::Action::ToggleLink1);
+    assert(keys.press(KEY_3) == hotkey::Action::ToggleLink3);
+    assert(keys.press(KEY_4) == hotkey::Action::None);  // No fourth link
+    assert(keys.press(KEY_0) == hotkey::Action::AllLinks);
+    assert(keys.press(KEY_H) == hotkey::Action::Exit);
+    assert(hotkey::toggled_link(hotkey::Action::ToggleLink3) == 2);
+    assert(!hotkey::toggled_link(hotkey::Action::AllLinks));
+    assert(hotkey::action_name(hotkey::toggle_link_action(8)) == "link-9");
+
+    // --hotkeys rebinds or removes them
+    hotkey::ChordMatcher matcher = hotkey::ChordMatcher::defaults(3);
+    std::string error;
+    assert(hotkey::parse_hotkeys("link-2=meta+f2,link-1=none,all-links=none", matcher, error));
+    Keys rebound;
+    rebound.matcher = matcher;
+    rebound.press(KEY_LEFTCTRL);
+    rebound.press(KEY_LEFTALT);
+    assert(rebound.press(KEY_1) == hotkey::Action::None);
+    assert(rebound.press(KEY_2) == hotkey::Action::None);
+    assert(rebound.press(KEY_3) == hotkey::Action::ToggleLink3);
+    assert(rebound.press(KEY_0) == hotkey::Action::None);
+    rebound.press(KEY_LEFTMETA);
+    assert(rebound.press(KEY_F2) == hotkey::Action::ToggleLink2);
 
-    // Set up the combination
-    detector.process_key_event(KEY_LEFTCTRL, 1);
-    detector.process_key_event(KEY_LEFTALT, 1);
-    bool exit_triggered = detector.process_key_event(KEY_H, 1);
-    assert(exit_triggered);
+    std::cout << "PASSED\n";
+}
 
-    // Test auto-repeat (value 2) - should not trigger again
-    exit_triggered = detector.process_key_event(KEY_H, 2);
-    assert(!exit_triggered);
+void test_describe() {
+    assert(hotkey::describe(*hotkey::ChordMatcher::defaults().chord(hotkey::Action::Exit)) ==
+           "Ctrl+Alt+H");
+    const hotkey::ChordMatcher matcher = parsed("metrics=rightshift+super+f12");
+    assert(hotkey::describe(*matcher.chord(hotkey::Action::DumpMetrics)) == "Shift+Meta+F12");
 
     std::cout << "PASSED\n";
 }
@@ -188,14 +267,19 @@ void test_key_repeat() {
 }  // namespace
 
 int main() {
-    return test_framework::run_test_suite("Exit Hotkey Detector Unit Tests",
-                                          {{"individual key tracking", test_individual_keys},
+    return test_framework::run_test_suite("Hotkey Chord Matcher Unit Tests",
+                                          {{"individual keys", test_individual_keys},
                                            {"partial combinations", test_partial_combinations},
                                            {"full combination", test_full_combination},
                                            {"different key orders", test_different_key_orders},
                                            {"right side modifiers", test_right_side_modifiers},
                                            {"mixed modifiers", test_mixed_modifiers},
                                            {"key release behavior", test_key_release_behavior},
-                                           {"state description", test_state_description},
-                                           {"key repeat", test_key_repeat}});
+                                           {"key repeat", test_key_repeat},
+                                           {"multiple chords", test_multiple_chords},
+                                           {"multi-key chord", test_multi_key_chord},
+                                           {"bind and unbind", test_bind_and_unbind},
+                                           {"parse errors", test_parse_errors},
+                                           {"link chords", test_link_chords},
+                                           {"describe", test_describe}});
 }
@@ -0,0 +1,78 @@
+/**
+ * @file test_idle_governor.cpp
+ * @brief Unit tests for the idle power-save governor
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include <cassert>
+#include <chrono>
+
+#include "idle_governor.hpp"
+#include "test_framework.hpp"
+
+namespace {
+
+using ble::IdleGovernor;
+using Clock = IdleGovernor::Clock;
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+
+void test_starts_active() {
+    const Clock::time_point t0{};
+    IdleGovernor idle(seconds(30), t0);
+    assert(!idle.idle());
+    assert(idle.timeout() == seconds(30));
+    assert(!idle.on_activity(t0 + seconds(1)));  // Activity while active is no wake-up
+    assert(idle.wakes() == 0 && idle.idle_entered() == 0);
+}
+
+void test_poll_returns_time_left() {
+    const Clock::time_point t0{};
+    IdleGovernor idle(seconds(30), t0);
+    const auto wait = idle.poll(t0 + seconds(10));
+    assert(wait && *wait == seconds(20));
+
+    // Activity pushes the deadline out without touching a timer
+    idle.on_activity(t0 + seconds(25));
+    const auto later = idle.poll(t0 + seconds(30));
+    assert(later && *later == seconds(25));
+    assert(!idle.idle());
+}
+
+void test_enters_idle_once() {
+    const Clock::time_point t0{};
+    IdleGovernor idle(seconds(30), t0);
+    assert(!idle.poll(t0 + seconds(30)));
+    assert(idle.idle());
+    assert(idle.idle_entered() == 1);
+
+    assert(!idle.poll(t0 + seconds(90)));  // Already idle
+    assert(idle.idle_entered() == 1);
+}
+
+void test_first_key_wakes() {
+    const Clock::time_point t0{};
+    IdleGovernor idle(seconds(30), t0);
+    [[maybe_unused]] const auto entered = idle.poll(t0 + seconds(45));
+
+    assert(idle.on_activity(t0 + seconds(60)));
+    assert(!idle.idle());
+    assert(idle.wakes() == 1);
+    assert(!idle.on_activity(t0 + seconds(60) + milliseconds(8)));  // Only the first key
+
+    // The next idle period counts from the latest key
+    const auto wait = idle.poll(t0 + seconds(61));
+    assert(wait && *wait == seconds(29) + milliseconds(8));
+}
+
+}  // namespace
+
+int main() {
+    return test_framework::run_test_suite(
+        "Idle Governor Tests", {{"starts active", test_starts_active},
+                                {"poll returns time left", test_poll_returns_time_left},
+                                {"enters idle once", test_enters_idle_once},
+                                {"first key wakes", test_first_key_wakes}});
+}
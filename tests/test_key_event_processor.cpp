@@ -0,0 +1,295 @@
+/**
+ * @file test_key_event_processor.cpp
+ * @brief Unit tests for EV_KEY to HID report conversion
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include <cassert>
+#include <vector>
+
+#include "key_event_processor.hpp"
+#include "latency_tracker.hpp"
+#include "test_framework.hpp"
+
+namespace {
+
+input_event key(int code, int value) {
+    input_event ev{};
+    ev.type = EV_KEY;
+    ev.code = static_cast<decltype(ev.code)>(code);
+    ev.value = value;
+    return ev;
+}
+
+struct Capture {
+    std::vector<pipeline::Report> reports;
+    pipeline::KeyEventProcessor processor{
+        [this](const pipeline::Report& report) { reports.push_back(report); }};
+};
+
+void test_press_sends_report() {
+    Capture c;
+    assert(c.processor.process(key(KEY_A, 1), "test") == hotkey::Action::None);
+
+    assert(c.reports.size() == 1);
+    assert(c.reports[0][0] == 0);
+    assert(c.reports[0][2] == 0x04);  // 'A'
+}
+
+input_event syn_report() {
+    input_event ev{};
+    ev.type = EV_SYN;
+    ev.code = SYN_REPORT;
+    return ev;
+}
+
+void test_release_sends_remaining_state() {
+    Capture c;
+    c.processor.process(key(KEY_LEFTSHIFT, 1), "test");
+    c.processor.process(key(KEY_A, 1), "test");
+    c.processor.process(key(KEY_A, 0), "test");
+
+    // Shift is still held, so the release report keeps the modifier
+    assert(c.reports.size() == 3);
+    assert(c.reports[1][0] == 0x02 && c.reports[1][2] == 0x04);  // Shift+A
+    assert(c.reports[2][0] == 0x02 && c.reports[2][2] == 0);     // Shift only
+
+    c.processor.process(key(KEY_LEFTSHIFT, 0), "test");
+    assert(c.reports.size() == 4);
+    assert(c.reports[3] == pipeline::Report{});
+}
+
+void test_duplicates_suppressed() {
+    Capture c;
+    c.processor.process(key(KEY_A, 1), "test");
+    c.processor.process(key(KEY_A, 2), "test");  // Auto-repeat: unchanged
+    c.processor.process(key(KEY_A, 2), "test");
+    c.processor.process(key(KEY_B, 0), "test");  // Release of a key that was never pressed
+
+    assert(c.reports.size() == 1);
+    assert(c.processor.reports_sent() == 1);
+    assert(c.processor.reports_suppressed() == 3);
+}
+
+void test_coalesced_frames() {
+    std::vector<pipeline::Report> reports;
+    pipeline::KeyEventProcessor processor(
+        [&reports](const pipeline::Report& report) { reports.push_back(report); }, false, true);
+
+    // Chord delivered in one frame produces one report at SYN_REPORT
+    processor.process(key(KEY_LEFTCTRL, 1), "test");
+    processor.process(key(KEY_C, 1), "test");
+    assert(reports.empty());
+    processor.process(syn_report(), "test");
+    assert(reports.size() == 1);
+    assert(reports[0][0] == 0x01 && reports[0][2] == 0x06);  // Ctrl+C
+
+    // Frame without state change (SYN only or auto-repeat) sends nothing
+    processor.process(syn_report(), "test");
+    processor.process(key(KEY_C, 2), "test");
+    processor.process(syn_report(), "test");
+    assert(reports.size() == 1);
+
+    // Press and release inside one frame collapse into the final state
+    processor.process(key(KEY_C, 0), "test");
+    processor.process(key(KEY_LEFTCTRL, 0), "test");
+    processor.process(syn_report(), "test");
+    assert(reports.size() == 2);
+    assert(reports[1] == pipeline::Report{});
+}
+
+void test_consumer_reports() {
+    Capture c;
+    c.processor.process(key(KEY_VOLUMEUP, 1), "test");
+    c.processor.process(key(KEY_VOLUMEUP, 2), "test");  // Auto-repeat: unchanged
+    assert(c.reports.size() == 1);
+    assert(c.reports[0].is_consumer() && c.reports[0].consumer_usage() == 0x00E9);
+
+    // The keyboard report is independent of the held media key
+    c.processor.process(key(KEY_A, 1), "test");
+    assert(c.reports.size() == 2);
+    assert(!c.reports[1].is_consumer() && c.reports[1][2] == 0x04);
+
+    // The latest media key wins; releasing the older one changes nothing
+    c.processor.process(key(KEY_MUTE, 1), "test");
+    c.processor.process(key(KEY_VOLUMEUP, 0), "test");
+    assert(c.reports.size() == 3);
+    assert(c.reports[2].consumer_usage() == 0x00E2);
+
+    c.processor.process(key(KEY_MUTE, 0), "test");
+    assert(c.reports.size() == 4);
+    assert(c.reports[3] == pipeline::Report::consumer(0));
+    assert(c.processor.consumer_usage() == 0);
+}
+
+void test_keys_beyond_six() {
+    Capture c;
+    const int codes[] = {KEY_A, KEY_S, KEY_D, KEY_F, KEY_G, KEY_H, KEY_J};
+    for (const int code : codes) {
+        c.processor.process(key(code, 1), "test");
+    }
+
+    // The seventh key does not change the boot bytes but is carried as overflow
+    assert(c.reports.size() == 7);
+    assert(c.reports[6].bytes == c.reports[5].bytes);
+    assert(c.reports[6].overflow[0x0D / 8] == (1U << (0x0D % 8)));  // 'J'
+    assert(c.reports[6].nkro()[1 + 0x04 / 8] & (1U << (0x04 % 8)));  // 'A' in the bitmap
+}
+
+void test_coalesced_consumer_frame() {
+    std::vector<pipeline::Report> reports;
+    pipeline::KeyEventProcessor processor(
+        [&reports](const pipeline::Report& report) { reports.push_back(report); }, false, true);
+
+    // A frame with a key and a media key sends both reports at SYN_REPORT
+    processor.process(key(KEY_LEFTSHIFT, 1), "test");
+    processor.process(key(KEY_PLAYPAUSE, 1), "test");
+    assert(reports.empty());
+    processor.process(syn_report(), "test");
+    assert(reports.size() == 2);
+    assert(!reports[0].is_consumer() && reports[0][0] == 0x02);
+    assert(reports[1].is_consumer() && reports[1].consumer_usage() == 0x00CD);
+
+    // A media-key-only frame sends only the consumer report
+    processor.process(key(KEY_PLAYPAUSE, 0), "test");
+    processor.process(syn_report(), "test");
+    assert(reports.size() == 3);
+    assert(reports[2] == pipeline::Report::consumer(0));
+}
+
+void test_non_key_events_ignored() {
+    Capture c;
+    assert(c.processor.process(syn_report(), "test") == hotkey::Action::None);
+
+    input_event unmapped = key(KEY_PROG1, 1);
+    assert(c.processor.process(unmapped, "test") == hotkey::Action::None);
+
+    assert(c.reports.empty());
+}
+
+void test_exit_hotkey() {
+    Capture c;
+    assert(c.processor.process(key(KEY_LEFTCTRL, 1), "test") == hotkey::Action::None);
+    assert(c.processor.process(key(KEY_LEFTALT, 1), "test") == hotkey::Action::None);
+    assert(c.processor.process(key(KEY_H, 1), "test") == hotkey::Action::Exit);
+
+    // Final report releases everything on the host
+    assert(!c.reports.empty());
+    assert(c.reports.back() == pipeline::Report{});
+    assert(c.processor.state().get_modifiers() == 0);
+}
+
+void test_exit_hotkey_releases_media_key() {
+    Capture c;
+    c.processor.process(key(KEY_VOLUMEDOWN, 1), "test");
+    c.processor.process(key(KEY_LEFTCTRL, 1), "test");
+    c.processor.process(key(KEY_LEFTALT, 1), "test");
+    assert(c.processor.process(key(KEY_H, 1), "test") == hotkey::Action::Exit);
+
+    assert(c.reports.size() >= 2);
+    assert(c.reports[c.reports.size() - 2] == pipeline::Report{});
+    assert(c.reports.back() == pipeline::Report::consumer(0));
+}
+
+hotkey::ChordMatcher grab_chord() {
+    hotkey::ChordMatcher chords = hotkey::ChordMatcher::defaults();
+    hotkey::Chord grab;
+    grab.action = hotkey::Action::ToggleGrab;
+    grab.modifiers = hotkey::MOD_CTRL | hotkey::MOD_ALT;
+    grab.add_key(0x0A);  // 'G'
+    chords.bind(grab);
+    return chords;
+}
+
+void test_action_hotkey_swallowed() {
+    Capture c;
+    c.processor.set_chords(grab_chord());
+    c.processor.process(key(KEY_LEFTCTRL, 1), "test");
+    c.processor.process(key(KEY_LEFTALT, 1), "test");
+    const std::size_t before = c.reports.size();
+    assert(c.processor.process(key(KEY_G, 1), "test") == hotkey::Action::ToggleGrab);
+
+    // Neither the chord key nor its repeat and release reach the host
+    assert(c.processor.process(key(KEY_G, 2), "test") == hotkey::Action::None);
+    assert(c.processor.process(key(KEY_G, 0), "test") == hotkey::Action::None);
+    assert(c.reports.size() == before);
+    assert(!c.processor.state().is_key_pressed(0x0A));  // 'G'
+
+    // The modifiers stay held and the next key is sent as usual
+    c.processor.process(key(KEY_A, 1), "test");
+    assert(c.reports.back()[0] == 0x05);  // Left Ctrl + Left Alt
+    assert(c.reports.back()[2] == 0x04);
+}
+
+void test_paused_holds_reports() {
+    Capture c;
+    c.processor.process(key(KEY_A, 1), "test");
+    c.processor.set_paused(true);
+    assert(c.processor.paused());
+    assert(c.reports.back() == pipeline::Report{});  // Released on the host
+
+    const std::size_t before = c.reports.size();
+    c.processor.process(key(KEY_B, 1), "test");
+    assert(c.reports.size() == before);
+
+    // Hotkeys still fire while paused
+    c.processor.process(key(KEY_LEFTCTRL, 1), "test");
+    c.processor.process(key(KEY_LEFTALT, 1), "test");
+    c.processor.set_paused(false);
+    assert(c.reports.back()[0] == 0x05);
+    assert(c.reports.back()[2] == 0x04 && c.reports.back()[3] == 0x05);  // 'A', 'B'
+    c.processor.set_paused(true);
+    assert(c.processor.process(key(KEY_H, 1), "test") == hotkey::Action::Exit);
+}
+
+void test_latency_timing() {
+    pipeline::LatencyTracker latency;
+    std::vector<pipeline::ReportTiming> timings;
+    pipeline::KeyEventProcessor* self = nullptr;
+    pipeline::KeyEventProcessor processor(
+        [&](const pipeline::Report&) { timings.push_back(self->last_timing()); }, false, true);
+    self = &processor;
+    processor.set_latency_tracker(&latency);
+
+    // A coalesced frame is as old as its first key change
+    processor.process(key(KEY_LEFTCTRL, 1), "test", {1000, 2000, 0, 0});
+    processor.process(key(KEY_C, 1), "test", {5000, 6000, 0, 0});
+    processor.process(syn_report(), "test", {5000, 7000, 0, 0});
+    assert(timings.size() == 1);
+    assert(timings[0].event_ns == 1000 && timings[0].read_ns == 2000);
+    assert(timings[0].built_ns >= timings[0].read_ns);  // Stamped with the monotonic clock
+    assert(latency.total(pipeline::LatencyStage::KernelToRead).count() == 1);
+
+    // Unchanged frames record nothing; untimed events are not measured
+    processor.process(syn_report(), "test", {8000, 9000, 0, 0});
+    processor.process(key(KEY_C, 0), "test");
+    processor.process(syn_report(), "test");
+    assert(timings.size() == 2);
+    assert(timings[1].event_ns == 0);
+    assert(latency.total(pipeline::LatencyStage::ReadToReport).count() == 1);
+}
+
+}  // namespace
+
+int main() {
+    return test_framework::run_test_suite("Key Event Processor Unit Tests",
+                                          {{"press sends report", test_press_sends_report},
+                                           {"release sends remaining state",
+                                            test_release_sends_remaining_state},
+                                           {"duplicates suppressed", test_duplicates_suppressed},
+                                           {"coalesced frames", test_coalesced_frames},
+                                           {"consumer reports", test_consumer_reports},
+                                           {"keys beyond six", test_keys_beyond_six},
+                                           {"coalesced consumer frame",
+                                            test_coalesced_consumer_frame},
+                                           {"non-key events ignored", test_non_key_events_ignored},
+                                           {"exit hotkey", test_exit_hotkey},
+                                           {"exit hotkey releases media key",
+                                            test_exit_hotkey_releases_media_key},
+                                           {"action hotkey swallowed",
+                                            test_action_hotkey_swallowed},
+                                           {"paused holds reports", test_paused_holds_reports},
+                                           {"latency timing", test_latency_timing}});
+}
@@ -0,0 +1,248 @@
+/**
+ * @file test_keymap.cpp
+ * @brief Unit tests for keymap parsing, compiled tables and the remapper
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include <cassert>
+#include <sstream>
+#include <string>
+
+#include "keymap.hpp"
+#include "test_framework.hpp"
+
+namespace {
+
+using keymap::Keymap;
+using keymap::KeyboardMatch;
+
+Keymap parse(const std::string& text) {
+    std::istringstream in(text);
+    std::string error;
+    auto keymap = keymap::parse_keymap(in, error);
+    assert(keymap.has_value());
+    assert(error.empty());
+    return std::move(*keymap);
+}
+
+std::string parse_error(const std::string& text) {
+    std::istringstream in(text);
+    std::string error;
+    assert(!keymap::parse_keymap(in, error).has_value());
+    return error;
+}
+
+input_event key(std::uint16_t code, std::int32_t value) {
+    input_event ev{};
+    ev.type = EV_KEY;
+    ev.code = code;
+    ev.value = value;
+    return ev;
+}
+
+//! @brief Remap one key event; returns its code, or 0 if dropped
+std::uint16_t send(keymap::Remapper& remapper, std::uint16_t code, std::int32_t value) {
+    input_event ev = key(code, value);
+    return remapper.remap(ev) ? ev.code : 0;
+}
+
+void test_base_bindings() {
+    const Keymap keymap = parse("# Global bindings\n"
+                                "CAPSLOCK = LEFTCTRL\n"
+                                "key_insert = none   # disabled\n"
+                                "30 = KEY_B\n");
+    assert(keymap.sections.size() == 1);
+    const auto& section = keymap.sections[0];
+    assert(section.match.kind == KeyboardMatch::Kind::Any);
+    assert(section.keymap.layers.size() == 1);
+    const keymap::Table& base = section.keymap.layers[0];
+    assert(base[KEY_CAPSLOCK] == KEY_LEFTCTRL);
+    assert(base[KEY_INSERT] == 0);
+    assert(base[KEY_A] == KEY_B);
+    assert(base[KEY_Z] == KEY_Z);  // Unbound keys pass through
+    assert(base[KEY_FN] == KEY_FN);
+}
+
+void test_empty_keymap() {
+    const Keymap keymap = parse("\n# nothing\n");
+    assert(keymap.sections.empty());
+    assert(keymap.for_device("kbd", "/dev/input/event3") == nullptr);
+}
+
+void test_layers() {
+    const Keymap keymap = parse("layer nav = RIGHTALT\n"
+                                "nav H = LEFT\n"
+                                "NAV j = DOWN\n"
+                                "H = G\n");
+    const auto& tables = keymap.sections[0].keymap;
+    assert(tables.layers.size() == 2);
+    assert(tables.layer_names[1] == "nav");
+    assert(tables.layers[0][KEY_RIGHTALT] == (keymap::LAYER_FLAG | 1));
+    assert(tables.layers[1][KEY_RIGHTALT] == (keymap::LAYER_FLAG | 1));
+    assert(tables.layers[0][KEY_H] == KEY_G);
+    assert(tables.layers[1][KEY_H] == KEY_LEFT);  // Layer binding wins over the base one
+    assert(tables.layers[1][KEY_J] == KEY_DOWN);
+    assert(tables.layers[1][KEY_K] == KEY_K);     // Falls through to the base layer
+}
+
+void test_sections() {
+    const Keymap keymap = parse("CAPSLOCK = ESC\n"
+                                "layer fn = RIGHTCTRL\n"
+                                "fn 1 = F1\n"
+                                "[keyboard Keychron K2]\n"
+                                "CAPSLOCK = LEFTCTRL\n"
+                                "fn 2 = F2\n"
+                                "[keyboard /dev/input/event7]\n"
+                                "LEFTMETA = LEFTALT\n");
+    assert(keymap.sections.size() == 3);
+
+    const auto& named = keymap.sections[1];
+    assert(named.match.kind == KeyboardMatch::Kind::Name);
+    assert(named.match.value == "Keychron K2");
+    assert(named.keymap.layers[0][KEY_CAPSLOCK] == KEY_LEFTCTRL);  // Overrides the global line
+    assert(named.keymap.layers[1][KEY_1] == KEY_F1);               // Inherits the global layer
+    assert(named.keymap.layers[1][KEY_2] == KEY_F2);
+
+    const auto& by_path = keymap.sections[2];
+    assert(by_path.match.kind == KeyboardMatch::Kind::Path);
+    assert(by_path.keymap.layers[0][KEY_CAPSLOCK] == KEY_ESC);
+    assert(by_path.keymap.layers[0][KEY_LEFTMETA] == KEY_LEFTALT);
+
+    // The global section does not see the per-keyboard lines
+    assert(keymap.sections[0].keymap.layers[1][KEY_2] == KEY_2);
+}
+
+void test_for_device() {
+    const Keymap keymap = parse("A = B\n"
+                                "[keyboard Keychron K2]\n"
+                                "A = C\n"
+                                "[keyboard /dev/input/event7]\n"
+                                "A = D\n");
+    assert(keymap.for_device("Other", "/dev/input/event1") == &keymap.sections[0]);
+    assert(keymap.for_device("Keychron K2", "/dev/input/event1") == &keymap.sections[1]);
+    // A path section wins over a name section
+    assert(keymap.for_device("Keychron K2", "/dev/input/event7") == &keymap.sections[2]);
+
+    const Keymap named_only = parse("[keyboard Keychron K2]\nA = C\n");
+    assert(named_only.for_device("Other", "/dev/input/event1") == nullptr);
+}
+
+void test_errors() {
+    assert(parse_error("A = B\nA = NOSUCHKEY\n") == "line 2: unknown key 'NOSUCHKEY'");
+    assert(parse_error("A\n") == "line 1: expected KEY = KEY");
+    assert(parse_error("\n\nnav H = LEFT\n").rfind("line 3: unknown layer 'nav'", 0) == 0);
+    assert(parse_error("[keyboard Foo\n") == "line 1: unterminated section header");
+    assert(parse_error("[mouse Foo]\n").rfind("line 1: expected [keyboard", 0) == 0);
+    assert(parse_error("A = B C\n").rfind("line 1: expected", 0) == 0);
+    assert(parse_error("layer base = RIGHTALT\n").rfind("line 1: ", 0) == 0);
+    assert(parse_error("99999 = A\n") == "line 1: unknown key '99999'");
+
+    std::string many;
+    for (std::size_t i = 1; i < keymap::MAX_LAYERS; ++i) {
+        many += "layer l" + std::to_string(i) + " = F" + std::to_string(i) + "\n";
+    }
+    parse(many);
+    assert(parse_error(many + "layer extra = F12\n").rfind("line 8: more than 7 layers", 0) == 0);
+
+    std::string error;
+    assert(!keymap::load_keymap("/nonexistent/keymap", error).has_value());
+    assert(error == "cannot open /nonexistent/keymap");
+}
+
+void test_remapper_unmapped() {
+    keymap::Remapper remapper;
+    assert(!remapper.update(nullptr, "kbd", "/dev/input/event1"));
+    assert(send(remapper, KEY_A, 1) == KEY_A);
+
+    const Keymap keymap = parse("[keyboard Other]\nA = B\n");
+    assert(remapper.update(&keymap, "kbd", "/dev/input/event1"));
+    assert(remapper.keymap() == nullptr);
+    assert(send(remapper, KEY_A, 1) == KEY_A);
+    assert(send(remapper, KEY_A, 0) == KEY_A);
+
+    input_event syn{};
+    syn.type = EV_SYN;
+    assert(remapper.remap(syn));
+}
+
+void test_remapper_layers() {
+    const Keymap keymap = parse("CAPSLOCK = LEFTCTRL\n"
+                                "INSERT = NONE\n"
+                                "layer nav = RIGHTALT\n"
+                                "nav H = LEFT\n");
+    keymap::Remapper remapper;
+    assert(remapper.update(&keymap, "kbd", "/dev/input/event1"));
+    assert(!remapper.update(&keymap, "kbd", "/dev/input/event1"));  // Unchanged
+
+    assert(send(remapper, KEY_CAPSLOCK, 1) == KEY_LEFTCTRL);
+    assert(send(remapper, KEY_CAPSLOCK, 2) == KEY_LEFTCTRL);
+    assert(send(remapper, KEY_CAPSLOCK, 0) == KEY_LEFTCTRL);
+    assert(send(remapper, KEY_INSERT, 1) == 0);
+    assert(send(remapper, KEY_INSERT, 0) == 0);
+
+    assert(send(remapper, KEY_H, 1) == KEY_H);
+    assert(send(remapper, KEY_H, 0) == KEY_H);
+    assert(send(remapper, KEY_RIGHTALT, 1) == 0);  // Layer keys are not sent
+    assert(send(remapper, KEY_H, 1) == KEY_LEFT);
+    assert(send(remapper, KEY_RIGHTALT, 2) == 0);  // Repeat keeps the layer
+    assert(send(remapper, KEY_H, 2) == KEY_LEFT);
+    assert(send(remapper, KEY_RIGHTALT, 0) == 0);
+    assert(send(remapper, KEY_H, 0) == KEY_LEFT);  // Released as pressed
+    assert(send(remapper, KEY_H, 1) == KEY_H);     // Base layer again
+    assert(send(remapper, KEY_H, 0) == KEY_H);
+}
+
+void test_remapper_reload_while_held() {
+    const Keymap first = parse("A = B\n");
+    const Keymap second = parse("A = C\n");
+    keymap::Remapper remapper;
+    remapper.update(&first, "kbd", "/dev/input/event1");
+    assert(send(remapper, KEY_A, 1) == KEY_B);
+
+    assert(remapper.update(&second, "kbd", "/dev/input/event1"));
+    assert(send(remapper, KEY_A, 2) == KEY_B);  // Still held as B
+    assert(send(remapper, KEY_A, 0) == KEY_B);
+    assert(send(remapper, KEY_A, 1) == KEY_C);
+    assert(send(remapper, KEY_A, 0) == KEY_C);
+
+    // A held layer key is let go of cleanly after a reload without layers
+    const Keymap layered = parse("layer nav = RIGHTALT\nnav H = LEFT\n");
+    remapper.update(&layered, "kbd", "/dev/input/event1");
+    assert(send(remapper, KEY_RIGHTALT, 1) == 0);
+    remapper.update(&first, "kbd", "/dev/input/event1");
+    assert(send(remapper, KEY_RIGHTALT, 0) == 0);
+    assert(send(remapper, KEY_H, 1) == KEY_H);
+}
+
+void test_store_publish() {
+    keymap::KeymapStore store;
+    assert(store.current() == nullptr);
+    store.publish(parse("A = B\n"));
+    const Keymap* first = store.current();
+    assert(first && first->sections[0].keymap.layers[0][KEY_A] == KEY_B);
+
+    store.publish(parse("A = C\n"));
+    const Keymap* second = store.current();
+    assert(second != first);
+    assert(second->sections[0].keymap.layers[0][KEY_A] == KEY_C);
+    assert(first->sections[0].keymap.layers[0][KEY_A] == KEY_B);  // Still readable
+}
+
+}  // namespace
+
+int main() {
+    return test_framework::run_test_suite(
+        "Keymap Tests",
+        {{"base bindings", test_base_bindings},
+         {"empty keymap", test_empty_keymap},
+         {"layers", test_layers},
+         {"sections", test_sections},
+         {"for device", test_for_device},
+         {"errors", test_errors},
+         {"remapper unmapped", test_remapper_unmapped},
+         {"remapper layers", test_remapper_layers},
+         {"remapper reload while held", test_remapper_reload_while_held},
+         {"store publish", test_store_publish}});
+}
@@ -0,0 +1,207 @@
+/**
+ * @file test_latency_tracker.cpp
+ * @brief Unit tests for the latency histograms and the per-keyboard tracker
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "latency_histogram.hpp"
+#include "latency_tracker.hpp"
+#include "logger.hpp"
+#include "test_framework.hpp"
+
+namespace {
+
+using pipeline::LatencyHistogram;
+using pipeline::LatencyStage;
+using pipeline::LatencyTracker;
+using pipeline::ReportTiming;
+
+void test_bucket_mapping() {
+    // Exact below 64 ns
+    for (std::uint64_t v = 0; v < LatencyHistogram::SUB_BUCKETS; ++v) {
+        assert(LatencyHistogram::bucket_for(v) == v);
+        assert(LatencyHistogram::bucket_upper(v) == v);
+    }
+
+    // Buckets are contiguous: every value lies in its bucket and the next one starts right after
+    std::uint64_t previous_upper = LatencyHistogram::SUB_BUCKETS - 1;
+    for (std::size_t b = LatencyHistogram::SUB_BUCKETS; b < LatencyHistogram::BUCKET_COUNT; ++b) {
+        const std::uint64_t lower = previous_upper + 1;
+        const std::uint64_t upper = LatencyHistogram::bucket_upper(b);
+        assert(upper >= lower);
+        assert(LatencyHistogram::bucket_for(lower) == b);
+        assert(LatencyHistogram::bucket_for(upper) == b);
+        // Relative bucket width stays within about 3 %
+        assert((upper - lower + 1) * 32 <= lower + 1);
+        previous_upper = upper;
+    }
+
+    // Out-of-range values saturate
+    assert(LatencyHistogram::bucket_for(~std::uint64_t{0}) == LatencyHistogram::BUCKET_COUNT - 1);
+}
+
+void test_percentiles() {
+    LatencyHistogram histogram;
+    assert(histogram.summarize().count == 0);
+    assert(histogram.percentile(0.5) == 0);
+
+    for (std::uint64_t us = 1; us <= 1000; ++us) {
+        histogram.record(us * 1000);
+    }
+
+    const auto s = histogram.summarize();
+    assert(s.count == 1000);
+    assert(s.mean == 500500);
+    assert(s.max == 1000000);
+    auto near = [](std::uint64_t value, std::uint64_t expected) {
+        return value >= expected && value <= expected + expected / 32;
+    };
+    assert(near(s.p50, 500000));
+    assert(near(s.p99, 990000));
+    assert(near(s.p999, 999000));
+    assert(histogram.percentile(1.0) == s.max);  // Never above the exact maximum
+}
+
+void test_keyboard_slots() {
+    LatencyTracker tracker;
+    const auto a = tracker.keyboard_slot("/dev/input/event3");
+    const auto b = tracker.keyboard_slot("/dev/input/event7");
+    assert(a == 0 && b == 1);
+    assert(tracker.keyboard_slot("/dev/input/event3") == a);  // Replugged keyboard keeps its slot
+
+    for (std::size_t i = 2; i < LatencyTracker::MAX_KEYBOARDS; ++i) {
+        assert(tracker.keyboard_slot("/dev/input/kbd" + std::to_string(i)) == i);
+    }
+    assert(tracker.keyboard_slot("/dev/input/one-too-many") == pipeline::NO_KEYBOARD_SLOT);
+    assert(tracker.keyboard("/dev/input/one-too-many", LatencyStage::EndToEnd) == nullptr);
+    assert(tracker.keyboard("/dev/input/event7", LatencyStage::EndToEnd) != nullptr);
+}
+
+void test_stage_recording() {
+    LatencyTracker tracker;
+    const auto slot = tracker.keyboard_slot("/dev/input/event3");
+
+    const ReportTiming timing{1000000, 1050000, 1060000, slot};
+    tracker.on_report_built(timing);
+    tracker.on_report_written(timing, 1260000);
+
+    assert(tracker.total(LatencyStage::KernelToRead).summarize().max == 50000);
+    assert(tracker.total(LatencyStage::ReadToReport).summarize().max == 10000);
+    assert(tracker.total(LatencyStage::ReportToWrite).summarize().max == 200000);
+    assert(tracker.total(LatencyStage::EndToEnd).summarize().max == 260000);
+    assert(tracker.keyboard("/dev/input/event3", LatencyStage::EndToEnd)->count() == 1);
+
+    // Untimed reports are ignored; reports without a slot only count in the totals
+    tracker.on_report_built({});
+    tracker.on_report_written({}, 2000000);
+    tracker.on_report_written({1000000, 0, 0, pipeline::NO_KEYBOARD_SLOT}, 1100000);
+    assert(tracker.total(LatencyStage::EndToEnd).count() == 2);
+    assert(tracker.keyboard("/dev/input/event3", LatencyStage::EndToEnd)->count() == 1);
+
+    // Stamps that run backwards (microsecond kernel resolution) record 0, not a huge value
+    tracker.on_report_built({1000500, 1000000, 1000000, slot});
+    assert(tracker.total(LatencyStage::KernelToRead).summarize().max == 50000);
+    assert(tracker.total(LatencyStage::KernelToRead).percentile(0.0) == 0);
+}
+
+void test_concurrent_recording() {
+    LatencyTracker tracker;
+    constexpr int THREADS = 4;
+    constexpr int PER_THREAD = 5000;
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < THREADS; ++t) {
+        producers.emplace_back([&tracker, t]() {
+            const auto slot = tracker.keyboard_slot("/dev/input/event" + std::to_string(t % 2));
+            for (int i = 0; i < PER_THREAD; ++i) {
+                const auto base = static_cast<std::uint64_t>(i) * 1000;
+                tracker.on_report_written({base + 1, base + 2, base + 3, slot}, base + 1001);
+                if (i % 256 == 0) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    assert(tracker.total(LatencyStage::EndToEnd).count() == THREADS * PER_THREAD);
+    assert(tracker.total(LatencyStage::EndToEnd).summarize().max == 1000);
+    assert(tracker.keyboard("/dev/input/event0", LatencyStage::EndToEnd)->count() ==
+           2 * PER_THREAD);
+    assert(tracker.keyboard("/dev/input/event1", LatencyStage::ReportToWrite)->count() ==
+           2 * PER_THREAD);
+}
+
+void test_summary() {
+    LatencyTracker tracker;
+    const auto slot = tracker.keyboard_slot("/dev/input/event5");
+    const ReportTiming timing{1000000, 1020000, 1030000, slot};
+    tracker.on_report_built(timing);
+    tracker.on_report_written(timing, 1530000);
+
+    const std::string text = tracker.summary();
+    assert(text.find("Report latency (all keyboards):") == 0);
+    assert(text.find("Report latency (/dev/input/event5):") != std::string::npos);
+    assert(text.find("kernel->read") != std::string::npos);
+    assert(text.find("end-to-end") != std::string::npos);
+    assert(text.find("max=530.0 us") != std::string::npos);
+}
+
+void test_summary_async_log() {
+    LatencyTracker tracker;
+    for (int k = 0; k < 3; ++k) {
+        const auto slot = tracker.keyboard_slot("/dev/input/by-id/usb-keyboard-" +
+                                                std::to_string(k) + "-event-kbd");
+        const ReportTiming timing{1000000, 1020000, 1030000, slot};
+        tracker.on_report_built(timing);
+        tracker.on_report_written(timing, 1530000);
+    }
+    const std::string text = tracker.summary();
+    assert(text.size() > 240);  // Longer than one async record
+
+    std::ostringstream captured;
+    std::streambuf* previous = std::cout.rdbuf(captured.rdbuf());
+    logging::Logger::set_level("info");
+    logging::Logger::enable_timestamps(false);
+    logging::Logger::enable_async(true);
+    LOG_INFO_LINES(text);
+    logging::Logger::flush();
+    logging::Logger::enable_async(false);
+    std::cout.rdbuf(previous);
+    assert(logging::Logger::dropped_count() == 0);
+
+    // Every summary line arrives whole, each as its own record
+    const std::string out = captured.str();
+    std::istringstream lines(text);
+    std::size_t count = 0;
+    for (std::string line; std::getline(lines, line); ++count) {
+        assert(out.find("] " + line + "\033[0m\n") != std::string::npos);
+    }
+    assert(count == (1 + 3) * (1 + pipeline::LATENCY_STAGE_COUNT));  // Totals + 3 keyboards
+    assert(out.find("...") == std::string::npos);  // No record was truncated
+}
+
+}  // namespace
+
+int main() {
+    return test_framework::run_test_suite(
+        "Latency Tracker Tests", {{"bucket mapping", test_bucket_mapping},
+                                  {"percentiles", test_percentiles},
+                                  {"keyboard slots", test_keyboard_slots},
+                                  {"stage recording", test_stage_recording},
+                                  {"concurrent recording", test_concurrent_recording},
+                                  {"summary", test_summary},
+                                  {"summary with async logging", test_summary_async_log}});
+}
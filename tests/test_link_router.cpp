@@ -0,0 +1,102 @@
+/**
+ * @file test_link_router.cpp
+ * @brief Unit tests for multi-link report routing
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include <cassert>
+
+#include "link_router.hpp"
+#include "test_framework.hpp"
+
+namespace {
+
+using ble::LinkRouter;
+
+void test_routes_to_all_by_default() {
+    LinkRouter router(3);
+    assert(router.link_count() == 3);
+    assert(router.active() == 0b111);
+    assert(router.routes_to(0) && router.routes_to(1) && router.routes_to(2));
+    assert(!router.routes_to(3));
+}
+
+void test_toggle_links() {
+    LinkRouter router(3);
+    auto change = router.toggle(1);
+    assert(change.left == 0b010 && change.joined == 0);
+    assert(router.routes_to(0) && !router.routes_to(1) && router.routes_to(2));
+
+    change = router.toggle(1);
+    assert(change.left == 0 && change.joined == 0b010);
+    assert(router.active() == 0b111);
+}
+
+void test_select_all_and_out_of_range() {
+    LinkRouter router(3);
+    router.toggle(0);
+    router.toggle(2);
+    assert(router.active() == 0b010);
+
+    // A link that does not exist changes nothing
+    auto change = router.toggle(6);
+    assert(change.left == 0 && change.joined == 0);
+    assert(router.active() == 0b010);
+
+    change = router.route_all();
+    assert(change.left == 0 && change.joined == 0b101);
+    assert(router.active() == 0b111);
+}
+
+void test_last_link_stays_routed() {
+    LinkRouter router(2);
+    router.toggle(0);
+    assert(router.active() == 0b10);
+    const auto change = router.toggle(1);
+    assert(change.left == 0 && change.joined == 0);
+    assert(router.active() == 0b10);
+
+    LinkRouter single(1);
+    assert(single.toggle(0).left == 0 && single.routes_to(0));
+}
+
+void test_route_mask() {
+    LinkRouter router(ble::MAX_LINKS + 3);
+    assert(router.link_count() == ble::MAX_LINKS);
+    const auto change = router.route(0xFFFF);
+    assert(change.left == 0 && change.joined == 0);
+    assert(router.active() == (1U << ble::MAX_LINKS) - 1U);
+    assert(!router.routes_to(ble::MAX_LINKS));
+}
+
+void test_next_target() {
+    LinkRouter router(3);
+    auto change = router.next();  // All routed: wraps to link 1
+    assert(change.left == 0b110 && change.joined == 0);
+    assert(router.active() == 0b001);
+    change = router.next();
+    assert(change.left == 0b001 && change.joined == 0b010);
+    [[maybe_unused]] const auto third = router.next();
+    assert(router.active() == 0b100);
+    [[maybe_unused]] const auto wrapped = router.next();
+    assert(router.active() == 0b001);
+
+    LinkRouter single(1);
+    change = single.next();
+    assert(change.left == 0 && change.joined == 0);
+    assert(single.routes_to(0));
+}
+
+}  // namespace
+
+int main() {
+    return test_framework::run_test_suite(
+        "Link Router Tests", {{"routes to all by default", test_routes_to_all_by_default},
+                              {"toggle links", test_toggle_links},
+                              {"select all and out of range", test_select_all_and_out_of_range},
+                              {"last link stays routed", test_last_link_stays_routed},
+                              {"route mask", test_route_mask},
+                              {"next target", test_next_target}});
+}
@@ -7,8 +7,12 @@
  */
 
 #include <cassert>
+#include <cstdint>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "logger.hpp"
 
@@ -87,15 +91,48 @@ void test_message_formatting() {
     std::cout << "PASSED\n";
 }
 
+//! @brief Redirects std::cout into a string for the lifetime of the object
+struct CoutCapture {
+    std::ostringstream captured;
+    std::streambuf* previous;
+
+    CoutCapture() : previous(std::cout.rdbuf(captured.rdbuf())) {}
+    ~CoutCapture() { std::cout.rdbuf(previous); }
+};
+
 void test_concurrent_logging() {
-    // Basic test - in a real scenario we'd use threads
-    // For now, just ensure rapid consecutive calls don't crash
+    // Synchronous mode: lines from several threads must come out whole
     logging::Logger::set_level("debug");
+    logging::Logger::enable_timestamps(false);
 
-    for (int i = 0; i < 100; ++i) {
-        LOG_DEBUG("Rapid message " + std::to_string(i));
+    constexpr int THREADS = 4;
+    constexpr int MESSAGES = 200;
+    std::string out;
+    {
+        CoutCapture capture;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < THREADS; ++t) {
+            threads.emplace_back([t] {
+                for (int i = 0; i < MESSAGES; ++i) {
+                    LOG_DEBUG("Rapid message t" + std::to_string(t) + " m" + std::to_string(i));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        out = capture.captured.str();
     }
 
+    std::istringstream lines(out);
+    int count = 0;
+    for (std::string line; std::getline(lines, line); ++count) {
+        assert(line.find("[DEBUG] Rapid message t") != std::string::npos);
+        assert(line.size() >= 4 && line.compare(line.size() - 4, 4, "\033[0m") == 0);
+        assert(line.find("Rapid", line.find("Rapid") + 1) == std::string::npos);
+    }
+    assert(count == THREADS * MESSAGES);
+
     std::cout << "PASSED\n";
 }
 
@@ -110,6 +147,110 @@ void test_level_case_insensitivity() {
     std::cout << "PASSED\n";
 }
 
+int g_evaluations = 0;
+
+std::string counted_message() {
+    ++g_evaluations;
+    return "counted";
+}
+
+void test_lazy_evaluation() {
+    logging::Logger::set_level("info");
+    assert(!logging::Logger::is_enabled(logging::Level::DEBUG));
+    assert(logging::Logger::is_enabled(logging::Level::INFO));
+
+    g_evaluations = 0;
+    LOG_DEBUG(counted_message());  // Filtered: argument must not be evaluated
+    assert(g_evaluations == 0);
+
+    {
+        CoutCapture capture;
+        LOG_INFO(counted_message());
+        assert(capture.captured.str().find("counted") != std::string::npos);
+    }
+    assert(g_evaluations == 1);
+
+    // Macros are single statements
+    if (g_evaluations == 1)
+        LOG_DEBUG(counted_message());
+    else
+        LOG_DEBUG(counted_message());
+    assert(g_evaluations == 1);
+
+    std::cout << "PASSED\n";
+}
+
+void test_format_api() {
+    logging::Logger::set_level("debug");
+    logging::Logger::enable_timestamps(false);
+
+    {
+        CoutCapture capture;
+        LOG_DEBUGF("Key event: code=%u value=%d from %s", 30U, 1, "kbd");
+        assert(capture.captured.str().find("Key event: code=30 value=1 from kbd") !=
+               std::string::npos);
+    }
+
+    // Longer than the initial buffer: grows and keeps the whole message
+    const std::string long_msg(1000, 'B');
+    {
+        CoutCapture capture;
+        LOG_INFOF("Long: %s!", long_msg.c_str());
+        assert(capture.captured.str().find("Long: " + long_msg + "!") != std::string::npos);
+    }
+
+    logging::Logger::set_level("error");
+    {
+        CoutCapture capture;
+        LOG_INFOF("hidden %d", 1);
+        assert(capture.captured.str().empty());
+    }
+
+    std::cout << "PASSED\n";
+}
+
+void test_async_sink() {
+    logging::Logger::set_level("debug");
+    logging::Logger::enable_timestamps(true);
+
+    {
+        CoutCapture capture;
+        logging::Logger::enable_async(true);
+        assert(logging::Logger::async_enabled());
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([t] {
+                for (int i = 0; i < 100; ++i) {
+                    LOG_INFOF("async t%d m%d", t, i);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        LOG_INFO(std::string(500, 'L'));  // Longer than a record: truncated, marked with "..."
+        logging::Logger::flush();
+
+        const std::string flushed = capture.captured.str();
+        const std::uint64_t dropped = logging::Logger::dropped_count();
+        std::size_t lines = 0;
+        for (char c : flushed) {
+            lines += (c == '\n') ? 1 : 0;
+        }
+        assert(lines + dropped == 401);  // Every record is either written or counted as dropped
+        assert(flushed.find("...") != std::string::npos || dropped > 0);
+
+        logging::Logger::enable_async(false);
+        assert(!logging::Logger::async_enabled());
+        LOG_INFO("sync again");
+        assert(capture.captured.str().find("sync again") != std::string::npos);
+    }
+
+    logging::Logger::enable_timestamps(false);
+    std::cout << "PASSED\n";
+}
+
 }  // namespace
 
 int main() {
@@ -123,6 +264,9 @@ int main() {
         test_message_formatting();
         test_concurrent_logging();
         test_level_case_insensitivity();
+        test_lazy_evaluation();
+        test_format_api();
+        test_async_sink();
 
         std::cout << "\n=== All logger tests completed ===\n";
         return 0;
@@ -11,128 +11,81 @@
 #include <cassert>
 #include <cstdint>
 #include <iostream>
-#include <vector>
-
-// Mock Qt types for testing
-class MockQLowEnergyService {
-  public:
-    std::vector<uint8_t> last_written_data;
-    bool write_called = false;
-    bool valid = true;
-
-    void writeCharacteristic(void* /*ch*/, const std::vector<uint8_t>& data, int /*mode*/) {
-        write_called = true;
-        last_written_data = data;
-    }
-};
-
-class MockQLowEnergyCharacteristic {
-  public:
-    bool valid = true;
-    bool isValid() const { return valid; }
-};
-
-// Simple logging for tests
-#define LOG_INFO(msg) std::cout << "[INFO] " << msg << std::endl
-
-// Mock version of make_report_writer for testing
-auto make_report_writer_test(MockQLowEnergyService* service, MockQLowEnergyCharacteristic ch) {
-    return [service, ch](const std::array<uint8_t, 8>& report) {
-        // Validate service and characteristic before writing
-        if (!service || !ch.isValid()) {
-            LOG_INFO("Invalid service or characteristic, skipping HID report");
-            return;
-        }
-
-        // Convert HID report to vector and transmit
-        std::vector<uint8_t> data(report.begin(), report.end());
-        service->writeCharacteristic(nullptr, data, 0);
-    };
-}
-
-void test_valid_service_and_characteristic() {
-    MockQLowEnergyService service;
-    MockQLowEnergyCharacteristic ch;
-
-    auto writer = make_report_writer_test(&service, ch);
 
-    std::array<uint8_t, 8> test_report = {0x01, 0x00, 0x04, 0x00,
-                                          0x00, 0x00, 0x00, 0x00};  // Ctrl+A
-    writer(test_report);
-
-    assert(service.write_called);
-    assert(service.last_written_data.size() == 8);
-    assert(std::equal(service.last_written_data.begin(), service.last_written_data.end(),
-                      test_report.begin()));
+#include "hid_keycodes.hpp"
+#include "report_map.hpp"
+#include "report_types.hpp"
+
+// make_report_writer() in ble_link.cpp writes what encode_report_write() returns to the
+// characteristic it names; the encoding is tested here without Qt.
+using ble::encode_report_write;
+using hid::ReportId;
+using pipeline::Report;
+
+void test_boot_report_without_nkro() {
+    const Report report = Report{0x01, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00};  // Ctrl+A
+
+    for (const bool consumer : {false, true}) {
+        const auto write = encode_report_write(report, false, consumer);
+        assert(write);
+        assert(write->characteristic == ReportId::Keyboard);
+        assert(write->size == hid::KEYBOARD_REPORT_SIZE);
+        assert(std::equal(report.begin(), report.end(), write->data()));
+    }
 
     std::cout << "PASSED" << std::endl;
 }
 
-void test_null_service() {
-    MockQLowEnergyCharacteristic ch;
-
-    auto writer = make_report_writer_test(nullptr, ch);
+void test_boot_fallback_drops_overflow() {
+    // Seven keys held: the boot form only carries the first six
+    std::array<std::uint8_t, hid::NKRO_BITMAP_SIZE> overflow{};
+    overflow[0x0A / 8] = 1U << (0x0A % 8);
+    const Report report = Report::keyboard({0x02, 0, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09}, overflow);
 
-    std::array<uint8_t, 8> test_report = {0x01, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00};
-
-    // Should not crash when service is null
-    writer(test_report);
+    const auto write = encode_report_write(report, false, false);
+    assert(write && write->characteristic == ReportId::Keyboard);
+    assert(write->size == hid::KEYBOARD_REPORT_SIZE);
+    assert(std::equal(report.begin(), report.end(), write->data()));
 
     std::cout << "PASSED" << std::endl;
 }
 
-void test_invalid_characteristic() {
-    MockQLowEnergyService service;
-    MockQLowEnergyCharacteristic ch;
-    ch.valid = false;
-
-    auto writer = make_report_writer_test(&service, ch);
-
-    std::array<uint8_t, 8> test_report = {0x01, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00};
-    writer(test_report);
+void test_nkro_report() {
+    std::array<std::uint8_t, hid::NKRO_BITMAP_SIZE> overflow{};
+    overflow[0x0A / 8] = 1U << (0x0A % 8);
+    const Report report = Report::keyboard({0x02, 0, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09}, overflow);
+
+    const auto write = encode_report_write(report, true, false);
+    assert(write);
+    assert(write->characteristic == ReportId::Nkro);
+    assert(write->size == hid::NKRO_REPORT_SIZE);
+    assert(write->bytes[0] == 0x02);  // Modifiers keep their byte
+    for (const std::uint8_t usage : {0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A}) {
+        assert(write->bytes[1 + usage / 8] & (1U << (usage % 8)));
+    }
+    assert(write->bytes == report.nkro());
 
-    // Should not call write when characteristic is invalid
-    assert(service.write_called == false);
+    // A release is an empty bitmap on the same characteristic
+    const auto release = encode_report_write(Report{}, true, true);
+    assert(release && release->characteristic == ReportId::Nkro);
+    assert(std::all_of(release->bytes.begin(), release->bytes.end(),
+                       [](std::uint8_t b) { return b == 0; }));
 
     std::cout << "PASSED" << std::endl;
 }
 
-void test_different_reports() {
-    MockQLowEnergyService service;
-    MockQLowEnergyCharacteristic ch;
-
-    auto writer = make_report_writer_test(&service, ch);
-
-    // Test empty report
-    std::array<uint8_t, 8> empty_report = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-    writer(empty_report);
-    assert(service.write_called);
-    assert(service.last_written_data.size() == 8);
-    assert(std::equal(service.last_written_data.begin(), service.last_written_data.end(),
-                      empty_report.begin()));
-
-    // Reset for next test
-    service.write_called = false;
-    service.last_written_data.clear();
-
-    // Test modifier-only report (Shift)
-    std::array<uint8_t, 8> shift_report = {0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-    writer(shift_report);
-    assert(service.write_called);
-    assert(std::equal(service.last_written_data.begin(), service.last_written_data.end(),
-                      shift_report.begin()));
-
-    // Reset for next test
-    service.write_called = false;
-    service.last_written_data.clear();
-
-    // Test multiple keys report
-    std::array<uint8_t, 8> multi_report = {0x00, 0x00, 0x04, 0x05,
-                                           0x06, 0x00, 0x00, 0x00};  // A, B, C
-    writer(multi_report);
-    assert(service.write_called);
-    assert(std::equal(service.last_written_data.begin(), service.last_written_data.end(),
-                      multi_report.begin()));
+void test_consumer_report() {
+    const Report volume_up = Report::consumer(0x00E9);
+
+    const auto write = encode_report_write(volume_up, true, true);
+    assert(write);
+    assert(write->characteristic == ReportId::Consumer);
+    assert(write->size == hid::CONSUMER_REPORT_SIZE);
+    assert(write->bytes[0] == 0xE9 && write->bytes[1] == 0x00);
+
+    // Without a consumer characteristic media keys are dropped, never sent as keyboard bytes
+    assert(!encode_report_write(volume_up, true, false));
+    assert(!encode_report_write(volume_up, false, false));
 
     std::cout << "PASSED" << std::endl;
 }
@@ -141,10 +94,10 @@ int main() {
     std::cout << "=== Make Report Writer Unit Tests ===" << std::endl;
 
     try {
-        test_valid_service_and_characteristic();
-        test_null_service();
-        test_invalid_characteristic();
-        test_different_reports();
+        test_boot_report_without_nkro();
+        test_boot_fallback_drops_overflow();
+        test_nkro_report();
+        test_consumer_report();
 
         std::cout << std::endl << "=== All make_report_writer tests completed ===" << std::endl;
         return 0;
@@ -0,0 +1,281 @@
+/**
+ * @file test_metrics.cpp
+ * @brief Unit tests for the metrics registry and its scrape endpoint
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include <arpa/inet.h>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "latency_tracker.hpp"
+#include "metrics.hpp"
+#include "metrics_server.hpp"
+#include "test_framework.hpp"
+
+namespace {
+
+//! @brief Scratch directory removed again at the end of each test
+struct TempDir {
+    std::filesystem::path path;
+
+    TempDir() {
+        path = std::filesystem::temp_directory_path() /
+               ("ninja_metrics_test_" + std::to_string(::getpid()));
+        std::filesystem::remove_all(path);
+        std::filesystem::create_directories(path);
+    }
+    ~TempDir() { std::filesystem::remove_all(path); }
+};
+
+//! @brief Read everything the server sends until it closes the connection
+std::string read_all(int fd) {
+    std::string data;
+    char buffer[1024];
+    ssize_t n = 0;
+    while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        data.append(buffer, static_cast<std::size_t>(n));
+    }
+    close(fd);
+    return data;
+}
+
+std::string scrape_unix(const std::string& path) {
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    assert(connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0);
+    return read_all(fd);
+}
+
+std::string http_get(std::uint16_t port, const std::string& target) {
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    assert(connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0);
+    const std::string request = "GET " + target + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    assert(send(fd, request.data(), request.size(), 0) == static_cast<ssize_t>(request.size()));
+    return read_all(fd);
+}
+
+bool contains(const std::string& text, const std::string& needle) {
+    return text.find(needle) != std::string::npos;
+}
+
+void test_counter_layout() {
+    static_assert(alignof(metrics::Counter) == pipeline::CACHE_LINE_SIZE);
+    static_assert(sizeof(metrics::Counter) == pipeline::CACHE_LINE_SIZE);
+
+    metrics::Metrics m;
+    // Neighbouring counters never share a cache line
+    const auto a = reinterpret_cast<std::uintptr_t>(&m.reports_sent);
+    const auto b = reinterpret_cast<std::uintptr_t>(&m.reports_suppressed);
+    assert(b - a >= pipeline::CACHE_LINE_SIZE);
+
+    m.reports_sent.add();
+    m.reports_sent.add(4);
+    assert(m.reports_sent.load() == 5);
+    m.ble_queue_depth.set(3);
+    m.ble_queue_depth.set(1);
+    assert(m.ble_queue_depth.load() == 1);
+}
+
+void test_device_slots() {
+    metrics::Metrics m;
+    const auto kbd = m.device_slot("/dev/input/event3");
+    assert(kbd == 0);
+    assert(m.device_slot("/dev/input/event3") == kbd);
+    m.add_events(kbd, 10);
+    m.add_events(kbd, 1);
+    assert(m.events_read("/dev/input/event3") == 11);
+    assert(m.events_read("/dev/input/event9") == 0);
+
+    for (std::size_t i = 1; i < metrics::Metrics::MAX_DEVICES; ++i) {
+        assert(m.device_slot("/dev/input/kbd" + std::to_string(i)) == i);
+    }
+    const auto overflow = m.device_slot("/dev/input/one-too-many");
+    assert(overflow == metrics::NO_DEVICE_SLOT);
+    m.add_events(overflow, 2);  // Counted as "other"
+    assert(contains(m.render(), "ninja_util_events_read_total{device=\"other\"} 2\n"));
+}
+
+void test_render() {
+    metrics::Metrics m;
+    m.add_events(m.device_slot("/dev/input/event3"), 42);
+    m.add_events(m.device_slot("/dev/input/we\"ird\\"), 1);
+    m.reports_sent.add(7);
+    m.reports_suppressed.add(2);
+    m.ble_writes.add(6);
+    m.ble_queue_depth.set(1);
+    m.keyboards_added.add();
+    m.ble_reconnected.add(2);
+    m.ble_reconnect_us.add(3500000);
+    m.ble_last_reconnect_us.set(1250000);
+    m.idle_entered.add(3);
+    m.idle_wakes.add(2);
+    m.idle.set(1);
+
+    const std::string text = m.render();
+    assert(contains(text, "# TYPE ninja_util_events_read_total counter\n"));
+    assert(contains(text, "ninja_util_events_read_total{device=\"/dev/input/event3\"} 42\n"));
+    assert(contains(text, "ninja_util_events_read_total{device=\"/dev/input/we\\\"ird\\\\\"} 1\n"));
+    assert(contains(text, "ninja_util_reports_sent_total 7\n"));
+    assert(contains(text, "ninja_util_reports_suppressed_total 2\n"));
+    assert(contains(text, "ninja_util_ble_writes_total 6\n"));
+    assert(contains(text, "# TYPE ninja_util_ble_queue_depth gauge\n"));
+    assert(contains(text, "ninja_util_ble_queue_depth 1\n"));
+    assert(contains(text, "ninja_util_keyboards_added_total 1\n"));
+    assert(contains(text, "# TYPE ninja_util_ble_reconnect_seconds summary\n"));
+    assert(contains(text, "ninja_util_ble_reconnect_seconds_sum 3.5\n"));
+    assert(contains(text, "ninja_util_ble_reconnect_seconds_count 2\n"));
+    assert(contains(text, "ninja_util_ble_last_reconnect_seconds 1.25\n"));
+    assert(contains(text, "ninja_util_idle_entered_total 3\n"));
+    assert(contains(text, "ninja_util_idle_wakes_total 2\n"));
+    assert(contains(text, "# TYPE ninja_util_idle gauge\n"));
+    assert(contains(text, "ninja_util_idle 1\n"));
+    assert(contains(text, "ninja_util_log_dropped_total 0\n"));
+    assert(!contains(text, "report_latency_seconds"));  // No tracker attached
+
+    pipeline::LatencyTracker latency;
+    latency.on_report_written({1000000, 1000000, 1000000, pipeline::NO_KEYBOARD_SLOT}, 1250000);
+    const std::string with_latency = m.render(&latency);
+    assert(contains(with_latency, "# TYPE ninja_util_report_latency_seconds summary\n"));
+    assert(contains(with_latency,
+                    "ninja_util_report_latency_seconds{stage=\"end-to-end\",quantile=\"1\"} "
+                    "0.00025\n"));
+    assert(contains(with_latency,
+                    "ninja_util_report_latency_seconds_count{stage=\"end-to-end\"} 1\n"));
+}
+
+void test_concurrent_updates() {
+    metrics::Metrics m;
+    constexpr int THREADS = 4;
+    constexpr int PER_THREAD = 20000;
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < THREADS; ++t) {
+        producers.emplace_back([&m]() {
+            const auto slot = m.device_slot("/dev/input/event0");
+            for (int i = 0; i < PER_THREAD; ++i) {
+                m.add_events(slot, 1);
+                m.reports_sent.add();
+                if (i % 1024 == 0) {
+                    std::this_thread::yield();
+                    [[maybe_unused]] const std::string page = m.render();  // Scrape mid-update
+                }
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    assert(m.events_read("/dev/input/event0") == THREADS * PER_THREAD);
+    assert(m.reports_sent.load() == THREADS * PER_THREAD);
+}
+
+void test_parse_endpoint() {
+    assert(metrics::parse_endpoint("9464")->port == 9464);
+    assert(!metrics::parse_endpoint("9464")->is_unix());
+    assert(metrics::parse_endpoint("127.0.0.1:80")->port == 80);
+    assert(metrics::parse_endpoint("localhost:65535")->port == 65535);
+    assert(metrics::parse_endpoint("/run/ninja.sock")->unix_path == "/run/ninja.sock");
+
+    assert(!metrics::parse_endpoint(""));
+    assert(!metrics::parse_endpoint("0"));
+    assert(!metrics::parse_endpoint("65536"));
+    assert(!metrics::parse_endpoint("123456"));
+    assert(!metrics::parse_endpoint("0.0.0.0:9464"));  // Loopback only
+    assert(!metrics::parse_endpoint("localhost:"));
+    assert(!metrics::parse_endpoint("ninja.sock"));  // Relative paths are ambiguous
+    assert(!metrics::parse_endpoint("94a4"));
+
+    assert(metrics::parse_endpoint("9464")->describe() == "http://127.0.0.1:9464/metrics");
+    assert(metrics::parse_endpoint("/tmp/m.sock")->describe() == "unix:/tmp/m.sock");
+}
+
+void test_unix_socket_server() {
+    TempDir dir;
+    const std::string path = (dir.path / "metrics.sock").string();
+    metrics::Metrics m;
+    m.reports_sent.add(3);
+
+    {
+        metrics::MetricsServer server({path, 0}, [&m]() { return m.render(); });
+        assert(server.is_valid());
+        assert(server.start());
+        assert(std::filesystem::is_socket(path));
+
+        assert(contains(scrape_unix(path), "ninja_util_reports_sent_total 3\n"));
+        m.reports_sent.add();
+        assert(contains(scrape_unix(path), "ninja_util_reports_sent_total 4\n"));
+        assert(server.scrapes() == 2);
+    }
+    // The socket file is removed again
+    assert(!std::filesystem::exists(path));
+
+    // A stale socket from a crashed run is replaced, other files never are
+    {
+        metrics::MetricsServer first({path, 0}, []() { return std::string("first\n"); });
+        metrics::MetricsServer second({path, 0}, []() { return std::string("second\n"); });
+        assert(second.is_valid() && second.start());
+        assert(scrape_unix(path) == "second\n");
+    }
+    const std::string file = (dir.path / "regular").string();
+    std::ofstream(file) << "keep me";
+    metrics::MetricsServer refused({file, 0}, []() { return std::string(); });
+    assert(!refused.is_valid());
+    assert(std::filesystem::file_size(file) == 7);
+}
+
+void test_http_server() {
+    metrics::Metrics m;
+    m.ble_writes.add(9);
+
+    // Port 0 lets the kernel pick a free port; endpoint() reports it
+    metrics::MetricsServer server({"", 0}, [&m]() { return m.render(); });
+    assert(server.is_valid());
+    assert(server.endpoint().port != 0);
+    assert(server.start());
+
+    const std::string ok = http_get(server.endpoint().port, "/metrics");
+    assert(ok.rfind("HTTP/1.1 200 OK\r\n", 0) == 0);
+    assert(contains(ok, "Content-Type: text/plain; version=0.0.4"));
+    const std::string body = ok.substr(ok.find("\r\n\r\n") + 4);
+    assert(contains(ok, "Content-Length: " + std::to_string(body.size()) + "\r\n"));
+    assert(contains(body, "ninja_util_ble_writes_total 9\n"));
+
+    assert(http_get(server.endpoint().port, "/metrics?name[]=x").rfind("HTTP/1.1 200", 0) == 0);
+    assert(http_get(server.endpoint().port, "/other").rfind("HTTP/1.1 404", 0) == 0);
+
+    server.stop();
+    server.stop();  // Idempotent
+    assert(server.scrapes() == 3);
+}
+
+}  // namespace
+
+int main() {
+    return test_framework::run_test_suite(
+        "Metrics Tests", {{"counter layout", test_counter_layout},
+                          {"device slots", test_device_slots},
+                          {"render", test_render},
+                          {"concurrent updates", test_concurrent_updates},
+                          {"parse endpoint", test_parse_endpoint},
+                          {"unix socket server", test_unix_socket_server},
+                          {"http server", test_http_server}});
+}
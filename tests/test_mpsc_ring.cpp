@@ -0,0 +1,116 @@
+/**
+ * @file test_mpsc_ring.cpp
+ * @brief Unit tests for the lock-free MPSC ring buffer
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "mpsc_ring.hpp"
+#include "test_framework.hpp"
+
+namespace {
+
+void test_push_pop_order() {
+    pipeline::MpscRing<int, 8> ring;
+    int value = -1;
+    assert(!ring.try_pop(value));
+
+    for (int i = 0; i < 5; ++i) {
+        assert(ring.try_push(i));
+    }
+    for (int i = 0; i < 5; ++i) {
+        assert(ring.try_pop(value));
+        assert(value == i);
+    }
+    assert(!ring.try_pop(value));
+}
+
+void test_full_ring_rejects_push() {
+    pipeline::MpscRing<int, 4> ring;
+    for (int i = 0; i < 4; ++i) {
+        assert(ring.try_push(i));
+    }
+    assert(!ring.try_push(99));
+
+    int value = -1;
+    assert(ring.try_pop(value) && value == 0);
+    assert(ring.try_push(4));  // Freed slot is reusable
+    assert(!ring.try_push(5));
+}
+
+void test_wraparound() {
+    pipeline::MpscRing<std::uint32_t, 4> ring;
+    std::uint32_t value = 0;
+
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        assert(ring.try_push(i));
+        assert(ring.try_push(i + 1000));
+        assert(ring.try_pop(value) && value == i);
+        assert(ring.try_pop(value) && value == i + 1000);
+    }
+    assert(!ring.try_pop(value));
+}
+
+void test_concurrent_producers() {
+    constexpr std::uint32_t PRODUCERS = 4;
+    constexpr std::uint32_t PER_PRODUCER = 20000;
+
+    // Element: producer id in the upper bits, sequence number in the lower bits
+    pipeline::MpscRing<std::uint64_t, 64> ring;
+    std::atomic<bool> go{false};
+    std::vector<std::thread> producers;
+    for (std::uint32_t p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&ring, &go, p] {
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+            for (std::uint32_t i = 0; i < PER_PRODUCER; ++i) {
+                const std::uint64_t value = (std::uint64_t{p} << 32) | i;
+                while (!ring.try_push(value)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::array<std::uint32_t, PRODUCERS> next{};
+    std::uint64_t received = 0;
+    go.store(true);
+    while (received < std::uint64_t{PRODUCERS} * PER_PRODUCER) {
+        std::uint64_t value = 0;
+        if (!ring.try_pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        const auto producer = static_cast<std::uint32_t>(value >> 32);
+        const auto sequence = static_cast<std::uint32_t>(value);
+        assert(producer < PRODUCERS);
+        assert(sequence == next[producer]);  // Per-producer FIFO, nothing lost or duplicated
+        ++next[producer];
+        ++received;
+    }
+
+    for (auto& t : producers) {
+        t.join();
+    }
+    std::uint64_t value = 0;
+    assert(!ring.try_pop(value));
+}
+
+}  // namespace
+
+int main() {
+    return test_framework::run_test_suite(
+        "MPSC Ring Unit Tests", {{"push/pop order", test_push_pop_order},
+                                 {"full ring", test_full_ring_rejects_push},
+                                 {"wraparound", test_wraparound},
+                                 {"concurrent producers", test_concurrent_producers}});
+}
@@ -0,0 +1,121 @@
+/**
+ * @file test_probe_retry.cpp
+ * @brief Unit tests for the hot-plug probe retry schedule
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+
+#include "probe_retry.hpp"
+#include "test_framework.hpp"
+
+namespace {
+
+using device::ProbeRetryQueue;
+using Clock = ProbeRetryQueue::Clock;
+using std::chrono::milliseconds;
+
+void test_retryable_errors() {
+    assert(ProbeRetryQueue::is_retryable(EACCES));
+    assert(ProbeRetryQueue::is_retryable(EPERM));
+    assert(ProbeRetryQueue::is_retryable(ENOENT));
+    assert(ProbeRetryQueue::is_retryable(EBUSY));
+    assert(!ProbeRetryQueue::is_retryable(ENODEV));
+    assert(!ProbeRetryQueue::is_retryable(EINVAL));
+    assert(!ProbeRetryQueue::is_retryable(0));
+}
+
+void test_exponential_backoff() {
+    assert(ProbeRetryQueue::delay_after(1) == milliseconds(50));
+    assert(ProbeRetryQueue::delay_after(2) == milliseconds(100));
+    assert(ProbeRetryQueue::delay_after(3) == milliseconds(200));
+    assert(ProbeRetryQueue::delay_after(ProbeRetryQueue::MAX_RETRIES) == milliseconds(1600));
+}
+
+void test_schedule_and_take_due() {
+    ProbeRetryQueue retries;
+    const Clock::time_point t0{};
+    assert(!retries.next_due());
+
+    assert(retries.schedule("/dev/input/event7", 0x0d47, 1, t0));
+    assert(retries.schedule("/dev/input/event8", 0x0d48, 3, t0));
+    assert(retries.size() == 2);
+    assert(*retries.next_due() == t0 + milliseconds(50));
+
+    // Nothing is due early
+    assert(retries.take_due(t0 + milliseconds(49)).empty());
+
+    const auto first = retries.take_due(t0 + milliseconds(50));
+    assert(first.size() == 1);
+    assert(first[0].path == "/dev/input/event7");
+    assert(first[0].devnum == 0x0d47);
+    assert(first[0].failures == 1);
+    assert(*retries.next_due() == t0 + milliseconds(200));
+
+    const auto second = retries.take_due(t0 + milliseconds(1000));
+    assert(second.size() == 1 && second[0].path == "/dev/input/event8");
+    assert(retries.empty());
+    assert(!retries.next_due());
+}
+
+void test_one_entry_per_path() {
+    ProbeRetryQueue retries;
+    const Clock::time_point t0{};
+    assert(retries.schedule("/dev/input/event7", 0, 1, t0));
+    // A later failure of the same node replaces the first entry
+    assert(retries.schedule("/dev/input/event7", 0, 2, t0 + milliseconds(50)));
+    assert(retries.size() == 1);
+    assert(*retries.next_due() == t0 + milliseconds(150));
+
+    assert(retries.cancel("/dev/input/event7"));
+    assert(!retries.cancel("/dev/input/event7"));
+    assert(retries.empty());
+}
+
+void test_gives_up_after_max_retries() {
+    ProbeRetryQueue retries;
+    Clock::time_point now{};
+    for (int failures = 1; failures <= ProbeRetryQueue::MAX_RETRIES; ++failures) {
+        assert(retries.schedule("/dev/input/event9", 0, failures, now));
+        now = *retries.next_due();
+        assert(retries.take_due(now).size() == 1);
+    }
+    assert(!retries.schedule("/dev/input/event9", 0, ProbeRetryQueue::MAX_RETRIES + 1, now));
+    assert(retries.empty());
+
+    // About three seconds of retries in total
+    assert(now - Clock::time_point{} == milliseconds(3150));
+}
+
+void test_cancel_keeps_others() {
+    ProbeRetryQueue retries;
+    const Clock::time_point t0{};
+    assert(retries.schedule("/dev/input/event1", 0, 1, t0));
+    assert(retries.schedule("/dev/input/event2", 0, 2, t0));
+    assert(retries.schedule("/dev/input/event3", 0, 3, t0));
+
+    assert(retries.cancel("/dev/input/event1"));
+    assert(retries.size() == 2);
+    const auto due = retries.take_due(t0 + milliseconds(1000));
+    assert(due.size() == 2);
+    assert(due[0].path != due[1].path);
+    for (const auto& probe : due) {
+        assert(probe.path == "/dev/input/event2" || probe.path == "/dev/input/event3");
+    }
+}
+
+}  // namespace
+
+int main() {
+    return test_framework::run_test_suite(
+        "Probe Retry Tests", {{"retryable errors", test_retryable_errors},
+                              {"exponential backoff", test_exponential_backoff},
+                              {"schedule and take due", test_schedule_and_take_due},
+                              {"one entry per path", test_one_entry_per_path},
+                              {"gives up after max retries", test_gives_up_after_max_retries},
+                              {"cancel keeps others", test_cancel_keeps_others}});
+}
@@ -0,0 +1,96 @@
+/**
+ * @file test_reconnect_backoff.cpp
+ * @brief Unit tests for the BLE reconnect backoff schedule
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include <cassert>
+#include <chrono>
+
+#include "reconnect_backoff.hpp"
+#include "test_framework.hpp"
+
+namespace {
+
+using ble::ReconnectBackoff;
+using Clock = ReconnectBackoff::Clock;
+using State = ReconnectBackoff::State;
+using std::chrono::milliseconds;
+
+void test_exponential_delay() {
+    assert(ReconnectBackoff::delay_before(1) == milliseconds(250));
+    assert(ReconnectBackoff::delay_before(2) == milliseconds(500));
+    assert(ReconnectBackoff::delay_before(3) == milliseconds(1000));
+    assert(ReconnectBackoff::delay_before(7) == milliseconds(16000));
+
+    // Capped, also for attempt counts that would overflow the shift
+    assert(ReconnectBackoff::delay_before(8) == ReconnectBackoff::MAX_DELAY);
+    assert(ReconnectBackoff::delay_before(1000) == ReconnectBackoff::MAX_DELAY);
+    assert(ReconnectBackoff::delay_before(0) == milliseconds(250));
+}
+
+void test_starts_idle() {
+    ReconnectBackoff backoff;
+    assert(backoff.state() == State::Idle);
+    assert(!backoff.reconnecting());
+    assert(backoff.attempts() == 0);
+    assert(!backoff.on_connected(Clock::time_point{}));  // Initial connect is not a reconnect
+}
+
+void test_failed_attempts_back_off() {
+    ReconnectBackoff backoff;
+    const Clock::time_point t0{};
+    assert(backoff.on_failure(t0) == milliseconds(250));
+    assert(backoff.state() == State::Waiting && backoff.reconnecting());
+
+    assert(backoff.begin_attempt() == 1);
+    assert(backoff.state() == State::Connecting);
+    assert(backoff.on_failure(t0 + milliseconds(5250)) == milliseconds(500));
+
+    assert(backoff.begin_attempt() == 2);
+    assert(backoff.on_failure(t0 + milliseconds(10750)) == milliseconds(1000));
+    assert(backoff.attempts() == 2);
+}
+
+void test_outage_measured_from_loss() {
+    ReconnectBackoff backoff;
+    const Clock::time_point t0{};
+    [[maybe_unused]] const auto first = backoff.on_failure(t0);
+    backoff.begin_attempt();
+    [[maybe_unused]] const auto second = backoff.on_failure(t0 + milliseconds(300));
+    backoff.begin_attempt();
+
+    const auto outage = backoff.on_connected(t0 + milliseconds(1200));
+    assert(outage && *outage == milliseconds(1200));
+    assert(backoff.state() == State::Idle);
+    assert(!backoff.on_connected(t0 + milliseconds(1300)));
+}
+
+void test_next_loss_starts_over() {
+    ReconnectBackoff backoff;
+    const Clock::time_point t0{};
+    for (int i = 0; i < 5; ++i) {
+        [[maybe_unused]] const auto delay = backoff.on_failure(t0);
+        backoff.begin_attempt();
+    }
+    [[maybe_unused]] const auto outage = backoff.on_connected(t0 + milliseconds(9000));
+
+    const Clock::time_point t1 = t0 + milliseconds(60000);
+    assert(backoff.on_failure(t1) == milliseconds(250));
+    assert(backoff.begin_attempt() == 1);
+    const auto second = backoff.on_connected(t1 + milliseconds(400));
+    assert(second && *second == milliseconds(400));
+}
+
+}  // namespace
+
+int main() {
+    return test_framework::run_test_suite(
+        "Reconnect Backoff Tests", {{"exponential delay", test_exponential_delay},
+                                    {"starts idle", test_starts_idle},
+                                    {"failed attempts back off", test_failed_attempts_back_off},
+                                    {"outage measured from loss", test_outage_measured_from_loss},
+                                    {"next loss starts over", test_next_loss_starts_over}});
+}
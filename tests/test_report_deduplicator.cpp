@@ -0,0 +1,85 @@
+/**
+ * @file test_report_deduplicator.cpp
+ * @brief Unit tests for the report de-duplication transmit stage
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include <cassert>
+#include <vector>
+
+#include "report_deduplicator.hpp"
+#include "test_framework.hpp"
+
+namespace {
+
+const pipeline::Report kShiftA{0x02, 0, 0x04, 0, 0, 0, 0, 0};
+
+void test_first_report_always_sent() {
+    std::vector<pipeline::Report> sent;
+    pipeline::ReportDeduplicator dedup([&sent](const pipeline::Report& r) { sent.push_back(r); });
+
+    // Even an all-zero report goes out when nothing was sent before
+    assert(dedup.submit(pipeline::Report{}));
+    assert(sent.size() == 1);
+    assert(dedup.sent_count() == 1);
+    assert(dedup.suppressed_count() == 0);
+}
+
+void test_duplicates_dropped() {
+    std::vector<pipeline::Report> sent;
+    pipeline::ReportDeduplicator dedup([&sent](const pipeline::Report& r) { sent.push_back(r); });
+
+    assert(dedup.submit(kShiftA));
+    assert(!dedup.submit(kShiftA));
+    assert(!dedup.submit(kShiftA));
+    assert(dedup.submit(pipeline::Report{}));
+    assert(dedup.submit(kShiftA));
+
+    assert(sent.size() == 3);
+    assert(dedup.last_sent() == kShiftA);
+    assert(dedup.sent_count() == 3);
+    assert(dedup.suppressed_count() == 2);
+}
+
+void test_reset_forces_resend() {
+    std::vector<pipeline::Report> sent;
+    pipeline::ReportDeduplicator dedup([&sent](const pipeline::Report& r) { sent.push_back(r); });
+
+    assert(dedup.submit(kShiftA));
+    dedup.reset();
+    assert(dedup.submit(kShiftA));
+    assert(sent.size() == 2);
+    assert(dedup.suppressed_count() == 0);
+}
+
+void test_report_kinds_tracked_separately() {
+    std::vector<pipeline::Report> sent;
+    pipeline::ReportDeduplicator dedup([&sent](const pipeline::Report& r) { sent.push_back(r); });
+
+    const auto mute = pipeline::Report::consumer(0x00E2);
+    assert(dedup.submit(kShiftA));
+    assert(dedup.submit(mute));
+    assert(!dedup.submit(kShiftA));  // Still the last keyboard report
+    assert(!dedup.submit(mute));
+    assert(dedup.submit(pipeline::Report::consumer(0)));
+    assert(dedup.last_sent() == kShiftA);
+
+    // Overflow keys make a keyboard report differ even with equal boot bytes
+    auto seventh = kShiftA;
+    seventh.overflow[1] = 0x01;
+    assert(dedup.submit(seventh));
+    assert(sent.size() == 4);
+}
+
+}  // namespace
+
+int main() {
+    return test_framework::run_test_suite(
+        "Report Deduplicator Unit Tests",
+        {{"first report always sent", test_first_report_always_sent},
+         {"duplicates dropped", test_duplicates_dropped},
+         {"reset forces resend", test_reset_forces_resend},
+         {"report kinds tracked separately", test_report_kinds_tracked_separately}});
+}
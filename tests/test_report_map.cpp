@@ -0,0 +1,88 @@
+/**
+ * @file test_report_map.cpp
+ * @brief Unit tests for assigning HID reports to GATT characteristics
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include <cassert>
+#include <vector>
+
+#include "report_map.hpp"
+#include "test_framework.hpp"
+
+namespace {
+
+using ble::CharacteristicInfo;
+using ble::map_report_characteristics;
+
+void test_first_writable_without_descriptors() {
+    const std::vector<CharacteristicInfo> chars = {
+        {"{read-only}", false, std::nullopt},
+        {"{ffe1}", true, std::nullopt},
+        {"{ffe2}", true, std::nullopt},
+    };
+    const auto map = map_report_characteristics(chars);
+    assert(map.keyboard == 1U);
+    assert(!map.nkro && !map.consumer);  // Nothing else without report IDs
+}
+
+void test_report_ids() {
+    const std::vector<CharacteristicInfo> chars = {
+        {"{consumer}", true, 2},
+        {"{nkro}", true, 3},
+        {"{keyboard}", true, 1},
+        {"{vendor}", true, 9},  // Unknown report ID
+    };
+    const auto map = map_report_characteristics(chars);
+    assert(map.keyboard == 2U);
+    assert(map.nkro == 1U);
+    assert(map.consumer == 0U);
+}
+
+void test_untagged_keyboard_with_consumer() {
+    const std::vector<CharacteristicInfo> chars = {
+        {"{consumer}", true, 2},
+        {"{ffe1}", true, std::nullopt},
+    };
+    const auto map = map_report_characteristics(chars);
+    assert(map.keyboard == 1U);  // A tagged consumer characteristic is not the keyboard
+    assert(map.consumer == 0U);
+}
+
+void test_not_writable_ignored() {
+    const std::vector<CharacteristicInfo> chars = {
+        {"{keyboard}", false, 1},
+        {"{consumer}", false, 2},
+    };
+    const auto map = map_report_characteristics(chars);
+    assert(!map.keyboard && !map.nkro && !map.consumer);
+}
+
+void test_cached_uuid() {
+    const std::vector<CharacteristicInfo> chars = {
+        {"{ffe1}", true, std::nullopt},
+        {"{ffe2}", true, std::nullopt},
+        {"{consumer}", true, 2},
+    };
+    auto map = map_report_characteristics(chars, std::string("{ffe2}"));
+    assert(map.keyboard == 1U);
+    assert(map.consumer == 2U);
+
+    // The cached characteristic is gone: nothing is mapped
+    map = map_report_characteristics(chars, std::string("{ffe9}"));
+    assert(!map.keyboard && !map.consumer);
+}
+
+}  // namespace
+
+int main() {
+    return test_framework::run_test_suite(
+        "Report Map Tests",
+        {{"first writable without descriptors", test_first_writable_without_descriptors},
+         {"report ids", test_report_ids},
+         {"untagged keyboard with consumer", test_untagged_keyboard_with_consumer},
+         {"not writable ignored", test_not_writable_ignored},
+         {"cached uuid", test_cached_uuid}});
+}
@@ -0,0 +1,114 @@
+/**
+ * @file test_scan_selector.cpp
+ * @brief Unit tests for early-exit BLE device selection
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include <cassert>
+#include <string>
+#include <vector>
+
+#include "scan_selector.hpp"
+#include "test_framework.hpp"
+
+namespace {
+
+using ble::ScanSelector;
+using Action = ScanSelector::Action;
+
+void test_ninja_name() {
+    assert(ScanSelector::is_ninja_name("NinjaUSB"));
+    assert(ScanSelector::is_ninja_name("my-NINJA-dongle"));
+    assert(!ScanSelector::is_ninja_name("Keyboard"));
+    assert(!ScanSelector::is_ninja_name(""));
+}
+
+void test_target_connects_immediately() {
+    ScanSelector selector("AA:BB:CC:DD:EE:FF", true, 500);
+    assert(selector.on_discovered("11:22:33:44:55:66", "NinjaUSB") == Action::None);
+    assert(selector.on_discovered("AA:BB:CC:DD:EE:FF", "Other") == Action::ConnectNow);
+    assert(selector.decided());
+    // Nothing else happens once decided
+    assert(selector.on_discovered("AA:BB:CC:DD:EE:FF", "Other") == Action::None);
+
+    ScanSelector by_name("Desk", true, 500);
+    assert(by_name.on_discovered("11:22:33:44:55:66", "Desk") == Action::ConnectNow);
+}
+
+void test_single_ninja_after_grace() {
+    ScanSelector selector("", true, 500);
+    assert(selector.on_discovered("01:01:01:01:01:01", "Phone") == Action::None);
+    assert(selector.on_discovered("AA:AA:AA:AA:AA:AA", "NinjaUSB") == Action::StartGrace);
+    // Repeated reports of the same device are not a second candidate
+    assert(selector.on_discovered("AA:AA:AA:AA:AA:AA", "NinjaUSB") == Action::None);
+    assert(!selector.decided());
+    assert(selector.on_grace_expired());
+    assert(selector.decided());
+    assert(!selector.on_grace_expired());
+}
+
+void test_second_ninja_cancels() {
+    ScanSelector selector("", true, 500);
+    assert(selector.on_discovered("AA:AA:AA:AA:AA:AA", "NinjaUSB") == Action::StartGrace);
+    assert(selector.on_discovered("BB:BB:BB:BB:BB:BB", "ninja-2") == Action::CancelGrace);
+    assert(!selector.on_grace_expired());
+    assert(!selector.decided());
+
+    selector.reset();
+    assert(selector.on_discovered("BB:BB:BB:BB:BB:BB", "ninja-2") == Action::StartGrace);
+}
+
+void test_zero_grace_and_disabled_auto_connect() {
+    ScanSelector immediate("", true, 0);
+    assert(immediate.on_discovered("AA:AA:AA:AA:AA:AA", "NinjaUSB") == Action::ConnectNow);
+
+    ScanSelector manual("", false, 500);
+    assert(manual.on_discovered("AA:AA:AA:AA:AA:AA", "NinjaUSB") == Action::None);
+    assert(!manual.on_grace_expired());
+}
+
+void test_all_targets_before_connecting() {
+    ScanSelector selector(std::vector<std::string>{"AA:AA:AA:AA:AA:AA", "Desk"}, true, 500);
+    assert(selector.on_discovered("AA:AA:AA:AA:AA:AA", "NinjaUSB") == Action::None);
+    // Seeing the same target again does not count twice
+    assert(selector.on_discovered("AA:AA:AA:AA:AA:AA", "NinjaUSB") == Action::None);
+    assert(selector.on_discovered("BB:BB:BB:BB:BB:BB", "ninja-2") == Action::None);
+    assert(!selector.decided());
+    assert(selector.on_discovered("CC:CC:CC:CC:CC:CC", "Desk") == Action::ConnectNow);
+    assert(selector.decided());
+
+    selector.reset();
+    assert(selector.on_discovered("CC:CC:CC:CC:CC:CC", "Desk") == Action::None);
+}
+
+void test_precomputed_classification() {
+    // The caller's classification wins over the name (DeviceCache computes it once)
+    ScanSelector selector("", true, 0);
+    assert(selector.on_discovered("11:22:33:44:55:66", "NinjaUSB", false) == Action::None);
+    assert(selector.on_discovered("AA:BB:CC:DD:EE:FF", "", true) == Action::ConnectNow);
+}
+
+void test_target_address_any_case() {
+    ScanSelector selector("aa:bb:cc:dd:ee:ff", true, 500);
+    assert(selector.on_discovered("AA:BB:CC:DD:EE:FF", "Other") == Action::ConnectNow);
+
+    // Names still match exactly
+    ScanSelector by_name("desk", true, 500);
+    assert(by_name.on_discovered("11:22:33:44:55:66", "Desk") == Action::None);
+}
+}  // namespace
+
+int main() {
+    return test_framework::run_test_suite(
+        "Scan Selector Unit Tests",
+        {{"ninja name matching", test_ninja_name},
+         {"target connects immediately", test_target_connects_immediately},
+         {"single NinjaUSB device after grace", test_single_ninja_after_grace},
+         {"second NinjaUSB device cancels early exit", test_second_ninja_cancels},
+         {"zero grace and manual selection", test_zero_grace_and_disabled_auto_connect},
+         {"all targets before connecting", test_all_targets_before_connecting},
+         {"precomputed classification", test_precomputed_classification},
+         {"target address in any case", test_target_address_any_case}});
+}
@@ -9,11 +9,16 @@
 #include <atomic>
 #include <cassert>
 #include <csignal>
+#include <cstdint>
 #include <iostream>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 // We need to replicate the signal handling logic for testing
 // since the actual signal_handler is in main.cpp
 std::atomic<bool> g_running_test{true};
+int g_shutdown_fd_test = -1;
+volatile std::sig_atomic_t g_shutdown_signal_test = 0;
 
 void test_signal_handler(int signum) {
     if (signum == SIGINT) {
@@ -21,8 +26,13 @@ void test_signal_handler(int signum) {
         return;
     }
 
-    // For other signals, stop running
+    // For other signals, stop running and wake the event loop (no logging here)
     g_running_test = false;
+    g_shutdown_signal_test = signum;
+    if (g_shutdown_fd_test >= 0) {
+        const std::uint64_t one = 1;
+        [[maybe_unused]] const ssize_t written = write(g_shutdown_fd_test, &one, sizeof(one));
+    }
 }
 
 namespace {
@@ -57,6 +67,29 @@ void test_other_signals_handled() {
     std::cout << "PASSED\n";
 }
 
+void test_shutdown_wakes_event_loop() {
+    g_running_test = true;
+    g_shutdown_fd_test = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    assert(g_shutdown_fd_test >= 0);
+
+    std::uint64_t requests = 0;
+    test_signal_handler(SIGINT);
+    assert(read(g_shutdown_fd_test, &requests, sizeof(requests)) < 0);  // Nothing to report
+
+    // Delivered for real: the handler only flags and signals the eventfd
+    signal(SIGTERM, test_signal_handler);
+    raise(SIGTERM);
+    signal(SIGTERM, SIG_DFL);
+    assert(g_running_test == false && g_shutdown_signal_test == SIGTERM);
+    assert(read(g_shutdown_fd_test, &requests, sizeof(requests)) == sizeof(requests));
+    assert(requests == 1);
+
+    close(g_shutdown_fd_test);
+    g_shutdown_fd_test = -1;
+
+    std::cout << "PASSED\n";
+}
+
 }  // namespace
 
 int main() {
@@ -66,6 +99,7 @@ int main() {
         test_sigint_ignored();
         test_sigterm_handled();
         test_other_signals_handled();
+        test_shutdown_wakes_event_loop();
 
         std::cout << "\n=== All signal handler tests completed ===\n";
         return 0;
@@ -0,0 +1,123 @@
+/**
+ * @file test_spsc_ring.cpp
+ * @brief Unit tests for the lock-free SPSC ring buffer
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <thread>
+
+#include "spsc_ring.hpp"
+#include "test_framework.hpp"
+
+namespace {
+
+void test_push_pop_order() {
+    pipeline::SpscRing<int, 8> ring;
+    assert(ring.empty());
+
+    for (int i = 0; i < 5; ++i) {
+        assert(ring.try_push(i));
+    }
+    assert(ring.size() == 5);
+
+    int value = -1;
+    for (int i = 0; i < 5; ++i) {
+        assert(ring.try_pop(value));
+        assert(value == i);
+    }
+    assert(!ring.try_pop(value));
+    assert(ring.empty());
+}
+
+void test_full_ring_rejects_push() {
+    pipeline::SpscRing<int, 4> ring;
+    for (int i = 0; i < 4; ++i) {
+        assert(ring.try_push(i));
+    }
+    assert(!ring.try_push(99));
+    assert(ring.size() == ring.capacity());
+
+    int value = -1;
+    assert(ring.try_pop(value) && value == 0);
+    assert(ring.try_push(4));  // Freed slot is reusable
+}
+
+void test_wraparound() {
+    pipeline::SpscRing<std::uint32_t, 4> ring;
+    std::uint32_t value = 0;
+
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        assert(ring.try_push(i));
+        assert(ring.try_push(i + 1000));
+        assert(ring.try_pop(value) && value == i);
+        assert(ring.try_pop(value) && value == i + 1000);
+    }
+    assert(ring.empty());
+}
+
+void test_high_water_mark() {
+    pipeline::SpscRing<int, 16> ring;
+    assert(ring.high_water_mark() == 0);
+
+    for (int i = 0; i < 6; ++i) {
+        ring.try_push(i);
+    }
+    int value = 0;
+    while (ring.try_pop(value)) {
+    }
+    ring.try_push(1);
+    ring.try_push(2);
+
+    // Peak occupancy is kept after the ring drains
+    assert(ring.high_water_mark() == 6);
+}
+
+void test_concurrent_producer_consumer() {
+    using Report = std::array<std::uint8_t, 8>;
+    constexpr std::uint32_t COUNT = 200000;
+    pipeline::SpscRing<Report, 64> ring;
+
+    std::thread producer([&ring]() {
+        for (std::uint32_t i = 0; i < COUNT; ++i) {
+            Report report{};
+            report[2] = static_cast<std::uint8_t>(i);
+            report[3] = static_cast<std::uint8_t>(i >> 8);
+            report[4] = static_cast<std::uint8_t>(i >> 16);
+            while (!ring.try_push(report)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::uint32_t expected = 0;
+    Report report{};
+    while (expected < COUNT) {
+        if (!ring.try_pop(report)) {
+            std::this_thread::yield();
+            continue;
+        }
+        const std::uint32_t seq = report[2] | (report[3] << 8) | (report[4] << 16);
+        assert(seq == expected);
+        ++expected;
+    }
+    producer.join();
+
+    assert(ring.empty());
+    assert(ring.high_water_mark() <= ring.capacity());
+}
+
+}  // namespace
+
+int main() {
+    return test_framework::run_test_suite(
+        "SPSC Ring Unit Tests", {{"push/pop order", test_push_pop_order},
+                                 {"full ring", test_full_ring_rejects_push},
+                                 {"wraparound", test_wraparound},
+                                 {"high-water mark", test_high_water_mark},
+                                 {"concurrent producer/consumer", test_concurrent_producer_consumer}});
+}
@@ -0,0 +1,162 @@
+/**
+ * @file test_text_injector.cpp
+ * @brief Unit tests for text → HID report compilation and streaming
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+#include "test_framework.hpp"
+#include "text_injector.hpp"
+
+namespace {
+
+using pipeline::Report;
+
+constexpr std::uint8_t LSHIFT = 0x02;
+
+inject::KeySequence compile(std::string_view text) {
+    std::string error;
+    auto sequence = inject::compile_text(text, error);
+    assert(sequence.has_value() && error.empty());
+    return *sequence;
+}
+
+void test_rollover_between_keys() {
+    const auto sequence = compile("abc");
+    assert(sequence.characters == 3);
+    assert(sequence.reports.size() == 4);
+    assert(sequence.reports[0] == (Report{0, 0, 0x04}));
+    assert(sequence.reports[1] == (Report{0, 0, 0x05}));
+    assert(sequence.reports[2] == (Report{0, 0, 0x06}));
+    assert(sequence.reports[3] == Report{});
+
+    std::cout << "PASSED\n";
+}
+
+void test_repeated_key_released() {
+    const auto sequence = compile("ll");
+    assert(sequence.reports.size() == 4);
+    assert(sequence.reports[0] == (Report{0, 0, 0x0F}));
+    assert(sequence.reports[1] == Report{});
+    assert(sequence.reports[2] == (Report{0, 0, 0x0F}));
+
+    std::cout << "PASSED\n";
+}
+
+void test_shift_handling() {
+    const auto sequence = compile("aB!c");
+    assert(sequence.characters == 4);
+    assert(sequence.reports.size() == 7);
+    assert(sequence.reports[0] == (Report{0, 0, 0x04}));
+    assert(sequence.reports[1] == Report{});  // Released before Shift is pressed
+    assert(sequence.reports[2] == (Report{LSHIFT, 0, 0x05}));
+    assert(sequence.reports[3] == (Report{LSHIFT, 0, 0x1E}));  // '!' is Shift+1
+    assert(sequence.reports[4] == Report{});
+    assert(sequence.reports[5] == (Report{0, 0, 0x06}));
+    assert(sequence.reports[6] == Report{});
+
+    std::cout << "PASSED\n";
+}
+
+void test_whitespace_and_punctuation() {
+    const auto sequence = compile("a b\r\n\t~");
+    assert(sequence.characters == 6);  // '\r' is skipped
+    assert(sequence.reports[1] == (Report{0, 0, 0x2C}));  // Space
+    assert(sequence.reports[3] == (Report{0, 0, 0x28}));  // Enter
+    assert(sequence.reports[4] == (Report{0, 0, 0x2B}));  // Tab
+    assert(sequence.reports[6] == (Report{LSHIFT, 0, 0x35}));  // '~' is Shift+`
+
+    // Every printable character can be typed
+    std::string printable;
+    for (char c = ' '; c <= '~'; ++c) {
+        printable += c;
+    }
+    assert(compile(printable).characters == printable.size());
+
+    std::cout << "PASSED\n";
+}
+
+void test_untypable_characters() {
+    for (const std::string_view text : {std::string_view("caf\xC3\xA9"), std::string_view("bell\a"),
+                                        std::string_view("nul\0", 4)}) {
+        std::string error;
+        assert(!inject::compile_text(text, error));
+        assert(error.find("at offset 3") != std::string::npos ||
+               error.find("at offset 4") != std::string::npos);
+    }
+    assert(compile("").reports.empty());
+
+    std::cout << "PASSED\n";
+}
+
+void test_injector_progress() {
+    using Clock = inject::TextInjector::Clock;
+    inject::TextInjector injector(compile("hi!"));
+    assert(injector.characters() == 3);
+    assert(injector.reports() == 5);
+    assert(!injector.done());
+
+    const Clock::time_point start{};
+    int sent = 0;
+    while (injector.next(start + std::chrono::milliseconds(10) * sent)) {
+        ++sent;
+    }
+    assert(sent == 5);
+    assert(injector.done());
+    assert(injector.typed() == 3);
+    assert(injector.elapsed() == std::chrono::milliseconds(40));
+    assert(std::abs(injector.chars_per_second() - 75.0) < 1e-9);
+    assert(!injector.next(start));
+
+    std::cout << "PASSED\n";
+}
+
+void test_typing_link_retired() {
+    using inject::TypingStep;
+    inject::TextInjector injector(compile("hello"));
+    std::uint32_t typing = 0b11;  // Typed to links 0 and 1
+    std::uint32_t ready = 0b11;
+    assert(inject::typing_step(typing, ready) == TypingStep::Type);
+    assert(injector.next({}) && injector.next({}));
+
+    // Link 1 is retired in the middle of the text: link 0 carries on alone
+    typing &= ~0b10U;
+    ready &= ~0b10U;
+    assert(inject::typing_step(typing, ready) == TypingStep::Type);
+    assert(injector.next({}));
+
+    // Link 0 reconnects: the text waits for it
+    ready = 0;
+    assert(inject::typing_step(typing, ready) == TypingStep::Wait);
+
+    // Reconnecting gives up; another device takes slot 0 but was never typed to
+    typing &= ~0b01U;
+    ready = 0b01;
+    assert(inject::typing_step(typing, ready) == TypingStep::Abandon);
+    assert(!injector.done());
+
+    // A non-typing link that is up does not keep typing alive
+    assert(inject::typing_step(0, 0b100) == TypingStep::Abandon);
+
+    std::cout << "PASSED\n";
+}
+
+}  // namespace
+
+int main() {
+    return test_framework::run_test_suite(
+        "Text Injector Tests", {{"rollover between keys", test_rollover_between_keys},
+                                {"repeated key released", test_repeated_key_released},
+                                {"shift handling", test_shift_handling},
+                                {"whitespace and punctuation", test_whitespace_and_punctuation},
+                                {"untypable characters", test_untypable_characters},
+                                {"injector progress", test_injector_progress},
+                                {"typing link retired", test_typing_link_retired}});
+}
@@ -0,0 +1,231 @@
+/**
+ * @file test_trace_recorder.cpp
+ * @brief Unit tests for the memory-mapped event trace
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "test_framework.hpp"
+#include "trace_recorder.hpp"
+
+namespace {
+
+//! @brief Scratch directory removed again at the end of each test
+struct TempDir {
+    std::filesystem::path path;
+
+    TempDir() {
+        path = std::filesystem::temp_directory_path() /
+               ("ninja_trace_test_" + std::to_string(::getpid()));
+        std::filesystem::remove_all(path);
+        std::filesystem::create_directories(path);
+    }
+    ~TempDir() { std::filesystem::remove_all(path); }
+};
+
+input_event key_event(std::uint16_t code, std::int32_t value) {
+    input_event ev{};
+    ev.type = EV_KEY;
+    ev.code = code;
+    ev.value = value;
+    return ev;
+}
+
+constexpr std::size_t size_for(std::size_t records) {
+    return sizeof(trace::TraceHeader) + records * sizeof(trace::TraceRecord);
+}
+
+void test_round_trip() {
+    TempDir dir;
+    const std::string path = (dir.path / "round_trip.trace").string();
+    const pipeline::Report report = {0x02, 0, 0x04, 0, 0, 0, 0, 0};
+
+    {
+        trace::TraceRecorder recorder(path, size_for(64), trace::TRACE_FLAG_COALESCE_FRAMES);
+        assert(recorder.is_valid());
+        assert(recorder.capacity() == 64);
+        // Preallocated up front
+        assert(std::filesystem::file_size(path) == size_for(64));
+
+        recorder.record_input(3, key_event(KEY_A, 1));
+        recorder.record_report(trace::RecordType::HidReport, report);
+        recorder.record_report(trace::RecordType::BleWrite, report);
+        recorder.record_connection_state(2);
+        recorder.record_connection_interval(std::chrono::microseconds(7500));
+        assert(recorder.recorded() == 5);
+    }
+
+    // Closing trims the unused tail
+    assert(std::filesystem::file_size(path) == size_for(5));
+
+    auto loaded = trace::load_trace(path);
+    assert(loaded.has_value());
+    assert(loaded->header.count == 5);
+    assert(loaded->header.capacity == 64);
+    assert(loaded->header.flags == trace::TRACE_FLAG_COALESCE_FRAMES);
+    assert(loaded->records.size() == 5);
+
+    const auto& records = loaded->records;
+    assert(records[0].record_type() == trace::RecordType::InputEvent);
+    assert(records[0].device == 3);
+    assert(records[0].event_type == EV_KEY);
+    assert(records[0].event_code == KEY_A);
+    assert(records[0].value == 1);
+
+    assert(records[1].record_type() == trace::RecordType::HidReport);
+    assert(records[1].device == trace::NO_DEVICE);
+    assert(records[1].report[0] == 0x02 && records[1].report[2] == 0x04);
+    assert(records[2].record_type() == trace::RecordType::BleWrite);
+
+    assert(records[3].record_type() == trace::RecordType::ConnectionState);
+    assert(records[3].value == 2);
+    assert(records[4].record_type() == trace::RecordType::ConnectionInterval);
+    assert(records[4].value == 7500);
+
+    // Monotonic timestamps, never before the recording started
+    assert(records[0].timestamp_ns >= loaded->header.start_ns);
+    for (std::size_t i = 1; i < records.size(); ++i) {
+        assert(records[i].timestamp_ns >= records[i - 1].timestamp_ns);
+    }
+}
+
+void test_report_id_recorded() {
+    TempDir dir;
+    const std::string path = (dir.path / "report_id.trace").string();
+
+    {
+        trace::TraceRecorder recorder(path, size_for(4), 0);
+        assert(recorder.is_valid());
+        recorder.record_report(trace::RecordType::HidReport, pipeline::Report{0, 0, 0x04});
+        recorder.record_report(trace::RecordType::HidReport, pipeline::Report::consumer(0x00E9));
+    }
+
+    const auto loaded = trace::load_trace(path);
+    assert(loaded && loaded->records.size() == 2);
+    assert(loaded->records[0].report_id == static_cast<std::uint8_t>(hid::ReportId::Keyboard));
+    assert(loaded->records[1].report_id == static_cast<std::uint8_t>(hid::ReportId::Consumer));
+    assert(loaded->records[1].report[0] == 0xE9 && loaded->records[1].report[1] == 0x00);
+}
+
+void test_full_file_drops() {
+    TempDir dir;
+    const std::string path = (dir.path / "full.trace").string();
+
+    trace::TraceRecorder recorder(path, size_for(4), 0);
+    assert(recorder.is_valid());
+    for (int i = 0; i < 10; ++i) {
+        recorder.record_input(0, key_event(KEY_B, i % 2));
+    }
+    assert(recorder.recorded() == 4);
+    assert(recorder.dropped() == 6);
+
+    recorder.close();
+    assert(!recorder.is_valid());
+    recorder.record_input(0, key_event(KEY_B, 0));  // Ignored after close
+    recorder.close();                               // Idempotent
+
+    auto loaded = trace::load_trace(path);
+    assert(loaded.has_value());
+    assert(loaded->records.size() == 4);
+}
+
+void test_unfinished_trace() {
+    TempDir dir;
+    const std::string path = (dir.path / "crash.trace").string();
+
+    trace::TraceRecorder recorder(path, size_for(16), 0);
+    recorder.record_input(1, key_event(KEY_C, 1));
+    recorder.record_input(1, key_event(KEY_C, 0));
+
+    // The shared mapping is visible to readers while the recorder is still open,
+    // exactly as a file left behind by a crash: count 0, zero-filled tail.
+    auto loaded = trace::load_trace(path);
+    assert(loaded.has_value());
+    assert(loaded->header.count == 0);
+    assert(loaded->records.size() == 2);
+    assert(loaded->records[1].value == 0);
+}
+
+void test_concurrent_producers() {
+    TempDir dir;
+    const std::string path = (dir.path / "threads.trace").string();
+    constexpr int THREADS = 4;
+    constexpr int PER_THREAD = 2000;
+
+    trace::TraceRecorder recorder(path, size_for(THREADS * PER_THREAD), 0);
+    std::vector<std::thread> producers;
+    for (int t = 0; t < THREADS; ++t) {
+        producers.emplace_back([&recorder, t]() {
+            for (int i = 0; i < PER_THREAD; ++i) {
+                recorder.record_input(static_cast<std::uint16_t>(t), key_event(KEY_D, i));
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    recorder.close();
+
+    auto loaded = trace::load_trace(path);
+    assert(loaded.has_value());
+    assert(loaded->records.size() == THREADS * PER_THREAD);
+
+    // Every record arrived intact, and each thread's records stay in order
+    std::vector<int> next(THREADS, 0);
+    for (const auto& r : loaded->records) {
+        assert(r.record_type() == trace::RecordType::InputEvent);
+        assert(r.device < THREADS);
+        assert(r.value == next[r.device]);
+        ++next[r.device];
+    }
+}
+
+void test_invalid_inputs() {
+    TempDir dir;
+
+    trace::TraceRecorder missing_dir((dir.path / "no" / "such" / "dir.trace").string(),
+                                     size_for(4), 0);
+    assert(!missing_dir.is_valid());
+    missing_dir.record_input(0, key_event(KEY_E, 1));  // Safe no-op
+
+    trace::TraceRecorder too_small((dir.path / "small.trace").string(), 16, 0);
+    assert(!too_small.is_valid());
+
+    assert(!trace::load_trace((dir.path / "missing.trace").string()).has_value());
+
+    const std::string garbage = (dir.path / "garbage.trace").string();
+    std::ofstream(garbage) << "not a trace file, but long enough to hold a header.........";
+    assert(!trace::load_trace(garbage).has_value());
+}
+
+void test_device_id_from_path() {
+    assert(trace::device_id_from_path("/dev/input/event0") == 0);
+    assert(trace::device_id_from_path("/dev/input/event17") == 17);
+    assert(trace::device_id_from_path("/dev/input/by-id/usb-kbd") == trace::NO_DEVICE);
+    assert(trace::device_id_from_path("") == trace::NO_DEVICE);
+    assert(trace::device_id_from_path("/dev/input/event99999") == trace::NO_DEVICE);
+}
+
+}  // namespace
+
+int main() {
+    return test_framework::run_test_suite(
+        "Trace Recorder Tests", {{"round trip", test_round_trip},
+                                 {"report id recorded", test_report_id_recorded},
+                                 {"full file drops records", test_full_file_drops},
+                                 {"unfinished trace", test_unfinished_trace},
+                                 {"concurrent producers", test_concurrent_producers},
+                                 {"invalid inputs", test_invalid_inputs},
+                                 {"device id from path", test_device_id_from_path}});
+}
@@ -0,0 +1,248 @@
+/**
+ * @file test_transmit_scheduler.cpp
+ * @brief Unit tests for the BLE transmit queue and connection-interval pacing
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ */
+
+#include <cassert>
+#include <chrono>
+#include <vector>
+
+#include "latency_tracker.hpp"
+#include "test_framework.hpp"
+#include "transmit_queue.hpp"
+#include "transmit_scheduler.hpp"
+
+namespace {
+
+using pipeline::Report;
+using pipeline::TransmitQueue;
+using pipeline::TransmitScheduler;
+using namespace std::chrono_literals;
+
+const Report kNone{};
+const Report kA{0, 0, 0x04, 0, 0, 0, 0, 0};
+const Report kAB{0, 0, 0x04, 0x05, 0, 0, 0, 0};
+const Report kABC{0, 0, 0x04, 0x05, 0x06, 0, 0, 0};
+const Report kB{0, 0, 0x05, 0, 0, 0, 0, 0};
+const Report kShift{0x02, 0, 0, 0, 0, 0, 0, 0};
+const Report kShiftA{0x02, 0, 0x04, 0, 0, 0, 0, 0};
+
+void test_collapse_rule() {
+    // Rollover presses in the same direction merge
+    assert(TransmitQueue::can_collapse(kNone, kA, kAB));
+    assert(TransmitQueue::can_collapse(kA, kAB, kABC));
+    assert(TransmitQueue::can_collapse(kNone, kShift, kShiftA));
+
+    // Press followed by release of the same key would lose both edges
+    assert(!TransmitQueue::can_collapse(kNone, kA, kNone));
+    assert(!TransmitQueue::can_collapse(kA, kNone, kA));
+    assert(!TransmitQueue::can_collapse(kNone, kShift, kNone));
+
+    // Independent keys changing in different reports are fine
+    assert(TransmitQueue::can_collapse(kAB, kB, kNone));
+    assert(!TransmitQueue::can_collapse(kA, kAB, kA));
+}
+
+void test_queue_collapses_tail() {
+    TransmitQueue queue;
+    const auto t0 = TransmitQueue::Clock::now();
+
+    assert(queue.push(kA, t0) == TransmitQueue::PushResult::Queued);
+    assert(queue.push(kAB, t0 + 1ms) == TransmitQueue::PushResult::Collapsed);
+    assert(queue.push(kB, t0 + 2ms) == TransmitQueue::PushResult::Queued);  // A release edge
+    assert(queue.size() == 2);
+
+    TransmitQueue::Entry entry;
+    assert(queue.pop(entry));
+    assert(entry.report == kAB);
+    assert(entry.enqueued == t0);  // Oldest contributing timestamp is kept
+    assert(queue.pop(entry));
+    assert(entry.report == kB);
+    assert(!queue.pop(entry));
+    assert(queue.high_water_mark() == 2);
+}
+
+void test_queue_full() {
+    TransmitQueue queue;
+    const auto now = TransmitQueue::Clock::now();
+
+    // Alternating press/release can never collapse
+    for (std::size_t i = 0; i < TransmitQueue::CAPACITY; ++i) {
+        assert(queue.push(i % 2 == 0 ? kA : kNone, now) == TransmitQueue::PushResult::Queued);
+    }
+    assert(queue.push(kA, now) == TransmitQueue::PushResult::Full);
+    assert(queue.size() == TransmitQueue::CAPACITY);
+}
+
+void test_overflow_keys_in_collapse_rule() {
+    // Six keys held plus 'J' (0x0D) beyond the slots
+    const Report six{0, 0, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09};
+    Report seven = six;
+    seven.overflow[0x0D / 8] = 1U << (0x0D % 8);
+    // 'A' released: 'J' takes its slot
+    const Report promoted{0, 0, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0D};
+    const Report released{0, 0, 0x05, 0x06, 0x07, 0x08, 0x09, 0};
+
+    // Pressing and releasing an overflow key is an edge pair for an NKRO peer
+    assert(!TransmitQueue::can_collapse(six, seven, six));
+
+    // The promotion is an edge for a boot-only peer even though 'J' stayed held
+    assert(!TransmitQueue::can_collapse(seven, promoted, released));
+
+    // Pressing 'J' and releasing 'A' are different keys in both views
+    assert(TransmitQueue::can_collapse(six, seven, promoted));
+}
+
+void test_consumer_reports_never_collapse() {
+    TransmitQueue queue;
+    const auto t0 = TransmitQueue::Clock::now();
+    const Report mute = Report::consumer(0x00E2);
+
+    assert(queue.push(kA, t0) == TransmitQueue::PushResult::Queued);
+    assert(queue.push(mute, t0) == TransmitQueue::PushResult::Queued);
+    assert(queue.push(Report::consumer(0), t0) == TransmitQueue::PushResult::Queued);
+
+    // A keyboard report after consumer reports is compared with the last keyboard one
+    assert(queue.push(kAB, t0) == TransmitQueue::PushResult::Queued);  // Tail is consumer
+    assert(queue.push(kABC, t0) == TransmitQueue::PushResult::Collapsed);
+    assert(queue.push(kAB, t0) == TransmitQueue::PushResult::Queued);
+
+    TransmitQueue::Entry entry;
+    assert(queue.pop(entry) && entry.report == kA);
+    assert(queue.pop(entry) && entry.report == mute);
+    assert(queue.pop(entry) && entry.report == Report::consumer(0));
+    assert(queue.pop(entry) && entry.report == kABC);
+    assert(queue.pop(entry) && entry.report == kAB);
+}
+
+void test_idle_link_writes_immediately() {
+    std::vector<Report> written;
+    TransmitScheduler scheduler([&written](const Report& r) { written.push_back(r); }, 30ms);
+    const auto t0 = TransmitScheduler::Clock::now();
+
+    assert(!scheduler.submit(kA, t0));
+    assert(written.size() == 1);
+
+    // Next interval: link idle again
+    assert(!scheduler.submit(kNone, t0 + 30ms));
+    assert(written.size() == 2);
+    assert(scheduler.stats().latency_max_us == 0);
+}
+
+void test_paced_writes_keep_edges() {
+    std::vector<Report> written;
+    TransmitScheduler scheduler([&written](const Report& r) { written.push_back(r); }, 30ms);
+    const auto t0 = TransmitScheduler::Clock::now();
+    const Report kBC{0, 0, 0x05, 0x06, 0, 0, 0, 0};
+
+    assert(!scheduler.submit(kA, t0));  // Written now
+    auto wait = scheduler.submit(kAB, t0 + 5ms);
+    assert(wait && *wait == 25ms);
+    scheduler.submit(kABC, t0 + 6ms);  // Same direction: collapsed
+    scheduler.submit(kBC, t0 + 7ms);   // A's press was already written: collapsed
+    scheduler.submit(kABC, t0 + 8ms);  // A pressed again: separate edge
+    assert(scheduler.queue_depth() == 2);
+    assert(scheduler.stats().collapsed == 2);
+
+    // Nothing is written before the slot
+    wait = scheduler.service(t0 + 20ms);
+    assert(wait && *wait == 10ms);
+    assert(written.size() == 1);
+
+    wait = scheduler.service(t0 + 30ms);
+    assert(written.size() == 2 && written[1] == kBC);
+    assert(wait && *wait == 30ms);
+
+    assert(!scheduler.service(t0 + 60ms));
+    assert(written.size() == 3 && written[2] == kABC);
+
+    const auto& stats = scheduler.stats();
+    assert(stats.submitted == 5);
+    assert(stats.written == 3);
+    assert(stats.latency_max_us == 52000);  // Enqueued at +8ms, written at +60ms
+    assert(scheduler.queue_high_water_mark() == 2);
+}
+
+void test_full_queue_forces_write() {
+    std::vector<Report> written;
+    TransmitScheduler scheduler([&written](const Report& r) { written.push_back(r); }, 50ms);
+    const auto t0 = TransmitScheduler::Clock::now();
+
+    scheduler.submit(kNone, t0);
+    for (std::size_t i = 0; i < TransmitQueue::CAPACITY + 1; ++i) {
+        scheduler.submit(i % 2 == 0 ? kA : kNone, t0 + 1ms);
+    }
+
+    // Oldest report went out early instead of being dropped
+    assert(scheduler.stats().forced_writes == 1);
+    assert(written.size() == 2 && written[1] == kA);
+    assert(scheduler.queue_depth() == TransmitQueue::CAPACITY);
+
+    scheduler.flush(t0 + 2ms);
+    assert(scheduler.queue_depth() == 0);
+    assert(written.size() == TransmitQueue::CAPACITY + 2);
+    assert(written.back() == kA);
+}
+
+void test_connection_interval_update() {
+    std::vector<Report> written;
+    TransmitScheduler scheduler([&written](const Report& r) { written.push_back(r); });
+    assert(scheduler.connection_interval() == TransmitScheduler::DEFAULT_INTERVAL);
+
+    scheduler.set_connection_interval(7500us);
+    assert(scheduler.connection_interval() == 7500us);
+    scheduler.set_connection_interval(0us);  // Unknown interval is ignored
+    assert(scheduler.connection_interval() == 7500us);
+
+    // Multiple writes per interval shorten the spacing
+    TransmitScheduler burst([&written](const Report& r) { written.push_back(r); }, 30ms, 3);
+    const auto t0 = TransmitScheduler::Clock::now();
+    burst.submit(kA, t0);
+    const auto wait = burst.submit(kNone, t0);
+    assert(wait && *wait == 10ms);
+}
+
+void test_latency_tracking() {
+    using pipeline::LatencyStage;
+    pipeline::LatencyTracker latency;
+    TransmitScheduler scheduler([](const Report&) {}, 10ms);
+    scheduler.set_latency_tracker(&latency);
+    const TransmitScheduler::Clock::time_point t0{};  // Simulated clock: ns since epoch == 0
+    auto ns = [](std::chrono::nanoseconds d) { return static_cast<std::uint64_t>(d.count()); };
+
+    // Idle link writes at once: report→write is 0
+    scheduler.submit(kA, t0 + 1ms, {ns(100us), ns(200us), ns(1ms), 0});
+    // Queued and collapsed: the older report's stamps are kept
+    scheduler.submit(kAB, t0 + 2ms, {ns(1500us), ns(1600us), ns(2ms), 0});
+    scheduler.submit(kABC, t0 + 3ms, {ns(2500us), ns(2600us), ns(3ms), 0});
+    scheduler.submit(kNone, t0 + 4ms);  // Untimed
+    scheduler.service(t0 + 11ms);
+    scheduler.flush(t0 + 21ms);
+
+    const auto& to_write = latency.total(LatencyStage::ReportToWrite);
+    assert(to_write.count() == 2);
+    assert(latency.total(LatencyStage::EndToEnd).count() == 2);
+    // kAB+kABC were written at +11ms for a report built at +2ms
+    assert(to_write.summarize().max == ns(9ms));
+    assert(latency.total(LatencyStage::EndToEnd).summarize().max == ns(11ms) - ns(1500us));
+}
+
+}  // namespace
+
+int main() {
+    return test_framework::run_test_suite(
+        "Transmit Scheduler Unit Tests",
+        {{"collapse rule", test_collapse_rule},
+         {"queue collapses tail", test_queue_collapses_tail},
+         {"queue full", test_queue_full},
+         {"overflow keys in collapse rule", test_overflow_keys_in_collapse_rule},
+         {"consumer reports never collapse", test_consumer_reports_never_collapse},
+         {"idle link writes immediately", test_idle_link_writes_immediately},
+         {"paced writes keep edges", test_paced_writes_keep_edges},
+         {"full queue forces write", test_full_queue_forces_write},
+         {"connection interval update", test_connection_interval_update},
+         {"latency tracking", test_latency_tracking}});
+}
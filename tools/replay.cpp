@@ -0,0 +1,297 @@
+/**
+ * @file replay.cpp
+ * @brief ninja_util-replay: feed a recorded event trace back through the pipeline
+ * @author Dharun A P
+ * @license SPDX-License-Identifier: Apache-2.0
+ * @copyright SPDX-FileCopyrightText: 2025 Dharun A P
+ *
+ * Reads a trace written with `ninja_util --trace <path>` and replays its raw
+ * input events through a KeyEventProcessor (hid::apply_key_event and
+ * KeyboardState, de-duplication, exit hotkey) and a TransmitScheduler that
+ * runs on the recorded timeline, including the recorded connection-interval
+ * changes. Nothing touches real devices or Bluetooth, so a trace captured on
+ * a user's machine reproduces the same report stream anywhere.
+ *
+ * The replayed reports are compared with the reports in the trace; a
+ * difference means the pipeline behaves differently than the build that
+ * recorded it and makes the tool exit with status 2, which is what
+ * regression tests check for.
+ *
+ * Usage: ninja_util-replay [--speed <factor>] [--device <id>] [--coalesce-frames] [--dump]
+ *                          <trace>
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <linux/input.h>
+
+#include "key_event_processor.hpp"
+#include "logger.hpp"
+#include "trace_recorder.hpp"
+#include "transmit_scheduler.hpp"
+
+namespace {
+
+using Clock = pipeline::TransmitScheduler::Clock;
+
+struct ReplayOptions {
+    std::string path;              //!< Trace file to replay
+    double speed = 1.0;            //!< Playback speed factor (0: no delays)
+    int device = -1;               //!< Only replay this keyboard id (-1: all)
+    bool coalesce_frames = false;  //!< Force frame coalescing on
+    bool dump = false;             //!< Print the records instead of replaying
+    bool verbose = false;          //!< Per-event debug logging from the processor
+};
+
+void show_usage(const char* program) {
+    std::cout
+        << "Usage: " << program << " [OPTIONS] <trace>\n\n"
+        << "OPTIONS:\n"
+        << "    --speed <factor>     Playback speed: 1 original (default), 10 ten times faster,\n"
+        << "                         0 as fast as possible\n"
+        << "    --device <id>        Only replay events from /dev/input/event<id>\n"
+        << "    --coalesce-frames    Replay with frame coalescing even if the trace was\n"
+        << "                         recorded without it\n"
+        << "    --dump               Print every record instead of replaying\n"
+        << "    -V, --verbose        Per-event debug logging\n"
+        << "    -h, --help           Show this help message and exit\n\n"
+        << "Exit status: 0 replayed reports match the trace, 1 error, 2 reports differ\n";
+}
+
+std::optional<ReplayOptions> parse_options(int argc, char* argv[]) {
+    ReplayOptions opts;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::optional<std::string> {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: " << arg << " requires a value\n";
+                return std::nullopt;
+            }
+            return std::string(argv[++i]);
+        };
+
+        if (arg == "-h" || arg == "--help") {
+            show_usage(argv[0]);
+            std::exit(0);
+        } else if (arg == "--speed") {
+            auto v = value();
+            char* end = nullptr;
+            opts.speed = v ? std::strtod(v->c_str(), &end) : -1.0;
+            if (!v || end == v->c_str() || *end != '\0' || opts.speed < 0.0) {
+                std::cerr << "Error: speed must be a non-negative number\n";
+                return std::nullopt;
+            }
+        } else if (arg == "--device") {
+            auto v = value();
+            char* end = nullptr;
+            const long id = v ? std::strtol(v->c_str(), &end, 10) : -1;
+            if (!v || end == v->c_str() || *end != '\0' || id < 0 || id >= trace::NO_DEVICE) {
+                std::cerr << "Error: device must be an event number such as 3\n";
+                return std::nullopt;
+            }
+            opts.device = static_cast<int>(id);
+        } else if (arg == "--coalesce-frames") {
+            opts.coalesce_frames = true;
+        } else if (arg == "--dump") {
+            opts.dump = true;
+        } else if (arg == "-V" || arg == "--verbose") {
+            opts.verbose = true;
+        } else if (!arg.empty() && arg.front() == '-') {
+            std::cerr << "Error: unknown argument '" << arg << "'\n";
+            return std::nullopt;
+        } else if (opts.path.empty()) {
+            opts.path = arg;
+        } else {
+            std::cerr << "Error: only one trace file can be replayed\n";
+            return std::nullopt;
+        }
+    }
+
+    if (opts.path.empty()) {
+        show_usage(argv[0]);
+        return std::nullopt;
+    }
+    return opts;
+}
+
+std::string format_report(const std::uint8_t* report) {
+    char text[48];
+    std::snprintf(text, sizeof(text), "[%02x %02x %02x %02x %02x %02x %02x %02x]", report[0],
+                  report[1], report[2], report[3], report[4], report[5], report[6], report[7]);
+    return text;
+}
+
+void dump_records(const trace::Trace& t) {
+    for (const auto& r : t.records) {
+        char prefix[48];
+        std::snprintf(prefix, sizeof(prefix), "%12.3f ms  %-13s",
+                      static_cast<double>(r.timestamp_ns - t.header.start_ns) / 1e6,
+                      trace::to_string(r.record_type()));
+        std::cout << prefix;
+        switch (r.record_type()) {
+            case trace::RecordType::InputEvent:
+                std::cout << " event" << r.device << " type=" << r.event_type
+                          << " code=" << r.event_code << " value=" << r.value;
+                break;
+            case trace::RecordType::HidReport:
+            case trace::RecordType::BleWrite:
+                if (r.report_id == static_cast<std::uint8_t>(hid::ReportId::Consumer)) {
+                    std::cout << " consumer";
+                }
+                std::cout << ' ' << format_report(r.report);
+                break;
+            case trace::RecordType::ConnectionState:
+                std::cout << " state=" << r.value;
+                break;
+            case trace::RecordType::ConnectionInterval:
+                std::cout << " interval=" << r.value << " us";
+                break;
+        }
+        std::cout << '\n';
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const auto opts = parse_options(argc, argv);
+    if (!opts) {
+        return 1;
+    }
+
+    const auto recorded = trace::load_trace(opts->path);
+    if (!recorded) {
+        std::cerr << "Error: " << opts->path << " is not a readable ninja_util trace\n";
+        return 1;
+    }
+    if (opts->dump) {
+        dump_records(*recorded);
+        return 0;
+    }
+
+    logging::Logger::set_level(opts->verbose ? "debug" : "warn");
+    const bool coalesce =
+        opts->coalesce_frames || (recorded->header.flags & trace::TRACE_FLAG_COALESCE_FRAMES);
+
+    // The scheduler runs on the recorded timeline: trace timestamps map directly onto its
+    // clock, so pacing and latency figures do not depend on --speed.
+    Clock::time_point now{};
+    std::optional<Clock::time_point> deadline;
+    auto arm = [&](std::optional<Clock::duration> wait) {
+        deadline = wait ? std::optional<Clock::time_point>(now + *wait) : std::nullopt;
+    };
+
+    std::uint64_t writes = 0;
+    pipeline::TransmitScheduler scheduler([&](const pipeline::Report&) { ++writes; });
+    std::vector<pipeline::Report> produced;
+    pipeline::KeyEventProcessor processor(
+        [&](const pipeline::Report& report) {
+            // The trace keeps the report ID and boot bytes, not the overflow keys
+            produced.push_back(pipeline::Report{report.bytes, report.id});
+            arm(scheduler.submit(report, now));
+        },
+        opts->verbose, coalesce);
+
+    auto run_scheduler_until = [&](Clock::time_point t) {
+        while (deadline && *deadline <= t) {
+            now = *deadline;
+            arm(scheduler.service(now));
+        }
+    };
+
+    std::vector<pipeline::Report> expected;
+    std::uint64_t input_events = 0;
+    std::uint64_t recorded_writes = 0;
+    bool exit_hotkey = false;
+    const std::uint64_t start_ns = recorded->header.start_ns;
+    const auto wall_start = std::chrono::steady_clock::now();
+
+    for (const auto& r : recorded->records) {
+        const Clock::time_point t{std::chrono::nanoseconds(r.timestamp_ns - start_ns)};
+        run_scheduler_until(t);
+        now = t;
+
+        if (opts->speed > 0.0) {
+            std::this_thread::sleep_until(
+                wall_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                 t.time_since_epoch() / opts->speed));
+        }
+
+        switch (r.record_type()) {
+            case trace::RecordType::InputEvent: {
+                if (exit_hotkey || (opts->device >= 0 && r.device != opts->device)) {
+                    break;
+                }
+                input_event ev{};
+                ev.type = r.event_type;
+                ev.code = r.event_code;
+                ev.value = r.value;
+                ++input_events;
+                if (processor.process(ev, "event" + std::to_string(r.device)) ==
+                    hotkey::Action::Exit) {
+                    exit_hotkey = true;  // The recording stopped reading here as well
+                }
+                break;
+            }
+            case trace::RecordType::HidReport: {
+                pipeline::Report report{};
+                std::copy(std::begin(r.report), std::end(r.report), report.begin());
+                if (r.report_id == static_cast<std::uint8_t>(hid::ReportId::Consumer)) {
+                    report.id = hid::ReportId::Consumer;  // 0 in older traces: keyboard
+                }
+                expected.push_back(report);
+                break;
+            }
+            case trace::RecordType::BleWrite:
+                ++recorded_writes;
+                break;
+            case trace::RecordType::ConnectionInterval:
+                scheduler.set_connection_interval(std::chrono::microseconds(r.value));
+                break;
+            case trace::RecordType::ConnectionState:
+                break;
+        }
+    }
+    run_scheduler_until(Clock::time_point::max());
+
+    const double span_ms =
+        recorded->records.empty()
+            ? 0.0
+            : static_cast<double>(recorded->records.back().timestamp_ns - start_ns) / 1e6;
+    const auto& stats = scheduler.stats();
+    std::cout << "Trace: " << recorded->records.size() << " records over " << span_ms
+              << " ms, " << expected.size() << " reports and " << recorded_writes
+              << " BLE writes recorded" << (coalesce ? " (frame coalescing)" : "") << "\n";
+    std::cout << "Replay: " << input_events << " input events, " << produced.size()
+              << " reports (" << processor.reports_suppressed() << " unchanged suppressed), "
+              << writes << " BLE writes (" << stats.collapsed << " collapsed, "
+              << stats.forced_writes << " forced); transmit latency mean "
+              << stats.latency_mean_us() << " us, max " << stats.latency_max_us << " us\n";
+
+    if (opts->device >= 0) {
+        std::cout << "Report comparison skipped (--device replays a subset)\n";
+        return 0;
+    }
+    for (std::size_t i = 0; i < std::max(produced.size(), expected.size()); ++i) {
+        if (i >= produced.size() || i >= expected.size() || produced[i] != expected[i]) {
+            std::cout << "Reports differ from the recording at report #" << i << ": recorded "
+                      << (i < expected.size() ? format_report(expected[i].data()) : "none")
+                      << ", replayed "
+                      << (i < produced.size() ? format_report(produced[i].data()) : "none")
+                      << "\n";
+            return 2;
+        }
+    }
+    std::cout << "Replayed reports match the recording\n";
+    return 0;
+}